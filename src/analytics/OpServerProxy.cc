@@ -28,6 +28,7 @@
 #include <base/connection_info.h>
 #include "redis_connection.h"
 #include "redis_processor_vizd.h"
+#include "uve_write_queue.h"
 #include "viz_sandesh.h"
 #include "viz_collector.h"
 
@@ -173,6 +174,15 @@ class OpServerProxy::OpServerImpl {
             void RedisUveDeleteNoConn() {
                 rinfo_.set_delete_no_conn(rinfo_.get_delete_no_conn()+1);
             }
+            void RedisUveUpdateCount(uint64_t count, bool success) {
+                if (success) {
+                    rinfo_.set_update_succeeded(
+                        rinfo_.get_update_succeeded() + count);
+                } else {
+                    rinfo_.set_update_failed(
+                        rinfo_.get_update_failed() + count);
+                }
+            }
 
             void RedisStatusUpdate(RacStatus connection_status) {
                 rinfo_.set_status(RacStatusToString(connection_status));
@@ -200,6 +210,108 @@ class OpServerProxy::OpServerImpl {
                 redis_uve_info.set_conn_cb_failed(to_ops_conn_->CallbackFailed());
                 redis_uve_info.set_conn_cb_succeeded(to_ops_conn_->CallbackSucceeded());
             }
+            redis_uve_info.set_update_coalesced(uve_write_queue_.coalesced());
+            redis_uve_info.set_write_batches(uve_write_queue_.batches());
+            redis_uve_info.set_write_queue_pending(uve_write_queue_.pending());
+            redis_uve_info.set_write_queue_inflight(
+                uve_write_queue_.inflight());
+            redis_uve_info.set_write_queue_defer(uve_write_queue_.defer());
+        }
+
+        // Completion of a UVE write sent to redis
+        class UveWriteProcessor : public RedisProcessorIf {
+        public:
+            UveWriteProcessor(OpServerImpl *impl, UveWriteQueue::Write::Op op,
+                              uint64_t count) :
+                impl_(impl), op_(op), count_(count) {
+            }
+            // reply is NULL when the connection went down
+            virtual void ProcessCallback(redisReply *reply) {
+                impl_->UveWriteDone(op_, count_, reply != NULL);
+                delete this;
+            }
+            virtual bool RedisSend() { return true; }
+            virtual void FinalResult() {}
+            virtual std::string Key() { return "UveWrite"; }
+        private:
+            OpServerImpl *impl_;
+            UveWriteQueue::Write::Op op_;
+            uint64_t count_;
+        };
+
+        static const int kUveWriteFlushMsec = 20;
+
+        bool UveWriteSend(UveWriteQueue::Write::Op op,
+                          const UveWriteQueue::Batch &batch,
+                          const UveWriteQueue::Write *write) {
+            uint64_t count(write ? 1 : batch.size());
+            shared_ptr<RedisAsyncConnection> prac = to_ops_conn();
+            UveWriteProcessor *rpi(new UveWriteProcessor(this, op, count));
+            bool ret(false);
+            if (!prac) {
+                ret = false;
+            } else if (op == UveWriteQueue::Write::UPDATE) {
+                ret = RedisProcessorExec::UVEUpdateBatch(prac.get(), rpi,
+                                                         batch);
+            } else if (op == UveWriteQueue::Write::UPDATE_STATS) {
+                const RedisUVEUpdateArgs &args(write->args);
+                ret = RedisProcessorExec::UVEUpdate(prac.get(), rpi,
+                    args.type, args.attr, args.source, args.node_type,
+                    args.module, args.instance_id, args.key, args.msg,
+                    args.seq, write->agg, write->atyp, write->ts, args.part,
+                    args.is_alarm);
+            } else {
+                const RedisUVEUpdateArgs &args(write->args);
+                ret = RedisProcessorExec::UVEDelete(prac.get(), rpi,
+                    args.type, args.source, args.node_type, args.module,
+                    args.instance_id, args.key, args.seq, args.is_alarm);
+            }
+            if (!ret) {
+                delete rpi;
+                UveWriteStats(op, count, false);
+            }
+            return ret;
+        }
+
+        // UVE writes are accounted as succeeded only once redis replies
+        void UveWriteDone(UveWriteQueue::Write::Op op, uint64_t count,
+                          bool success) {
+            UveWriteStats(op, count, success);
+            uve_write_queue_.WriteDone(count);
+        }
+
+        void UveWriteStats(UveWriteQueue::Write::Op op, uint64_t count,
+                           bool success) {
+            if (!success) {
+                LOG(ERROR, "UVE " << (op == UveWriteQueue::Write::DELETE ?
+                    "delete" : "update") << " of " << count <<
+                    " attributes to redis FAILED");
+            }
+            tbb::mutex::scoped_lock lock(rac_mutex_);
+            if (op == UveWriteQueue::Write::DELETE) {
+                success ? redis_uve_.RedisUveDelete() :
+                    redis_uve_.RedisUveDeleteFail();
+            } else {
+                redis_uve_.RedisUveUpdateCount(count, success);
+            }
+        }
+
+        // Defer reading messages from the generators while the number of
+        // UVE writes queued or in flight to redis is above the high water
+        // mark, and resume once it drains below the low water mark. Runs in
+        // the vizd::UveWriteDefer task, so that the generator and generator
+        // map locks are never taken under the locks of the UVE writer
+        void UveWriteDefer(bool defer) {
+            if (collector_) {
+                collector_->RedisQueueUpdate(defer);
+            }
+        }
+
+        bool UveWriteTimerExpired() {
+            if (uve_write_queue_.pending()) {
+                uve_write_queue_.Flush();
+            }
+            return true;
         }
 
         void ToOpsConnUpPostProcess() {
@@ -321,6 +433,7 @@ class OpServerProxy::OpServerImpl {
             }
             collector_->RedisUpdate(false);
             redis_up_ = false;
+            uve_write_queue_.Clear();
 
             // Update connection info
             ConnectionState::GetInstance()->Update(ConnectionType::REDIS,
@@ -349,6 +462,10 @@ class OpServerProxy::OpServerImpl {
 
             if (reply == NULL) {
                 LOG(DEBUG, "NULL Reply...\n");
+                // Let UVE writes in flight know that they are done
+                if (rpi) {
+                    rpi->ProcessCallback(reply);
+                }
                 return;
             }
             // If redis returns error for async request, then perhaps it
@@ -482,7 +599,16 @@ class OpServerProxy::OpServerImpl {
             kafka_timer_(TimerManager::CreateTimer(*evm->io_service(),
                          "Kafka Timer", 
                          TaskScheduler::GetInstance()->GetTaskId(
-                         "Kafka Timer"))) {
+                         "Kafka Timer"))),
+            uve_write_timer_(TimerManager::CreateTimer(*evm->io_service(),
+                         "UVE Write Timer",
+                         TaskScheduler::GetInstance()->GetTaskId(
+                         "UVE Write Timer"))),
+            uve_write_queue_(
+                boost::bind(&OpServerImpl::UveWriteSend, this, _1, _2, _3),
+                boost::bind(&OpServerImpl::UveWriteDefer, this, _1),
+                TaskScheduler::GetInstance()->GetTaskId(
+                "vizd::UveWriteDefer")) {
             to_ops_conn_.reset(new RedisAsyncConnection(evm_, 
                 redis_uve_ip, redis_uve_port, 
                 boost::bind(&OpServerProxy::OpServerImpl::ToOpsConnUp, this),
@@ -504,6 +630,8 @@ class OpServerProxy::OpServerImpl {
 
             kafka_timer_->Start(1000,
                 boost::bind(&OpServerImpl::KafkaTimer, this), NULL);
+            uve_write_timer_->Start(kUveWriteFlushMsec,
+                boost::bind(&OpServerImpl::UveWriteTimerExpired, this), NULL);
             if (brokers.empty()) return;
             assert(StartKafka());
         }
@@ -547,6 +675,8 @@ class OpServerProxy::OpServerImpl {
         }
 
         ~OpServerImpl() {
+            TimerManager::DeleteTimer(uve_write_timer_);
+            uve_write_timer_ = NULL;
             TimerManager::DeleteTimer(kafka_timer_);
             kafka_timer_ = NULL;
             StopKafka();
@@ -573,6 +703,8 @@ class OpServerProxy::OpServerImpl {
         std::string topicpre_;
         bool redis_up_;
         Timer *kafka_timer_;
+        Timer *uve_write_timer_;
+        UveWriteQueue uve_write_queue_;
 };
 
 OpServerProxy::OpServerProxy(EventManager *evm, VizCollector *collector,
@@ -671,6 +803,10 @@ OpServerProxy::UVEUpdate(const std::string &type, const std::string &attr,
         impl_->redis_uve_.RedisUveUpdateNoConn();
         return false;
     }
+    if (!prac->IsConnUp()) {
+        impl_->redis_uve_.RedisUveUpdateFail();
+        return false;
+    }
 
     unsigned int pt = 0;
     if (!is_alarm) {
@@ -678,15 +814,22 @@ OpServerProxy::UVEUpdate(const std::string &type, const std::string &attr,
         pt = djb_hash(key.c_str(), key.size()) % impl_->partitions_;
     }
 
-    bool ret = RedisProcessorExec::UVEUpdate(prac.get(), NULL, type, attr,
-            source, node_type, module, instance_id, key, message,
-            seq, agg, atyp, ts, pt, is_alarm);
-    if (ret) {
-        impl_->redis_uve_.RedisUveUpdate();
-    } else {
-        impl_->redis_uve_.RedisUveUpdateFail();
-    }
-    return ret;
+    RedisUVEUpdateArgs args;
+    args.type = type;
+    args.attr = attr;
+    args.source = source;
+    args.node_type = node_type;
+    args.module = module;
+    args.instance_id = instance_id;
+    args.key = key;
+    args.msg = message;
+    args.seq = seq;
+    args.part = pt;
+    args.is_alarm = is_alarm;
+    UveWriteQueue::Write::Op op(agg == "stats" ?
+        UveWriteQueue::Write::UPDATE_STATS : UveWriteQueue::Write::UPDATE);
+    impl_->uve_write_queue_.Enqueue(op, args, agg, atyp, ts);
+    return true;
 }
 
 bool
@@ -701,11 +844,24 @@ OpServerProxy::UVEDelete(const std::string &type,
         impl_->redis_uve_.RedisUveDeleteNoConn();
         return false;
     }
+    if (!prac->IsConnUp()) {
+        impl_->redis_uve_.RedisUveDeleteFail();
+        return false;
+    }
 
-    bool ret = RedisProcessorExec::UVEDelete(prac.get(), NULL, type, source, 
-            node_type, module, instance_id, key, seq, is_alarm);
-    ret ? impl_->redis_uve_.RedisUveDelete() : impl_->redis_uve_.RedisUveDeleteFail(); 
-    return ret;
+    RedisUVEUpdateArgs args;
+    args.type = type;
+    args.source = source;
+    args.node_type = node_type;
+    args.module = module;
+    args.instance_id = instance_id;
+    args.key = key;
+    args.seq = seq;
+    args.part = 0;
+    args.is_alarm = is_alarm;
+    impl_->uve_write_queue_.Enqueue(UveWriteQueue::Write::DELETE, args,
+        std::string(), std::string(), 0);
+    return true;
 }
 
 bool
@@ -729,6 +885,9 @@ OpServerProxy::DeleteUVEs(const string &source, const string &module,
 
     shared_ptr<RedisAsyncConnection> prac = impl_->to_ops_conn();
     if  (!(prac && prac->IsConnUp())) return false;
+    // Writes still queued for the generator would only be rejected
+    impl_->uve_write_queue_.Drop(source + ":" + node_type + ":" + module + ":" +
+                        instance_id);
     bool ret =  RedisProcessorExec::SyncDeleteUVEs(impl_->redis_uve_.GetIp(),
             impl_->redis_uve_.GetPort(), impl_->get_redis_password(), source,
             node_type, module, instance_id);
@@ -33,6 +33,9 @@ public:
     OpServerProxy() : impl_(NULL) { }
     virtual ~OpServerProxy();
 
+    // UVE updates and deletes are queued and written to redis in batches.
+    // They return false when redis is not connected. Writes that fail
+    // after being queued are logged and counted as failed in RedisUveInfo
     virtual bool UVEUpdate(const std::string &type, const std::string &attr,
                            const std::string &source, const std::string &node_type,
                            const std::string &module, 
@@ -91,6 +91,8 @@ Collector::Collector(EventManager *evm, short server_port,
         cassandra_ports_(cassandra_ports),
         ttl_map_(ttl_map),
         db_task_id_(TaskScheduler::GetInstance()->GetTaskId(kDbTask)),
+        stat_rollup_(false),
+        redis_queue_defer_(false),
         db_queue_wm_info_(kDbQueueWaterMarkInfo),
         sm_queue_wm_info_(kSmQueueWaterMarkInfo) {
 
@@ -140,6 +142,18 @@ void Collector::RedisUpdate(bool rsc) {
     return;
 }
 
+void Collector::RedisQueueUpdate(bool defer) {
+    LOG(INFO, "RedisQueueUpdate " << defer);
+
+    tbb::mutex::scoped_lock lock(gen_map_mutex_);
+    redis_queue_defer_ = defer;
+    for (GeneratorMap::iterator gen_it = gen_map_.begin();
+            gen_it != gen_map_.end(); gen_it++) {
+        SandeshGenerator *gen = gen_it->second;
+        gen->SetRedisDeferDequeue(defer);
+    }
+}
+
 bool Collector::ReceiveResourceUpdate(SandeshSession *session,
             bool rsc) {
     VizSession *vsession = dynamic_cast<VizSession *>(session);
@@ -253,6 +267,9 @@ bool Collector::ReceiveSandeshCtrlMsg(SandeshStateMachine *state_machine,
         gen = new SandeshGenerator(this, vsession, state_machine, id.get<0>(),
                 id.get<1>(), id.get<2>(), id.get<3>());
         gen_map_.insert(id, gen);
+        if (redis_queue_defer_) {
+            gen->SetRedisDeferDequeue(true);
+        }
     } else {
         // Update the generator if needed
         gen = gen_it->second;
@@ -386,6 +403,22 @@ void Collector::SendGeneratorStatistics() {
     }
 }
 
+void Collector::StatRollupFlush(uint64_t now) {
+    tbb::mutex::scoped_lock lock(gen_map_mutex_);
+    for (GeneratorMap::iterator gm_it = gen_map_.begin();
+            gm_it != gen_map_.end(); gm_it++) {
+        gm_it->second->StatRollupFlush(now);
+    }
+}
+
+void Collector::StatRollupFlushAll() {
+    tbb::mutex::scoped_lock lock(gen_map_mutex_);
+    for (GeneratorMap::iterator gm_it = gen_map_.begin();
+            gm_it != gen_map_.end(); gm_it++) {
+        gm_it->second->StatRollupFlushAll(db_handler_);
+    }
+}
+
 void Collector::GetGeneratorUVEInfo(vector<ModuleServerState> &genlist) {
     genlist.clear();
     tbb::mutex::scoped_lock lock(gen_map_mutex_);
@@ -107,9 +107,13 @@ public:
         std::vector<Sandesh::QueueWaterMarkInfo> &wm_info) const;
 
     OpServerProxy * GetOSP() const { return osp_; }
+    DbHandler * GetDbHandler() const { return db_handler_; }
     EventManager * event_manager() const { return evm_; }
     VizCallback ProcessSandeshMsgCb() const { return cb_; }
     void RedisUpdate(bool rsc);
+    // Defer or resume reading generator messages based on the depth of
+    // the redis UVE write queue
+    void RedisQueueUpdate(bool defer);
 
     static const std::string &GetProgramName() { return prog_name_; };
     static void SetProgramName(const char *name) { prog_name_ = name; };
@@ -119,6 +123,13 @@ public:
     std::vector<std::string> cassandra_ips() { return cassandra_ips_; }
     std::vector<int> cassandra_ports() { return cassandra_ports_; }
     const DbHandler::TtlMap& analytics_ttl_map() { return ttl_map_; }
+    // Roll up the stats samples written by the generators' DbHandlers
+    void EnableStatRollup(bool enable) { stat_rollup_ = enable; }
+    bool stat_rollup() const { return stat_rollup_; }
+    void StatRollupFlush(uint64_t now);
+    // Write all the generators' rolled up stats samples through the
+    // collector's DbHandler, called on shutdown
+    void StatRollupFlushAll();
     int db_task_id();
     const CollectorStats &GetStats() const { return stats_; }
     void SendGeneratorStatistics();
@@ -169,11 +180,14 @@ private:
     std::vector<int> cassandra_ports_;
     DbHandler::TtlMap ttl_map_;
     int db_task_id_;
+    bool stat_rollup_;
 
     // SandeshGenerator map
     typedef boost::ptr_map<SandeshGenerator::GeneratorId, SandeshGenerator> GeneratorMap;
     mutable tbb::mutex gen_map_mutex_;
     GeneratorMap gen_map_;
+    // Set while the redis UVE write queue is above its high water mark
+    bool redis_queue_defer_;
 
     // Random generator for UUIDs
     ThreadSafeUuidGenerator umn_gen_;
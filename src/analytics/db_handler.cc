@@ -14,6 +14,7 @@
 #include <rapidjson/writer.h>
 
 #include <base/logging.h>
+#include <base/string_util.h>
 #include <io/event_manager.h>
 #include <base/connection_info.h>
 #include <sandesh/sandesh_types.h>
@@ -54,7 +55,11 @@ DbHandler::DbHandler(EventManager *evm,
         const std::vector<int> &cassandra_ports,
         std::string name, const TtlMap& ttl_map) :
     name_(name),
-    drop_level_(SandeshLevel::INVALID), ttl_map_(ttl_map) {
+    ttl_map_(ttl_map),
+    stat_rollup_flush_ts_(0) {
+        drop_level_ = SandeshLevel::INVALID;
+        stat_rollup_ = false;
+        stat_rollup_write_fails_ = 0;
         int analytics_ttl = DbHandler::GetTtlFromMap(ttl_map, DbHandler::GLOBAL_TTL);
         if (analytics_ttl == -1) {
             DB_LOG(ERROR, "Unexpected analytics_ttl value: " << analytics_ttl);
@@ -69,7 +74,11 @@ DbHandler::DbHandler(EventManager *evm,
 
 DbHandler::DbHandler(GenDb::GenDbIf *dbif, const TtlMap& ttl_map) :
     dbif_(dbif),
-    ttl_map_(ttl_map) {
+    ttl_map_(ttl_map),
+    stat_rollup_flush_ts_(0) {
+    drop_level_ = SandeshLevel::INVALID;
+    stat_rollup_ = false;
+    stat_rollup_write_fails_ = 0;
 }
 
 DbHandler::~DbHandler() {
@@ -324,6 +333,10 @@ bool DbHandler::GetStats(std::vector<GenDb::DbTableInfo> *vdbti,
     return dbif_->Db_GetStats(vdbti, dbe);
 }
 
+bool DbHandler::GetStats(GenDb::DbWriteBatchInfo *dbwbi) {
+    return dbif_->Db_GetWriteBatchStats(dbwbi);
+}
+
 bool DbHandler::AllowMessageTableInsert(const SandeshHeader &header) {
     return header.get_Type() != SandeshType::FLOW;
 }
@@ -814,10 +827,223 @@ DbHandler::StatTableInsert(uint64_t ts,
         const AttribMap & attribs) {
     int ttl = GetTtl(STATSDATA_TTL);
     StatTableInsertTtl(ts, statName, statAttr, attribs_tag, attribs, ttl);
+    if (stat_rollup_) {
+        if (StatRollupUpdate(ts, statName, statAttr, attribs_tag, attribs)) {
+            StatRollupFlushAll();
+        } else {
+            StatRollupFlush(ts);
+        }
+    }
+}
+
+// Rolled up stats samples of the periods in progress are lost when the
+// collector restarts, so the query engine only reads the rolled up samples
+// of the periods that start after the time written here. 0, written when
+// rollups are disabled, keeps it from reading any.
+bool
+DbHandler::StatRollupWriteStartTime() {
+    std::auto_ptr<GenDb::ColList> col_list(new GenDb::ColList);
+    col_list->cfname_ = g_viz_constants.SYSTEM_OBJECT_TABLE;
+    col_list->rowkey_.push_back(g_viz_constants.SYSTEM_OBJECT_ANALYTICS);
+    uint64_t start_time(stat_rollup_ ? UTCTimestampUsec() : 0);
+    col_list->columns_.push_back(new GenDb::NewCol(
+        g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME, start_time, 0));
+    if (!dbif_->Db_AddColumnSync(col_list)) {
+        DB_LOG(ERROR, "Stat rollup start time write FAILED");
+        return false;
+    }
+    return true;
+}
+
+// Tags identify the rolled up sample that a stats sample is aggregated
+// into
+static bool StatRollupIsGroupAttrib(const DbHandler::TagMap & attribs_tag,
+        const std::string& name) {
+    for (DbHandler::TagMap::const_iterator it = attribs_tag.begin();
+            it != attribs_tag.end(); it++) {
+        if ((it->first == name) ||
+            (it->second.second.find(name) != it->second.second.end())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void StatRollupAggregate(DbHandler::AttribMap *attribs,
+        const std::string& name, const DbHandler::Var& value) {
+    pair<DbHandler::AttribMap::iterator,bool> sum_rt =
+        attribs->insert(make_pair(name, value));
+    pair<DbHandler::AttribMap::iterator,bool> min_rt =
+        attribs->insert(make_pair(name +
+            g_viz_constants.STAT_ROLLUP_MIN_SUFFIX, value));
+    pair<DbHandler::AttribMap::iterator,bool> max_rt =
+        attribs->insert(make_pair(name +
+            g_viz_constants.STAT_ROLLUP_MAX_SUFFIX, value));
+    if (sum_rt.second) {
+        return;
+    }
+    DbHandler::Var& sum = sum_rt.first->second;
+    DbHandler::Var& min = min_rt.first->second;
+    DbHandler::Var& max = max_rt.first->second;
+    if (sum.type != value.type) {
+        return;
+    }
+    switch (value.type) {
+        case DbHandler::UINT64:
+            sum.num += value.num;
+            min.num = std::min(min.num, value.num);
+            max.num = std::max(max.num, value.num);
+            break;
+        case DbHandler::DOUBLE:
+            sum.dbl += value.dbl;
+            min.dbl = std::min(min.dbl, value.dbl);
+            max.dbl = std::max(max.dbl, value.dbl);
+            break;
+        default:
+            break;
+    }
+}
+
+// This function aggregates a Stats sample into the rolled up samples of
+// its stats table for each of the rollup periods. Returns true once
+// kStatRollupMaxEntries rolled up samples are pending.
+bool
+DbHandler::StatRollupUpdate(uint64_t ts,
+        const std::string& statName,
+        const std::string& statAttr,
+        const TagMap & attribs_tag,
+        const AttribMap & attribs) {
+
+    std::ostringstream group;
+    for (AttribMap::const_iterator it = attribs.begin();
+            it != attribs.end(); it++) {
+        if (StatRollupIsGroupAttrib(attribs_tag, it->first)) {
+            group << it->first << '\x1f' << it->second << '\x1e';
+        }
+    }
+
+    tbb::mutex::scoped_lock lock(rollup_mutex_);
+    const std::vector<uint32_t>& periods(g_viz_constants.STAT_ROLLUP_PERIODS);
+    for (size_t idx = 0; idx < periods.size(); idx++) {
+        uint64_t period = periods[idx] * 1000000ULL;
+        uint64_t start = ts - (ts % period);
+        std::ostringstream key;
+        key << periods[idx] << '|' << start << '|' << statName << '|' <<
+            statAttr << '|' << group.str();
+
+        pair<StatRollupMap::iterator,bool> rt =
+            stat_rollups_.insert(make_pair(key.str(), StatRollup()));
+        StatRollup& rollup = rt.first->second;
+        if (rt.second) {
+            rollup.ts = start;
+            rollup.end_ts = start + period;
+            rollup.statName = statName;
+            rollup.statAttr = statAttr;
+            rollup.rollupAttr = statAttr +
+                g_viz_constants.STAT_ROLLUP_SEPARATOR +
+                integerToString(periods[idx]);
+            rollup.attribs_tag = attribs_tag;
+            if (!stat_rollup_flush_ts_ ||
+                (rollup.end_ts < stat_rollup_flush_ts_)) {
+                stat_rollup_flush_ts_ = rollup.end_ts;
+            }
+        }
+        rollup.count++;
+        for (AttribMap::const_iterator it = attribs.begin();
+                it != attribs.end(); it++) {
+            if (StatRollupIsGroupAttrib(attribs_tag, it->first)) {
+                rollup.attribs.insert(*it);
+            } else if ((it->second.type == DbHandler::UINT64) ||
+                       (it->second.type == DbHandler::DOUBLE)) {
+                StatRollupAggregate(&rollup.attribs, it->first, it->second);
+            }
+            // Other attributes that are not tags are not rolled up
+        }
+    }
+    return stat_rollups_.size() >= kStatRollupMaxEntries;
 }
 
-// This function writes Stats samples to the DB.
+// This function writes the rolled up Stats samples of the periods that
+// ended before now. A sample arriving after its period was written is
+// rolled up again; the query engine aggregates both rolled up samples.
 void
+DbHandler::StatRollupFlush(uint64_t now) {
+    std::vector<StatRollup> rollups;
+    {
+        tbb::mutex::scoped_lock lock(rollup_mutex_);
+        if (!stat_rollup_flush_ts_ ||
+            (now < stat_rollup_flush_ts_ + kStatRollupFlushDelayUsec)) {
+            return;
+        }
+        stat_rollup_flush_ts_ = 0;
+        for (StatRollupMap::iterator it = stat_rollups_.begin();
+                it != stat_rollups_.end(); ) {
+            const StatRollup& rollup(it->second);
+            if (now >= rollup.end_ts + kStatRollupFlushDelayUsec) {
+                rollups.push_back(rollup);
+                stat_rollups_.erase(it++);
+                continue;
+            }
+            if (!stat_rollup_flush_ts_ ||
+                (rollup.end_ts < stat_rollup_flush_ts_)) {
+                stat_rollup_flush_ts_ = rollup.end_ts;
+            }
+            it++;
+        }
+    }
+    StatRollupWrite(&rollups);
+}
+
+// This function writes all the rolled up Stats samples, including those
+// of the periods in progress, so that they are not lost when the DB
+// connection of this DbHandler goes away or too many are pending. Later
+// samples of a period in progress go into a second rolled up sample for
+// the period, which the query engine aggregates with the first one.
+void
+DbHandler::StatRollupFlushAll(DbHandler *db_handler) {
+    std::vector<StatRollup> rollups;
+    {
+        tbb::mutex::scoped_lock lock(rollup_mutex_);
+        for (StatRollupMap::const_iterator it = stat_rollups_.begin();
+                it != stat_rollups_.end(); it++) {
+            rollups.push_back(it->second);
+        }
+        stat_rollups_.clear();
+        stat_rollup_flush_ts_ = 0;
+    }
+    if (db_handler) {
+        db_handler->StatRollupWrite(&rollups);
+    } else {
+        StatRollupWrite(&rollups);
+    }
+}
+
+// The query engine reads the rolled up samples of the periods after the
+// rollup start time. If a rolled up sample can not be written, the start
+// time is moved past its period so that the raw samples are read instead.
+void
+DbHandler::StatRollupWrite(std::vector<StatRollup> *rollups) {
+    int ttl = GetTtl(STATSDATA_TTL);
+    bool success(true);
+    for (std::vector<StatRollup>::iterator it = rollups->begin();
+            it != rollups->end(); it++) {
+        it->attribs.insert(make_pair(it->statAttr +
+            g_viz_constants.STAT_ROLLUP_COUNT_SUFFIX, Var(it->count)));
+        if (!StatTableInsertTtl(it->ts, it->statName, it->rollupAttr,
+                it->attribs_tag, it->attribs, ttl)) {
+            stat_rollup_write_fails_++;
+            success = false;
+        }
+    }
+    if (!success) {
+        DB_LOG(ERROR, "Stat rollup write FAILED, resetting start time");
+        StatRollupWriteStartTime();
+    }
+}
+
+// This function writes Stats samples to the DB. Returns false if any of
+// the writes failed.
+bool
 DbHandler::StatTableInsertTtl(uint64_t ts, 
         const std::string& statName,
         const std::string& statAttr,
@@ -888,6 +1114,7 @@ DbHandler::StatTableInsertTtl(uint64_t ts,
     dd.Accept(writer);
     string jsonline(sb.GetString());
 
+    bool success(true);
     uint32_t t1;
     if ( statName.compare("FieldNames") != 0) {
 	t1 = (uint32_t)(temp_u64& g_viz_constants.RowTimeInMask);
@@ -903,18 +1130,22 @@ DbHandler::StatTableInsertTtl(uint64_t ts,
         ptag.second = it->second.first;
         if (it->second.second.empty()) {
             pair<string,DbHandler::Var> stag;
-            StatTableWrite(temp_u32, statName, statAttr,
-                                ptag, stag, t1, unm, jsonline, ttl);
+            if (!StatTableWrite(temp_u32, statName, statAttr,
+                                ptag, stag, t1, unm, jsonline, ttl)) {
+                success = false;
+            }
         } else {
             for (AttribMap::const_iterator jt = it->second.second.begin();
                     jt != it->second.second.end(); jt++) {
-                StatTableWrite(temp_u32, statName, statAttr,
-                                    ptag, *jt, t1, unm, jsonline, ttl);
+                if (!StatTableWrite(temp_u32, statName, statAttr,
+                                    ptag, *jt, t1, unm, jsonline, ttl)) {
+                    success = false;
+                }
             }
         }
 
     }
-
+    return success;
 }
 
 typedef boost::array<GenDb::DbDataValue,
@@ -1260,54 +1491,70 @@ bool DbHandler::FlowTableInsert(const pugi::xml_node &parent,
 bool DbHandler::UnderlayFlowSampleInsert(const UFlowData& flow_data,
                                          uint64_t timestamp) {
     const std::vector<UFlowSample>& flow = flow_data.get_flow();
+    DbHandler::Var name(flow_data.get_name());
     for (std::vector<UFlowSample>::const_iterator it = flow.begin();
          it != flow.end(); ++it) {
-        // Add all attributes
-        DbHandler::AttribMap amap;
-        DbHandler::Var name(flow_data.get_name());
-        amap.insert(std::make_pair("name", name));
-        DbHandler::Var pifindex = it->get_pifindex();
-        amap.insert(std::make_pair("flow.pifindex", pifindex));
-        DbHandler::Var sip = it->get_sip();
-        amap.insert(std::make_pair("flow.sip", sip));
-        DbHandler::Var dip = it->get_dip();
-        amap.insert(std::make_pair("flow.dip", dip));
-        DbHandler::Var sport = static_cast<uint64_t>(it->get_sport());
-        amap.insert(std::make_pair("flow.sport", sport));
-        DbHandler::Var dport = static_cast<uint64_t>(it->get_dport());
-        amap.insert(std::make_pair("flow.dport", dport));
-        DbHandler::Var protocol = static_cast<uint64_t>(it->get_protocol());
-        amap.insert(std::make_pair("flow.protocol", protocol));
-        DbHandler::Var ft = it->get_flowtype();
-        amap.insert(std::make_pair("flow.flowtype", ft));
-        
-        DbHandler::TagMap tmap;
-        // Add tag -> name:.pifindex
-        DbHandler::AttribMap amap_name_pifindex;
-        amap_name_pifindex.insert(std::make_pair("flow.pifindex", pifindex));
-        tmap.insert(std::make_pair("name", std::make_pair(name,
-                amap_name_pifindex)));
-        // Add tag -> .sip
-        DbHandler::AttribMap amap_sip;
-        tmap.insert(std::make_pair("flow.sip", std::make_pair(sip, amap_sip)));
-        // Add tag -> .dip
-        DbHandler::AttribMap amap_dip;
-        tmap.insert(std::make_pair("flow.dip", std::make_pair(dip, amap_dip)));
-        // Add tag -> .protocol:.sport
-        DbHandler::AttribMap amap_protocol_sport;
-        amap_protocol_sport.insert(std::make_pair("flow.sport", sport));
-        tmap.insert(std::make_pair("flow.protocol",
-                std::make_pair(protocol, amap_protocol_sport)));
-        // Add tag -> .protocol:.dport
-        DbHandler::AttribMap amap_protocol_dport;
-        amap_protocol_dport.insert(std::make_pair("flow.dport", dport));
-        tmap.insert(std::make_pair("flow.protocol",
-                std::make_pair(protocol, amap_protocol_dport)));
-        StatTableInsert(timestamp, "UFlowData", "flow", tmap, amap);
+        UFlowSampleInsert(name, *it, timestamp);
+    }
+    return true;
+}
+
+bool DbHandler::UnderlayFlowSampleInsert(const std::string& name,
+                                         const UFlowSampleList& samples) {
+    DbHandler::Var gen_name(name);
+    for (UFlowSampleList::const_iterator it = samples.begin();
+         it != samples.end(); ++it) {
+        UFlowSampleInsert(gen_name, it->second, it->first);
     }
     return true;
 }
 
+void DbHandler::UFlowSampleInsert(const DbHandler::Var& name,
+                                  const UFlowSample& sample,
+                                  uint64_t timestamp) {
+    // Add all attributes
+    DbHandler::AttribMap amap;
+    amap.insert(std::make_pair("name", name));
+    DbHandler::Var pifindex = sample.get_pifindex();
+    amap.insert(std::make_pair("flow.pifindex", pifindex));
+    DbHandler::Var sip = sample.get_sip();
+    amap.insert(std::make_pair("flow.sip", sip));
+    DbHandler::Var dip = sample.get_dip();
+    amap.insert(std::make_pair("flow.dip", dip));
+    DbHandler::Var sport = static_cast<uint64_t>(sample.get_sport());
+    amap.insert(std::make_pair("flow.sport", sport));
+    DbHandler::Var dport = static_cast<uint64_t>(sample.get_dport());
+    amap.insert(std::make_pair("flow.dport", dport));
+    DbHandler::Var protocol = static_cast<uint64_t>(sample.get_protocol());
+    amap.insert(std::make_pair("flow.protocol", protocol));
+    DbHandler::Var ft = sample.get_flowtype();
+    amap.insert(std::make_pair("flow.flowtype", ft));
+    
+    DbHandler::TagMap tmap;
+    // Add tag -> name:.pifindex
+    DbHandler::AttribMap amap_name_pifindex;
+    amap_name_pifindex.insert(std::make_pair("flow.pifindex", pifindex));
+    tmap.insert(std::make_pair("name", std::make_pair(name,
+            amap_name_pifindex)));
+    // Add tag -> .sip
+    DbHandler::AttribMap amap_sip;
+    tmap.insert(std::make_pair("flow.sip", std::make_pair(sip, amap_sip)));
+    // Add tag -> .dip
+    DbHandler::AttribMap amap_dip;
+    tmap.insert(std::make_pair("flow.dip", std::make_pair(dip, amap_dip)));
+    // Add tag -> .protocol:.sport
+    DbHandler::AttribMap amap_protocol_sport;
+    amap_protocol_sport.insert(std::make_pair("flow.sport", sport));
+    tmap.insert(std::make_pair("flow.protocol",
+            std::make_pair(protocol, amap_protocol_sport)));
+    // Add tag -> .protocol:.dport
+    DbHandler::AttribMap amap_protocol_dport;
+    amap_protocol_dport.insert(std::make_pair("flow.dport", dport));
+    tmap.insert(std::make_pair("flow.protocol",
+            std::make_pair(protocol, amap_protocol_dport)));
+    StatTableInsert(timestamp, "UFlowData", "flow", tmap, amap);
+}
+
 DbHandlerInitializer::DbHandlerInitializer(EventManager *evm,
     const std::string &db_name, int db_task_instance,
     const std::string &timer_task_name,
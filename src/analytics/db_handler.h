@@ -21,6 +21,8 @@
 #endif
 
 #include <boost/tuple/tuple.hpp>
+#include <tbb/atomic.h>
+#include <tbb/mutex.h>
 
 #include "Thrift.h"
 #include "base/parse_object.h"
@@ -88,6 +90,8 @@ public:
 
     typedef std::map<std::string, Var > AttribMap;
     typedef std::multimap<std::string, std::pair<Var, AttribMap> > TagMap;
+    // Underlay flow samples, each with the time it was received at
+    typedef std::vector<std::pair<uint64_t, UFlowSample> > UFlowSampleList;
 
     DbHandler(EventManager *evm, GenDb::GenDbIf::DbErrorHandler err_handler,
         const std::vector<std::string> &cassandra_ips,
@@ -128,19 +132,38 @@ public:
             const TagMap & attribs_tag,
             const AttribMap & attribs_all);
 
-    void StatTableInsertTtl(uint64_t ts, 
+    bool StatTableInsertTtl(uint64_t ts, 
             const std::string& statName,
             const std::string& statAttr,
             const TagMap & attribs_tag,
             const AttribMap & attribs_all, int ttl);
 
+    // Maintain rolled up stats samples over the STAT_ROLLUP_PERIODS along
+    // with the raw samples written by StatTableInsert
+    void EnableStatRollup(bool enable) { stat_rollup_ = enable; }
+    // Write the rolled up stats samples of the periods that ended before now
+    void StatRollupFlush(uint64_t now);
+    // Write all rolled up stats samples, including the periods in progress,
+    // through db_handler, or this DbHandler if it is NULL
+    void StatRollupFlushAll(DbHandler *db_handler = NULL);
+    uint64_t stat_rollup_write_fails() const {
+        return stat_rollup_write_fails_;
+    }
+    // Record in the system object table when the rollups start, called
+    // once the database is initialized
+    bool StatRollupWriteStartTime();
+
     bool FlowTableInsert(const pugi::xml_node& parent,
         const SandeshHeader &header);
     bool UnderlayFlowSampleInsert(const UFlowData& flow_data,
         uint64_t timestamp);
+    // Insert the flow samples received from the generator name
+    bool UnderlayFlowSampleInsert(const std::string& name,
+        const UFlowSampleList& samples);
     bool GetStats(uint64_t *queue_count, uint64_t *enqueues) const;
     bool GetStats(std::vector<GenDb::DbTableInfo> *vdbti,
         GenDb::DbErrors *dbe, std::vector<GenDb::DbTableInfo> *vstats_dbti);
+    bool GetStats(GenDb::DbWriteBatchInfo *dbwbi);
     void GetSandeshStats(std::string *drop_level,
         std::vector<SandeshStats> *vdropmstats) const;
 
@@ -152,6 +175,24 @@ public:
     std::string GetName() const;
 
 private:
+    // Rolled up stats samples of one stats table and group over a period
+    struct StatRollup {
+        StatRollup() : ts(0), end_ts(0), count(0) {}
+        uint64_t ts;
+        uint64_t end_ts;
+        std::string statName;
+        std::string statAttr;
+        std::string rollupAttr;
+        TagMap attribs_tag;
+        AttribMap attribs;
+        uint64_t count;
+    };
+    typedef std::map<std::string, StatRollup> StatRollupMap;
+    // Wait for samples arriving late before writing a rolled up sample
+    static const uint64_t kStatRollupFlushDelayUsec = 10 * 1000000ULL;
+    // Write all pending rolled up stats samples once there are this many
+    static const size_t kStatRollupMaxEntries = 64 * 1024;
+
     bool CreateTables();
     void SetDropLevel(size_t queue_count, SandeshLevel::type level,
         boost::function<void (void)> cb);
@@ -166,6 +207,12 @@ private:
     int GetTtl(TtlType type) {
         return GetTtlFromMap(ttl_map_, type);
     }
+    void UFlowSampleInsert(const Var& name, const UFlowSample& sample,
+        uint64_t timestamp);
+    bool StatRollupUpdate(uint64_t ts,
+        const std::string& statName, const std::string& statAttr,
+        const TagMap & attribs_tag, const AttribMap & attribs);
+    void StatRollupWrite(std::vector<StatRollup> *rollups);
 
     boost::scoped_ptr<GenDb::GenDbIf> dbif_;
 
@@ -173,11 +220,18 @@ private:
     ThreadSafeUuidGenerator umn_gen_;
     std::string name_;
     std::string col_name_;
-    SandeshLevel::type drop_level_;
+    // Set from the DB queue task, read from the generator session tasks
+    tbb::atomic<SandeshLevel::type> drop_level_;
     VizMsgStatistics dropped_msg_stats_;
     GenDb::DbTableStatistics stable_stats_;
     mutable tbb::mutex smutex_;
     TtlMap ttl_map_;
+    tbb::atomic<bool> stat_rollup_;
+    // Set from the generator session tasks and the collector info timer
+    tbb::mutex rollup_mutex_;
+    StatRollupMap stat_rollups_;
+    uint64_t stat_rollup_flush_ts_;
+    tbb::atomic<uint64_t> stat_rollup_write_fails_;
 
     DISALLOW_COPY_AND_ASSIGN(DbHandler);
 };
@@ -97,6 +97,8 @@ SandeshGenerator::SandeshGenerator(Collector * const collector, VizSession *sess
         name_(source + ":" + node_type_ + ":" + module + ":" + instance_id_),
         instance_(session->GetSessionInstance()),
         db_connect_timer_(NULL),
+        db_defer_(false),
+        redis_defer_(false),
         db_handler_(new DbHandler(
             collector->event_manager(), boost::bind(
                 &SandeshGenerator::StartDbifReinit, this),
@@ -108,6 +110,7 @@ SandeshGenerator::SandeshGenerator(Collector * const collector, VizSession *sess
     gen_attr_.set_connect_time(UTCTimestampUsec());
     // Update state machine
     state_machine_->SetGeneratorKey(name_);
+    db_handler_->EnableStatRollup(collector->stat_rollup());
     Create_Db_Connect_Timer();
 }
 
@@ -186,6 +189,22 @@ bool SandeshGenerator::Db_Connection_Init() {
     return true;
 }
 
+// The rolled up stats samples of a generator that stopped sending are
+// written from the collector info timer. A disconnected generator has none
+// pending, they are all written when its session goes away
+void SandeshGenerator::StatRollupFlush(uint64_t now) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    if (disconnected_) {
+        return;
+    }
+    GetDbHandler()->StatRollupFlush(now);
+}
+
+void SandeshGenerator::StatRollupFlushAll(DbHandler *db_handler) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    GetDbHandler()->StatRollupFlushAll(db_handler);
+}
+
 void SandeshGenerator::TimerErrorHandler(string name, string error) {
     GENERATOR_LOG(ERROR, name + " error: " + error);
 }
@@ -221,11 +240,18 @@ void SandeshGenerator::DisconnectSession(VizSession *vsession) {
         viz_session_ = NULL;
         state_machine_ = NULL;
         vsession->set_generator(NULL);
+        // The DB queue water marks are set up again on connect
+        db_defer_ = false;
         collector_->GetOSP()->DeleteUVEs(source_, module_, 
                                          node_type_, instance_id_);
         ModuleServerState ginfo;
         GetGeneratorInfo(ginfo);
         SandeshModuleServerTrace::Send(ginfo);
+        // The generator may not come back to this collector, so write its
+        // rolled up stats samples of the periods in progress now. They go
+        // through the collector's DbHandler, since the writes queued to
+        // this generator's DB connection are dropped on uninit
+        GetDbHandler()->StatRollupFlushAll(collector_->GetDbHandler());
         Db_Connection_Uninit();
     } else {
         GENERATOR_LOG(ERROR, "Disconnect for session:" << vsession->ToString() <<
@@ -282,6 +308,11 @@ void SandeshGenerator::SendDbStatistics() {
     gdbstats.set_table_info(vdbti);
     gdbstats.set_errors(vdbe);
     gdbstats.set_statistics_table_info(vstats_dbti);
+    GenDb::DbWriteBatchInfo dbwbi;
+    db_handler_->GetStats(&dbwbi);
+    std::vector<GenDb::DbWriteBatchInfo> vdbwbi;
+    vdbwbi.push_back(dbwbi);
+    gdbstats.set_write_batch_info(vdbwbi);
     GeneratorDbStatsUve::Send(gdbstats);
 }
 
@@ -308,6 +339,9 @@ void SandeshGenerator::ConnectSession(VizSession *session,
     tbb::mutex::scoped_lock lock(mutex_);
     set_session(session);
     set_state_machine(state_machine);
+    if (redis_defer_) {
+        state_machine_->SetDeferDequeue(true);
+    }
     disconnected_ = false;
     uint32_t tmp = gen_attr_.get_connects();
     gen_attr_.set_connects(tmp+1);
@@ -321,15 +355,31 @@ void SandeshGenerator::SetDbQueueWaterMarkInfo(
     bool defer_undefer(boost::get<3>(wm));
     boost::function<void (void)> cb;
     if (high && defer_undefer) {
-        cb = boost::bind(&SandeshStateMachine::SetDeferDequeue,
-                state_machine_, true);
+        cb = boost::bind(&SandeshGenerator::SetDbDeferDequeue, this, true);
     } else if (!high && defer_undefer) {
-        cb = boost::bind(&SandeshStateMachine::SetDeferDequeue,
-                state_machine_, false);
+        cb = boost::bind(&SandeshGenerator::SetDbDeferDequeue, this, false);
     }
     GetDbHandler()->SetDbQueueWaterMarkInfo(wm, cb);
 }
 
+void SandeshGenerator::SetDbDeferDequeue(bool defer) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    db_defer_ = defer;
+    UpdateDeferDequeueLocked();
+}
+
+void SandeshGenerator::SetRedisDeferDequeue(bool defer) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    redis_defer_ = defer;
+    UpdateDeferDequeueLocked();
+}
+
+void SandeshGenerator::UpdateDeferDequeueLocked() {
+    if (state_machine_) {
+        state_machine_->SetDeferDequeue(db_defer_ || redis_defer_);
+    }
+}
+
 void SandeshGenerator::ResetDbQueueWaterMarkInfo() {
     GetDbHandler()->ResetDbQueueWaterMarkInfo();
 }
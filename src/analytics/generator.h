@@ -83,14 +83,21 @@ public:
     void GetGeneratorInfo(ModuleServerState &genlist) const;
     void SetDbQueueWaterMarkInfo(Sandesh::QueueWaterMarkInfo &wm);
     void ResetDbQueueWaterMarkInfo();
+    // Messages are not dequeued from the state machine while either the
+    // DB queue or the redis UVE write queue is above its high water mark
+    void SetDbDeferDequeue(bool defer);
+    void SetRedisDeferDequeue(bool defer);
     void SetSmQueueWaterMarkInfo(Sandesh::QueueWaterMarkInfo &wm);
     void ResetSmQueueWaterMarkInfo();
     void StartDbifReinit();
+    void StatRollupFlush(uint64_t now);
+    void StatRollupFlushAll(DbHandler *db_handler);
     virtual DbHandler *GetDbHandler() { return db_handler_.get (); }
 
 private:
     virtual bool ProcessRules(const VizMsg *vmsg, bool rsc);
     void set_session(VizSession *session);
+    void UpdateDeferDequeueLocked();
 
     void set_state_machine(SandeshStateMachine *state_machine) {
         state_machine_ = state_machine;
@@ -126,6 +133,8 @@ private:
 
     Timer *db_connect_timer_;
     tbb::atomic<bool> disconnected_;
+    bool db_defer_;
+    bool redis_defer_;
     boost::scoped_ptr<DbHandler> db_handler_;
     mutable tbb::mutex mutex_;
 };
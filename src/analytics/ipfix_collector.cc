@@ -48,6 +48,7 @@ IpfixCollector::IpfixCollector(EventManager* evm,
       num_packets_(0),
       udp_sources_(NULL),
       colinfo_(new ipfix_col_info())  {
+    set_receive_batch(kReceiveBatch);
 }
 
 IpfixCollector::~IpfixCollector() {
@@ -94,6 +95,16 @@ void IpfixCollector::ProcessIpfixPacket(boost::asio::const_buffer& buffer,
     input.u.ipcon.addrlen = generator_ip.size();
     (void) ipfix_parse_msg( &input, &udp_sources_,
         boost::asio::buffer_cast<const unsigned char*>(buffer), length);
+    FlushFlowSamples();
+    DeallocateBuffer(buffer);
+}
+
+void IpfixCollector::FlushFlowSamples() {
+    if (flow_samples_.empty()) {
+        return;
+    }
+    db_handler_->UnderlayFlowSampleInsert(flow_samples_name_, flow_samples_);
+    flow_samples_.clear();
 }
 
 int IpfixCollector::NewSource(ipfixs_node *s, void *arg)
@@ -136,12 +147,17 @@ int IpfixCollector::ExportDrecord(
         " nfields: " << t->ipfixt->nfields <<
         ((t->ipfixt->nscopefields)?"(option record)":""));
 #endif
-    UFlowData flow_data;
-    flow_data.set_name(ipfix_col_input_get_ident(s->input));
+    const char *name = ipfix_col_input_get_ident(s->input);
+    if (flow_samples_name_ != name) {
+        FlushFlowSamples();
+        flow_samples_name_ = name;
+    }
     // TODO: Get the timestamp from the packet
     uint64_t tm = UTCTimestampUsec();
-    std::vector<UFlowSample> samples;
-    UFlowSample sample;
+    // Fill the sample in place at the end of the batch
+    flow_samples_.resize(flow_samples_.size() + 1);
+    flow_samples_.back().first = tm;
+    UFlowSample& sample = flow_samples_.back().second;
     sample.set_flowtype(g_uflow_constants.FlowTypeName.find(
                             FlowType::IPFIX)->second);
     for (int i=0; i<t->ipfixt->nfields; i++ ) {
@@ -171,9 +187,6 @@ int IpfixCollector::ExportDrecord(
             // TODO : Put other fields in  "otherinfo"
         }
     }
-    samples.push_back(sample);
-    flow_data.set_flow(samples);
-    db_handler_->UnderlayFlowSampleInsert(flow_data, tm);
     return 0;
 }
 
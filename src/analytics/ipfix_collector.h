@@ -35,7 +35,9 @@ public:
             void *arg);
     int ExportTrecord(ipfixs_node *s, ipfixt_node *t, void *arg);
 private:
-   
+    // Datagrams read per receive completion
+    static const size_t kReceiveBatch = 32;
+
     DbHandler* const db_handler_;
     std::string ip_address_;
     int port_;
@@ -43,6 +45,10 @@ private:
     ipfixs_node  *udp_sources_;
     std::map<std::string,std::string> uflowfields_;
     boost::scoped_ptr<ipfix_col_info> colinfo_;
+    // Data records of the datagram being parsed, written to the database
+    // once the datagram is parsed
+    std::string flow_samples_name_;
+    DbHandler::UFlowSampleList flow_samples_;
 
     void HandleReceive(boost::asio::const_buffer& buffer,
                        boost::asio::ip::udp::endpoint remote_endpoint,
@@ -53,6 +59,7 @@ private:
                                     boost::asio::ip::udp::endpoint generator_ip);
 
     int RegisterCb(void);
+    void FlushFlowSamples();
 
     DISALLOW_COPY_AND_ASSIGN(IpfixCollector);
 };
@@ -141,6 +141,8 @@ bool CollectorInfoLogger(VizSandeshContext &ctx) {
 
     analytics->TestDatabaseConnection();
 
+    analytics->StatRollupFlush();
+
     collector_info_log_timer->Cancel();
     collector_info_log_timer->Start(60*1000, boost::bind(&CollectorInfoLogTimer),
                                NULL);
@@ -334,6 +336,7 @@ int main(int argc, char *argv[])
             options.partitions(),
             options.dup(),
             ttl_map);
+    analytics.EnableStatRollup(options.stats_rollup());
 
 #if 0
     // initialize python/c++ API
@@ -143,6 +143,8 @@ void Options::Initialize(EventManager &evm,
              "sFlow listener UDP port (< 0 will disable sFlow Collector)")
         ("DEFAULT.ipfix_port", opt::value<int>()->default_value(4739),
              "ipfix listener UDP port (< 0 will disable ipfix Collector)")
+        ("DEFAULT.stats_rollup", opt::bool_switch(&stats_rollup_),
+             "Maintain rolled up stats samples for faster stats queries")
         ("DEFAULT.test_mode", opt::bool_switch(&test_mode_),
              "Enable collector to run in test-mode")
 
@@ -55,6 +55,7 @@ public:
     const int syslog_port() const { return syslog_port_; }
     const int sflow_port() const { return sflow_port_; }
     const int ipfix_port() const { return ipfix_port_; }
+    const bool stats_rollup() const { return stats_rollup_; }
     const bool test_mode() const { return test_mode_; }
 
 private:
@@ -108,6 +109,7 @@ private:
     int syslog_port_;
     int sflow_port_;
     int ipfix_port_;
+    bool stats_rollup_;
     bool test_mode_;
     bool dup_;
     int analytics_data_ttl_;
@@ -42,6 +42,18 @@ void ProtobufCollector::DbInitializeCb() {
     server_->Initialize();
 }
 
+void ProtobufCollector::EnableStatRollup(bool enable) {
+    db_initializer_->GetDbHandler()->EnableStatRollup(enable);
+}
+
+void ProtobufCollector::StatRollupFlushAll(DbHandler *db_handler) {
+    db_initializer_->GetDbHandler()->StatRollupFlushAll(db_handler);
+}
+
+void ProtobufCollector::StatRollupFlush(uint64_t now) {
+    db_initializer_->GetDbHandler()->StatRollupFlush(now);
+}
+
 void ProtobufCollector::SendStatistics(const std::string &name) {
     ProtobufCollectorStats stats;
     stats.set_name(name);
@@ -62,6 +74,11 @@ void ProtobufCollector::SendStatistics(const std::string &name) {
     stats.set_db_table_info(v_dbti);
     stats.set_db_statistics_table_info(v_stats_dbti);
     stats.set_db_errors(v_dbe);
+    GenDb::DbWriteBatchInfo dbwbi;
+    db_handler->GetStats(&dbwbi);
+    std::vector<GenDb::DbWriteBatchInfo> v_dbwbi;
+    v_dbwbi.push_back(dbwbi);
+    stats.set_db_write_batch_info(v_dbwbi);
     uint64_t db_queue_count, db_enqueues;
     db_handler->GetStats(&db_queue_count, &db_enqueues);
     stats.set_db_queue_count(db_queue_count);
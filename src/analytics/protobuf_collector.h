@@ -11,6 +11,7 @@
 
 #include "analytics/protobuf_server.h"
 
+class DbHandler;
 class DbHandlerInitializer;
 
 class ProtobufCollector {
@@ -22,6 +23,9 @@ class ProtobufCollector {
     bool Initialize();
     void Shutdown();
     void SendStatistics(const std::string &name);
+    void EnableStatRollup(bool enable);
+    void StatRollupFlush(uint64_t now);
+    void StatRollupFlushAll(DbHandler *db_handler);
 
  private:
     void DbInitializeCb();
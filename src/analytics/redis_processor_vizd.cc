@@ -15,6 +15,7 @@
 #include "delrequest_lua.cpp"
 #include "uveupdate_lua.cpp"
 #include "uveupdate_st_lua.cpp"
+#include "uveupdate_batch_lua.cpp"
 #include "uvedelete_lua.cpp"
 #include "flushuves_lua.cpp"
 
@@ -98,6 +99,52 @@ RedisProcessorExec::UVEUpdate(RedisAsyncConnection * rac, RedisProcessorIf *rpi,
     return ret;
 }
 
+bool
+RedisProcessorExec::UVEUpdateBatch(RedisAsyncConnection * rac,
+        RedisProcessorIf *rpi,
+        const std::vector<const RedisUVEUpdateArgs *> &updates) {
+
+    if (updates.empty()) {
+        return true;
+    }
+    // EVAL, script, numkeys, 5 keys and 11 args per update and the db
+    vector<string> args;
+    args.reserve(4 + updates.size() * 16);
+    args.push_back("EVAL");
+    args.push_back(string(reinterpret_cast<char *>(uveupdate_batch_lua),
+                          uveupdate_batch_lua_len));
+    args.push_back(integerToString(updates.size() * 5));
+    for (vector<const RedisUVEUpdateArgs *>::const_iterator it =
+            updates.begin(); it != updates.end(); ++it) {
+        const RedisUVEUpdateArgs &u(**it);
+        const string gen(u.source + ":" + u.node_type + ":" + u.module +
+                         ":" + u.instance_id);
+        const string table(u.key.substr(0, u.key.find(":")));
+        args.push_back(string("TYPES:") + gen);
+        args.push_back((u.is_alarm ? "ALARM_ORIGINS:" : "ORIGINS:") + u.key);
+        args.push_back((u.is_alarm ? "ALARM_TABLE:" : "TABLE:") + table);
+        args.push_back(string("UVES:") + gen + ":" + u.type);
+        args.push_back(string("VALUES:") + u.key + ":" + gen + ":" + u.type);
+    }
+    args.push_back(integerToString(REDIS_DB_UVE));
+    for (vector<const RedisUVEUpdateArgs *>::const_iterator it =
+            updates.begin(); it != updates.end(); ++it) {
+        const RedisUVEUpdateArgs &u(**it);
+        args.push_back(u.source);
+        args.push_back(u.node_type);
+        args.push_back(u.module);
+        args.push_back(u.instance_id);
+        args.push_back(u.type);
+        args.push_back(u.attr);
+        args.push_back(u.key);
+        args.push_back(integerToString(u.seq));
+        args.push_back(u.msg);
+        args.push_back(integerToString(u.part));
+        args.push_back(integerToString(u.is_alarm));
+    }
+    return rac->RedisAsyncArgCmd(rpi, args);
+}
+
 bool
 RedisProcessorExec::UVEDelete(RedisAsyncConnection * rac, RedisProcessorIf *rpi,
         const std::string &type,
@@ -15,6 +15,22 @@
 class RedisAsyncConnection; 
 class RedisProcessorIf;
 
+// Arguments of a single non-stats UVE attribute update, as carried in a
+// batch sent by RedisProcessorExec::UVEUpdateBatch
+struct RedisUVEUpdateArgs {
+    std::string type;
+    std::string attr;
+    std::string source;
+    std::string node_type;
+    std::string module;
+    std::string instance_id;
+    std::string key;
+    std::string msg;
+    int32_t seq;
+    unsigned int part;
+    bool is_alarm;
+};
+
 class RedisProcessorExec {
 public:
     static bool
@@ -27,6 +43,12 @@ public:
                        const std::string &atyp, int64_t ts, unsigned int part,
                        bool is_alarm);
 
+    // Applies a batch of non-stats UVE updates with a single script call,
+    // in the order given. The reply is the number of updates applied
+    static bool
+    UVEUpdateBatch(RedisAsyncConnection * rac, RedisProcessorIf *rpi,
+            const std::vector<const RedisUVEUpdateArgs *> &updates);
+
     static bool
     UVEDelete(RedisAsyncConnection * rac, RedisProcessorIf *rpi,
             const std::string &type,
@@ -107,14 +107,15 @@ static DbHandler::Var ParseNode(const pugi::xml_node& node, bool silent = false)
         LOG(ERROR, __func__ << "Parsing Empty node");
         return sample;
     }
-    string attype = node.attribute("type").value();
-    if (attype == "string") {
+    const char *attype = node.attribute("type").value();
+    if (strcmp(attype, "string") == 0) {
         std::string val(node.child_value());
         TXMLProtocol::unescapeXMLControlChars(val);
         sample = val;
-    } else if (attype == "double") {   
+    } else if (strcmp(attype, "double") == 0) {
         sample = (double) strtod(node.child_value(), NULL);
-    } else if ((attype == "u16") ||  (attype == "u32") || (attype == "u64")) {
+    } else if (attype[0] == 'u' && (strcmp(attype, "u16") == 0 ||
+               strcmp(attype, "u32") == 0 || strcmp(attype, "u64") == 0)) {
         sample = (uint64_t) strtoul(node.child_value(), NULL, 10);
     } else {
         if (!silent)
@@ -124,27 +125,24 @@ static DbHandler::Var ParseNode(const pugi::xml_node& node, bool silent = false)
     return sample;
 }
 
-static bool ParseDomTags(const std::string& tstr,
-        std::vector<std::string> *toptags,
-        const std::vector<std::pair<std::string,pugi::xml_node> >* elem_chain,
-        StatWalker::TagMap *tagmap) {
+void DomTagSpec::Compile(const std::string& tstr) {
     size_t pos;
     size_t npos = 0;
 
     // If the tags string is empty, there's nothing to parse
-    if (tstr.empty()) return true;
+    if (tstr.empty()) return;
 
     do {
         if (npos)
             pos = npos+1;
         else
             pos = 0;
-        
+
         npos = tstr.find(',' , pos);
         string term;
         if (npos == string::npos)
             term = tstr.substr(pos, string::npos);
-        else 
+        else
             term = tstr.substr(pos, npos - pos);
 
         // Separating this term into a prefix and suffix
@@ -156,73 +154,104 @@ static bool ParseDomTags(const std::string& tstr,
             // Single Tag case
             sterm = term;
         } else {
-            // Double Tag case 
+            // Double Tag case
             pterm = term.substr(0,spos);
             sterm = term.substr(spos+1,string::npos);
         }
 
-        if (sterm.empty()) return false;
+        if (sterm.empty()) {
+            top_valid = valid = false;
+            return;
+        }
 
-        if (toptags) {
-            assert(elem_chain==NULL);
-            assert(tagmap==NULL);
-            if (sterm[0] != '.') {
-                // These are top-level tags
+        if (sterm[0] != '.') {
+            // These are top-level tags
 
-                // We do not allow prefixes with top-level tags            
-                if (!pterm.empty()) return false;
+            // We do not allow prefixes with top-level tags
+            if (!pterm.empty()) top_valid = false;
 
-                toptags->push_back(sterm);
-            }
-            
+            toptags.push_back(sterm);
             continue;
-        } else {
-            assert(elem_chain);
-            assert(elem_chain->size()>1);
-            assert(tagmap);
-            if (sterm[0] != '.') {
-                // We are not processing at the top level
-                // Ignore top-level tags 
-                continue;
-            }
         }
 
-        string sname, pname;
-
+        Term t;
         // strip out the leading "."
-        sname = sterm.substr(1, string::npos);
+        t.sname = sterm.substr(1, string::npos);
+        if (!pterm.empty()) {
+            t.pterm = pterm;
+            size_t found = pterm.rfind('.');
+            t.pattr = pterm.substr(found+1, string::npos);
+        }
+        terms.push_back(t);
+
+    } while (npos != string::npos);
+}
+
+const DomTagSpec *DomTagCache::Lookup(const std::string &tstr,
+                                      DomTagSpec *local) {
+    {
+        tbb::spin_rw_mutex::scoped_lock read_lock(rw_mutex_, false);
+        SpecMap::const_iterator it = specs_.find(tstr);
+        if (it != specs_.end()) {
+            return &it->second;
+        }
+    }
+    tbb::spin_rw_mutex::scoped_lock write_lock(rw_mutex_, true);
+    SpecMap::iterator it = specs_.find(tstr);
+    if (it != specs_.end()) {
+        return &it->second;
+    }
+    if (specs_.size() >= kMaxEntries) {
+        local->Compile(tstr);
+        return local;
+    }
+    it = specs_.insert(make_pair(tstr, DomTagSpec())).first;
+    it->second.Compile(tstr);
+    return &it->second;
+}
 
-        size_t sz = elem_chain->size();
-        pugi::xml_node anode_s = elem_chain->at(sz-1).second.child(sname.c_str());
+size_t DomTagCache::size() const {
+    tbb::spin_rw_mutex::scoped_lock read_lock(rw_mutex_, false);
+    return specs_.size();
+}
+
+// Fill the tags of the struct at the end of the element chain
+static void FillDomTags(const DomTagSpec &spec,
+        const std::vector<std::pair<std::string,pugi::xml_node> >& elem_chain,
+        StatWalker::TagMap *tagmap) {
+    assert(elem_chain.size()>1);
+    size_t sz = elem_chain.size();
+    for (std::vector<DomTagSpec::Term>::const_iterator it = spec.terms.begin();
+         it != spec.terms.end(); ++it) {
+        pugi::xml_node anode_s =
+            elem_chain.at(sz-1).second.child(it->sname.c_str());
         StatWalker::TagVal tv;
         tv.val = ParseNode(anode_s);
 
+        const string &pterm(it->pterm);
         if (!pterm.empty()) {
+            string pname;
             // The prefix is a child of the deepest node,
             // or a child at the current level (2nd deepest node)
             size_t idx = ((pterm[0] == '.') ? sz-1 : sz-2);
             for (size_t ix=1; ix<=idx; ix++) {
                 if (!pname.empty()) pname.append(".");
-                pname.append(elem_chain->at(ix).first);
+                pname.append(elem_chain.at(ix).first);
             }
             if (pterm[0] != '.') {
                 if (!pname.empty()) pname.append(".");
             }
             pname.append(pterm);
-            size_t found = pterm.rfind('.');
-            string pattr = pterm.substr(found+1, string::npos);
-            pugi::xml_node anode_p = elem_chain->at(idx).second.child(pattr.c_str());
+            pugi::xml_node anode_p =
+                elem_chain.at(idx).second.child(it->pattr.c_str());
             DbHandler::Var pv = ParseNode(anode_p);
-            LOG(ERROR, __func__ <<" PrefixProc for " << elem_chain->at(0).first <<
+            LOG(ERROR, __func__ <<" PrefixProc for " << elem_chain.at(0).first <<
                 " pname " << pname << " val " << pv);
             tv.prefix = make_pair(pname, pv);
         }
 
-        tagmap->insert(make_pair(sname, tv));
-
-    } while (npos != string::npos);
-
-    return true;
+        tagmap->insert(make_pair(it->sname, tv));
+    }
 }
 
 static bool DomValidElems(pugi::xml_node node,
@@ -254,8 +283,9 @@ static bool DomValidElems(pugi::xml_node node,
    stats attribute
 */
 static bool DomStatWalker(StatWalker& sw,
+        DomTagCache *tag_cache,
         const std::string& tstr,
-        std::vector<std::pair<std::string,pugi::xml_node> > elem_chain) {
+        const std::vector<std::pair<std::string,pugi::xml_node> >& elem_chain) {
 
     pugi::xml_node object = elem_chain.at(0).second;
     size_t sz = elem_chain.size();
@@ -264,7 +294,10 @@ static bool DomStatWalker(StatWalker& sw,
     StatWalker::TagMap tagmap;
     // Parse the tags annotation to find all tags that will
     // be used to index stats samples
-    if (ParseDomTags(tstr, NULL, &elem_chain, &tagmap)) {
+    DomTagSpec local_spec;
+    const DomTagSpec *spec(tag_cache->Lookup(tstr, &local_spec));
+    if (spec->valid) {
+        FillDomTags(*spec, elem_chain, &tagmap);
         DbHandler::AttribMap attribs;
         // For this map:
         //     the key is the attribute name
@@ -313,7 +346,7 @@ static bool DomStatWalker(StatWalker& sw,
                 elem_parent.push_back(make_pair(ei->first,elem_list[idx]));
                 // recursive invokation to process stats of child
                 // structs and lists that have the tags annotation
-                if (!DomStatWalker(sw, tstr_sub, elem_parent)) {
+                if (!DomStatWalker(sw, tag_cache, tstr_sub, elem_parent)) {
                     LOG(ERROR, __func__ << 
                       " Name: " << object.name() <<  " Node: " << node.name()  <<
                       " Bad element " << elem_list[idx].name());
@@ -338,9 +371,10 @@ static bool DomStatWalker(StatWalker& sw,
 
 static bool DomTopStatWalker(const pugi::xml_node& object,
         DbHandler *db,
+        DomTagCache *tag_cache,
         uint64_t timestamp,
         const pugi::xml_node& node,
-        StatWalker::TagMap tmap,
+        const StatWalker::TagMap& tmap,
         const std::string& source) {
 
     vector<pugi::xml_node> elem_list;
@@ -356,12 +390,13 @@ static bool DomTopStatWalker(const pugi::xml_node& object,
         return false;
     }
 
-    std::vector<std::string> toptags;
-
     string tstr(node.attribute("tags").value());
 
     // Get the top-level tags for this stat attribute
-    if (ParseDomTags(tstr, &toptags, NULL, NULL)) {
+    DomTagSpec local_spec;
+    const DomTagSpec *spec(tag_cache->Lookup(tstr, &local_spec));
+    if (spec->top_valid) {
+        const std::vector<std::string> &toptags(spec->toptags);
 
         StatWalker::TagMap m1 = tmap;
 
@@ -383,7 +418,7 @@ static bool DomTopStatWalker(const pugi::xml_node& object,
         for (size_t idx=0; idx<elem_list.size(); idx++) {
             vector<pair<string, pugi::xml_node> > elem_chain = parent_chain; 
             elem_chain.push_back(make_pair(node.name(), elem_list[idx]));
-            if (!DomStatWalker(sw, tstr, elem_chain)) {
+            if (!DomStatWalker(sw, tag_cache, tstr, elem_chain)) {
                 LOG(ERROR, __func__ << " Source: " << source <<
                   " Name: " << object.name() <<  " Node: " << node.name()  <<
                   " Bad element " << elem_list[idx].name());
@@ -401,7 +436,8 @@ static bool DomTopStatWalker(const pugi::xml_node& object,
 
 /*
  * Walk the XML DOM to find keys to record this message against.
- * Write to the objectlog accordingly
+ * Write to the objectlog accordingly.
+ * The identifier attributes are removed in the same walk.
  */
 static size_t DomObjectWalk(const pugi::xml_node& parent, const VizMsg *rmsg,
         DbHandler *db, uint64_t timestamp) {
@@ -412,17 +448,15 @@ static size_t DomObjectWalk(const pugi::xml_node& parent, const VizMsg *rmsg,
 
     for (pugi::xml_node node = parent.first_child(); node;
          node = node.next_sibling()) {
+        node.remove_attribute("identifier");
         table = node.attribute("key").value();
         if (strcmp(table, "")) {
             rowkey = std::string(node.child_value());
             TXMLProtocol::unescapeXMLControlChars(rowkey);
             it = keymap.find(table);
             if (it != keymap.end()) {
-                std::string tempstr(it->second);
-                tempstr.append(":");
-                tempstr.append(rowkey);
-                keymap.erase(it);
-                keymap.insert(std::pair<std::string, std::string>(table, tempstr));
+                it->second.append(":");
+                it->second.append(rowkey);
             } else {
                 keymap.insert(std::pair<std::string, std::string>(table, rowkey));
             }
@@ -448,6 +482,7 @@ static size_t DomObjectWalk(const pugi::xml_node& parent, const VizMsg *rmsg,
 void Ruleeng::handle_object_log(const pugi::xml_node& parent, const VizMsg *rmsg,
         DbHandler *db, const SandeshHeader &header) {
     if (!(header.get_Hints() & g_sandesh_constants.SANDESH_KEY_HINT)) {
+        remove_identifier(parent);
         return;
     }
     uint64_t timestamp(header.get_Timestamp());
@@ -489,7 +524,7 @@ void Ruleeng::handle_object_log(const pugi::xml_node& parent, const VizMsg *rmsg
            node = node.next_sibling()) {
 
         if (!node.attribute("tags").empty()) {
-           DomTopStatWalker(object, db, timestamp, node,
+           DomTopStatWalker(object, db, &tag_cache_, timestamp, node,
                    m1, source);
         }
     }
@@ -582,25 +617,23 @@ bool Ruleeng::handle_uve_publish(const pugi::xml_node& parent,
 
     for (pugi::xml_node node = object.first_child(); node;
            node = node.next_sibling()) {
-        std::ostringstream ostr; 
-        node.print(ostr, "", pugi::format_raw | pugi::format_no_escapes);
-        std::string agg;
-        std::string atyp;
         tempstr = node.attribute("key").value();
         if (strcmp(tempstr, "")) {
             continue;
         }
+        std::ostringstream ostr; 
+        std::string agg;
         tempstr = node.attribute("aggtype").value();
         if (strcmp(tempstr, "")) {
             agg = std::string(tempstr);
-            if (!strcmp(tempstr,"stats")) {
-                ostr.str("");
-                ostr.clear();
-                ostr << node.child_value();
-            }
         } else {
             agg = std::string("None");
         }
+        if (!strcmp(tempstr,"stats")) {
+            ostr << node.child_value();
+        } else {
+            node.print(ostr, "", pugi::format_raw | pugi::format_no_escapes);
+        }
 
         if (!node.attribute("tags").empty()) {
 
@@ -628,7 +661,7 @@ bool Ruleeng::handle_uve_publish(const pugi::xml_node& parent,
             // Process this UVE's Stat attributes.
             // We will always index by Source and UVE key (name) 
             // Other indexes depend on the "tags" attribute
-            if (!DomTopStatWalker(object, db, ts, node,
+            if (!DomTopStatWalker(object, db, &tag_cache_, ts, node,
                     m1, source)) {
                 continue;
             }
@@ -689,8 +722,7 @@ bool Ruleeng::rule_execute(const VizMsg *vmsgp, bool uveproc, DbHandler *db) {
         static_cast<const SandeshXMLMessage *>(vmsgp->msg);
     const pugi::xml_node &parent(sxmsg->GetMessageNode());
 
-    remove_identifier(parent);
-
+    // Also removes the identifier attributes from the message
     handle_object_log(parent, vmsgp, db, header);
 
     if (uveproc) handle_uve_publish(parent, vmsgp, db, header);
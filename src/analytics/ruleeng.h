@@ -5,14 +5,55 @@
 #ifndef __RULEENG_H__
 #define __RULEENG_H__
 
+#include <map>
+#include <tbb/spin_rw_mutex.h>
 #include "viz_message.h"
 #include "ruleparser/t_ruleparser.h"
 #include "base/task.h"
+#include "base/util.h"
 #include "gendb_if.h"
 
 class DbHandler;
 class OpServerProxy;
 
+// "tags" annotation of a stats attribute, tokenized into top level tags and
+// tags of the struct elements (with a leading ".")
+struct DomTagSpec {
+    struct Term {
+        std::string sname;  // tag name, without the leading "."
+        std::string pterm;  // prefix term, empty if there is no prefix
+        std::string pattr;  // name of the prefix attribute
+    };
+
+    DomTagSpec() : top_valid(true), valid(true) {}
+    void Compile(const std::string &tstr);
+
+    bool top_valid;
+    bool valid;
+    std::vector<std::string> toptags;
+    std::vector<Term> terms;
+};
+
+// Tags annotations are the same for every message of a sandesh type, so
+// they are tokenized once and looked up by the annotation string
+class DomTagCache {
+public:
+    static const size_t kMaxEntries = 4096;
+
+    DomTagCache() {}
+    // Returns the cached spec, or spec compiled into local if the cache is
+    // full
+    const DomTagSpec *Lookup(const std::string &tstr, DomTagSpec *local);
+    size_t size() const;
+
+private:
+    typedef std::map<std::string, DomTagSpec> SpecMap;
+    SpecMap specs_;
+    mutable tbb::spin_rw_mutex rw_mutex_;
+
+    DISALLOW_COPY_AND_ASSIGN(DomTagCache);
+};
+
 class Ruleeng {
     public:
         static int RuleBuilderID;
@@ -44,6 +85,7 @@ class Ruleeng {
         OpServerProxy *osp_;
         t_rulelist *rulelist_;
         std::vector<std::string> rulesrc_;
+        DomTagCache tag_cache_;
 
         bool handle_uve_publish(const pugi::xml_node& parent,
             const VizMsg *rmsg, DbHandler *db, const SandeshHeader &header);
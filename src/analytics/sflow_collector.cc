@@ -8,6 +8,7 @@
 
 SFlowListener::SFlowListener(EventManager* evm)
     : UdpServer(evm) {
+    set_receive_batch(kReceiveBatch);
 }
 
 SFlowListener::~SFlowListener() {
@@ -25,6 +25,9 @@ protected:
                                     size_t length,
                                     const std::string& generator_ip) = 0;
 private:
+    // Datagrams read per receive completion
+    static const size_t kReceiveBatch = 32;
+
     void HandleReceive(boost::asio::const_buffer& buffer,
                        boost::asio::ip::udp::endpoint remote_endpoint,
                        size_t bytes_transferred,
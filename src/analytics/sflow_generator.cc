@@ -4,7 +4,6 @@
 
 #include "sflow_collector.h"
 #include "sflow_generator.h"
-#include "sflow_parser.h"
 #include "uflow_constants.h"
 #include "uflow_types.h"
 #include "sflow_types.h"
@@ -28,6 +27,7 @@ SFlowGenerator::SFlowGenerator(const std::string& ip_address,
             "SFlowGenerator:"+ip_address), 0,
             boost::bind(&SFlowGenerator::ProcessSFlowPacket, this, _1)),
       trace_buf_(SandeshTraceBufferCreate("SFlowGenerator:"+ip_address, 1000)) {
+    flow_samples_.reserve(kMaxFlowSamplesPerBatch);
 }
 
 SFlowGenerator::~SFlowGenerator() {
@@ -49,45 +49,56 @@ bool SFlowGenerator::ProcessSFlowPacket(
         boost::shared_ptr<SFlowQueueEntry> qentry) {
     SFlowParser parser(boost::asio::buffer_cast<const uint8_t* const>(
                        qentry->buffer), qentry->length, trace_buf_);
-    SFlowData sflow_data;
-    if (parser.Parse(&sflow_data) < 0) {
+    sflow_data_.Clear();
+    if (parser.Parse(&sflow_data_) < 0) {
         LOG(ERROR, "Error parsing sFlow packet");
+        FlushFlowSamples();
         return false;
     }
-    std::stringstream sflow_data_str;
-    sflow_data_str << "sFlow Packet: " << sflow_data;
-    SFLOW_PACKET_TRACE(trace_buf_, sflow_data_str.str());
+    if (trace_buf_->IsTraceOn()) {
+        std::stringstream sflow_data_str;
+        sflow_data_str << "sFlow Packet: " << sflow_data_;
+        SFLOW_PACKET_TRACE(trace_buf_, sflow_data_str.str());
+    }
 
-    UFlowData flow_data;
-    flow_data.set_name(ip_address_);
-    std::string flow_type =
+    const std::string& flow_type =
         g_uflow_constants.FlowTypeName.find(FlowType::SFLOW)->second;
-    boost::ptr_vector<SFlowFlowSampleData>::const_iterator fs_it = 
-        sflow_data.flow_samples.begin();
-    std::vector<UFlowSample> samples;
-    for (; fs_it != sflow_data.flow_samples.end(); ++fs_it) {
+    std::vector<SFlowFlowSampleData>::const_iterator fs_it = 
+        sflow_data_.flow_samples.begin();
+    for (; fs_it != sflow_data_.flow_samples.end(); ++fs_it) {
         const SFlowFlowSampleData& fs_data = *fs_it;
-        UFlowSample sample;
+        if (!fs_data.is_flow_header_set ||
+            !fs_data.flow_header.is_ip_data_set) {
+            continue;
+        }
+        const SFlowFlowIpData& ip_data = fs_data.flow_header.decoded_ip_data;
+        // Fill the sample in place at the end of the batch
+        flow_samples_.resize(flow_samples_.size() + 1);
+        flow_samples_.back().first = qentry->timestamp;
+        UFlowSample& sample = flow_samples_.back().second;
         sample.set_pifindex(fs_data.flow_sample.sourceid_index);
-        boost::ptr_map<uint32_t, SFlowFlowRecord>::const_iterator fr_it = 
-            fs_data.flow_records.find(SFLOW_FLOW_HEADER);
-        if (fr_it != fs_data.flow_records.end()) {
-            SFlowFlowHeader* record = (SFlowFlowHeader*)fr_it->second;
-            if (record->is_ip_data_set) {
-                SFlowFlowIpData& ip_data = record->decoded_ip_data;
-                sample.sip = ip_data.src_ip.ToString();
-                sample.dip = ip_data.dst_ip.ToString();
-                sample.sport = ip_data.src_port;
-                sample.dport = ip_data.dst_port;
-                sample.protocol = ip_data.protocol;
-                sample.flowtype = flow_type;
-                samples.push_back(sample);
-            }
+        sample.sip = ip_data.src_ip.ToString();
+        sample.dip = ip_data.dst_ip.ToString();
+        sample.sport = ip_data.src_port;
+        sample.dport = ip_data.dst_port;
+        sample.protocol = ip_data.protocol;
+        sample.flowtype = flow_type;
+        if (flow_samples_.size() >= kMaxFlowSamplesPerBatch) {
+            FlushFlowSamples();
         }
     }
-    if (samples.size()) {
-        flow_data.set_flow(samples);
-        db_handler_->UnderlayFlowSampleInsert(flow_data, qentry->timestamp);
+    // Not done from the queue exit callback, which runs with the queue
+    // lock held and would block the receive path enqueueing packets
+    if (sflow_pkt_queue_.IsQueueEmpty()) {
+        FlushFlowSamples();
     }
     return true;
 }
+
+void SFlowGenerator::FlushFlowSamples() {
+    if (flow_samples_.empty()) {
+        return;
+    }
+    db_handler_->UnderlayFlowSampleInsert(ip_address_, flow_samples_);
+    flow_samples_.clear();
+}
@@ -8,6 +8,7 @@
 #include "base/queue_task.h"
 
 #include "db_handler.h"
+#include "sflow_parser.h"
 
 class SFlowCollector;
 
@@ -31,7 +32,12 @@ public:
     bool EnqueueSFlowPacket(boost::asio::const_buffer& buffer,
                             size_t length, uint64_t timestamp);
 private:
+    // Flow samples are written to the database when the packet queue
+    // drains, or after kMaxFlowSamplesPerBatch samples
+    static const size_t kMaxFlowSamplesPerBatch = 256;
+
     bool ProcessSFlowPacket(boost::shared_ptr<SFlowQueueEntry>);
+    void FlushFlowSamples();
 
     typedef WorkQueue<boost::shared_ptr<SFlowQueueEntry> > SFlowPktQueue;
     
@@ -40,6 +46,9 @@ private:
     DbHandler* const db_handler_;
     SFlowPktQueue sflow_pkt_queue_;
     SandeshTraceBufferPtr trace_buf_;
+    // Reused across packets, accessed from the packet queue task only
+    SFlowData sflow_data_;
+    DbHandler::UFlowSampleList flow_samples_;
     uint64_t num_packets_;
     uint64_t num_invalid_packets_;
     uint64_t time_first_pkt_seen_;
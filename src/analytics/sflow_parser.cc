@@ -55,22 +55,17 @@ int SFlowParser::Parse(SFlowData* const sflow_data) {
             return -1;
         }
         switch(sample_type) {
-        case SFLOW_FLOW_SAMPLE: {
-            SFlowFlowSampleData* fs_data(new SFlowFlowSampleData());
-            if (ReadSFlowFlowSample(*fs_data, false) < 0) {
-                delete fs_data;
-                return -1;
-            }
-            sflow_data->flow_samples.push_back(fs_data);
-            break;
-        }
+        case SFLOW_FLOW_SAMPLE:
         case SFLOW_FLOW_SAMPLE_EXPANDED: {
-            SFlowFlowSampleData* fs_data(new SFlowFlowSampleData());
-            if (ReadSFlowFlowSample(*fs_data, true) < 0) {
-                delete fs_data;
+            // Decode into the next slot of flow_samples
+            std::vector<SFlowFlowSampleData>& flow_samples =
+                sflow_data->flow_samples;
+            flow_samples.resize(flow_samples.size() + 1);
+            if (ReadSFlowFlowSample(flow_samples.back(),
+                    sample_type == SFLOW_FLOW_SAMPLE_EXPANDED) < 0) {
+                flow_samples.pop_back();
                 return -1;
             }
-            sflow_data->flow_samples.push_back(fs_data);
             break;
         }
         default:
@@ -174,17 +169,21 @@ int SFlowParser::ReadSFlowFlowSample(SFlowFlowSampleData& flow_sample_data,
         if (ReadData32(flow_record_len) < 0) {
             return -1;
         }
+        if (flow_record_type == SFLOW_FLOW_HEADER &&
+            !flow_sample_data.is_flow_header_set) {
+            if (ReadSFlowFlowHeader(flow_sample_data.flow_header) < 0) {
+                return -1;
+            }
+            flow_sample_data.is_flow_header_set = true;
+            continue;
+        }
         switch(flow_record_type) {
-        case SFLOW_FLOW_HEADER: {
-            SFlowFlowHeader* flow_header(new SFlowFlowHeader());
-            if (ReadSFlowFlowHeader(*flow_header) < 0) {
-                delete flow_header;
+        case SFLOW_FLOW_HEADER:
+            // Only the first raw packet header of the sample is decoded
+            if (SkipBytes(flow_record_len) < 0) {
                 return -1;
             }
-            flow_sample_data.flow_records.insert(flow_record_type, 
-                                                 flow_header);
             break;
-        }
         default:
             if (SkipBytes(flow_record_len) < 0) {
                 return -1;
@@ -5,20 +5,23 @@
 #ifndef __SFLOW_PARSER_H__
 #define __SFLOW_PARSER_H__
 
-#include <boost/ptr_container/ptr_map.hpp>
-#include <boost/ptr_container/ptr_vector.hpp>
+#include <vector>
 
 #include <sandesh/sandesh_trace.h>
 
 #include "base/util.h"
 #include "sflow.h"
 
+// Flow samples and flow headers are decoded in place, without per sample
+// allocations. Only the raw packet header record is decoded, other flow
+// records are skipped.
 struct SFlowFlowSampleData {
     SFlowFlowSample flow_sample;
-    boost::ptr_map<uint32_t, SFlowFlowRecord> flow_records;
+    bool is_flow_header_set;
+    SFlowFlowHeader flow_header;
 
     explicit SFlowFlowSampleData() : 
-        flow_sample(), flow_records() {
+        flow_sample(), is_flow_header_set(), flow_header() {
     }
     ~SFlowFlowSampleData() {
     }
@@ -29,23 +32,26 @@ struct SFlowFlowSampleData {
 std::ostream& operator<<(std::ostream& out, 
             const SFlowFlowSampleData& fs_data) {
     out << fs_data.flow_sample;
-    boost::ptr_map<uint32_t, SFlowFlowRecord>::const_iterator it =
-        fs_data.flow_records.begin();
-    for (; it != fs_data.flow_records.end(); ++it) {
-        SFlowFlowHeader* sflow_header = (SFlowFlowHeader*)it->second;
-        out << *sflow_header;
+    if (fs_data.is_flow_header_set) {
+        out << fs_data.flow_header;
     }
     return out;
 }
 
+// The flow samples are kept across Clear() so that an SFlowData reused for
+// successive datagrams does not reallocate them.
 struct SFlowData {
     SFlowHeader sflow_header;
-    boost::ptr_vector<SFlowFlowSampleData> flow_samples;
+    std::vector<SFlowFlowSampleData> flow_samples;
 
     explicit SFlowData() : sflow_header(), flow_samples() {
     }
     ~SFlowData() {
     }
+    void Clear() {
+        sflow_header = SFlowHeader();
+        flow_samples.clear();
+    }
     friend inline std::ostream& operator<<(std::ostream& out, 
                                            const SFlowData& sflow_data);
 };
@@ -53,7 +59,7 @@ struct SFlowData {
 std::ostream& operator<<(std::ostream& out, const SFlowData& sflow_data) {
     out << std::endl;
     out << sflow_data.sflow_header;
-    boost::ptr_vector<SFlowFlowSampleData>::const_iterator it = 
+    std::vector<SFlowFlowSampleData>::const_iterator it = 
         sflow_data.flow_samples.begin();
     out << "Num of Flow Samples: " << sflow_data.flow_samples.size() 
         << std::endl;
@@ -7,8 +7,10 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/assign/ptr_list_of.hpp>
 #include <boost/uuid/uuid.hpp>
+#include <rapidjson/document.h>
 #include "testing/gunit.h"
 #include "base/logging.h"
+#include "base/string_util.h"
 #include "sandesh/sandesh_types.h"
 #include "sandesh/sandesh.h"
 #include "sandesh/sandesh_message_builder.h"
@@ -19,6 +21,7 @@
 #include "../vizd_table_desc.h"
 
 using ::testing::Return;
+using ::testing::Invoke;
 using ::testing::Field;
 using ::testing::AnyOf;
 using ::testing::AnyNumber;
@@ -680,6 +683,163 @@ TEST_F(DbHandlerTest, FlowTableInsertTest) {
     delete msg;
 }
 
+class DbHandlerStatRollupTest : public DbHandlerTest {
+protected:
+    // Records the JSON of the stats samples by stats attribute and name
+    bool StatTableAddColumn(GenDb::ColList *cl) {
+        std::string attr(boost::get<std::string>(cl->rowkey_.at(3)));
+        const GenDb::NewCol& col(cl->columns_.at(0));
+        std::string name(boost::get<std::string>(col.name->at(0)));
+        samples_[attr].insert(std::make_pair(name,
+            boost::get<std::string>(col.value->at(0))));
+        return true;
+    }
+
+    void StatTableInsert(uint64_t ts, const std::string& name,
+                         uint64_t rss, double cpu) {
+        DbHandler::TagMap tags;
+        tags.insert(std::make_pair("name",
+            std::make_pair(DbHandler::Var(name), DbHandler::AttribMap())));
+        DbHandler::AttribMap attribs;
+        attribs.insert(std::make_pair("name", DbHandler::Var(name)));
+        attribs.insert(std::make_pair("cpu_stats.rss", DbHandler::Var(rss)));
+        attribs.insert(std::make_pair("cpu_stats.cpu_one_min_avg",
+            DbHandler::Var(cpu)));
+        // Not a tag, so it neither splits nor is kept in the rollups
+        attribs.insert(std::make_pair("cpu_stats.state",
+            DbHandler::Var(std::string(rss > 10 ? "high" : "low"))));
+        db_handler()->StatTableInsert(ts, "VirtualMachineStats", "cpu_stats",
+            tags, attribs);
+    }
+
+    std::string Sample(const std::string& attr, const std::string& name) {
+        std::multimap<std::string, std::string>& samples(samples_[attr]);
+        EXPECT_EQ(1U, samples.count(name));
+        std::multimap<std::string, std::string>::const_iterator it =
+            samples.find(name);
+        return it == samples.end() ? std::string() : it->second;
+    }
+
+    std::map<std::string, std::multimap<std::string, std::string> > samples_;
+};
+
+TEST_F(DbHandlerStatRollupTest, RollupTest) {
+    EXPECT_CALL(*dbif_mock(), Db_AddColumnProxy(_))
+        .WillRepeatedly(Invoke(this,
+            &DbHandlerStatRollupTest::StatTableAddColumn));
+
+    // Samples within one minute are not rolled up until it ends
+    uint64_t hour = 1449997200ULL * 1000000;
+    db_handler()->EnableStatRollup(true);
+    StatTableInsert(hour + 5000000, "vm1", 10, 0.5);
+    StatTableInsert(hour + 20000000, "vm1", 30, 1.5);
+    StatTableInsert(hour + 30000000, "vm2", 5, 0.25);
+    EXPECT_EQ(2U, samples_["cpu_stats"].count("vm1"));
+    EXPECT_EQ(1U, samples_["cpu_stats"].count("vm2"));
+    EXPECT_TRUE(samples_["cpu_stats@60"].empty());
+    EXPECT_TRUE(samples_["cpu_stats@3600"].empty());
+
+    db_handler()->StatRollupFlush(hour + 3610ULL * 1000000);
+    const char *rollups[] = { "cpu_stats@60", "cpu_stats@3600" };
+    for (size_t idx = 0; idx < 2; idx++) {
+        rapidjson::Document vm1, vm2;
+        vm1.Parse<0>(Sample(rollups[idx], "vm1").c_str());
+        ASSERT_TRUE(vm1.IsObject());
+        EXPECT_EQ(40U, vm1["cpu_stats.rss|n"].GetUint64());
+        EXPECT_EQ(10U, vm1["cpu_stats.rss@min|n"].GetUint64());
+        EXPECT_EQ(30U, vm1["cpu_stats.rss@max|n"].GetUint64());
+        EXPECT_EQ(2.0, vm1["cpu_stats.cpu_one_min_avg|d"].GetDouble());
+        EXPECT_EQ(0.5, vm1["cpu_stats.cpu_one_min_avg@min|d"].GetDouble());
+        EXPECT_EQ(1.5, vm1["cpu_stats.cpu_one_min_avg@max|d"].GetDouble());
+        EXPECT_EQ(2U, vm1["cpu_stats@count|n"].GetUint64());
+        EXPECT_STREQ("vm1", vm1["name|s"].GetString());
+        EXPECT_FALSE(vm1.HasMember("cpu_stats.state|s"));
+        vm2.Parse<0>(Sample(rollups[idx], "vm2").c_str());
+        ASSERT_TRUE(vm2.IsObject());
+        EXPECT_EQ(5U, vm2["cpu_stats.rss|n"].GetUint64());
+        EXPECT_EQ(1U, vm2["cpu_stats@count|n"].GetUint64());
+    }
+
+    // Nothing is left to roll up
+    samples_.clear();
+    db_handler()->StatRollupFlush(hour + 7210ULL * 1000000);
+    EXPECT_TRUE(samples_.empty());
+}
+
+// The rolled up samples of the periods in progress are written by
+// StatRollupFlushAll, as on generator disconnect, through the DbHandler
+// given
+TEST_F(DbHandlerStatRollupTest, RollupFlushAll) {
+    EXPECT_CALL(*dbif_mock(), Db_AddColumnProxy(_))
+        .WillRepeatedly(Invoke(this,
+            &DbHandlerStatRollupTest::StatTableAddColumn));
+
+    uint64_t hour = 1449997200ULL * 1000000;
+    db_handler()->EnableStatRollup(true);
+    StatTableInsert(hour + 5000000, "vm1", 10, 0.5);
+    StatTableInsert(hour + 20000000, "vm1", 30, 1.5);
+    EXPECT_TRUE(samples_["cpu_stats@60"].empty());
+
+    db_handler()->StatRollupFlushAll(db_handler());
+    const char *rollups[] = { "cpu_stats@60", "cpu_stats@3600" };
+    for (size_t idx = 0; idx < 2; idx++) {
+        rapidjson::Document vm1;
+        vm1.Parse<0>(Sample(rollups[idx], "vm1").c_str());
+        ASSERT_TRUE(vm1.IsObject());
+        EXPECT_EQ(40U, vm1["cpu_stats.rss|n"].GetUint64());
+        EXPECT_EQ(2U, vm1["cpu_stats@count|n"].GetUint64());
+    }
+
+    // A later sample of the same period gets a rolled up sample of its own
+    samples_.clear();
+    StatTableInsert(hour + 40000000, "vm1", 5, 0.25);
+    db_handler()->StatRollupFlush(hour + 3610ULL * 1000000);
+    for (size_t idx = 0; idx < 2; idx++) {
+        rapidjson::Document vm1;
+        vm1.Parse<0>(Sample(rollups[idx], "vm1").c_str());
+        ASSERT_TRUE(vm1.IsObject());
+        EXPECT_EQ(5U, vm1["cpu_stats.rss|n"].GetUint64());
+        EXPECT_EQ(1U, vm1["cpu_stats@count|n"].GetUint64());
+    }
+    EXPECT_EQ(0U, db_handler()->stat_rollup_write_fails());
+}
+
+// A rolled up sample that can not be written is counted, and the rollup
+// start time is written again so that the query engine does not read the
+// rollups of its period
+TEST_F(DbHandlerStatRollupTest, RollupWriteFailure) {
+    EXPECT_CALL(*dbif_mock(), Db_AddColumnProxy(_))
+        .WillRepeatedly(Return(false));
+    EXPECT_CALL(*dbif_mock(), Db_AddColumnSyncProxy(_))
+        .WillOnce(Return(true));
+
+    uint64_t hour = 1449997200ULL * 1000000;
+    db_handler()->EnableStatRollup(true);
+    StatTableInsert(hour + 5000000, "vm1", 10, 0.5);
+    db_handler()->StatRollupFlush(hour + 3610ULL * 1000000);
+    EXPECT_EQ(2U, db_handler()->stat_rollup_write_fails());
+}
+
+// Once too many rolled up samples are pending, all of them are written
+TEST_F(DbHandlerStatRollupTest, RollupMaxEntries) {
+    EXPECT_CALL(*dbif_mock(), Db_AddColumnProxy(_))
+        .WillRepeatedly(Invoke(this,
+            &DbHandlerStatRollupTest::StatTableAddColumn));
+
+    // Each sample is rolled up for each of the periods
+    uint64_t hour = 1449997200ULL * 1000000;
+    size_t periods(g_viz_constants.STAT_ROLLUP_PERIODS.size());
+    size_t count(64 * 1024 / periods);
+    db_handler()->EnableStatRollup(true);
+    for (size_t idx = 0; idx < count - 1; idx++) {
+        StatTableInsert(hour + 5000000, "vm" + integerToString(idx), 1, 0.5);
+    }
+    EXPECT_TRUE(samples_["cpu_stats@60"].empty());
+    StatTableInsert(hour + 5000000, "vm-last", 1, 0.5);
+    EXPECT_EQ(count, samples_["cpu_stats@60"].size());
+    EXPECT_EQ(count, samples_["cpu_stats@3600"].size());
+}
+
 class UUIDRandomGenTest : public ::testing::Test {
  public:
     bool PopulateUUIDMap(std::map<std::string, unsigned int>& uuid_map,
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+#include "testing/gunit.h"
+
+#include "base/logging.h"
+#include "base/string_util.h"
+#include "base/time_util.h"
+#include "analytics/sflow_parser.h"
+
+typedef std::vector<uint8_t> Datagram;
+
+class SFlowParserTest : public ::testing::Test {
+protected:
+    static const uint32_t kSampleHeaderLength = 42;
+
+    virtual void SetUp() {
+        trace_buf_ = SandeshTraceBufferCreate("SFlowParserTest", 100);
+    }
+
+    static void AppendData32(Datagram *dgram, uint32_t data32) {
+        uint32_t ndata32 = htonl(data32);
+        const uint8_t *p = reinterpret_cast<const uint8_t *>(&ndata32);
+        dgram->insert(dgram->end(), p, p + sizeof(ndata32));
+    }
+
+    static void AppendBytes(Datagram *dgram, const uint8_t *bytes,
+                            size_t len) {
+        dgram->insert(dgram->end(), bytes, bytes + len);
+        // All the fields in sFlow datagram are 4-byte aligned
+        dgram->resize(dgram->size() + ((4 - len % 4) % 4));
+    }
+
+    // Raw packet header of an Ethernet/IPv4/UDP packet
+    static void AppendPacketHeader(Datagram *dgram, uint32_t sip,
+                                   uint32_t dip, uint16_t sport,
+                                   uint16_t dport) {
+        uint8_t header[kSampleHeaderLength] = {};
+        // Ethernet
+        header[12] = 0x08;
+        // IPv4
+        uint8_t *iph = header + 14;
+        iph[0] = 0x45;
+        iph[9] = IPPROTO_UDP;
+        uint32_t nsip = htonl(sip), ndip = htonl(dip);
+        memcpy(iph + 12, &nsip, 4);
+        memcpy(iph + 16, &ndip, 4);
+        // UDP
+        uint8_t *udph = iph + 20;
+        udph[0] = sport >> 8;
+        udph[1] = sport & 0xFF;
+        udph[2] = dport >> 8;
+        udph[3] = dport & 0xFF;
+        AppendData32(dgram, SFLOW_FLOW_HEADER_ETHERNET_ISO8023);
+        AppendData32(dgram, 1500);
+        AppendData32(dgram, 4);
+        AppendData32(dgram, kSampleHeaderLength);
+        AppendBytes(dgram, header, kSampleHeaderLength);
+    }
+
+    // sFlow v5 datagram with nsamples flow samples of UDP packets from
+    // 10.0.0.<sample> to 10.1.0.<sample>, received on port <index>.
+    static Datagram SFlowDatagram(uint32_t seqno, uint32_t nsamples,
+                                  uint32_t index) {
+        Datagram dgram;
+        AppendData32(&dgram, 5);
+        AppendData32(&dgram, SFLOW_IPADDR_V4);
+        AppendData32(&dgram, 0x0A0000FE);
+        AppendData32(&dgram, 0);
+        AppendData32(&dgram, seqno);
+        AppendData32(&dgram, 1000);
+        AppendData32(&dgram, nsamples);
+        for (uint32_t i = 0; i < nsamples; i++) {
+            Datagram record;
+            AppendPacketHeader(&record, 0x0A000000 + i, 0x0A010000 + i,
+                               1024 + i, 53);
+            AppendData32(&dgram, SFLOW_FLOW_SAMPLE);
+            AppendData32(&dgram, 32 + 8 + record.size());
+            AppendData32(&dgram, seqno * nsamples + i);
+            AppendData32(&dgram, index);
+            AppendData32(&dgram, 1024);
+            AppendData32(&dgram, 1024 * (seqno + 1));
+            AppendData32(&dgram, 0);
+            AppendData32(&dgram, index);
+            AppendData32(&dgram, 0);
+            AppendData32(&dgram, 1);
+            AppendData32(&dgram, SFLOW_FLOW_HEADER);
+            AppendData32(&dgram, record.size());
+            dgram.insert(dgram.end(), record.begin(), record.end());
+        }
+        return dgram;
+    }
+
+    int Parse(const Datagram &dgram, SFlowData *sflow_data) {
+        SFlowParser parser(&dgram[0], dgram.size(), trace_buf_);
+        return parser.Parse(sflow_data);
+    }
+
+    SandeshTraceBufferPtr trace_buf_;
+};
+
+TEST_F(SFlowParserTest, Basic) {
+    Datagram dgram(SFlowDatagram(7, 4, 12));
+    SFlowData sflow_data;
+    ASSERT_EQ(0, Parse(dgram, &sflow_data));
+    EXPECT_EQ(5U, sflow_data.sflow_header.version);
+    EXPECT_EQ(7U, sflow_data.sflow_header.seqno);
+    EXPECT_EQ("10.0.0.254",
+              sflow_data.sflow_header.agent_ip_address.ToString());
+    ASSERT_EQ(4U, sflow_data.flow_samples.size());
+    for (uint32_t i = 0; i < 4; i++) {
+        const SFlowFlowSampleData &fs_data(sflow_data.flow_samples[i]);
+        EXPECT_EQ(12U, fs_data.flow_sample.sourceid_index);
+        ASSERT_TRUE(fs_data.is_flow_header_set);
+        ASSERT_TRUE(fs_data.flow_header.is_ip_data_set);
+        const SFlowFlowIpData &ip_data(fs_data.flow_header.decoded_ip_data);
+        EXPECT_EQ("10.0.0." + integerToString(i), ip_data.src_ip.ToString());
+        EXPECT_EQ("10.1.0." + integerToString(i), ip_data.dst_ip.ToString());
+        EXPECT_EQ(1024U + i, ip_data.src_port);
+        EXPECT_EQ(53U, ip_data.dst_port);
+        EXPECT_EQ(static_cast<uint32_t>(IPPROTO_UDP), ip_data.protocol);
+    }
+}
+
+TEST_F(SFlowParserTest, Truncated) {
+    Datagram dgram(SFlowDatagram(1, 3, 1));
+    dgram.resize(dgram.size() - 8);
+    SFlowData sflow_data;
+    EXPECT_GT(0, Parse(dgram, &sflow_data));
+    // The samples decoded before the truncated one are kept
+    EXPECT_EQ(2U, sflow_data.flow_samples.size());
+}
+
+TEST_F(SFlowParserTest, Reuse) {
+    SFlowData sflow_data;
+    ASSERT_EQ(0, Parse(SFlowDatagram(1, 8, 1), &sflow_data));
+    EXPECT_EQ(8U, sflow_data.flow_samples.size());
+    sflow_data.Clear();
+    ASSERT_EQ(0, Parse(SFlowDatagram(2, 2, 3), &sflow_data));
+    EXPECT_EQ(2U, sflow_data.sflow_header.seqno);
+    ASSERT_EQ(2U, sflow_data.flow_samples.size());
+    EXPECT_EQ(3U, sflow_data.flow_samples[1].flow_sample.sourceid_index);
+    EXPECT_EQ(1025U, sflow_data.flow_samples[1].flow_header.
+              decoded_ip_data.src_port);
+}
+
+// Replays a set of datagrams through the parser, decoding into one reused
+// SFlowData as the generator does; the rate is printed and not checked
+TEST_F(SFlowParserTest, DISABLED_ReplayBenchmark) {
+    std::vector<Datagram> dgrams;
+    for (uint32_t i = 0; i < 64; i++) {
+        dgrams.push_back(SFlowDatagram(i, 1 + i % 10, i));
+    }
+    const int kReplays = 2000;
+    size_t nsamples = 0;
+    SFlowData sflow_data;
+    uint64_t start = ClockMonotonicUsec();
+    for (int replay = 0; replay < kReplays; replay++) {
+        for (size_t i = 0; i < dgrams.size(); i++) {
+            sflow_data.Clear();
+            ASSERT_EQ(0, Parse(dgrams[i], &sflow_data));
+            nsamples += sflow_data.flow_samples.size();
+        }
+    }
+    uint64_t elapsed = ClockMonotonicUsec() - start;
+    std::cout << "Replayed " << kReplays * dgrams.size() << " datagrams, " <<
+        nsamples << " flow samples in " << elapsed << " usec" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "testing/gunit.h"
+#include "base/logging.h"
+#include "base/string_util.h"
+#include "base/test/task_test_util.h"
+
+#include <boost/bind.hpp>
+#include "uve_write_queue.h"
+
+using std::string;
+using std::vector;
+
+// A write handed to the send callback. Updates are recorded as attr=msg
+struct SentWrite {
+    UveWriteQueue::Write::Op op;
+    vector<string> updates;
+};
+
+class UveWriteQueueTest : public ::testing::Test {
+public:
+    bool Send(UveWriteQueue::Write::Op op, const UveWriteQueue::Batch &batch,
+              const UveWriteQueue::Write *write) {
+        SentWrite sent;
+        sent.op = op;
+        if (write) {
+            sent.updates.push_back(write->args.attr + "=" + write->args.msg);
+        }
+        for (UveWriteQueue::Batch::const_iterator it = batch.begin();
+             it != batch.end(); ++it) {
+            sent.updates.push_back((*it)->attr + "=" + (*it)->msg);
+        }
+        sent_.push_back(sent);
+        return send_result_;
+    }
+
+    // Takes the generator mutex, like Collector::RedisQueueUpdate does
+    void Defer(bool defer) {
+        tbb::mutex::scoped_lock lock(gen_mutex_);
+        defer_calls_.push_back(defer);
+    }
+
+protected:
+    UveWriteQueueTest() :
+        queue_(boost::bind(&UveWriteQueueTest::Send, this, _1, _2, _3),
+               boost::bind(&UveWriteQueueTest::Defer, this, _1),
+               TaskScheduler::GetInstance()->GetTaskId(
+               "vizd::UveWriteDefer"), 8, 2),
+        send_result_(true) {
+    }
+
+    virtual void TearDown() {
+        task_util::WaitForIdle();
+    }
+
+    static RedisUVEUpdateArgs Args(const string &key, const string &attr,
+                                   const string &msg,
+                                   const string &source = "src1") {
+        RedisUVEUpdateArgs args;
+        args.type = "UveVirtualNetworkAgent";
+        args.attr = attr;
+        args.source = source;
+        args.node_type = "Compute";
+        args.module = "contrail-vrouter-agent";
+        args.instance_id = "0";
+        args.key = "ObjectVNTable:" + key;
+        args.msg = msg;
+        args.seq = 0;
+        args.part = 0;
+        args.is_alarm = false;
+        return args;
+    }
+
+    void Update(const string &key, const string &attr, const string &msg,
+                const string &source = "src1") {
+        queue_.Enqueue(UveWriteQueue::Write::UPDATE,
+                       Args(key, attr, msg, source), "None", "", 0);
+    }
+
+    void UpdateStats(const string &key, const string &attr,
+                     const string &msg) {
+        queue_.Enqueue(UveWriteQueue::Write::UPDATE_STATS,
+                       Args(key, attr, msg), "stats", "", 0);
+    }
+
+    void Delete(const string &key) {
+        queue_.Enqueue(UveWriteQueue::Write::DELETE, Args(key, "", ""),
+                       "", "", 0);
+    }
+
+    UveWriteQueue queue_;
+    tbb::mutex gen_mutex_;
+    bool send_result_;
+    vector<SentWrite> sent_;
+    vector<bool> defer_calls_;
+};
+
+// An update to a queued attribute replaces it and takes its place at the
+// end of the queue
+TEST_F(UveWriteQueueTest, Coalesce) {
+    Update("vn1", "a", "1");
+    Update("vn1", "b", "1");
+    Update("vn1", "a", "2");
+    Update("vn2", "a", "1");
+    EXPECT_EQ(3U, queue_.pending());
+    EXPECT_EQ(1U, queue_.coalesced());
+    EXPECT_TRUE(sent_.empty());
+
+    queue_.Flush();
+    EXPECT_EQ(0U, queue_.pending());
+    ASSERT_EQ(1U, sent_.size());
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[0].op);
+    ASSERT_EQ(3U, sent_[0].updates.size());
+    EXPECT_EQ("b=1", sent_[0].updates[0]);
+    EXPECT_EQ("a=2", sent_[0].updates[1]);
+    EXPECT_EQ("a=1", sent_[0].updates[2]);
+    EXPECT_EQ(3U, queue_.inflight());
+    EXPECT_EQ(1U, queue_.batches());
+}
+
+// Updates queued after a delete of the UVE are not coalesced with the
+// updates queued before it
+TEST_F(UveWriteQueueTest, CoalesceDelete) {
+    Update("vn1", "a", "1");
+    Delete("vn1");
+    Update("vn1", "a", "2");
+    EXPECT_EQ(0U, queue_.coalesced());
+
+    queue_.Flush();
+    ASSERT_EQ(3U, sent_.size());
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[0].op);
+    EXPECT_EQ("a=1", sent_[0].updates[0]);
+    EXPECT_EQ(UveWriteQueue::Write::DELETE, sent_[1].op);
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[2].op);
+    EXPECT_EQ("a=2", sent_[2].updates[0]);
+}
+
+// Stats updates and deletes are sent on their own and split the batches
+// of updates around them
+TEST_F(UveWriteQueueTest, BatchOrder) {
+    Update("vn1", "a", "1");
+    Update("vn1", "b", "1");
+    UpdateStats("vn1", "s", "1");
+    Update("vn1", "c", "1");
+    Delete("vn2");
+    Update("vn3", "a", "1");
+    queue_.Flush();
+
+    ASSERT_EQ(5U, sent_.size());
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[0].op);
+    EXPECT_EQ(2U, sent_[0].updates.size());
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE_STATS, sent_[1].op);
+    EXPECT_EQ("s=1", sent_[1].updates[0]);
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[2].op);
+    EXPECT_EQ("c=1", sent_[2].updates[0]);
+    EXPECT_EQ(UveWriteQueue::Write::DELETE, sent_[3].op);
+    EXPECT_EQ(UveWriteQueue::Write::UPDATE, sent_[4].op);
+    EXPECT_EQ(3U, queue_.batches());
+    EXPECT_EQ(6U, queue_.inflight());
+}
+
+// The queue is flushed once kBatchSize updates are pending
+TEST_F(UveWriteQueueTest, BatchFlush) {
+    UveWriteQueue queue(
+        boost::bind(&UveWriteQueueTest::Send, this, _1, _2, _3),
+        UveWriteQueue::DeferCb(),
+        TaskScheduler::GetInstance()->GetTaskId("vizd::UveWriteDefer"));
+    size_t batch_size = UveWriteQueue::kBatchSize;
+    for (size_t i = 0; i < batch_size - 1; i++) {
+        queue.Enqueue(UveWriteQueue::Write::UPDATE,
+            Args("vn1", "a" + integerToString(i), "1"), "None", "", 0);
+    }
+    EXPECT_TRUE(sent_.empty());
+    queue.Enqueue(UveWriteQueue::Write::UPDATE,
+        Args("vn1", "last", "1"), "None", "", 0);
+    ASSERT_EQ(1U, sent_.size());
+    EXPECT_EQ(batch_size, sent_[0].updates.size());
+    EXPECT_EQ(0U, queue.pending());
+    EXPECT_EQ(batch_size, queue.inflight());
+    queue.WriteDone(batch_size);
+    EXPECT_EQ(0U, queue.inflight());
+}
+
+// Queued writes of a generator are dropped when its UVEs are deleted
+TEST_F(UveWriteQueueTest, Drop) {
+    Update("vn1", "a", "1", "src1");
+    Update("vn1", "a", "1", "src2");
+    queue_.Drop("src1:Compute:contrail-vrouter-agent:0");
+    EXPECT_EQ(1U, queue_.pending());
+    Update("vn1", "a", "2", "src1");
+    EXPECT_EQ(0U, queue_.coalesced());
+    queue_.Flush();
+    ASSERT_EQ(1U, sent_.size());
+    ASSERT_EQ(2U, sent_[0].updates.size());
+    EXPECT_EQ("a=1", sent_[0].updates[0]);
+    EXPECT_EQ("a=2", sent_[0].updates[1]);
+}
+
+// Writes that can not be sent are not counted in flight
+TEST_F(UveWriteQueueTest, SendFailure) {
+    send_result_ = false;
+    Update("vn1", "a", "1");
+    Delete("vn2");
+    queue_.Flush();
+    EXPECT_EQ(2U, sent_.size());
+    EXPECT_EQ(0U, queue_.pending());
+    EXPECT_EQ(0U, queue_.inflight());
+}
+
+// Dequeue is deferred once writes queued and in flight reach the high
+// water mark, and resumed when they drain to the low water mark
+TEST_F(UveWriteQueueTest, WaterMarks) {
+    for (int i = 0; i < 7; i++) {
+        Update("vn1", "a" + integerToString(i), "1");
+    }
+    task_util::WaitForIdle();
+    EXPECT_TRUE(defer_calls_.empty());
+    // Coalesced updates do not add to the depth
+    Update("vn1", "a0", "2");
+    task_util::WaitForIdle();
+    EXPECT_TRUE(defer_calls_.empty());
+    Update("vn1", "a7", "1");
+    EXPECT_TRUE(queue_.defer());
+    task_util::WaitForIdle();
+    ASSERT_EQ(1U, defer_calls_.size());
+    EXPECT_TRUE(defer_calls_[0]);
+
+    // Writes in flight still count
+    queue_.Flush();
+    EXPECT_EQ(8U, queue_.inflight());
+    Update("vn2", "a", "1");
+    queue_.WriteDone(6);
+    task_util::WaitForIdle();
+    EXPECT_EQ(1U, defer_calls_.size());
+    queue_.WriteDone(1);
+    EXPECT_FALSE(queue_.defer());
+    task_util::WaitForIdle();
+    ASSERT_EQ(2U, defer_calls_.size());
+    EXPECT_FALSE(defer_calls_[1]);
+
+    // Clearing the queue on redis down also resumes
+    for (int i = 0; i < 8; i++) {
+        Update("vn3", "a" + integerToString(i), "1");
+    }
+    queue_.Clear();
+    task_util::WaitForIdle();
+    ASSERT_EQ(4U, defer_calls_.size());
+    EXPECT_TRUE(defer_calls_[2]);
+    EXPECT_FALSE(defer_calls_[3]);
+}
+
+// A generator disconnects while dequeue is deferred. Its writes are dropped
+// with the generator mutex held, and the resume that follows must not be
+// run under it since the defer callback takes the same mutex
+TEST_F(UveWriteQueueTest, DropWhileDeferred) {
+    for (int i = 0; i < 8; i++) {
+        Update("vn1", "a" + integerToString(i), "1", "src1");
+    }
+    task_util::WaitForIdle();
+    ASSERT_EQ(1U, defer_calls_.size());
+    EXPECT_TRUE(defer_calls_[0]);
+
+    {
+        tbb::mutex::scoped_lock lock(gen_mutex_);
+        queue_.Drop("src1:Compute:contrail-vrouter-agent:0");
+        EXPECT_EQ(0U, queue_.pending());
+        EXPECT_FALSE(queue_.defer());
+    }
+    task_util::WaitForIdle();
+    ASSERT_EQ(2U, defer_calls_.size());
+    EXPECT_FALSE(defer_calls_[1]);
+
+    queue_.Flush();
+    EXPECT_TRUE(sent_.empty());
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "uve_write_queue.h"
+
+#include <boost/bind.hpp>
+
+UveWriteQueue::UveWriteQueue(SendCb send_cb, DeferCb defer_cb,
+                             int defer_task_id,
+                             uint64_t high_water_mark,
+                             uint64_t low_water_mark) :
+    send_cb_(send_cb),
+    defer_cb_(defer_cb),
+    high_water_mark_(high_water_mark),
+    low_water_mark_(low_water_mark),
+    defer_queue_(defer_task_id, 0,
+                 boost::bind(&UveWriteQueue::DeferExecutor, this, _1)) {
+    pending_ = 0;
+    inflight_ = 0;
+    defer_ = false;
+    coalesced_ = 0;
+    batches_ = 0;
+}
+
+UveWriteQueue::~UveWriteQueue() {
+    defer_queue_.Shutdown();
+}
+
+std::string UveWriteQueue::IndexKey(const RedisUVEUpdateArgs &args) {
+    return args.source + ":" + args.node_type + ":" + args.module + ":" +
+        args.instance_id + "|" + args.key + "|" + args.type + "|";
+}
+
+// Remove the index entries that start with prefix, so that later updates
+// are not coalesced into writes queued before a delete
+void UveWriteQueue::IndexErase(const std::string &prefix) {
+    WriteIndex::iterator it = index_.lower_bound(prefix);
+    while (it != index_.end() &&
+           it->first.compare(0, prefix.size(), prefix) == 0) {
+        index_.erase(it++);
+    }
+}
+
+void UveWriteQueue::Enqueue(Write::Op op, const RedisUVEUpdateArgs &args,
+                            const std::string &agg, const std::string &atyp,
+                            int64_t ts) {
+    bool flush;
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        if (op == Write::UPDATE) {
+            std::pair<WriteIndex::iterator, bool> ret =
+                index_.insert(std::make_pair(IndexKey(args) + args.attr,
+                                             writes_.size()));
+            if (!ret.second) {
+                Write &prev(writes_[ret.first->second]);
+                prev.valid = false;
+                prev.args.msg.clear();
+                ret.first->second = writes_.size();
+                pending_--;
+                coalesced_++;
+            }
+        } else if (op == Write::DELETE) {
+            IndexErase(IndexKey(args));
+        }
+        writes_.push_back(Write(op, args, agg, atyp, ts));
+        pending_++;
+        flush = pending_ >= kBatchSize || writes_.size() >= kMaxEntries;
+    }
+    if (flush) {
+        Flush();
+    }
+    WaterMarkCheck();
+}
+
+void UveWriteQueue::Drop(const std::string &gen) {
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        for (std::vector<Write>::iterator it = writes_.begin();
+             it != writes_.end(); ++it) {
+            const RedisUVEUpdateArgs &args(it->args);
+            if (it->valid && gen == args.source + ":" + args.node_type +
+                    ":" + args.module + ":" + args.instance_id) {
+                it->valid = false;
+                it->args.msg.clear();
+                pending_--;
+            }
+        }
+        IndexErase(gen + "|");
+    }
+    WaterMarkCheck();
+}
+
+void UveWriteQueue::Clear() {
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        writes_.clear();
+        index_.clear();
+        pending_ = 0;
+    }
+    WaterMarkCheck();
+}
+
+void UveWriteQueue::Send(Write::Op op, const Batch &batch,
+                         const Write *write) {
+    uint64_t count(write ? 1 : batch.size());
+    // Account before sending, the reply may arrive before send_cb_ returns
+    inflight_ += count;
+    if (op == Write::UPDATE) {
+        batches_++;
+    }
+    if (!send_cb_(op, batch, write)) {
+        inflight_ -= count;
+    }
+}
+
+void UveWriteQueue::Flush() {
+    // Serialize flushes so that batches go out in queue order
+    tbb::mutex::scoped_lock flush_lock(flush_mutex_);
+    std::vector<Write> writes;
+    {
+        tbb::mutex::scoped_lock lock(mutex_);
+        writes.swap(writes_);
+        index_.clear();
+        pending_ = 0;
+    }
+    Batch batch;
+    batch.reserve(kBatchSize);
+    for (std::vector<Write>::const_iterator it = writes.begin();
+         it != writes.end(); ++it) {
+        if (!it->valid) {
+            continue;
+        }
+        if (it->op == Write::UPDATE) {
+            batch.push_back(&it->args);
+            if (batch.size() < kBatchSize) {
+                continue;
+            }
+        }
+        if (!batch.empty()) {
+            Send(Write::UPDATE, batch, NULL);
+            batch.clear();
+        }
+        if (it->op != Write::UPDATE) {
+            Send(it->op, batch, &*it);
+        }
+    }
+    if (!batch.empty()) {
+        Send(Write::UPDATE, batch, NULL);
+    }
+    // Writes that could not be sent are dropped
+    WaterMarkCheck();
+}
+
+void UveWriteQueue::WriteDone(uint64_t count) {
+    inflight_ -= count;
+    WaterMarkCheck();
+}
+
+void UveWriteQueue::WaterMarkCheck() {
+    uint64_t depth(pending_ + inflight_);
+    if ((!defer_ && depth < high_water_mark_) ||
+        (defer_ && depth > low_water_mark_)) {
+        return;
+    }
+    tbb::mutex::scoped_lock lock(wm_mutex_);
+    depth = pending_ + inflight_;
+    if (!defer_ && depth >= high_water_mark_) {
+        defer_ = true;
+        defer_queue_.Enqueue(true);
+    } else if (defer_ && depth <= low_water_mark_) {
+        defer_ = false;
+        defer_queue_.Enqueue(false);
+    }
+}
+
+// Runs in the defer task, without any of the locks held by the callers
+// that crossed the water mark
+bool UveWriteQueue::DeferExecutor(bool defer) {
+    if (!defer_cb_.empty()) {
+        defer_cb_(defer);
+    }
+    return true;
+}
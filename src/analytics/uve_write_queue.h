@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef ANALYTICS_UVE_WRITE_QUEUE_H_
+#define ANALYTICS_UVE_WRITE_QUEUE_H_
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/function.hpp>
+#include <tbb/atomic.h>
+#include <tbb/mutex.h>
+
+#include "base/queue_task.h"
+#include "base/util.h"
+#include "redis_processor_vizd.h"
+
+//
+// UVE writes are not sent to redis as they arrive. They are held in the
+// queue until Flush, and an update to a UVE attribute that is already
+// queued replaces the earlier one. The replaced entry is invalidated in
+// place and the new one is appended, so redis still sees the writes in
+// arrival order. On Flush, non-stats updates are handed to the send
+// callback in batches of up to kBatchSize, while stats updates and deletes
+// are handed over on their own, in order.
+//
+// Writes queued plus writes in flight are tracked against a high and a low
+// water mark. Crossing the high water mark calls the defer callback with
+// true, and draining below the low water mark calls it with false. The
+// defer callback is not called inline, since the water marks are crossed
+// under locks held by callers e.g. Drop is called with the generator mutex
+// held. It is run from a WorkQueue in the defer task instead, in the order
+// the water marks were crossed.
+//
+class UveWriteQueue {
+public:
+    struct Write {
+        enum Op {
+            UPDATE,
+            UPDATE_STATS,
+            DELETE,
+        };
+
+        Write(Op op, const RedisUVEUpdateArgs &args, const std::string &agg,
+              const std::string &atyp, int64_t ts) :
+            op(op), valid(true), args(args), agg(agg), atyp(atyp), ts(ts) {
+        }
+
+        Op op;
+        bool valid;
+        RedisUVEUpdateArgs args;
+        std::string agg;
+        std::string atyp;
+        int64_t ts;
+    };
+    typedef std::vector<const RedisUVEUpdateArgs *> Batch;
+
+    // Sends a batch of updates (write is NULL) or a single write. Returns
+    // false if it could not be sent. Once sent, WriteDone must be called
+    // for it when redis replies or the connection goes down
+    typedef boost::function<bool(Write::Op op, const Batch &batch,
+                                 const Write *write)> SendCb;
+    typedef boost::function<void(bool defer)> DeferCb;
+
+    static const size_t kBatchSize = 256;
+    static const size_t kMaxEntries = 4 * kBatchSize;
+    static const uint64_t kHighWaterMark = 32 * 1024;
+    static const uint64_t kLowWaterMark = 8 * 1024;
+
+    UveWriteQueue(SendCb send_cb, DeferCb defer_cb, int defer_task_id,
+                  uint64_t high_water_mark = kHighWaterMark,
+                  uint64_t low_water_mark = kLowWaterMark);
+    ~UveWriteQueue();
+
+    void Enqueue(Write::Op op, const RedisUVEUpdateArgs &args,
+                 const std::string &agg, const std::string &atyp, int64_t ts);
+    // Drop the queued writes of a generator whose UVEs are being deleted
+    void Drop(const std::string &gen);
+    void Clear();
+    void Flush();
+    void WriteDone(uint64_t count);
+
+    uint64_t pending() const { return pending_; }
+    uint64_t inflight() const { return inflight_; }
+    bool defer() const { return defer_; }
+    uint64_t coalesced() const { return coalesced_; }
+    uint64_t batches() const { return batches_; }
+
+private:
+    typedef std::map<std::string, size_t> WriteIndex;
+
+    static std::string IndexKey(const RedisUVEUpdateArgs &args);
+    void IndexErase(const std::string &prefix);
+    void Send(Write::Op op, const Batch &batch, const Write *write);
+    void WaterMarkCheck();
+    bool DeferExecutor(bool defer);
+
+    SendCb send_cb_;
+    DeferCb defer_cb_;
+    const uint64_t high_water_mark_;
+    const uint64_t low_water_mark_;
+    std::vector<Write> writes_;
+    WriteIndex index_;
+    tbb::atomic<uint64_t> pending_;
+    tbb::atomic<uint64_t> inflight_;
+    tbb::atomic<bool> defer_;
+    tbb::atomic<uint64_t> coalesced_;
+    tbb::atomic<uint64_t> batches_;
+    tbb::mutex mutex_;
+    tbb::mutex flush_mutex_;
+    tbb::mutex wm_mutex_;
+    WorkQueue<bool> defer_queue_;
+
+    DISALLOW_COPY_AND_ASSIGN(UveWriteQueue);
+};
+
+#endif  // ANALYTICS_UVE_WRITE_QUEUE_H_
@@ -0,0 +1,54 @@
+--
+-- Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+--
+
+-- Batched form of uveupdate.lua. KEYS carries 5 keys per update and
+-- ARGV carries the db followed by 11 arguments per update, both in the
+-- order used by uveupdate.lua. Returns the number of updates applied.
+
+local db = tonumber(ARGV[1])
+local nupdates = #KEYS / 5
+local gens = {}
+local applied = 0
+
+redis.call('select',db)
+
+for i = 0, nupdates - 1 do
+    local k = i * 5
+    local a = 1 + i * 11
+
+    local sm = ARGV[a+1]..":"..ARGV[a+2]..":"..ARGV[a+3]..":"..ARGV[a+4]
+    local typ = ARGV[a+5]
+    local attr = ARGV[a+6]
+    local key = ARGV[a+7]
+    local seq = ARGV[a+8]
+    local val = ARGV[a+9]
+    local part = ARGV[a+10]
+    local is_alarm = tonumber(ARGV[a+11])
+
+    local _types = KEYS[k+1]
+    local _origins = KEYS[k+2]
+    local _table = KEYS[k+3]
+    local _uves = KEYS[k+4]
+    local _values = KEYS[k+5]
+
+    if gens[sm] == nil then
+        gens[sm] = redis.call('sismember', 'NGENERATORS', sm)
+    end
+
+    if gens[sm] == 1 then
+        if is_alarm == 0 then
+            redis.call('sadd',"PART2KEY:"..part, sm..":"..typ..":"..key)
+            redis.call('hset',"KEY2PART:"..sm..":"..typ, key, part)
+        end
+
+        redis.call('sadd',_types,typ)
+        redis.call('sadd',_origins,sm..":"..typ)
+        redis.call('sadd',_table,key..':'..sm..":"..typ)
+        redis.call('zadd',_uves,seq,key)
+        redis.call('hset',_values,attr,val)
+        applied = applied + 1
+    end
+end
+
+return applied
@@ -9,6 +9,7 @@
 
 #include "base/logging.h"
 #include "base/task.h"
+#include "base/time_util.h"
 #include "base/parse_object.h"
 #include "io/event_manager.h"
 
@@ -119,11 +120,22 @@ void VizCollector::Shutdown() {
     for (int cnt = 0; collector_->ConnectionsCount() != 0 && cnt < 15; cnt++) {
         sleep(1);
     }
+    // Write the rolled up stats samples of the periods in progress while
+    // the DB connection is still up, so that no samples received before
+    // the shutdown are missing from the rollups
+    DbHandler *db_handler(db_initializer_->GetDbHandler());
+    collector_->StatRollupFlushAll();
     TcpServerManager::DeleteServer(collector_);
 
     syslog_listener_->Shutdown();
     WaitForIdle();
 
+    if (protobuf_collector_) {
+        protobuf_collector_->StatRollupFlushAll(db_handler);
+    }
+    db_handler->StatRollupFlushAll();
+    WaitForIdle();
+
     if (protobuf_collector_) {
         protobuf_collector_->Shutdown();
         WaitForIdle();
@@ -145,6 +157,7 @@ void VizCollector::Shutdown() {
 
 void VizCollector::DbInitializeCb() {
     ruleeng_->Init();
+    db_initializer_->GetDbHandler()->StatRollupWriteStartTime();
     if (!syslog_listener_->IsRunning()) {
         syslog_listener_->Start();
         LOG(DEBUG, __func__ << " Initialization of syslog listener done!");
@@ -181,3 +194,24 @@ void VizCollector::TestDatabaseConnection() {
         collector_->TestDatabaseConnection();
     }
 }
+
+void VizCollector::EnableStatRollup(bool enable) {
+    db_initializer_->GetDbHandler()->EnableStatRollup(enable);
+    if (collector_) {
+        collector_->EnableStatRollup(enable);
+    }
+    if (protobuf_collector_) {
+        protobuf_collector_->EnableStatRollup(enable);
+    }
+}
+
+void VizCollector::StatRollupFlush() {
+    uint64_t now(UTCTimestampUsec());
+    db_initializer_->GetDbHandler()->StatRollupFlush(now);
+    if (collector_) {
+        collector_->StatRollupFlush(now);
+    }
+    if (protobuf_collector_) {
+        protobuf_collector_->StatRollupFlush(now);
+    }
+}
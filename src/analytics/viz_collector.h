@@ -66,6 +66,9 @@ public:
     void SendProtobufCollectorStatistics();
     void SendGeneratorStatistics();
     void TestDatabaseConnection();
+    // Stats rollups are kept by every DbHandler that writes stats samples
+    void EnableStatRollup(bool enable);
+    void StatRollupFlush();
 
 private:
     std::string DbGlobalName(bool dup=false);
@@ -120,6 +120,8 @@ void init_vizd_tables() {
                        GenDb::DbDataType::Unsigned64Type)
                       (g_viz_constants.SYSTEM_OBJECT_STAT_START_TIME,
                        GenDb::DbDataType::Unsigned64Type)
+                      (g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME,
+                       GenDb::DbDataType::Unsigned64Type)
                       ))
         (GenDb::NewCf(g_viz_constants.OBJECT_TABLE,
                       boost::assign::list_of
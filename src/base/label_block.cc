@@ -48,12 +48,19 @@ size_t LabelBlockManager::size() {
     return blocks_.size();
 }
 
+static const size_t kBitsPerWord = 64;
+static const uint64_t kAllOnes = ~static_cast<uint64_t>(0);
+
 LabelBlock::LabelBlock(uint32_t first, uint32_t last)
     : block_manager_(NULL),
       first_(first),
       last_(last),
-      prev_pos_(BitSet::npos) {
+      prev_pos_(npos),
+      used_count_(0),
+      peak_used_count_(0),
+      alloc_fail_count_(0) {
       refcount_ = 0;
+      InitBitmap();
 }
 
 LabelBlock::LabelBlock(
@@ -61,41 +68,221 @@ LabelBlock::LabelBlock(
     : block_manager_(block_manager),
       first_(first),
       last_(last),
-      prev_pos_(BitSet::npos) {
+      prev_pos_(npos),
+      used_count_(0),
+      peak_used_count_(0),
+      alloc_fail_count_(0) {
       refcount_ = 0;
+      InitBitmap();
 }
 
 LabelBlock::~LabelBlock() {
-    assert(used_bitset_.empty());
+    assert(used_count_ == 0);
     if (block_manager_)
         block_manager_->RemoveBlock(this);
 }
 
+//
+// The bitmap starts out empty, only the number of words needed to cover the
+// block is computed here.
+//
+void LabelBlock::InitBitmap() {
+    nwords_ = (label_count() + kBitsPerWord - 1) / kBitsPerWord;
+}
+
+//
+// Grow both levels of the bitmap to include word. The bits past the end of
+// the block are marked used when the last word gets added, so that searches
+// never need to check against the block size.
+//
+void LabelBlock::GrowBitmap(size_t word) {
+    size_t nwords = used_words_.size();
+    if (word < nwords)
+        return;
+    assert(word < nwords_);
+
+    used_words_.resize(word + 1, 0);
+    full_words_.resize(word / kBitsPerWord + 1, kAllOnes);
+    for (; nwords <= word; ++nwords) {
+        full_words_[nwords / kBitsPerWord] &=
+            ~(static_cast<uint64_t>(1) << (nwords % kBitsPerWord));
+    }
+
+    size_t count = label_count();
+    if (word == nwords_ - 1 && count % kBitsPerWord) {
+        used_words_[word] = kAllOnes << (count % kBitsPerWord);
+    }
+}
+
+//
+// Find the first clear bit at or after pos. The rest of the word containing
+// pos is checked first and the summary level is used to skip over full words
+// after that. If all the words in the bitmap are full, the first position
+// past them is free unless the bitmap already covers the whole block.
+//
+size_t LabelBlock::FindClear(size_t pos) const {
+    size_t word = pos / kBitsPerWord;
+    if (word < used_words_.size()) {
+        uint64_t bits =
+            ~used_words_[word] & (kAllOnes << (pos % kBitsPerWord));
+        if (bits)
+            return word * kBitsPerWord + __builtin_ctzll(bits);
+
+        word++;
+        size_t full_word = word / kBitsPerWord;
+        uint64_t free_bits = 0;
+        if (full_word < full_words_.size()) {
+            free_bits =
+                ~full_words_[full_word] & (kAllOnes << (word % kBitsPerWord));
+        }
+        while (!free_bits && ++full_word < full_words_.size()) {
+            free_bits = ~full_words_[full_word];
+        }
+        if (free_bits) {
+            word = full_word * kBitsPerWord + __builtin_ctzll(free_bits);
+            return word * kBitsPerWord + __builtin_ctzll(~used_words_[word]);
+        }
+        pos = used_words_.size() * kBitsPerWord;
+    }
+    return pos < label_count() ? pos : npos;
+}
+
+//
+// Find the first set bit in [pos, limit). Returns limit if there is none.
+//
+size_t LabelBlock::FindSet(size_t pos, size_t limit) const {
+    size_t word = pos / kBitsPerWord;
+    uint64_t mask = kAllOnes << (pos % kBitsPerWord);
+    for (; word < used_words_.size() && word * kBitsPerWord < limit; word++) {
+        uint64_t bits = used_words_[word] & mask;
+        if (bits) {
+            size_t set_pos = word * kBitsPerWord + __builtin_ctzll(bits);
+            return set_pos < limit ? set_pos : limit;
+        }
+        mask = kAllOnes;
+    }
+    return limit;
+}
+
+void LabelBlock::SetUsed(size_t pos) {
+    size_t word = pos / kBitsPerWord;
+    GrowBitmap(word);
+    used_words_[word] |= static_cast<uint64_t>(1) << (pos % kBitsPerWord);
+    if (used_words_[word] == kAllOnes) {
+        full_words_[word / kBitsPerWord] |=
+            static_cast<uint64_t>(1) << (word % kBitsPerWord);
+    }
+    if (++used_count_ > peak_used_count_)
+        peak_used_count_ = used_count_;
+}
+
+void LabelBlock::ClearUsed(size_t pos) {
+    size_t word = pos / kBitsPerWord;
+    if (word >= used_words_.size())
+        return;
+    uint64_t bit = static_cast<uint64_t>(1) << (pos % kBitsPerWord);
+    if ((used_words_[word] & bit) == 0)
+        return;
+    if (used_words_[word] == kAllOnes) {
+        full_words_[word / kBitsPerWord] &=
+            ~(static_cast<uint64_t>(1) << (word % kBitsPerWord));
+    }
+    used_words_[word] &= ~bit;
+    used_count_--;
+}
+
+//
+// Allocate the next free position after the previously allocated one,
+// wrapping around to the start of the block if needed. The caller must
+// hold the mutex_ and must have checked that the block is not full.
+//
+size_t LabelBlock::AllocatePosition() {
+    size_t pos = npos;
+    if (prev_pos_ != npos)
+        pos = FindClear(prev_pos_ + 1);
+    if (pos == npos)
+        pos = FindClear(0);
+    assert(pos != npos);
+    SetUsed(pos);
+    prev_pos_ = pos;
+    return pos;
+}
+
+void LabelBlock::ReleasePosition(uint32_t value) {
+    assert(value >= first_ && value <= last_);
+    ClearUsed(value - first_);
+}
+
 uint32_t LabelBlock::AllocateLabel() {
     tbb::mutex::scoped_lock lock(mutex_);
 
-    size_t pos;
-    for (int idx = 0; idx < 2; prev_pos_ = BitSet::npos, idx++) {
-        if (prev_pos_ == BitSet::npos) {
-            pos = used_bitset_.find_first_clear();
-        } else {
-            pos = used_bitset_.find_next_clear(prev_pos_);
-        }
+    if (used_count_ == label_count()) {
+        alloc_fail_count_++;
+        return 0;
+    }
+    return first_ + AllocatePosition();
+}
+
+void LabelBlock::ReleaseLabel(uint32_t value) {
+    tbb::mutex::scoped_lock lock(mutex_);
+    ReleasePosition(value);
+}
+
+bool LabelBlock::AllocateLabels(size_t count, vector<uint32_t> *labels) {
+    tbb::mutex::scoped_lock lock(mutex_);
+
+    if (count > label_count() - used_count_) {
+        alloc_fail_count_++;
+        return false;
+    }
+    labels->reserve(labels->size() + count);
+    for (size_t idx = 0; idx < count; ++idx) {
+        labels->push_back(first_ + AllocatePosition());
+    }
+    return true;
+}
+
+void LabelBlock::ReleaseLabels(const vector<uint32_t> &labels) {
+    tbb::mutex::scoped_lock lock(mutex_);
+
+    for (vector<uint32_t>::const_iterator it = labels.begin();
+         it != labels.end(); ++it) {
+        ReleasePosition(*it);
+    }
+}
 
-        if (first_ + pos <= last_) {
-            used_bitset_.set(pos);
-            prev_pos_ = pos;
-            return (first_ + pos);
+uint32_t LabelBlock::AllocateLabelRange(size_t count) {
+    tbb::mutex::scoped_lock lock(mutex_);
+
+    if (count == 0 || count > label_count() - used_count_) {
+        alloc_fail_count_++;
+        return 0;
+    }
+
+    // Look for a run of count clear bits, skipping past the set bit that
+    // ends each run that is too short.
+    size_t pos = FindClear(0);
+    while (pos != npos) {
+        if (pos + count > label_count())
+            break;
+        size_t end = FindSet(pos, pos + count);
+        if (end == pos + count) {
+            for (size_t idx = pos; idx < end; ++idx) {
+                SetUsed(idx);
+            }
+            return first_ + pos;
         }
+        pos = FindClear(end);
     }
 
+    alloc_fail_count_++;
     return 0;
 }
 
-void LabelBlock::ReleaseLabel(uint32_t value) {
+void LabelBlock::ReleaseLabelRange(uint32_t first, size_t count) {
     tbb::mutex::scoped_lock lock(mutex_);
 
-    assert(value >= first_ && value <= last_);
-    size_t pos = value - first_;
-    used_bitset_.reset(pos);
+    for (size_t idx = 0; idx < count; ++idx) {
+        ReleasePosition(first + idx);
+    }
 }
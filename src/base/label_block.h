@@ -5,12 +5,12 @@
 #ifndef ctrlplane_label_block_h
 #define ctrlplane_label_block_h
 
+#include <stdint.h>
 #include <vector>
 #include <boost/intrusive_ptr.hpp>
+#include <tbb/atomic.h>
 #include <tbb/mutex.h>
 
-#include "base/bitset.h"
-
 class LabelBlock;
 class LabelBlockManager;
 
@@ -64,17 +64,28 @@ inline void intrusive_ptr_release(LabelBlockManager *block_manager) {
 
 //
 // This class represents a block of labels within a label space. Clients can
-// make requests to allocate/release a single label from within this block.
-// As mentioned above, clients always maintain an intrusive pointer to these
-// objects.
+// make requests to allocate/release a single label, a set of labels or a
+// contiguous range of labels from within this block. As mentioned above,
+// clients always maintain an intrusive pointer to these objects.
+//
+// Used/allocated values are tracked in a two level bitmap. A bit position in
+// used_words_ represents an offset from the first value e.g. label value of
+// first corresponds to bit position 0. A bit in full_words_ is set when the
+// corresponding word in used_words_ has no clear bits, so that a search for
+// a clear bit skips 64 full words at a time. Bits past the end of the block
+// are kept set in both levels and are never handed out.
+//
+// The bitmap grows a word at a time as labels get allocated, so a block for
+// a large range costs nothing until its labels are used. Labels past the
+// words in used_words_ are free. Bits in full_words_ for those words are kept
+// set, so a search of the summary level only finds words that exist.
 //
-// A BitSet is used to keep track of used/allocated values. A position in the
-// BitSet represents an offset from the first value e.g. label value of first
-// corresponds to bit position 0.
+// A block with last less than first has no labels, all allocations from it
+// fail.
 //
-// TBD: A BitSet is not time efficient when managing a large label space so
-// we should revisit the implementation of this class. Perhaps we could use
-// an itable or a hierarchy of BitSets.
+// Single labels are allocated next-fit i.e. the search starts after the last
+// allocated label and wraps around once. Contiguous ranges are allocated
+// first-fit from the start of the block.
 //
 class LabelBlock {
 public:
@@ -84,25 +95,61 @@ public:
 
     uint32_t AllocateLabel();
     void ReleaseLabel(uint32_t value);
+
+    // Allocates count labels, which need not be contiguous, and appends them
+    // to labels. Nothing is allocated if the block doesn't have count free
+    // labels.
+    bool AllocateLabels(size_t count, std::vector<uint32_t> *labels);
+    void ReleaseLabels(const std::vector<uint32_t> &labels);
+
+    // Returns the first label of a contiguous range of count labels, or 0 if
+    // there's no such free range.
+    uint32_t AllocateLabelRange(size_t count);
+    void ReleaseLabelRange(uint32_t first, size_t count);
+
     uint32_t first() { return first_; }
     uint32_t last() { return last_; }
     LabelBlockManagerPtr block_manager() { return block_manager_; }
 
+    size_t label_count() const {
+        return last_ < first_ ? 0 : static_cast<size_t>(last_ - first_) + 1;
+    }
+    size_t used_count() const { return used_count_; }
+    size_t peak_used_count() const { return peak_used_count_; }
+    uint64_t alloc_fail_count() const { return alloc_fail_count_; }
+
 private:
     friend class LabelBlockManager;
     friend class LabelBlockTest;
     friend void intrusive_ptr_add_ref(LabelBlock *block);
     friend void intrusive_ptr_release(LabelBlock *block);
 
+    static const size_t npos = static_cast<size_t>(-1);
+
+    void InitBitmap();
+    void GrowBitmap(size_t word);
+    size_t FindClear(size_t pos) const;
+    size_t FindSet(size_t pos, size_t limit) const;
+    void SetUsed(size_t pos);
+    void ClearUsed(size_t pos);
+    size_t AllocatePosition();
+    void ReleasePosition(uint32_t value);
+
     LabelBlockManagerPtr block_manager_;
     uint32_t first_, last_;
     size_t prev_pos_;
     tbb::atomic<int> refcount_;
 
-    // The BitSet of used labels is protected via the mutex_. This is needed
-    // since we need to handle concurrent calls to AllocateLabel/ReleaseLabel.
+    // The bitmap of used labels and the counters are protected via the
+    // mutex_. This is needed since we need to handle concurrent calls to
+    // AllocateLabel/ReleaseLabel.
     tbb::mutex mutex_;
-    BitSet used_bitset_;
+    size_t nwords_;
+    std::vector<uint64_t> used_words_;
+    std::vector<uint64_t> full_words_;
+    size_t used_count_;
+    size_t peak_used_count_;
+    uint64_t alloc_fail_count_;
 };
 
 inline void intrusive_ptr_add_ref(LabelBlock *block) {
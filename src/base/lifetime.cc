@@ -4,7 +4,9 @@
 
 #include "base/lifetime.h"
 
+#include <typeinfo>
 #include <boost/bind.hpp>
+#include <boost/units/detail/utility.hpp>
 #include "base/backtrace.h"
 #include "base/time_util.h"
 
@@ -224,8 +226,44 @@ bool LifetimeManager::DeleteExecutor(LifetimeActorRef actor_ref) {
         return false;
     }
     if (actor->ReferenceDecrementAndTest()) {
-        actor->DeleteComplete();
-        actor->Destroy();
+        DestroyActor(actor);
     }
     return true;
 }
+
+//
+// Concurrency: called in the context of the LifetimeManager's Task.
+//
+// Destroy the object and update the stats for the actor type. Note that the
+// actor itself is gone once Destroy returns.
+//
+void LifetimeManager::DestroyActor(LifetimeActor *actor) {
+    std::string type_name(typeid(*actor).name());
+    uint64_t latency_usecs =
+        UTCTimestampUsec() - actor->delete_time_stamp_usecs();
+    uint64_t start = ClockMonotonicUsec();
+    actor->DeleteComplete();
+    actor->Destroy();
+    uint64_t destroy_usecs = ClockMonotonicUsec() - start;
+
+    tbb::mutex::scoped_lock lock(stats_mutex_);
+    DestroyStats &stats = stats_map_[type_name];
+    stats.count++;
+    stats.total_latency_usecs += latency_usecs;
+    if (latency_usecs > stats.max_latency_usecs)
+        stats.max_latency_usecs = latency_usecs;
+    stats.total_destroy_usecs += destroy_usecs;
+}
+
+//
+// Concurrency: called in the context of any Task or the main thread.
+//
+void LifetimeManager::GetDestroyStats(DestroyStatsMap *stats_map) const {
+    tbb::mutex::scoped_lock lock(stats_mutex_);
+    for (DestroyStatsMap::const_iterator it = stats_map_.begin();
+         it != stats_map_.end(); ++it) {
+        std::string type_name =
+            boost::units::detail::demangle(it->first.c_str());
+        stats_map->insert(std::make_pair(type_name, it->second));
+    }
+}
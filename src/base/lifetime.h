@@ -5,6 +5,8 @@
 #ifndef __BASE__LIFETIME_H__
 #define __BASE__LIFETIME_H__
 
+#include <map>
+#include <string>
 #include <tbb/atomic.h>
 #include <tbb/mutex.h>
 
@@ -186,12 +188,29 @@ private:
 //
 class LifetimeManager {
 public:
+    // Destroy stats for a type of actor. The latency is measured from the
+    // call to Delete to the call to Destroy.
+    struct DestroyStats {
+        DestroyStats()
+            : count(0), total_latency_usecs(0), max_latency_usecs(0),
+              total_destroy_usecs(0) {
+        }
+        uint64_t count;
+        uint64_t total_latency_usecs;
+        uint64_t max_latency_usecs;
+        uint64_t total_destroy_usecs;
+    };
+    typedef std::map<std::string, DestroyStats> DestroyStatsMap;
+
     LifetimeManager(int task_id);
     virtual ~LifetimeManager();
 
     // Return the number of times work queue task executions were deferred.
     size_t GetQueueDeferCount() { return defer_count_; }
 
+    // Get the destroy stats keyed by actor type name.
+    void GetDestroyStats(DestroyStatsMap *stats_map) const;
+
 protected:
     virtual void SetQueueDisable(bool disabled);
 
@@ -214,10 +233,16 @@ private:
     virtual bool MayDestroy() { return true; }
 
     bool DeleteExecutor(LifetimeActorRef actor_ref);
+    void DestroyActor(LifetimeActor *actor);
 
     int defer_count_;
     WorkQueue<LifetimeActorRef> queue_;
 
+    // The stats are keyed by mangled type name and protected via the
+    // stats_mutex_ since they are read from introspect tasks.
+    mutable tbb::mutex stats_mutex_;
+    DestroyStatsMap stats_map_;
+
     DISALLOW_COPY_AND_ASSIGN(LifetimeManager);
 };
 
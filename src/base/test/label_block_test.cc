@@ -5,6 +5,7 @@
 #include <boost/foreach.hpp>
 #include "base/label_block.h"
 #include "base/logging.h"
+#include "base/time_util.h"
 #include "testing/gunit.h"
 
 using namespace std;
@@ -26,6 +27,9 @@ protected:
     }
 
     size_t BlockCount() { return manager_->size(); }
+    size_t BitmapWords(LabelBlock *block) {
+        return block->used_words_.size();
+    }
 
     LabelBlockManagerPtr manager_;
 };
@@ -143,6 +147,143 @@ TEST_F(LabelBlockTest, AllocateReleaseLabel3) {
     }
 }
 
+// Allocate all labels in a given block in bulk, in a few chunks.
+// Then verify that a bulk request that can't be satisfied in full allocates
+// nothing.
+TEST_F(LabelBlockTest, AllocateReleaseLabels) {
+    LabelBlockPtr block = manager_->LocateBlock(1000, 1500 - 1);
+    vector<uint32_t> labels;
+    EXPECT_TRUE(block->AllocateLabels(200, &labels));
+    EXPECT_TRUE(block->AllocateLabels(250, &labels));
+    EXPECT_EQ(450, labels.size());
+    for (int idx = 0; idx < 450; idx++) {
+        EXPECT_EQ(1000 + idx, labels[idx]);
+    }
+    EXPECT_FALSE(block->AllocateLabels(51, &labels));
+    EXPECT_EQ(450, labels.size());
+    EXPECT_EQ(450, block->used_count());
+    EXPECT_TRUE(block->AllocateLabels(50, &labels));
+    EXPECT_EQ(0, block->AllocateLabel());
+    block->ReleaseLabels(labels);
+    EXPECT_EQ(0, block->used_count());
+}
+
+// Allocate contiguous ranges of labels in a given block.
+// Verify that a range is only carved out of a hole that is large enough.
+TEST_F(LabelBlockTest, AllocateReleaseLabelRange) {
+    LabelBlockPtr block = manager_->LocateBlock(1000, 1500 - 1);
+    EXPECT_EQ(1000, block->AllocateLabelRange(100));
+    EXPECT_EQ(1100, block->AllocateLabelRange(100));
+    EXPECT_EQ(1200, block->AllocateLabelRange(300));
+    EXPECT_EQ(0, block->AllocateLabelRange(1));
+
+    // Punch a hole of 10 labels at 1050 and one of 100 labels at 1100.
+    block->ReleaseLabelRange(1050, 10);
+    block->ReleaseLabelRange(1100, 100);
+    EXPECT_EQ(0, block->AllocateLabelRange(111));
+    EXPECT_EQ(1100, block->AllocateLabelRange(64));
+    EXPECT_EQ(1050, block->AllocateLabelRange(10));
+    EXPECT_EQ(1164, block->AllocateLabelRange(36));
+    EXPECT_EQ(0, block->AllocateLabel());
+
+    block->ReleaseLabelRange(1000, 500);
+    EXPECT_EQ(0, block->used_count());
+    EXPECT_EQ(1000, block->AllocateLabelRange(500));
+    block->ReleaseLabelRange(1000, 500);
+}
+
+// Verify the occupancy stats of a block that is not a multiple of 64 labels.
+TEST_F(LabelBlockTest, OccupancyStats) {
+    LabelBlockPtr block = manager_->LocateBlock(16, 16 + 100 - 1);
+    EXPECT_EQ(100, block->label_count());
+    for (int idx = 0; idx < 100; idx++) {
+        EXPECT_EQ(16 + idx, block->AllocateLabel());
+    }
+    EXPECT_EQ(0, block->AllocateLabel());
+    EXPECT_EQ(0, block->AllocateLabelRange(2));
+    EXPECT_EQ(100, block->used_count());
+    EXPECT_EQ(2, block->alloc_fail_count());
+    for (int idx = 0; idx < 60; idx++) {
+        block->ReleaseLabel(16 + idx);
+    }
+    EXPECT_EQ(40, block->used_count());
+    EXPECT_EQ(100, block->peak_used_count());
+    EXPECT_EQ(16, block->AllocateLabel());
+    block->ReleaseLabel(16);
+    for (int idx = 60; idx < 100; idx++) {
+        block->ReleaseLabel(16 + idx);
+    }
+    EXPECT_EQ(0, block->used_count());
+}
+
+// A block with last less than first has no labels to hand out.
+TEST_F(LabelBlockTest, InvertedRange) {
+    LabelBlockPtr block = manager_->LocateBlock(100, 50);
+    EXPECT_EQ(1, BlockCount());
+    EXPECT_EQ(0, block->label_count());
+    EXPECT_EQ(0, block->AllocateLabel());
+    vector<uint32_t> labels;
+    EXPECT_FALSE(block->AllocateLabels(1, &labels));
+    EXPECT_TRUE(labels.empty());
+    EXPECT_EQ(0, block->AllocateLabelRange(1));
+    EXPECT_EQ(0, block->used_count());
+    EXPECT_EQ(3, block->alloc_fail_count());
+    EXPECT_EQ(0, BitmapWords(block.get()));
+}
+
+// A block covering the whole label space only grows its bitmap as far as
+// the labels that get allocated.
+TEST_F(LabelBlockTest, HugeRange) {
+    LabelBlockPtr block = manager_->LocateBlock(1, 0xFFFFFFFF);
+    uint64_t label_count = block->label_count();
+    EXPECT_EQ(0xFFFFFFFFULL, label_count);
+    EXPECT_EQ(0, BitmapWords(block.get()));
+
+    for (int idx = 0; idx < 100; idx++) {
+        EXPECT_EQ(1 + idx, block->AllocateLabel());
+    }
+    EXPECT_EQ(2, BitmapWords(block.get()));
+    EXPECT_EQ(101, block->AllocateLabelRange(200));
+    EXPECT_EQ(5, BitmapWords(block.get()));
+    EXPECT_EQ(300, block->used_count());
+
+    block->ReleaseLabelRange(101, 200);
+    for (int idx = 0; idx < 100; idx++) {
+        block->ReleaseLabel(1 + idx);
+    }
+    EXPECT_EQ(0, block->used_count());
+}
+
+// Churn through alloc/free cycles on a block of 1M labels that is kept
+// mostly full, so that every allocation needs to search past allocated
+// labels. The rate is printed and not checked.
+TEST_F(LabelBlockTest, DISABLED_ChurnBenchmark) {
+    const uint32_t kLabelCount = 1024 * 1024;
+    const int kIterations = 1000000;
+    LabelBlockPtr block = manager_->LocateBlock(16, 16 + kLabelCount - 1);
+    vector<uint32_t> labels;
+    uint64_t start = ClockMonotonicUsec();
+    EXPECT_TRUE(block->AllocateLabels(kLabelCount - 1024, &labels));
+    uint64_t bulk_alloc = ClockMonotonicUsec() - start;
+
+    start = ClockMonotonicUsec();
+    size_t seed = 1;
+    for (int idx = 0; idx < kIterations; idx++) {
+        seed = seed * 1103515245 + 12345;
+        size_t slot = (seed >> 16) % labels.size();
+        block->ReleaseLabel(labels[slot]);
+        labels[slot] = block->AllocateLabel();
+        EXPECT_NE(0, labels[slot]);
+    }
+    uint64_t churn = ClockMonotonicUsec() - start;
+    EXPECT_EQ(kLabelCount - 1024, block->used_count());
+    block->ReleaseLabels(labels);
+    EXPECT_EQ(0, block->used_count());
+    std::cout << "Allocated " << kLabelCount - 1024 << " labels in " <<
+        bulk_alloc << " usec, " << kIterations << " alloc/free cycles in " <<
+        churn << " usec" << std::endl;
+}
+
 void LabelBlockTest::ConcurrencyRun() {
     LabelBlockPtr block = manager_->LocateBlock(1000, 1500 - 1);
     EXPECT_EQ(1, BlockCount());
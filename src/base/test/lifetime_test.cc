@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "base/lifetime.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include "base/logging.h"
+#include "base/test/task_test_util.h"
+#include "testing/gunit.h"
+
+using namespace std;
+
+class LifetimeTest;
+
+class TestLifetimeManager : public LifetimeManager {
+public:
+    explicit TestLifetimeManager(int task_id) : LifetimeManager(task_id) {
+    }
+    virtual void SetQueueDisable(bool disabled) {
+        LifetimeManager::SetQueueDisable(disabled);
+    }
+};
+
+//
+// Managed object with an optional parent. The object is deleted when it's
+// actor is destroyed.
+//
+class TestObject {
+public:
+    class DeleteActor : public LifetimeActor {
+    public:
+        DeleteActor(LifetimeManager *manager, TestObject *object)
+            : LifetimeActor(manager), object_(object) {
+        }
+        virtual bool MayDelete() const { return true; }
+        virtual void Destroy();
+
+    private:
+        TestObject *object_;
+    };
+
+    TestObject(LifetimeTest *test, LifetimeManager *manager,
+               TestObject *parent)
+        : test_(test),
+          deleter_(new DeleteActor(manager, this)),
+          parent_delete_ref_(this, parent ? parent->deleter() : NULL) {
+    }
+
+    void ManagedDelete() { deleter_->Delete(); }
+    LifetimeActor *deleter() { return deleter_.get(); }
+
+private:
+    friend class DeleteActor;
+
+    LifetimeTest *test_;
+    boost::scoped_ptr<DeleteActor> deleter_;
+    LifetimeRef<TestObject> parent_delete_ref_;
+};
+
+class LifetimeTest : public ::testing::Test {
+public:
+    void ObjectDestroyed(TestObject *object) {
+        tbb::mutex::scoped_lock lock(mutex_);
+        destroyed_.push_back(object);
+        destroy_task_ids_.push_back(Task::Running()->GetTaskId());
+    }
+
+protected:
+    LifetimeTest()
+        : task_id_(TaskScheduler::GetInstance()->GetTaskId(
+              "::test::Lifetime")),
+          manager_(new TestLifetimeManager(task_id_)) {
+    }
+
+    virtual void TearDown() {
+        task_util::WaitForIdle();
+        manager_.reset();
+    }
+
+    size_t DestroyedCount() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return destroyed_.size();
+    }
+
+    uint64_t DestroyStatsCount() {
+        LifetimeManager::DestroyStatsMap stats_map;
+        manager_->GetDestroyStats(&stats_map);
+        if (stats_map.empty())
+            return 0;
+        EXPECT_EQ(1, stats_map.size());
+        const string &type_name = stats_map.begin()->first;
+        EXPECT_NE(string::npos, type_name.find("DeleteActor"));
+        return stats_map.begin()->second.count;
+    }
+
+    // Create a parent with count children and delete the parent.
+    TestObject *DeleteTree(size_t count) {
+        TestObject *parent = new TestObject(this, manager_.get(), NULL);
+        for (size_t idx = 0; idx < count; idx++) {
+            new TestObject(this, manager_.get(), parent);
+        }
+        parent->ManagedDelete();
+        return parent;
+    }
+
+    int task_id_;
+    boost::scoped_ptr<TestLifetimeManager> manager_;
+    tbb::mutex mutex_;
+    vector<TestObject *> destroyed_;
+    vector<int> destroy_task_ids_;
+};
+
+void TestObject::DeleteActor::Destroy() {
+    object_->test_->ObjectDestroyed(object_);
+    delete object_;
+}
+
+// Delete a parent with children. The parent must be destroyed after all of
+// it's children, in the LifetimeManager's task.
+TEST_F(LifetimeTest, DestroyTree) {
+    TestObject *parent = DeleteTree(100);
+    TASK_UTIL_EXPECT_EQ(101, DestroyedCount());
+    EXPECT_EQ(parent, destroyed_.back());
+    for (size_t idx = 0; idx < destroy_task_ids_.size(); idx++) {
+        EXPECT_EQ(task_id_, destroy_task_ids_[idx]);
+    }
+    TASK_UTIL_EXPECT_EQ(101, DestroyStatsCount());
+}
+
+// Delete a tree while the queue is disabled and verify that nothing gets
+// destroyed until the queue is enabled again.
+TEST_F(LifetimeTest, DestroyQueueDisable) {
+    manager_->SetQueueDisable(true);
+    DeleteTree(100);
+    task_util::WaitForIdle();
+    EXPECT_EQ(0, DestroyedCount());
+    EXPECT_EQ(0, DestroyStatsCount());
+    manager_->SetQueueDisable(false);
+    TASK_UTIL_EXPECT_EQ(101, DestroyedCount());
+    TASK_UTIL_EXPECT_EQ(101, DestroyStatsCount());
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
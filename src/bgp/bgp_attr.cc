@@ -389,6 +389,13 @@ EdgeDiscovery::Edge::Edge(const EdgeDiscoverySpec::Edge *spec_edge) {
     address = spec_edge->GetIp4Address();
     uint32_t first_label, last_label;
     spec_edge->GetLabels(&first_label, &last_label);
+
+    // A bad range from the peer results in an empty block, so that no labels
+    // get allocated from it.
+    if (first_label == 0 || first_label > last_label) {
+        first_label = 1;
+        last_label = 0;
+    }
     label_block = new LabelBlock(first_label, last_label);
 }
 
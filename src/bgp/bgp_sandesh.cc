@@ -12,6 +12,7 @@
 #include <sandesh/sandesh.h>
 #include <sandesh/request_pipeline.h>
 
+#include "base/lifetime.h"
 #include "base/time_util.h"
 #include "base/util.h"
 #include "bgp/bgp_config.h"
@@ -1867,6 +1868,54 @@ void ShowBgpServerReq::HandleRequest() const {
     RequestPipeline rp(ps);
 }
 
+class ShowLifetimeManagerHandler {
+public:
+    static bool CallbackS1(const Sandesh *sr,
+            const RequestPipeline::PipeSpec ps, int stage, int instNum,
+            RequestPipeline::InstData *data) {
+        const ShowLifetimeManagerReq *req =
+            static_cast<const ShowLifetimeManagerReq *>(ps.snhRequest_.get());
+        BgpSandeshContext *bsc =
+            static_cast<BgpSandeshContext *>(req->client_context());
+        LifetimeManager *manager = bsc->bgp_server->lifetime_manager();
+
+        LifetimeManager::DestroyStatsMap stats_map;
+        manager->GetDestroyStats(&stats_map);
+        vector<LifetimeDestroyStats> destroy_stats;
+        for (LifetimeManager::DestroyStatsMap::const_iterator it =
+             stats_map.begin(); it != stats_map.end(); ++it) {
+            LifetimeDestroyStats stats;
+            stats.set_actor_type(it->first);
+            stats.set_count(it->second.count);
+            stats.set_total_latency_usecs(it->second.total_latency_usecs);
+            stats.set_max_latency_usecs(it->second.max_latency_usecs);
+            stats.set_total_destroy_usecs(it->second.total_destroy_usecs);
+            destroy_stats.push_back(stats);
+        }
+
+        ShowLifetimeManagerResp *resp = new ShowLifetimeManagerResp;
+        resp->set_defer_count(manager->GetQueueDeferCount());
+        resp->set_destroy_stats(destroy_stats);
+        resp->set_context(req->context());
+        resp->Response();
+        return true;
+    }
+};
+
+void ShowLifetimeManagerReq::HandleRequest() const {
+    RequestPipeline::PipeSpec ps(this);
+
+    // Request pipeline has single stage to collect lifetime manager stats
+    // and respond to the request
+    RequestPipeline::StageSpec s1;
+    TaskScheduler *scheduler = TaskScheduler::GetInstance();
+    s1.taskId_ = scheduler->GetTaskId("bgp::ShowCommand");
+    s1.cbFn_ = ShowLifetimeManagerHandler::CallbackS1;
+    s1.instances_.push_back(0);
+    ps.stages_ = list_of(s1);
+    RequestPipeline rp(ps);
+}
+
 BgpSandeshContext::BgpSandeshContext()
         : bgp_server(NULL),
           xmpp_peer_manager(NULL),
@@ -917,7 +917,7 @@ bool BgpXmppChannel::ProcessMcastItem(string vrf_name,
         // Label Allocation item.entry.label by parsing the range
         if (!stringToIntegerList(
             item.entry.next_hops.next_hop[0].label, "-", labels) ||
-            labels.size() != 2) {
+            labels.size() != 2 || labels[0] == 0 || labels[0] > labels[1]) {
             BGP_LOG_PEER_INSTANCE(Peer(), vrf_name,
                 SandeshLevel::SYS_WARN, BGP_LOG_FLAG_ALL,
                 "Bad label block range: " <<
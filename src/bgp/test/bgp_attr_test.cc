@@ -1247,6 +1247,25 @@ TEST_F(BgpAttrTest, EdgeDiscovery5) {
     EXPECT_EQ(attr1->edge_discovery(), attr2.edge_discovery());
 }
 
+// An edge with a bad label range gets an empty label block.
+TEST_F(BgpAttrTest, EdgeDiscoveryBadLabels) {
+    BgpAttrSpec attr_spec;
+    EdgeDiscoverySpec edspec;
+    error_code ec;
+    EdgeDiscoverySpec::Edge *edge = new(EdgeDiscoverySpec::Edge);
+    edge->SetIp4Address(Ip4Address::from_string("10.1.1.1", ec));
+    edge->SetLabels(2000, 1000);
+    edspec.edge_list.push_back(edge);
+    attr_spec.push_back(&edspec);
+    BgpAttrPtr attr = attr_db_->Locate(attr_spec);
+
+    const EdgeDiscovery *ediscovery = attr->edge_discovery();
+    EXPECT_EQ(1, ediscovery->edge_list.size());
+    LabelBlockPtr label_block = ediscovery->edge_list.front()->label_block;
+    EXPECT_EQ(0, label_block->label_count());
+    EXPECT_EQ(0, label_block->AllocateLabel());
+}
+
 TEST_F(BgpAttrTest, EdgeDiscovery6) {
     BgpAttrSpec attr_spec1;
     EdgeDiscoverySpec edspec1;
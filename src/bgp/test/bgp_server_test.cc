@@ -83,6 +83,7 @@ protected:
     static void ValidateClearBgpNeighborResponse(Sandesh *sandesh,
                                                  bool success);
     static void ValidateShowBgpServerResponse(Sandesh *sandesh);
+    static void ValidateShowLifetimeManagerResponse(Sandesh *sandesh);
 
     BgpServerUnitTest() : a_session_manager_(NULL), b_session_manager_(NULL) {
         a_asn_update_notification_cnt_ = 0;
@@ -266,6 +267,28 @@ void BgpServerUnitTest::ValidateShowBgpServerResponse(Sandesh *sandesh) {
     validate_done_ = true;
 }
 
+void BgpServerUnitTest::ValidateShowLifetimeManagerResponse(
+    Sandesh *sandesh) {
+    ShowLifetimeManagerResp *resp =
+        dynamic_cast<ShowLifetimeManagerResp *>(sandesh);
+    EXPECT_TRUE(resp != NULL);
+    bool found = false;
+    const vector<LifetimeDestroyStats> &destroy_stats =
+        resp->get_destroy_stats();
+    for (vector<LifetimeDestroyStats>::const_iterator it =
+         destroy_stats.begin(); it != destroy_stats.end(); ++it) {
+        const LifetimeDestroyStats &stats = *it;
+        if (stats.get_actor_type() != "BgpPeer::DeleteActor")
+            continue;
+        found = true;
+        EXPECT_LE(3, stats.get_count());
+        EXPECT_LE(stats.get_max_latency_usecs(),
+                  stats.get_total_latency_usecs());
+    }
+    EXPECT_TRUE(found);
+    validate_done_ = true;
+}
+
 string BgpServerUnitTest::GetConfigStr(int peer_count,
         unsigned short port_a, unsigned short port_b,
         as_t as_num1, as_t as_num2,
@@ -2846,6 +2869,33 @@ TEST_F(BgpServerUnitTest, ShowBgpServer) {
     StateMachineTest::set_keepalive_time_msecs(0);
 }
 
+TEST_F(BgpServerUnitTest, ShowLifetimeManager) {
+    SetupPeers(3, a_->session_manager()->GetPort(),
+               b_->session_manager()->GetPort(), false);
+    VerifyPeers(3);
+
+    // Delete the peers on a_ so that their actors get destroyed.
+    SetupPeers(a_.get(), 3, a_->session_manager()->GetPort(),
+               b_->session_manager()->GetPort(), false,
+               BgpConfigManager::kDefaultAutonomousSystem,
+               BgpConfigManager::kDefaultAutonomousSystem,
+               "127.0.0.1", "127.0.0.1", "192.168.0.10", "192.168.0.11",
+               vector<string>(), vector<string>(), true);
+    TASK_UTIL_EXPECT_EQ(0, a_->num_bgp_peer());
+
+    BgpSandeshContext sandesh_context;
+    sandesh_context.bgp_server = a_.get();
+    Sandesh::set_client_context(&sandesh_context);
+    Sandesh::set_response_callback(
+        boost::bind(ValidateShowLifetimeManagerResponse, _1));
+    ShowLifetimeManagerReq *show_req = new ShowLifetimeManagerReq;
+    validate_done_ = false;
+    show_req->HandleRequest();
+    show_req->Release();
+    task_util::WaitForIdle();
+    TASK_UTIL_EXPECT_TRUE(validate_done_);
+}
+
 TEST_F(BgpServerUnitTest, BasicAdvertiseWithdraw) {
     SetupPeers(1, a_->session_manager()->GetPort(),
                b_->session_manager()->GetPort(), false);
@@ -348,6 +348,22 @@ TEST_F(BgpXmppMcastErrorTest, BadLabelBlock2) {
     EXPECT_TRUE(blue_table_->Size() == 0);
 }
 
+TEST_F(BgpXmppMcastErrorTest, BadLabelBlock3) {
+    agent_xa_->AddMcastRoute("blue", "225.0.0.1,90.1.1.1", "10.1.1.1", "20-10");
+    task_util::WaitForIdle();
+    ErmVpnTable *blue_table_ = static_cast<ErmVpnTable *>(
+        bs_x_->database()->FindTable("blue.ermvpn.0"));
+    EXPECT_TRUE(blue_table_->Size() == 0);
+}
+
+TEST_F(BgpXmppMcastErrorTest, BadLabelBlock4) {
+    agent_xa_->AddMcastRoute("blue", "225.0.0.1,90.1.1.1", "10.1.1.1", "0-10");
+    task_util::WaitForIdle();
+    ErmVpnTable *blue_table_ = static_cast<ErmVpnTable *>(
+        bs_x_->database()->FindTable("blue.ermvpn.0"));
+    EXPECT_TRUE(blue_table_->Size() == 0);
+}
+
 class BgpXmppMcastSubscriptionTest : public BgpXmppMcastTest {
 protected:
     virtual void SetUp() {
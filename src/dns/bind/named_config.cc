@@ -3,7 +3,9 @@
  */
 
 #include <cstdio>
+#include <cstring>
 #include <iomanip>
+#include <iterator>
 #include <assert.h>
 #include <errno.h>
 #include <sys/types.h>
@@ -65,13 +67,13 @@ void NamedConfig::AddView(const VirtualDnsConfig *vdns) {
 }
 
 void NamedConfig::ChangeView(const VirtualDnsConfig *vdns) {
-    UpdateNamedConf(vdns);
     std::string old_domain = vdns->GetOldDomainName();
     if (vdns->GetDomainName() != old_domain) {
         ZoneList zones;
         zones.push_back(old_domain);
         RemoveZoneFiles(vdns, zones);
     }
+    UpdateNamedConf(vdns);
 }
 
 void NamedConfig::DelView(const VirtualDnsConfig *vdns) {
@@ -100,7 +102,6 @@ void NamedConfig::AddZone(const Subnet &subnet, const VirtualDnsConfig *vdns) {
 }
 
 void NamedConfig::DelZone(const Subnet &subnet, const VirtualDnsConfig *vdns) {
-    UpdateNamedConf();
     ZoneList vdns_zones, snet_zones;
     MakeZoneList(vdns, vdns_zones);
     BindUtil::GetReverseZones(subnet, snet_zones);
@@ -117,11 +118,18 @@ void NamedConfig::DelZone(const Subnet &subnet, const VirtualDnsConfig *vdns) {
             i++;
     }
     RemoveZoneFiles(vdns, snet_zones);
+    UpdateNamedConf();
 }
 
 void NamedConfig::UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
-    CreateNamedConf(updated_vdns);
+    // reconfigure named only when named.conf or zone files have changed
+    if (!CreateNamedConf(updated_vdns))
+        return;
     sync();
+    Reconfig();
+}
+
+void NamedConfig::Reconfig() {
     // rndc_reconfig();
     // TODO: convert this to a call to rndc library
     std::stringstream str;
@@ -134,10 +142,14 @@ void NamedConfig::UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
     }
 }
 
-void NamedConfig::CreateNamedConf(const VirtualDnsConfig *updated_vdns) {
+// named.conf is generated into a temporary file, which replaces the current
+// one only if the content differs. Returns true if named.conf changed or any
+// zone file was written or removed since the last call.
+bool NamedConfig::CreateNamedConf(const VirtualDnsConfig *updated_vdns) {
      GetDefaultForwarders();
-     file_.open(named_config_file_.c_str());
-    
+     std::string tmp_file = named_config_file_ + ".tmp";
+     file_.open(tmp_file.c_str());
+
      WriteOptionsConfig();
      WriteRndcConfig();
      WriteLoggingConfig();
@@ -145,6 +157,33 @@ void NamedConfig::CreateNamedConf(const VirtualDnsConfig *updated_vdns) {
 
      file_.flush();
      file_.close();
+
+     bool zone_files_changed = zone_files_changed_;
+     zone_files_changed_ = false;
+     if (!reset_flag_ && FileContentEqual(tmp_file, named_config_file_)) {
+         remove(tmp_file.c_str());
+         return zone_files_changed;
+     }
+     if (rename(tmp_file.c_str(), named_config_file_.c_str()) != 0) {
+         LOG(WARN, "Unable to update " << named_config_file_ << " : " <<
+             strerror(errno));
+     }
+     return true;
+}
+
+bool NamedConfig::FileContentEqual(const std::string &file1,
+                                   const std::string &file2) {
+    std::ifstream f1(file1.c_str()), f2(file2.c_str());
+    if (!f1.is_open() || !f2.is_open())
+        return false;
+    std::istreambuf_iterator<char> it1(f1), it2(f2), end;
+    while (it1 != end && it2 != end) {
+        if (*it1 != *it2)
+            return false;
+        ++it1;
+        ++it2;
+    }
+    return (it1 == end && it2 == end);
 }
 
 void NamedConfig::CreateRndcConf() {
@@ -316,7 +355,8 @@ void NamedConfig::RemoveZoneFiles(const VirtualDnsConfig *vdns,
 
 void NamedConfig::RemoveZoneFile(const VirtualDnsConfig *vdns, string &zone) {
     string zfile_name = GetZoneFilePath(vdns->GetViewName(), zone);
-    remove(zfile_name.c_str());
+    if (remove(zfile_name.c_str()) == 0)
+        zone_files_changed_ = true;
     zfile_name.append(".jnl");
     remove(zfile_name.c_str());
 }
@@ -350,6 +390,7 @@ void NamedConfig::CreateZoneFile(std::string &zone_name,
     string ns_name;
     string zone_filename = GetZoneFilePath(vdns->GetViewName(), zone_name);
 
+    zone_files_changed_ = true;
     zfile.open(zone_filename.c_str());
     zfile << "$ORIGIN ." << endl;
     if (vdns->GetTtl() > 0) {
@@ -68,7 +68,8 @@ public:
                 const std::string& rndc_config_file,
                 const std::string& rndc_secret) :
         file_(), named_log_file_(named_log_file), rndc_secret_(rndc_secret),
-        reset_flag_(false), all_zone_files_(false) {
+        reset_flag_(false), all_zone_files_(false),
+        zone_files_changed_(false) {
             named_config_dir_ = named_config_dir + "/";
             named_config_file_ = named_config_dir_ + named_config_file;
             rndc_config_file_ = named_config_dir_ + rndc_config_file;
@@ -102,8 +103,11 @@ public:
     const std::string &named_config_file() const { return named_config_file_; }
 
 protected:
+    virtual void Reconfig();
     void CreateRndcConf();
-    void CreateNamedConf(const VirtualDnsConfig *updated_vdns);
+    bool CreateNamedConf(const VirtualDnsConfig *updated_vdns);
+    static bool FileContentEqual(const std::string &file1,
+                                 const std::string &file2);
     void WriteOptionsConfig();
     void WriteRndcConfig();
     void WriteLoggingConfig();
@@ -128,6 +132,7 @@ protected:
     std::string default_forwarders_;
     bool reset_flag_;
     bool all_zone_files_;
+    bool zone_files_changed_;
     static NamedConfig *singleton_;
 };
 
@@ -2,6 +2,7 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <algorithm>
 #include <cmn/dns.h>
 #include <bind/bind_util.h>
 #include <mgr/dns_mgr.h>
@@ -12,8 +13,34 @@
 
 uint16_t DnsManager::g_trans_id_;
 
+namespace {
+
+// Upper bound on the bytes taken by an item in a DNS update message : name,
+// type, class, ttl, rdlength and rdata, which is an address, a name (with
+// MX priority) or SOA names and counters
+uint32_t UpdateItemSize(const DnsItem &item) {
+    return item.name.size() + 2 + 10 + 2 +
+           std::max(item.data.size() + 2, (std::size_t) 16) +
+           item.soa.primary_ns.size() + 2 + item.soa.mailbox.size() + 2 + 20;
+}
+
+uint32_t UpdateSize(const std::string &view, const std::string &zone,
+                    const DnsItems &items) {
+    // header, zone and the view TXT record in the additional section
+    uint32_t size = sizeof(dnshdr) + zone.size() + 2 + 4;
+    size += 4 + 2 + 10 + 5 + view.size() + 1;
+    for (DnsItems::const_iterator it = items.begin(); it != items.end(); ++it)
+        size += UpdateItemSize(*it);
+    return size;
+}
+
+}  // namespace
+
 DnsManager::DnsManager()
     : bind_status_(boost::bind(&DnsManager::BindEventHandler, this, _1)),
+      update_trigger_(boost::bind(&DnsManager::SendQueuedUpdates, this),
+                      TaskScheduler::GetInstance()->GetTaskId("dns::Config"), 0),
+      update_count_(0), update_record_count_(0),
       pending_done_queue_(TaskScheduler::GetInstance()->GetTaskId("dns::Config"), 0,
                           boost::bind(&DnsManager::PendingDone, this, _1)) {
     std::vector<BindResolver::DnsServer> bind_servers;
@@ -59,6 +86,7 @@ void DnsManager::Initialize(DB *config_db, DBGraph *config_graph,
 }
 
 DnsManager::~DnsManager() {
+    update_trigger_.Reset();
     pending_timer_->Cancel();
     TimerManager::DeleteTimer(pending_timer_);
     pending_done_queue_.Shutdown();
@@ -288,16 +316,53 @@ bool DnsManager::SendRecordUpdate(BindUtil::Operation op,
     return true;
 }
 
+// Updates are queued and coalesced per view and zone into messages of up to
+// BindResolver::max_pkt_size. Queued updates are sent while there are less
+// than kMaxPendingUpdates updates waiting for a response from named.
 void DnsManager::SendUpdate(BindUtil::Operation op, const std::string &view,
                             const std::string &zone, DnsItems &items) {
+    // append to the last update queued for the zone; an update with another
+    // operation for the zone is queued behind it to retain the order
+    UpdateQueue::reverse_iterator it;
+    for (it = update_queue_.rbegin(); it != update_queue_.rend(); ++it) {
+        if (it->view == view && it->zone == zone)
+            break;
+    }
+    if (it != update_queue_.rend() && it->op == op) {
+        DnsItems merged(it->items);
+        merged.insert(merged.end(), items.begin(), items.end());
+        if (UpdateSize(view, zone, merged) <=
+            (uint32_t) BindResolver::max_pkt_size) {
+            it->items.swap(merged);
+            update_trigger_.Set();
+            return;
+        }
+    }
+    update_queue_.push_back(PendingList(0, view, zone, items, op));
+    update_trigger_.Set();
+}
+
+bool DnsManager::SendQueuedUpdates() {
+    while (!update_queue_.empty() &&
+           pending_map_.size() < kMaxPendingUpdates) {
+        SendPendingUpdate(update_queue_.front());
+        update_queue_.pop_front();
+    }
+    return true;
+}
+
+void DnsManager::SendPendingUpdate(const PendingList &update) {
     uint8_t *pkt = new uint8_t[BindResolver::max_pkt_size];
     uint16_t xid = GetTransId();
-    int len = BindUtil::BuildDnsUpdate(pkt, op, xid, view, zone, items);
+    int len = BindUtil::BuildDnsUpdate(pkt, update.op, xid, update.view,
+                                       update.zone, update.items);
     if (BindResolver::Resolver()->DnsSend(pkt, 0, len)) {
         DNS_BIND_TRACE(DnsBindTrace, "DNS Update sent for DNS record; xid = " <<
-                   xid << "; View = " << view << "; Zone = " << zone << "; " <<
-                   DnsItemsToString(items));
-        AddPendingList(xid, view, zone, items, op);
+                   xid << "; View = " << update.view << "; Zone = " <<
+                   update.zone << "; " << DnsItemsToString(update.items));
+        update_count_++;
+        update_record_count_ += update.items.size();
+        AddPendingList(xid, update.view, update.zone, update.items, update.op);
     }
 }
 
@@ -363,19 +428,27 @@ void DnsManager::HandleUpdateResponse(uint8_t *pkt) {
 
 bool DnsManager::PendingDone(uint16_t xid) {
     DeletePendingList(xid);
+    if (!update_queue_.empty())
+        update_trigger_.Set();
     return true;
 }
 
 void DnsManager::ResendAllRecords() {
     for (PendingListMap::iterator it = pending_map_.begin();
          it != pending_map_.end(); ) {
-        SendRetransmit(it->first, it->second.op, it->second.view,
-                       it->second.zone, it->second.items);
+        // an update whose items were all superseded is not resent, but it
+        // is still in flight and holds its slot until it times out
+        if (!it->second.items.empty()) {
+            SendRetransmit(it->first, it->second.op, it->second.view,
+                           it->second.zone, it->second.items);
+        }
         it->second.retransmit_count++;
         if (it->second.retransmit_count > kMaxRetransmitCount) {
             DNS_BIND_TRACE(DnsBindTrace, "DNS records max retransmits reached;"
                            << "no more retransmission; xid = " << it->first);
             pending_map_.erase(it++);
+            if (!update_queue_.empty())
+                update_trigger_.Set();
         } else {
             it++;
         }
@@ -402,18 +475,19 @@ void DnsManager::AddPendingList(uint16_t xid, const std::string &view,
 }
 
 // if there is an update for an item which is already in pending list,
-// remove it from the pending list
+// remove the item from the pending list. The update itself stays in the
+// list, even if no items are left, as it is in flight until named responds
 void DnsManager::UpdatePendingList(const std::string &view,
                                    const std::string &zone,
                                    const DnsItems &items) {
     for (PendingListMap::iterator it = pending_map_.begin();
-         it != pending_map_.end(); ) {
-        if (it->second.view == view &&
-            it->second.zone == zone &&
-            it->second.items == items)
-            pending_map_.erase(it++);
-        else
-            it++;
+         it != pending_map_.end(); ++it) {
+        if (it->second.view != view || it->second.zone != zone)
+            continue;
+        for (DnsItems::const_iterator item = items.begin();
+             item != items.end(); ++item) {
+            it->second.items.remove(*item);
+        }
     }
 }
 
@@ -425,6 +499,10 @@ void DnsManager::ClearPendingList() {
     pending_map_.clear();
 }
 
+void DnsManager::ClearUpdateQueue() {
+    update_queue_.clear();
+}
+
 // Remove entries from pending list, upon a view delete
 void DnsManager::PendingListViewDelete(const VirtualDnsConfig *config) {
     for (PendingListMap::iterator it = pending_map_.begin();
@@ -434,6 +512,13 @@ void DnsManager::PendingListViewDelete(const VirtualDnsConfig *config) {
         else
             it++;
     }
+    for (UpdateQueue::iterator it = update_queue_.begin();
+         it != update_queue_.end(); ) {
+        if (it->view == config->GetViewName())
+            update_queue_.erase(it++);
+        else
+            it++;
+    }
 }
 
 bool DnsManager::CheckZoneDelete(ZoneList &zones, PendingList &pend) {
@@ -458,6 +543,13 @@ void DnsManager::PendingListZoneDelete(const Subnet &subnet,
         else
             it++;
     }
+    for (UpdateQueue::iterator it = update_queue_.begin();
+         it != update_queue_.end(); ) {
+        if (it->view == config->GetViewName() && CheckZoneDelete(zones, *it))
+            update_queue_.erase(it++);
+        else
+            it++;
+    }
 }
 
 void DnsManager::StartPendingTimer() {
@@ -510,6 +602,7 @@ void DnsManager::BindEventHandler(BindStatus::Event event) {
             NamedConfig *ncfg = NamedConfig::GetNamedConfigObject();
             ncfg->Reset();
             ClearPendingList();
+            ClearUpdateQueue();
             break;
         }
 
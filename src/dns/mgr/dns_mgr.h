@@ -5,7 +5,9 @@
 #ifndef __dns_manager_h__
 #define __dns_manager_h__
 
+#include <list>
 #include <tbb/mutex.h>
+#include <base/task_trigger.h>
 #include <mgr/dns_oper.h>
 #include <bind/named_config.h>
 #include <cfg/dns_config.h>
@@ -20,6 +22,8 @@ public:
     static const int max_records_per_sandesh = 200;
     static const uint32_t kPendingRecordRetransmitTime = 3000; // milliseconds
     static const uint32_t kMaxRetransmitCount = 32;
+    // DNS updates sent to named and not yet acknowledged
+    static const uint32_t kMaxPendingUpdates = 64;
 
     struct PendingList {
         uint16_t xid;
@@ -42,6 +46,8 @@ public:
     };
     typedef std::map<uint16_t, PendingList> PendingListMap;
     typedef std::pair<uint16_t, PendingList> PendingListPair;
+    // updates waiting for a slot in the pending window, xid is not assigned
+    typedef std::list<PendingList> UpdateQueue;
 
     DnsManager();
     virtual ~DnsManager();
@@ -72,11 +78,18 @@ public:
     void ProcessAgentUpdate(BindUtil::Operation event, const std::string &name,
                             const std::string &vdns_name, const DnsItem &item);
 
+    uint64_t update_count() const { return update_count_; }
+    uint64_t update_record_count() const { return update_record_count_; }
+    uint32_t pending_count() const { return pending_map_.size(); }
+    uint32_t queued_update_count() const { return update_queue_.size(); }
+
 private:
     friend class DnsBindTest;
 
     bool SendRecordUpdate(BindUtil::Operation op, 
                           const VirtualDnsRecordConfig *config);
+    bool SendQueuedUpdates();
+    void SendPendingUpdate(const PendingList &update);
     bool PendingDone(uint16_t xid);
     void ResendRecord(uint16_t xid);
     void ResendAllRecords();
@@ -86,6 +99,7 @@ private:
     void UpdatePendingList(const std::string &view,
                                        const std::string &zone,
                                        const DnsItems &items);
+    void ClearUpdateQueue();
     void DeletePendingList(uint16_t xid);
     void ClearPendingList();
     void PendingListViewDelete(const VirtualDnsConfig *config);
@@ -103,6 +117,10 @@ private:
     DnsConfigManager config_mgr_;    
     static uint16_t g_trans_id_;
     PendingListMap pending_map_;
+    UpdateQueue update_queue_;
+    TaskTrigger update_trigger_;
+    uint64_t update_count_;
+    uint64_t update_record_count_;
     Timer *pending_timer_;
     WorkQueue<uint16_t> pending_done_queue_;
 
@@ -3,11 +3,14 @@
  */
 
 #include <fstream>
+#include <sstream>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/bind.hpp>
+#include <tbb/atomic.h>
 
 #include "base/logging.h"
 #include "base/task.h"
+#include "base/time_util.h"
 #include "base/test/task_test_util.h"
 #include "db/db.h"
 #include "db/db_graph.h"
@@ -18,9 +21,11 @@
 #include "ifmap/ifmap_server_parser.h"
 #include "ifmap/test/ifmap_test_util.h"
 #include "io/event_manager.h"
+#include "io/test/event_manager_test.h"
 #include "schema/vnc_cfg_types.h"
 #include "cmn/dns.h"
 #include "bind/bind_util.h"
+#include "bind/bind_resolver.h"
 #include "cfg/dns_config.h"
 #include "cfg/dns_config.h"
 #include "cfg/dns_config_parser.h"
@@ -34,7 +39,8 @@ class NamedConfigTest : public NamedConfig {
 public:
     NamedConfigTest(const std::string &conf_dir, const std::string &conf_file) :
                     NamedConfig(conf_dir, conf_file, "/var/log/named/bind.log",
-                                "rndc.conf", "xvysmOR8lnUQRBcunkC6vg==") {}
+                                "rndc.conf", "xvysmOR8lnUQRBcunkC6vg=="),
+                    reconfig_count_(0) {}
     static void Init() {
         assert(singleton_ == NULL);
         singleton_ = new NamedConfigTest(".", "named.conf");
@@ -46,9 +52,8 @@ public:
         remove("./named.conf");
         remove("./rndc.conf");
     }
-    virtual void UpdateNamedConf(const VirtualDnsConfig *updated_vdns) {
-        CreateNamedConf(updated_vdns);
-    }
+    virtual void Reconfig() { reconfig_count_++; }
+    int reconfig_count() const { return reconfig_count_; }
     std::string GetZoneFileName(const std::string &vdns, 
                                 const std::string &name) {
         if (name.size() && name.at(name.size() - 1) == '.')
@@ -64,6 +69,10 @@ public:
         return GetZoneFilePath("", name);
     }
     std::string GetResolveFile() { return ""; }
+    bool Regenerate() { return CreateNamedConf(NULL); }
+
+private:
+    int reconfig_count_;
 };
 
 static bool FileExists(const char *file) {
@@ -130,6 +139,51 @@ static bool FilesEqual(const char *file1, const char *file2) {
     return ret;
 }
 
+// Stands in for named : acknowledges every DNS update it receives
+class StubBindResponder {
+public:
+    explicit StubBindResponder(boost::asio::io_service &io)
+        : sock_(io, boost::asio::ip::udp::endpoint(
+                        boost::asio::ip::address::from_string("127.0.0.1"), 0)),
+          response_count_(0) {
+        AsyncRead();
+    }
+
+    uint16_t port() const { return sock_.local_endpoint().port(); }
+    uint32_t response_count() const { return response_count_; }
+
+private:
+    void AsyncRead() {
+        sock_.async_receive_from(boost::asio::buffer(buf_, sizeof(buf_)),
+            remote_, boost::bind(&StubBindResponder::ReadHandler, this,
+                                 boost::asio::placeholders::error,
+                                 boost::asio::placeholders::bytes_transferred));
+    }
+
+    void ReadHandler(const boost::system::error_code &error,
+                     std::size_t length) {
+        if (error)
+            return;
+        if (length >= sizeof(dnshdr)) {
+            dnshdr *dns = (dnshdr *) buf_;
+            dns->flags.req = 1;
+            dns->flags.ret = 0;
+            dns->ques_rrcount = dns->ans_rrcount = 0;
+            dns->auth_rrcount = dns->add_rrcount = 0;
+            boost::system::error_code ec;
+            sock_.send_to(boost::asio::buffer(buf_, sizeof(dnshdr)), remote_,
+                          0, ec);
+            response_count_++;
+        }
+        AsyncRead();
+    }
+
+    boost::asio::ip::udp::socket sock_;
+    boost::asio::ip::udp::endpoint remote_;
+    uint8_t buf_[BindResolver::max_pkt_size];
+    tbb::atomic<uint32_t> response_count_;
+};
+
 class DnsBindTest : public ::testing::Test {
 protected:
 
@@ -154,6 +208,24 @@ protected:
     }
     DB db_;
     DBGraph db_graph_;
+    void SendRecords(int start, int count) {
+        for (int i = start; i < start + count; i++) {
+            std::stringstream name, data;
+            name << "host-" << i << ".test.example.com";
+            data << "1.1." << (i / 256) % 256 << "." << i % 256;
+            DnsItem item;
+            item.eclass = DNS_CLASS_IN;
+            item.type = DNS_A_RECORD;
+            item.ttl = 86400;
+            item.name = name.str();
+            item.data = data.str();
+            DnsItems items;
+            items.push_back(item);
+            dns_manager_.SendUpdate(BindUtil::ADD_UPDATE, "test-view",
+                                    "test.example.com", items);
+        }
+    }
+
     DnsManager dns_manager_;
     DnsConfigParser parser_;
 };
@@ -494,6 +566,135 @@ TEST_F(DnsBindTest, Reordered) {
     }
 }
 
+// named.conf is replaced only when its content changes
+TEST_F(DnsBindTest, NamedConfUnchanged) {
+    NamedConfigTest *cfg =
+        static_cast<NamedConfigTest *>(NamedConfig::GetNamedConfigObject());
+    cfg->Regenerate();
+    EXPECT_FALSE(cfg->Regenerate());
+    EXPECT_TRUE(FileExists("./named.conf"));
+    EXPECT_FALSE(FileExists("./named.conf.tmp"));
+}
+
+// named is reconfigured when a zone file is added or removed even though
+// named.conf is unchanged
+TEST_F(DnsBindTest, ZoneFilesNamedConfUnchanged) {
+    string content = FileRead("controller/src/dns/testdata/config_test_2.xml");
+    EXPECT_TRUE(parser_.Parse(content));
+    task_util::WaitForIdle();
+    NamedConfigTest *cfg =
+        static_cast<NamedConfigTest *>(NamedConfig::GetNamedConfigObject());
+    VirtualDnsConfig *vdns = VirtualDnsConfig::Find("new-DNS");
+    ASSERT_TRUE(vdns != NULL);
+    EXPECT_FALSE(cfg->Regenerate());
+
+    // subnet not in the configuration, only its zone file is written
+    Subnet subnet("7.8.9.0", 24);
+    string zone_file = cfg->GetZoneFilePath("9.8.7.in-addr.arpa");
+    int reconfig_count = cfg->reconfig_count();
+    cfg->AddZone(subnet, vdns);
+    EXPECT_TRUE(FileExists(zone_file.c_str()));
+    EXPECT_EQ(reconfig_count + 1, cfg->reconfig_count());
+    EXPECT_FALSE(cfg->Regenerate());
+
+    cfg->DelZone(subnet, vdns);
+    EXPECT_FALSE(FileExists(zone_file.c_str()));
+    EXPECT_EQ(reconfig_count + 2, cfg->reconfig_count());
+    EXPECT_FALSE(cfg->Regenerate());
+
+    // nothing left to remove
+    cfg->DelZone(subnet, vdns);
+    EXPECT_EQ(reconfig_count + 2, cfg->reconfig_count());
+
+    // subnet still in use, its zone file is kept
+    Subnet used_subnet("1.2.3.0", 24);
+    string used_zone_file = cfg->GetZoneFilePath("3.2.1.in-addr.arpa");
+    EXPECT_TRUE(FileExists(used_zone_file.c_str()));
+    cfg->DelZone(used_subnet, vdns);
+    EXPECT_TRUE(FileExists(used_zone_file.c_str()));
+    EXPECT_EQ(reconfig_count + 2, cfg->reconfig_count());
+
+    boost::replace_all(content, "<config>", "<delete>");
+    boost::replace_all(content, "</config>", "</delete>");
+    EXPECT_TRUE(parser_.Parse(content));
+    task_util::WaitForIdle();
+}
+
+// Record updates for a zone are coalesced into a few messages and the
+// number of updates waiting for named is bounded
+TEST_F(DnsBindTest, UpdateBatching) {
+    const int record_count = 1000;
+    TaskScheduler::GetInstance()->Stop();
+    SendRecords(0, record_count);
+    uint32_t messages = dns_manager_.queued_update_count();
+    EXPECT_LT(messages, (uint32_t) record_count / 10);
+    TaskScheduler::GetInstance()->Start();
+    task_util::WaitForIdle();
+
+    EXPECT_EQ(messages, dns_manager_.update_count() +
+                        dns_manager_.queued_update_count());
+    uint32_t max_pending = DnsManager::kMaxPendingUpdates;
+    EXPECT_LE(dns_manager_.pending_count(), max_pending);
+    EXPECT_EQ(dns_manager_.update_count(), dns_manager_.pending_count());
+    LOG(DEBUG, "DNS records : " << record_count << " sent in " <<
+        dns_manager_.update_count() << " updates, " <<
+        dns_manager_.queued_update_count() << " updates queued");
+}
+
+// An update whose records are all superseded by a later update is still
+// waiting for named and keeps its slot in the window
+TEST_F(DnsBindTest, PrunedUpdateInWindow) {
+    const uint32_t max_pending = DnsManager::kMaxPendingUpdates;
+    for (uint32_t i = 0; i <= max_pending; i++) {
+        TaskScheduler::GetInstance()->Stop();
+        SendRecords(0, 1);
+        TaskScheduler::GetInstance()->Start();
+        task_util::WaitForIdle();
+    }
+    EXPECT_EQ(max_pending, dns_manager_.update_count());
+    EXPECT_EQ(max_pending, dns_manager_.pending_count());
+    EXPECT_EQ(1U, dns_manager_.queued_update_count());
+}
+
+// Records per second sent to a stub named which acknowledges every update.
+// The resolver is moved to an event manager run by the test.
+TEST_F(DnsBindTest, UpdateRateStubResponder) {
+    const int record_count = 20000;
+    EventManager evm;
+    StubBindResponder responder(*evm.io_service());
+    std::vector<BindResolver::DnsServer> bind_servers;
+    bind_servers.push_back(BindResolver::DnsServer("127.0.0.1",
+                                                   responder.port()));
+    BindResolver::Shutdown();
+    BindResolver::Init(*evm.io_service(), bind_servers,
+                       boost::bind(&DnsManager::HandleUpdateResponse,
+                                   &dns_manager_, _1));
+    ServerThread thread(&evm);
+    thread.Start();
+
+    uint64_t start = ClockMonotonicUsec();
+    TaskScheduler::GetInstance()->Stop();
+    SendRecords(0, record_count);
+    TaskScheduler::GetInstance()->Start();
+    TASK_UTIL_EXPECT_EQ(0U, dns_manager_.queued_update_count());
+    TASK_UTIL_EXPECT_EQ(0U, dns_manager_.pending_count());
+    uint64_t elapsed = ClockMonotonicUsec() - start;
+
+    EXPECT_EQ(static_cast<uint64_t>(record_count),
+              dns_manager_.update_record_count());
+    // retransmits may be acknowledged too
+    EXPECT_LE(dns_manager_.update_count(), responder.response_count());
+    LOG(DEBUG, "DNS records : " << record_count << " in " <<
+        dns_manager_.update_count() << " updates acknowledged in " <<
+        elapsed / 1000 << " msec, " <<
+        (record_count * 1000000ULL) / (elapsed ? elapsed : 1) <<
+        " records/sec");
+
+    evm.Shutdown();
+    thread.Join();
+    BindResolver::Shutdown();
+}
+
 }  // namespace
 
 int main(int argc, char **argv) {
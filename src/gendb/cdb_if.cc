@@ -590,7 +590,7 @@ public:
         cdbif_->cdbq_.reset(new CdbIfQueue(
             scheduler->GetTaskId(task_id_), cdbif_->task_instance_,
             boost::bind(&CdbIf::Db_AsyncAddColumn, cdbif_, _1),
-            CdbIf::kQueueSize));
+            CdbIf::kQueueSize, CdbIf::kMaxBatchRows));
         cdbif_->cdbq_->SetStartRunnerFunc(
             boost::bind(&CdbIf::Db_IsInitDone, cdbif_));
         cdbif_->cdbq_->SetExitCallback(boost::bind(&CdbIf::Db_BatchAddColumn,
@@ -627,7 +627,11 @@ CdbIf::CdbIf(DbErrorHandler errhandler,
     only_sync_(only_sync),
     task_instance_(-1),
     prev_task_instance_(-1),
-    task_instance_initialized_(false) {
+    task_instance_initialized_(false),
+    batch_rows_(0),
+    batch_columns_(0),
+    batch_bytes_(0),
+    batch_start_time_(0) {
 
     // reduce connection timeout
     boost::shared_ptr<TSocket> tsocket = 
@@ -644,7 +648,11 @@ CdbIf::CdbIf() :
     only_sync_(false), 
     task_instance_(-1),
     prev_task_instance_(-1),
-    task_instance_initialized_(false) {
+    task_instance_initialized_(false),
+    batch_rows_(0),
+    batch_columns_(0),
+    batch_bytes_(0),
+    batch_start_time_(0) {
     db_init_done_ = false;
 }
 
@@ -1232,6 +1240,9 @@ bool CdbIf::Db_AsyncAddColumn(CdbIfColList &cl) {
         return true;
     }
     uint64_t ts(UTCTimestampUsec());
+    if (mutation_map_.empty()) {
+        batch_start_time_ = ts;
+    }
     std::string cfname(new_colp->cfname_);
     // Does the row key exist in the Cassandra mutation map ?
     std::string key_value;
@@ -1325,20 +1336,44 @@ bool CdbIf::Db_AsyncAddColumn(CdbIfColList &cl) {
     }
     // Update write stats
     UpdateCfWriteStats(cfname);
+    batch_rows_++;
+    batch_columns_ += new_colp->columns_.size();
+    batch_bytes_ += new_colp->GetSize();
     // Allocated when enqueued, free it after processing
     delete new_colp;
     cl.gendb_cl = NULL;
+    // Rest of the column lists dequeued in this run go into the next batch
+    if (Db_BatchBudgetExhausted()) {
+        Db_BatchAddColumn(false);
+    }
     return true;
 }
 
+bool CdbIf::Db_BatchBudgetExhausted() const {
+    if (batch_rows_ >= kMaxBatchRows || batch_bytes_ >= kMaxBatchBytes) {
+        return true;
+    }
+    return UTCTimestampUsec() - batch_start_time_ >= kMaxBatchTimeUsec;
+}
+
 void CdbIf::Db_BatchAddColumn(bool done) {
+    if (mutation_map_.empty()) {
+        return;
+    }
     CDBIF_BEGIN_TRY {
         client_->batch_mutate(mutation_map_,
             org::apache::cassandra::ConsistencyLevel::ONE);
     } CDBIF_END_TRY_LOG_INTERNAL(integerToString(mutation_map_.size()),
           false, false, true, CdbIfStats::CDBIF_STATS_ERR_WRITE_BATCH_COLUMN,
           CdbIfStats::CDBIF_STATS_CF_OP_NONE)
+    {
+        tbb::mutex::scoped_lock lock(smutex_);
+        stats_.UpdateWriteBatch(batch_rows_, batch_columns_, batch_bytes_);
+    }
     mutation_map_.clear();
+    batch_rows_ = 0;
+    batch_columns_ = 0;
+    batch_bytes_ = 0;
 }
 
 bool CdbIf::Db_AddColumn(std::auto_ptr<GenDb::ColList> cl) {
@@ -1639,6 +1674,12 @@ bool CdbIf::Db_GetStats(std::vector<DbTableInfo> *vdbti, DbErrors *dbe) {
     stats_.Get(vdbti, dbe);
     return true;
 }
+
+bool CdbIf::Db_GetWriteBatchStats(DbWriteBatchInfo *dbwbi) {
+    tbb::mutex::scoped_lock lock(smutex_);
+    stats_.GetWriteBatch(dbwbi);
+    return true;
+}
        
 void CdbIf::UpdateCfWriteStats(const std::string &cf_name) {
     tbb::mutex::scoped_lock lock(smutex_);
@@ -1728,6 +1769,15 @@ void CdbIf::CdbIfStats::Get(std::vector<DbTableInfo> *vdbti,
     derrors.Get(dbe);
 }
 
+void CdbIf::CdbIfStats::UpdateWriteBatch(uint64_t rows, uint64_t columns,
+    uint64_t bytes) {
+    write_batch_stats_.Update(rows, columns, bytes);
+}
+
+void CdbIf::CdbIfStats::GetWriteBatch(DbWriteBatchInfo *dbwbi) {
+    write_batch_stats_.Get(dbwbi);
+}
+
 // Errors
 CdbIf::CdbIfStats::Errors operator+(const CdbIf::CdbIfStats::Errors &a,
     const CdbIf::CdbIfStats::Errors &b) {
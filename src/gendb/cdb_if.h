@@ -65,6 +65,7 @@ public:
     // Stats
     virtual bool Db_GetStats(std::vector<GenDb::DbTableInfo> *vdbti,
         GenDb::DbErrors *dbe);
+    virtual bool Db_GetWriteBatchStats(GenDb::DbWriteBatchInfo *dbwbi);
     // Connection
     virtual std::string Db_GetHost() const;
     virtual int Db_GetPort() const;
@@ -159,9 +160,16 @@ private:
     bool Db_GetColumnfamily(CdbIfCfInfo **info, const std::string& cfname);
     bool Db_FindColumnfamily(const std::string& cfname);
     // Column
+    // Column lists dequeued in one run of the queue task, or until the
+    // byte or time budget of the batch is exhausted, are grouped by row
+    // key and column family into a single batch_mutate
+    static const size_t kMaxBatchRows = 512;
+    static const size_t kMaxBatchBytes = 2 * 1024 * 1024;
+    static const uint64_t kMaxBatchTimeUsec = 50 * 1000;
     bool Db_AsyncAddColumn(CdbIfColList &cl);
     bool Db_AsyncAddColumnLocked(CdbIfColList &cl);
     void Db_BatchAddColumn(bool done);
+    bool Db_BatchBudgetExhausted() const;
     // Read
     static const int kMaxQueryRows = 5000;
     // API to get range of column data for a range of rows 
@@ -214,7 +222,10 @@ private:
         void IncrementErrors(ErrorType type);
         void UpdateCf(const std::string &cf_name, bool write, bool fail);
         void Get(std::vector<GenDb::DbTableInfo> *vdbti, GenDb::DbErrors *dbe);
+        void UpdateWriteBatch(uint64_t rows, uint64_t columns, uint64_t bytes);
+        void GetWriteBatch(GenDb::DbWriteBatchInfo *dbwbi);
         GenDb::DbTableStatistics cf_stats_;
+        GenDb::DbWriteBatchStatistics write_batch_stats_;
         Errors db_errors_;
         Errors odb_errors_;
     };
@@ -261,6 +272,10 @@ private:
     typedef std::map<std::string, MutationList> CFMutationMap;
     typedef std::map<std::string, CFMutationMap> CassandraMutationMap;
     CassandraMutationMap mutation_map_;
+    size_t batch_rows_;
+    size_t batch_columns_;
+    size_t batch_bytes_;
+    uint64_t batch_start_time_;
     mutable tbb::mutex smutex_;
     CdbIfStats stats_;
     std::vector<DbQueueWaterMarkInfo> cdbq_wm_info_;
@@ -197,6 +197,7 @@ public:
     // Stats
     virtual bool Db_GetStats(std::vector<DbTableInfo> *vdbti,
         DbErrors *dbe) = 0;
+    virtual bool Db_GetWriteBatchStats(DbWriteBatchInfo *dbwbi) = 0;
     // Connection
     virtual std::string Db_GetHost() const = 0;
     virtual int Db_GetPort() const = 0;
@@ -2,6 +2,7 @@
 // Copyright (c) 2014 Juniper Networks, Inc. All rights reserved.
 //
 
+#include <base/time_util.h>
 #include <analytics/diffstats.h>
 #include "gendb_statistics.h"
 
@@ -73,4 +74,79 @@ void GenDb::DbTableStatistics::Get(std::vector<GenDb::DbTableInfo> *vdbti) {
         table_stats_map_, otable_stats_map_, *vdbti);
 }
 
+// DbWriteBatchStatistics
+const size_t GenDb::DbWriteBatchStatistics::kHistogramBuckets;
+// Upper bounds of the histogram buckets, 0 for the unbounded last bucket
+const uint64_t GenDb::DbWriteBatchStatistics::kRowsBuckets[] = {
+    1, 8, 64, 512, 4096, 0 };
+const uint64_t GenDb::DbWriteBatchStatistics::kBytesBuckets[] = {
+    1024, 16 * 1024, 128 * 1024, 1024 * 1024, 8 * 1024 * 1024, 0 };
+
+GenDb::DbWriteBatchStatistics::BatchStats::BatchStats() :
+    num_batches_(0),
+    num_rows_(0),
+    num_columns_(0),
+    num_bytes_(0) {
+    for (size_t i = 0; i < kHistogramBuckets; i++) {
+        rows_histogram_[i] = 0;
+        bytes_histogram_[i] = 0;
+    }
+}
+
+GenDb::DbWriteBatchStatistics::DbWriteBatchStatistics() :
+    oget_time_(UTCTimestampUsec()) {
+}
+
+void GenDb::DbWriteBatchStatistics::UpdateHistogram(uint64_t *histogram,
+    const uint64_t *bounds, uint64_t value) {
+    for (size_t i = 0; i < kHistogramBuckets; i++) {
+        if (bounds[i] == 0 || value <= bounds[i]) {
+            histogram[i]++;
+            return;
+        }
+    }
+}
+
+void GenDb::DbWriteBatchStatistics::GetHistogram(
+    std::vector<GenDb::DbBatchSizeBucket> *vbucket, const uint64_t *histogram,
+    const uint64_t *ohistogram, const uint64_t *bounds) {
+    for (size_t i = 0; i < kHistogramBuckets; i++) {
+        GenDb::DbBatchSizeBucket bucket;
+        bucket.set_max_size(bounds[i]);
+        bucket.set_batches(histogram[i] - ohistogram[i]);
+        vbucket->push_back(bucket);
+    }
+}
+
+void GenDb::DbWriteBatchStatistics::Update(uint64_t rows, uint64_t columns,
+    uint64_t bytes) {
+    batch_stats_.num_batches_++;
+    batch_stats_.num_rows_ += rows;
+    batch_stats_.num_columns_ += columns;
+    batch_stats_.num_bytes_ += bytes;
+    UpdateHistogram(batch_stats_.rows_histogram_, kRowsBuckets, rows);
+    UpdateHistogram(batch_stats_.bytes_histogram_, kBytesBuckets, bytes);
+}
+
+void GenDb::DbWriteBatchStatistics::Get(GenDb::DbWriteBatchInfo *info) {
+    uint64_t now(UTCTimestampUsec());
+    uint64_t rows(batch_stats_.num_rows_ - obatch_stats_.num_rows_);
+    info->set_batches(batch_stats_.num_batches_ - obatch_stats_.num_batches_);
+    info->set_rows(rows);
+    info->set_columns(batch_stats_.num_columns_ - obatch_stats_.num_columns_);
+    info->set_bytes(batch_stats_.num_bytes_ - obatch_stats_.num_bytes_);
+    uint64_t elapsed(now > oget_time_ ? now - oget_time_ : 0);
+    info->set_rows_per_sec(elapsed ? rows * 1000000 / elapsed : 0);
+    std::vector<GenDb::DbBatchSizeBucket> rows_histogram, bytes_histogram;
+    GetHistogram(&rows_histogram, batch_stats_.rows_histogram_,
+        obatch_stats_.rows_histogram_, kRowsBuckets);
+    GetHistogram(&bytes_histogram, batch_stats_.bytes_histogram_,
+        obatch_stats_.bytes_histogram_, kBytesBuckets);
+    info->set_rows_histogram(rows_histogram);
+    info->set_bytes_histogram(bytes_histogram);
+    // Update old
+    obatch_stats_ = batch_stats_;
+    oget_time_ = now;
+}
+
 }  // namespace GenDb
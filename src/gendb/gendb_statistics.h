@@ -47,6 +47,41 @@ class DbTableStatistics {
     TableStatsMap otable_stats_map_;
 };
 
+// Statistics of the batches written to the database. Get() returns the
+// counters accumulated since the previous Get()
+class DbWriteBatchStatistics {
+ public:
+    static const size_t kHistogramBuckets = 6;
+
+    DbWriteBatchStatistics();
+    void Update(uint64_t rows, uint64_t columns, uint64_t bytes);
+    void Get(GenDb::DbWriteBatchInfo *info);
+
+ private:
+    struct BatchStats {
+        BatchStats();
+        uint64_t num_batches_;
+        uint64_t num_rows_;
+        uint64_t num_columns_;
+        uint64_t num_bytes_;
+        uint64_t rows_histogram_[kHistogramBuckets];
+        uint64_t bytes_histogram_[kHistogramBuckets];
+    };
+
+    static void UpdateHistogram(uint64_t *histogram, const uint64_t *bounds,
+        uint64_t value);
+    static void GetHistogram(std::vector<GenDb::DbBatchSizeBucket> *vbucket,
+        const uint64_t *histogram, const uint64_t *ohistogram,
+        const uint64_t *bounds);
+
+    static const uint64_t kRowsBuckets[kHistogramBuckets];
+    static const uint64_t kBytesBuckets[kHistogramBuckets];
+
+    BatchStats batch_stats_;
+    BatchStats obatch_stats_;
+    uint64_t oget_time_;
+};
+
 }  // namespace GenDb
 
 #endif  // GENDB_GENDB_STATISTICS_H__
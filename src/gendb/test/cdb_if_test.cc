@@ -59,6 +59,13 @@ protected:
         stats_.IncrementErrors(
             CdbIf::CdbIfStats::CDBIF_STATS_ERR_READ_COLUMN);
     }
+    void UpdateWriteBatchStats(uint64_t rows, uint64_t columns,
+        uint64_t bytes) {
+        stats_.UpdateWriteBatch(rows, columns, bytes);
+    }
+    void GetWriteBatchStats(GenDb::DbWriteBatchInfo *dbwbi) {
+        stats_.GetWriteBatch(dbwbi);
+    }
     bool DbDataValueVecFromString(GenDb::DbDataValueVec& output,
         const GenDb::DbDataTypeVec& typevec, const std::string& input) {
         return dbif_.DbDataValueVecFromString(output, typevec, input);
@@ -330,6 +337,41 @@ TEST_F(CdbIfTest, Stats) {
     EXPECT_EQ(edbe_diffs, adbe_diffs); 
 }
 
+TEST_F(CdbIfTest, WriteBatchStats) {
+    UpdateWriteBatchStats(1, 4, 512);
+    UpdateWriteBatchStats(100, 600, 64 * 1024);
+    UpdateWriteBatchStats(10000, 20000, 16 * 1024 * 1024);
+    GenDb::DbWriteBatchInfo dbwbi;
+    GetWriteBatchStats(&dbwbi);
+    EXPECT_EQ(3, dbwbi.get_batches());
+    EXPECT_EQ(10101, dbwbi.get_rows());
+    EXPECT_EQ(20604, dbwbi.get_columns());
+    EXPECT_EQ(512 + 64 * 1024 + 16 * 1024 * 1024, dbwbi.get_bytes());
+    const std::vector<GenDb::DbBatchSizeBucket> &rows_histogram(
+        dbwbi.get_rows_histogram());
+    ASSERT_EQ(GenDb::DbWriteBatchStatistics::kHistogramBuckets,
+        rows_histogram.size());
+    // 1, 8, 64, 512, 4096, unbounded
+    EXPECT_EQ(1, rows_histogram[0].get_batches());
+    EXPECT_EQ(1, rows_histogram[3].get_batches());
+    EXPECT_EQ(1, rows_histogram[5].get_batches());
+    EXPECT_EQ(0, rows_histogram[5].get_max_size());
+    const std::vector<GenDb::DbBatchSizeBucket> &bytes_histogram(
+        dbwbi.get_bytes_histogram());
+    // 1K, 16K, 128K, 1M, 8M, unbounded
+    EXPECT_EQ(1, bytes_histogram[0].get_batches());
+    EXPECT_EQ(1, bytes_histogram[2].get_batches());
+    EXPECT_EQ(1, bytes_histogram[5].get_batches());
+    // Diffs
+    UpdateWriteBatchStats(2, 2, 100);
+    GenDb::DbWriteBatchInfo dbwbi_diffs;
+    GetWriteBatchStats(&dbwbi_diffs);
+    EXPECT_EQ(1, dbwbi_diffs.get_batches());
+    EXPECT_EQ(2, dbwbi_diffs.get_rows());
+    EXPECT_EQ(1, dbwbi_diffs.get_rows_histogram()[1].get_batches());
+    EXPECT_EQ(0, dbwbi_diffs.get_rows_histogram()[0].get_batches());
+}
+
 int main(int argc, char **argv) {
     LoggingInit();
     ::testing::InitGoogleTest(&argc, argv);
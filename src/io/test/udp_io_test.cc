@@ -355,6 +355,34 @@ TEST_F(UdpRecvTest, Basic) {
     task_util::WaitForIdle();
 }
 
+TEST_F(UdpRecvTest, Batch) {
+    server_->set_receive_batch(16);
+    server_->Initialize(0);
+    server_->StartReceive();
+    task_util::WaitForIdle();
+    boost::system::error_code ec;
+    boost::asio::ip::udp::endpoint ep = server_->GetLocalEndpoint(&ec);
+    ASSERT_LT(0, ep.port());
+    UdpLocalClient client(ep.port());
+    TASK_UTIL_EXPECT_TRUE(client.Connect());
+    // Queue the datagrams before the io_service runs so that they are
+    // read in batches
+    const char msg[] = "Test Message";
+    int len = 0;
+    for (int i = 0; i < 40; i++) {
+        len += client.Send((const u_int8_t *) msg, sizeof(msg));
+    }
+    EXPECT_EQ((int) (40 * sizeof(msg)), len);
+    thread_->Start();
+    TASK_UTIL_EXPECT_EQ(40, server_->GetNumRecvMsg());
+    SocketIOStats rx_stats;
+    server_->GetRxSocketStats(rx_stats);
+    EXPECT_EQ(40, rx_stats.calls);
+    EXPECT_EQ(len, rx_stats.bytes);
+    client.Close();
+    task_util::WaitForIdle();
+}
+
 }  // namespace
 
 int main(int argc, char **argv) {
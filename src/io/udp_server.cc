@@ -44,7 +44,8 @@ UdpServer::UdpServer(boost::asio::io_service *io_service, int buffer_size):
     socket_(*io_service),
     buffer_size_(buffer_size),
     state_(Uninitialized),
-    evm_(NULL) {
+    evm_(NULL),
+    receive_batch_(1) {
     if (reader_task_id_ == -1) {
         TaskScheduler *scheduler = TaskScheduler::GetInstance();
         reader_task_id_ = scheduler->GetTaskId("io::udp::ReaderTask");
@@ -57,7 +58,8 @@ UdpServer::UdpServer(EventManager *evm, int buffer_size):
     socket_(*(evm->io_service())),
     buffer_size_(buffer_size),
     state_(Uninitialized),
-    evm_(evm) {
+    evm_(evm),
+    receive_batch_(1) {
     if (reader_task_id_ == -1) {
         TaskScheduler *scheduler = TaskScheduler::GetInstance();
         reader_task_id_ = scheduler->GetTaskId("io::udp::ReaderTask");
@@ -81,14 +83,23 @@ UdpServer::~UdpServer() {
     assert(state_ == Uninitialized || state_ == SocketOpenFailed ||
            state_ == SocketBindFailed);
     assert(pbuf_.empty());
+    while (!free_pbuf_.empty()) {
+        delete[] free_pbuf_.back();
+        free_pbuf_.pop_back();
+    }
 }
 
 void UdpServer::Shutdown() {
     {
         tbb::mutex::scoped_lock lock(mutex_);
-        while (!pbuf_.empty()) {
-            delete[] pbuf_.back();
-            pbuf_.pop_back();
+        for (std::map<u_int8_t *, std::size_t>::iterator it = pbuf_.begin();
+             it != pbuf_.end(); ++it) {
+            delete[] it->first;
+        }
+        pbuf_.clear();
+        while (!free_pbuf_.empty()) {
+            delete[] free_pbuf_.back();
+            free_pbuf_.pop_back();
         }
     }
     if (socket_.is_open()) {
@@ -150,10 +161,17 @@ bool UdpServer::Initialize(udp::endpoint local_endpoint) {
 }
 
 mutable_buffer UdpServer::AllocateBuffer(std::size_t s) {
-    u_int8_t *p = new u_int8_t[s];
+    u_int8_t *p;
     {
         tbb::mutex::scoped_lock lock(mutex_);
-        pbuf_.push_back(p);
+        if (s == static_cast<std::size_t>(buffer_size_) &&
+            !free_pbuf_.empty()) {
+            p = free_pbuf_.back();
+            free_pbuf_.pop_back();
+        } else {
+            p = new u_int8_t[s];
+        }
+        pbuf_.insert(std::make_pair(p, s));
     }
     return mutable_buffer(p, s);
 }
@@ -162,14 +180,26 @@ mutable_buffer UdpServer::AllocateBuffer() {
     return AllocateBuffer(buffer_size_);
 }
 
+//
+// The buffer may have been trimmed to the bytes received, so the size it
+// was allocated with is looked up to decide whether it can be reused.
+//
 void UdpServer::DeallocateBuffer(const_buffer &buffer) {
-    const u_int8_t *p = buffer_cast<const uint8_t *>(buffer);
+    u_int8_t *p = const_cast<u_int8_t *>(
+        buffer_cast<const uint8_t *>(buffer));
     {
         tbb::mutex::scoped_lock lock(mutex_);
-        std::vector<u_int8_t *>::iterator f = std::find(pbuf_.begin(),
-            pbuf_.end(), p);
-        if (f != pbuf_.end())
+        std::map<u_int8_t *, std::size_t>::iterator f = pbuf_.find(p);
+        if (f != pbuf_.end()) {
+            bool reuse = f->second ==
+                static_cast<std::size_t>(buffer_size_) &&
+                free_pbuf_.size() < kMaxFreeBuffers;
             pbuf_.erase(f);
+            if (reuse) {
+                free_pbuf_.push_back(p);
+                return;
+            }
+        }
     }
     delete[] p;
 }
@@ -253,9 +283,49 @@ void UdpServer::HandleReceiveInternal(const_buffer recv_buffer,
     stats_.read_bytes += bytes_transferred;
     // Call the handler
     HandleReceive(recv_buffer, remote_endpoint_, bytes_transferred, error);
+    // Read the datagrams that queued up meanwhile, before going back to
+    // the io_service
+    for (size_t count = 1; count < receive_batch_; count++) {
+        if (!ReceiveQueued()) {
+            break;
+        }
+    }
     StartReceive();
 }
 
+//
+// Synchronously read a datagram if one is already queued on the socket.
+// Only called from the receive completion, when no asynchronous receive
+// is outstanding, so the read does not block.
+//
+bool UdpServer::ReceiveQueued() {
+    if (state_ != OK) {
+        return false;
+    }
+    boost::system::error_code error;
+    if (socket_.available(error) == 0 || error) {
+        return false;
+    }
+    mutable_buffer b(AllocateBuffer());
+    const_buffer buffer(buffer_cast<const uint8_t*>(b), buffer_size(b));
+    udp::endpoint remote_endpoint;
+    std::size_t bytes_transferred = socket_.receive_from(
+        mutable_buffers_1(b), remote_endpoint, 0, error);
+    if (error) {
+        stats_.read_errors++;
+        UDP_SERVER_LOG_ERROR(this, UDP_DIR_IN,
+            "Read FAILED due to error: " << error.value() << " : " <<
+            error.message());
+        DeallocateBuffer(buffer);
+        return false;
+    }
+    // Update read statistics.
+    stats_.read_calls++;
+    stats_.read_bytes += bytes_transferred;
+    HandleReceive(buffer, remote_endpoint, bytes_transferred, error);
+    return true;
+}
+
 void UdpServer::HandleReceive(const_buffer &recv_buffer,
     udp::endpoint remote_endpoint, std::size_t bytes_transferred,
     const boost::system::error_code& error) {
@@ -5,6 +5,7 @@
 #ifndef IO_UDP_SERVER_H_
 #define IO_UDP_SERVER_H_
 
+#include <map>
 #include <string>
 #include <vector>
 #include <boost/asio.hpp>
@@ -24,6 +25,8 @@ class UdpServer {
         SocketBindFailed,
     };
     static const int kDefaultBufferSize = 4 * 1024;
+    // Upper bound on the receive buffers kept for reuse
+    static const size_t kMaxFreeBuffers = 256;
 
     explicit UdpServer(EventManager *evm, int buffer_size = kDefaultBufferSize);
     explicit UdpServer(boost::asio::io_service *io_service,
@@ -39,6 +42,11 @@ class UdpServer {
     void StartSend(boost::asio::ip::udp::endpoint ep, std::size_t bytes_to_send,
             boost::asio::const_buffer buffer);
     void StartReceive();
+    // Number of datagrams read per receive completion. Datagrams already
+    // queued on the socket after the first one are read synchronously,
+    // up to count in all, before the next asynchronous receive is issued.
+    void set_receive_batch(size_t count) { receive_batch_ = count; }
+    size_t receive_batch() const { return receive_batch_; }
     // state
     ServerState GetServerState() { return state_; }
     boost::asio::ip::udp::endpoint GetLocalEndpoint(
@@ -93,6 +101,7 @@ class UdpServer {
             boost::asio::const_buffer recv_buffer,
             std::size_t bytes_transferred,
             const boost::system::error_code& error);
+    bool ReceiveQueued();
     void HandleSendInternal(boost::asio::const_buffer send_buffer,
             boost::asio::ip::udp::endpoint remote_endpoint,
             std::size_t bytes_transferred,
@@ -106,7 +115,11 @@ class UdpServer {
     std::string name_;
     boost::asio::ip::udp::endpoint remote_endpoint_;
     tbb::mutex mutex_;
-    std::vector<u_int8_t *> pbuf_;
+    // Allocated buffers and their sizes
+    std::map<u_int8_t *, std::size_t> pbuf_;
+    // Released buffers of buffer_size_ bytes, reused by AllocateBuffer
+    std::vector<u_int8_t *> free_pbuf_;
+    size_t receive_batch_;
     tbb::atomic<int> refcount_;
     io::SocketStats stats_;
 
@@ -27,8 +27,11 @@
 #include "ksync_object.h"
 #include "ksync_types.h"
 
-KSyncObject::FwdRefTree  KSyncObject::fwd_ref_tree_;
-KSyncObject::BackRefTree  KSyncObject::back_ref_tree_;
+tbb::atomic<uint32_t> KSyncObject::ref_count_;
+KSyncObject::BackRefTree KSyncObject::default_back_ref_tree_;
+tbb::mutex KSyncObject::default_ref_lock_;
+KSyncObject::ObjectSet KSyncObject::object_set_;
+tbb::mutex KSyncObject::object_set_lock_;
 KSyncObjectManager *KSyncObjectManager::singleton_;
 std::auto_ptr<KSyncEntry> KSyncObjectManager::default_defer_entry_;
 bool KSyncDebug::debug_;
@@ -44,6 +47,10 @@ KSyncObject::KSyncObject() : need_index_(false), index_table_(),
                          stale_entry_cleanup_timer_(NULL),
                          stale_entry_cleanup_intvl_(0),
                          stale_entries_per_intvl_(0) {
+    lock_acquire_count_ = 0;
+    lock_contention_count_ = 0;
+    tbb::mutex::scoped_lock lock(object_set_lock_);
+    object_set_.insert(this);
 }
 
 KSyncObject::KSyncObject(int max_index) : 
@@ -52,10 +59,22 @@ KSyncObject::KSyncObject(int max_index) :
                          stale_entry_cleanup_timer_(NULL),
                          stale_entry_cleanup_intvl_(0),
                          stale_entries_per_intvl_(0) {
+    lock_acquire_count_ = 0;
+    lock_contention_count_ = 0;
+    tbb::mutex::scoped_lock lock(object_set_lock_);
+    object_set_.insert(this);
 }
 
 KSyncObject::~KSyncObject() {
     assert(tree_.size() == 0);
+    // References hold the entries of the object they are kept in, so these
+    // can not be left once the tree is empty
+    assert(fwd_ref_tree_.size() == 0);
+    assert(back_ref_tree_.size() == 0);
+    {
+        tbb::mutex::scoped_lock lock(object_set_lock_);
+        object_set_.erase(this);
+    }
     if (stale_entry_cleanup_timer_ != NULL) {
         TimerManager::DeleteTimer(stale_entry_cleanup_timer_);
     }
@@ -77,8 +96,25 @@ void KSyncObject::InitStaleEntryCleanup(boost::asio::io_service &ios,
 }
 
 void KSyncObject::Shutdown() {
-    assert(fwd_ref_tree_.size() == 0);
-    assert(back_ref_tree_.size() == 0);
+    assert(ref_count_ == 0);
+}
+
+KSyncObject::ScopedLock::ScopedLock(KSyncObject *obj) {
+    if (lock_.try_acquire(obj->lock_) == false) {
+        obj->lock_contention_count_++;
+        lock_.acquire(obj->lock_);
+    }
+    obj->lock_acquire_count_++;
+}
+
+std::size_t KSyncObject::FwdRefCount() {
+    tbb::mutex::scoped_lock lock(ref_lock_);
+    return fwd_ref_tree_.size();
+}
+
+std::size_t KSyncObject::BackRefCount() {
+    tbb::mutex::scoped_lock lock(ref_lock_);
+    return back_ref_tree_.size();
 }
 
 KSyncEntry *KSyncObject::Find(const KSyncEntry *key) {
@@ -125,7 +161,7 @@ void KSyncObject::ClearStale(KSyncEntry *entry) {
 }
 
 KSyncEntry *KSyncObject::Create(const KSyncEntry *key) {
-    tbb::recursive_mutex::scoped_lock lock(lock_);
+    ScopedLock lock(this);
     KSyncEntry *entry = Find(key);
     if (entry == NULL) {
         entry = CreateImpl(key);
@@ -148,7 +184,7 @@ KSyncEntry *KSyncObject::CreateStale(const KSyncEntry *key) {
     // Should not be called without initialising stale entry
     // cleanup InitStaleEntryCleanup
     assert(stale_entry_cleanup_timer_ != NULL);
-    tbb::recursive_mutex::scoped_lock lock(lock_);
+    ScopedLock lock(this);
     KSyncEntry *entry = Find(key);
     if (entry == NULL) {
         entry = CreateImpl(key);
@@ -207,7 +243,7 @@ void KSyncObject::FreeInd(KSyncEntry *entry, uint32_t index) {
 
 void KSyncObject::SafeNotifyEvent(KSyncEntry *entry, 
                                   KSyncEntry::KSyncEvent event) {
-    tbb::recursive_mutex::scoped_lock lock(lock_);
+    ScopedLock lock(this);
     NotifyEvent(entry, event);
 }
 
@@ -294,7 +330,7 @@ void KSyncDBObject::CleanupOnDel(KSyncEntry *entry) {
 // Generates events for the KSyncEntry state-machine based DBEntry
 // Stores the KSyncEntry allocated as DBEntry-state
 void KSyncDBObject::Notify(DBTablePartBase *partition, DBEntryBase *e) {
-    tbb::recursive_mutex::scoped_lock lock(lock_);
+    ScopedLock lock(this);
     DBEntry *entry = static_cast<DBEntry *>(e);
     DBTableBase *table = partition->parent();
     assert(table_ == table);
@@ -1193,7 +1229,7 @@ void KSyncObject::NotifyEvent(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
 }
 
 void KSyncObject::NetlinkAckInternal(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
-    tbb::recursive_mutex::scoped_lock lock(lock_);
+    ScopedLock lock(this);
     entry->Response();
     NotifyEvent(entry, event);
 }
@@ -1228,38 +1264,76 @@ void KSyncObject::NetlinkAck(KSyncEntry *entry, KSyncEntry::KSyncEvent event) {
 ///////////////////////////////////////////////////////////////////////////////
 // KSyncEntry dependency management
 ///////////////////////////////////////////////////////////////////////////////
+// Back references to an entry are kept in the KSyncObject of the entry.
+// Entries without a KSyncObject (default_defer_entry) use a shared tree
+KSyncObject::BackRefTree *KSyncObject::GetBackRefTree(KSyncEntry *entry,
+                                                      tbb::mutex **lock) {
+    KSyncObject *obj = entry->GetObject();
+    if (obj == NULL) {
+        *lock = &default_ref_lock_;
+        return &default_back_ref_tree_;
+    }
+    *lock = &obj->ref_lock_;
+    return &obj->back_ref_tree_;
+}
+
 void KSyncObject::BackRefAdd(KSyncEntry *key, KSyncEntry *reference) {
-    KSyncFwdReference *fwd_node = new KSyncFwdReference(key, reference);
-    FwdRefTree::iterator fwd_it = fwd_ref_tree_.find(*fwd_node);
-    assert(fwd_it == fwd_ref_tree_.end());
-    fwd_ref_tree_.insert(*fwd_node);
     intrusive_ptr_add_ref(key);
     intrusive_ptr_add_ref(reference);
+    ref_count_++;
+
+    // Forward reference is kept in the object of the waiting entry
+    KSyncObject *key_obj = key->GetObject();
+    KSyncFwdReference *fwd_node = new KSyncFwdReference(key, reference);
+    {
+        tbb::mutex::scoped_lock lock(key_obj->ref_lock_);
+        FwdRefTree::iterator fwd_it = key_obj->fwd_ref_tree_.find(*fwd_node);
+        assert(fwd_it == key_obj->fwd_ref_tree_.end());
+        key_obj->fwd_ref_tree_.insert(*fwd_node);
+    }
 
+    // Back reference is kept in the object of the entry waited on
+    tbb::mutex *back_lock;
+    BackRefTree *back_tree = GetBackRefTree(reference, &back_lock);
     KSyncBackReference *back_node = new KSyncBackReference(reference, key);
-    BackRefTree::iterator back_it = back_ref_tree_.find(*back_node);
-    assert(back_it == back_ref_tree_.end());
-    back_ref_tree_.insert(*back_node);
+    {
+        tbb::mutex::scoped_lock lock(*back_lock);
+        BackRefTree::iterator back_it = back_tree->find(*back_node);
+        assert(back_it == back_tree->end());
+        back_tree->insert(*back_node);
+    }
 }
 
 void KSyncObject::BackRefDel(KSyncEntry *key) {
-    KSyncFwdReference fwd_search_node(key, NULL);
-    FwdRefTree::iterator fwd_it = fwd_ref_tree_.find(fwd_search_node);
-    if (fwd_it == fwd_ref_tree_.end()) {
-        return;
+    KSyncObject *key_obj = key->GetObject();
+    KSyncEntry *reference;
+    {
+        tbb::mutex::scoped_lock lock(key_obj->ref_lock_);
+        KSyncFwdReference fwd_search_node(key, NULL);
+        FwdRefTree::iterator fwd_it =
+            key_obj->fwd_ref_tree_.find(fwd_search_node);
+        if (fwd_it == key_obj->fwd_ref_tree_.end()) {
+            return;
+        }
+        KSyncFwdReference *entry = fwd_it.operator->();
+        reference = entry->reference_;
+        key_obj->fwd_ref_tree_.erase(fwd_it);
+        delete entry;
     }
-    KSyncFwdReference *entry = fwd_it.operator->();
-    KSyncEntry *reference = entry->reference_;
-    fwd_ref_tree_.erase(fwd_it);
-    delete entry;
 
-    KSyncBackReference back_search_node(reference, key);
-    BackRefTree::iterator back_it = back_ref_tree_.find(back_search_node);
-    assert(back_it != back_ref_tree_.end());
-    KSyncBackReference *back_node = back_it.operator->();
-    back_ref_tree_.erase(back_it);
-    delete back_node;
+    tbb::mutex *back_lock;
+    BackRefTree *back_tree = GetBackRefTree(reference, &back_lock);
+    {
+        tbb::mutex::scoped_lock lock(*back_lock);
+        KSyncBackReference back_search_node(reference, key);
+        BackRefTree::iterator back_it = back_tree->find(back_search_node);
+        assert(back_it != back_tree->end());
+        KSyncBackReference *back_node = back_it.operator->();
+        back_tree->erase(back_it);
+        delete back_node;
+    }
 
+    ref_count_--;
     intrusive_ptr_release(key);
     intrusive_ptr_release(reference);
 }
@@ -1267,21 +1341,28 @@ void KSyncObject::BackRefDel(KSyncEntry *key) {
 void KSyncObject::BackRefReEval(KSyncEntry *key) {
     std::vector<KSyncEntry *> buf;
     KSyncBackReference node(key, NULL);
-
-    for (BackRefTree::iterator it = back_ref_tree_.upper_bound(node); 
-         it != back_ref_tree_.end(); ) {
-        BackRefTree::iterator it_work = it++;
-
-        KSyncBackReference *entry = it_work.operator->();
-        if (entry->key_ != key) {
-            break;
+    tbb::mutex *back_lock;
+    BackRefTree *back_tree = GetBackRefTree(key, &back_lock);
+
+    {
+        tbb::mutex::scoped_lock lock(*back_lock);
+        BackRefTree::iterator it = back_tree->upper_bound(node);
+        for (; it != back_tree->end(); it++) {
+            KSyncBackReference *entry = it.operator->();
+            if (entry->key_ != key) {
+                break;
+            }
+            buf.push_back(entry->back_reference_);
         }
-        KSyncEntry *back_ref = entry->back_reference_;
-        buf.push_back(back_ref);
-        BackRefDel(entry->back_reference_);
     }
 
     std::vector<KSyncEntry *>::iterator it = buf.begin();
+    while (it != buf.end()) {
+        BackRefDel(*it);
+        it++;
+    }
+
+    it = buf.begin();
     while (it != buf.end()) {
         NotifyEvent(*it, KSyncEntry::RE_EVAL);
         it++;
@@ -1413,3 +1494,27 @@ KSyncEntry *KSyncObjectManager::default_defer_entry() {
     }
     return default_defer_entry_.get();
 }
+
+void KSyncObjectStatsReq::HandleRequest() const {
+    KSyncObjectStatsResp *resp = new KSyncObjectStatsResp();
+    std::vector<KSyncObjectStats> list;
+    {
+        tbb::mutex::scoped_lock lock(KSyncObject::object_set_lock_);
+        KSyncObject::ObjectSet::const_iterator it =
+            KSyncObject::object_set_.begin();
+        for (; it != KSyncObject::object_set_.end(); ++it) {
+            KSyncObject *obj = *it;
+            KSyncObjectStats stats;
+            stats.set_object(TYPE_NAME(*obj));
+            stats.set_entries(obj->Size());
+            stats.set_lock_acquired(obj->lock_acquire_count());
+            stats.set_lock_contended(obj->lock_contention_count());
+            stats.set_pending_references(obj->FwdRefCount());
+            stats.set_back_references(obj->BackRefCount());
+            list.push_back(stats);
+        }
+    }
+    resp->set_objects(list);
+    resp->set_context(context());
+    resp->Response();
+}
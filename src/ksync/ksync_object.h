@@ -5,6 +5,8 @@
 #ifndef ctrlplane_ksync_object_h 
 #define ctrlplane_ksync_object_h 
 
+#include <set>
+#include <tbb/atomic.h>
 #include <tbb/mutex.h>
 #include <tbb/recursive_mutex.h>
 #include <base/queue_task.h>
@@ -27,6 +29,11 @@
 // -------------
 // Holds forward reference information. If Object-A is waiting on Object-B
 // Fwd-Ref tree will have an entry with Object-A as key and Object-B as data.
+//
+// Each KSyncObject holds the Fwd-Ref entries of its own KSyncEntries and the
+// Back-Ref entries for its KSyncEntries being waited on, guarded by ref_lock_
+// of the object. ref_lock_ is a leaf lock, so KSyncObjects processing events
+// in parallel do not serialize on the reference trees.
 /////////////////////////////////////////////////////////////////////////////
 
 struct KSyncFwdReference {
@@ -139,18 +146,39 @@ public:
     void set_delete_scheduled() { delete_scheduled_ = true;}
     bool delete_scheduled() { return delete_scheduled_;}
 
+    // Number of times lock_ was taken, and number of times it was held by
+    // another thread when taken
+    uint64_t lock_acquire_count() const { return lock_acquire_count_; }
+    uint64_t lock_contention_count() const { return lock_contention_count_; }
+    // Number of KSyncEntries of the object waiting on a reference
+    std::size_t FwdRefCount();
+    // Number of references waiting on KSyncEntries of the object
+    std::size_t BackRefCount();
+
 protected:
+    // Scoped lock on lock_ of the object, counting lock contention
+    class ScopedLock {
+    public:
+        explicit ScopedLock(KSyncObject *obj);
+    private:
+        tbb::recursive_mutex::scoped_lock lock_;
+        DISALLOW_COPY_AND_ASSIGN(ScopedLock);
+    };
+
     // Create an entry with default state. Used internally
     KSyncEntry *CreateImpl(const KSyncEntry *key);
     // Clear Stale Entry flag
     void ClearStale(KSyncEntry *entry);
-    // Big lock on the tree
-    // TODO: Make this more fine granular
+    // Big lock on the tree. It is not striped, the state machine recurses
+    // across entries of the object and Next() walks the ordered tree
     tbb::recursive_mutex  lock_;
 
 private:
+    typedef std::set<KSyncObject *> ObjectSet;
+
     friend class KSyncEntry;
     friend void TestTriggerStaleEntryCleanupCb(KSyncObject *obj);
+    friend class KSyncObjectStatsReq;
 
     // Free indication of an KSyncElement. 
     // Removes from tree and free index if allocated earlier
@@ -158,6 +186,7 @@ private:
     void NetlinkAckInternal(KSyncEntry *entry, KSyncEntry::KSyncEvent event);
 
     bool IsIndexValid() const { return need_index_; }
+    static BackRefTree *GetBackRefTree(KSyncEntry *entry, tbb::mutex **lock);
 
     // timer Callback to trigger delete of stale entries.
     bool StaleEntryCleanupCb();
@@ -168,9 +197,21 @@ private:
     // Tree of all KSyncEntries
     Tree tree_;
     // Forward reference tree
-    static FwdRefTree  fwd_ref_tree_;
+    FwdRefTree  fwd_ref_tree_;
     // Back reference tree
-    static BackRefTree  back_ref_tree_;
+    BackRefTree  back_ref_tree_;
+    // Lock on fwd_ref_tree_ and back_ref_tree_
+    tbb::mutex ref_lock_;
+    tbb::atomic<uint64_t> lock_acquire_count_;
+    tbb::atomic<uint64_t> lock_contention_count_;
+    // Number of references in all KSyncObjects
+    static tbb::atomic<uint32_t> ref_count_;
+    // Back references to entries without a KSyncObject
+    static BackRefTree default_back_ref_tree_;
+    static tbb::mutex default_ref_lock_;
+    // All KSyncObjects, for introspect
+    static ObjectSet object_set_;
+    static tbb::mutex object_set_lock_;
     // Does the KSyncEntry need index?
     bool need_index_;
     // Index table for KSyncObject
@@ -11,6 +11,8 @@
 #include <tbb/atomic.h>
 
 #include "base/logging.h"
+#include "base/string_util.h"
+#include "base/time_util.h"
 #include "testing/gunit.h"
 
 #include "db/db.h"
@@ -687,6 +689,173 @@ TEST_F(DBKSyncTest, DeleteAck_after_create_stale) {
     EXPECT_EQ(VlanKSyncEntry::GetDelCount(), 2);
 }
 
+// Port entries of a second KSyncObject waiting on vlan entries
+class PortKSyncEntry : public KSyncEntry {
+public:
+    PortKSyncEntry(uint16_t id, uint16_t vlan_tag) :
+        KSyncEntry(), id_(id), vlan_tag_(vlan_tag) { };
+    virtual ~PortKSyncEntry() { };
+
+    virtual bool IsLess(const KSyncEntry &rhs) const {
+        const PortKSyncEntry &entry = static_cast<const PortKSyncEntry &>(rhs);
+        return id_ < entry.id_;
+    }
+    virtual std::string ToString() const {return "PORT";};
+    virtual bool Add() { return true; };
+    virtual bool Change() { return true; };
+    virtual bool Delete() { return true; };
+    virtual KSyncObject *GetObject();
+    virtual KSyncEntry *UnresolvedReference() {
+        if (vlan_->IsResolved())
+            return NULL;
+        return vlan_.get();
+    };
+
+    uint16_t id() const {return id_;};
+    uint16_t vlan_tag() const {return vlan_tag_;};
+    KSyncEntryPtr vlan_;
+
+private:
+    uint16_t id_;
+    uint16_t vlan_tag_;
+    DISALLOW_COPY_AND_ASSIGN(PortKSyncEntry);
+};
+
+class PortKSyncObject : public KSyncObject {
+public:
+    PortKSyncObject() : KSyncObject() { };
+    virtual ~PortKSyncObject() { };
+
+    virtual KSyncEntry *Alloc(const KSyncEntry *entry, uint32_t index) {
+        const PortKSyncEntry *key = static_cast<const PortKSyncEntry *>(entry);
+        PortKSyncEntry *port = new PortKSyncEntry(key->id(), key->vlan_tag());
+        VlanKSyncEntry vlan(key->vlan_tag());
+        port->vlan_ =
+            VlanKSyncObject::GetKSyncObject()->GetReference(&vlan);
+        return static_cast<KSyncEntry *>(port);
+    };
+
+    static PortKSyncObject *singleton_;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(PortKSyncObject);
+};
+PortKSyncObject *PortKSyncObject::singleton_;
+
+KSyncObject *PortKSyncEntry::GetObject() {
+    return PortKSyncObject::singleton_;
+}
+
+// A port waiting on a vlan keeps the forward reference in the port object
+// and the back reference in the vlan object, both are removed once the vlan
+// is added
+TEST_F(DBKSyncTest, CrossObjectReference) {
+    PortKSyncObject::singleton_ = new PortKSyncObject();
+    PortKSyncObject *port_obj = PortKSyncObject::singleton_;
+    VlanKSyncObject *vlan_obj = VlanKSyncObject::GetKSyncObject();
+
+    PortKSyncEntry port_key(1, 20);
+    KSyncEntry *port = port_obj->Create(&port_key);
+    EXPECT_EQ(KSyncEntry::ADD_DEFER, port->GetState());
+    EXPECT_EQ(1U, port_obj->FwdRefCount());
+    EXPECT_EQ(0U, port_obj->BackRefCount());
+    EXPECT_EQ(0U, vlan_obj->FwdRefCount());
+    EXPECT_EQ(1U, vlan_obj->BackRefCount());
+
+    DBRequest req;
+    req.oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+    req.key.reset(new Vlan::VlanKey("vlan20", 20));
+    req.data.reset(NULL);
+    itbl->Enqueue(&req);
+    task_util::WaitForIdle();
+
+    EXPECT_EQ(KSyncEntry::IN_SYNC, port->GetState());
+    EXPECT_EQ(0U, port_obj->FwdRefCount());
+    EXPECT_EQ(0U, vlan_obj->BackRefCount());
+
+    port_obj->Delete(port);
+    task_util::WaitForIdle();
+    EXPECT_EQ(0U, port_obj->Size());
+
+    req.oper = DBRequest::DB_ENTRY_DELETE;
+    req.key.reset(new Vlan::VlanKey("vlan20", 20));
+    req.data.reset(NULL);
+    itbl->Enqueue(&req);
+    task_util::WaitForIdle();
+    EXPECT_EQ(0U, vlan_obj->Size());
+
+    delete port_obj;
+    PortKSyncObject::singleton_ = NULL;
+}
+
+// Deleting a port still waiting on a vlan removes both references and frees
+// the temporary vlan entry
+TEST_F(DBKSyncTest, CrossObjectReferenceDelete) {
+    PortKSyncObject::singleton_ = new PortKSyncObject();
+    PortKSyncObject *port_obj = PortKSyncObject::singleton_;
+    VlanKSyncObject *vlan_obj = VlanKSyncObject::GetKSyncObject();
+
+    PortKSyncEntry port_key(1, 30);
+    KSyncEntry *port = port_obj->Create(&port_key);
+    EXPECT_EQ(KSyncEntry::ADD_DEFER, port->GetState());
+    EXPECT_EQ(1U, port_obj->FwdRefCount());
+    EXPECT_EQ(1U, vlan_obj->BackRefCount());
+    EXPECT_EQ(1U, vlan_obj->Size());
+
+    port_obj->Delete(port);
+    task_util::WaitForIdle();
+    EXPECT_EQ(0U, port_obj->FwdRefCount());
+    EXPECT_EQ(0U, vlan_obj->BackRefCount());
+    EXPECT_EQ(0U, port_obj->Size());
+    EXPECT_EQ(0U, vlan_obj->Size());
+    EXPECT_EQ(0, VlanKSyncEntry::GetAddCount());
+
+    delete port_obj;
+    PortKSyncObject::singleton_ = NULL;
+}
+
+// Adds and deletes vlans spread over the DB partitions, which notify the
+// ksync object in parallel; the event rate and lock contention are printed
+// and not checked. Run with --gtest_also_run_disabled_tests
+TEST_F(DBKSyncTest, DISABLED_EventRateBenchmark) {
+    const int kVlanCount = 4000;
+    VlanKSyncObject *obj = VlanKSyncObject::GetKSyncObject();
+    uint64_t contention = obj->lock_contention_count();
+    DBRequest req;
+
+    uint64_t start = ClockMonotonicUsec();
+    for (int i = 1; i <= kVlanCount; i++) {
+        req.oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+        req.key.reset(new Vlan::VlanKey("vlan" + integerToString(i), i));
+        req.data.reset(NULL);
+        itbl->Enqueue(&req);
+    }
+    task_util::WaitForIdle();
+    uint64_t add_usec = ClockMonotonicUsec() - start;
+    EXPECT_EQ(kVlanCount, VlanKSyncEntry::GetAddCount());
+
+    start = ClockMonotonicUsec();
+    for (int i = 1; i <= kVlanCount; i++) {
+        req.oper = DBRequest::DB_ENTRY_DELETE;
+        req.key.reset(new Vlan::VlanKey("vlan" + integerToString(i), i));
+        req.data.reset(NULL);
+        itbl->Enqueue(&req);
+    }
+    task_util::WaitForIdle();
+    uint64_t del_usec = ClockMonotonicUsec() - start;
+    EXPECT_EQ(kVlanCount, VlanKSyncEntry::GetDelCount());
+    EXPECT_EQ(0U, obj->Size());
+    EXPECT_EQ(0U, obj->FwdRefCount());
+
+    cout << kVlanCount << " ksync adds in " << add_usec << " usec (" <<
+        (kVlanCount * 1000000ULL) / (add_usec ? add_usec : 1) <<
+        " events/sec), " << kVlanCount << " deletes in " << del_usec <<
+        " usec (" << (kVlanCount * 1000000ULL) / (del_usec ? del_usec : 1) <<
+        " events/sec), over " << DB::PartitionCount() <<
+        " partitions, lock contended " <<
+        (obj->lock_contention_count() - contention) << " times" << endl;
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     LoggingInit();
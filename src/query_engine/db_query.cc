@@ -4,6 +4,108 @@
 
 #include "query.h"
 
+static uint32_t ColListT2(const GenDb::ColList &row) {
+    uint32_t t2;
+    assert(row.rowkey_.size()!=0);
+    try {
+        t2 = boost::get<uint32_t>(row.rowkey_.at(0));
+    } catch (boost::bad_get& ex) {
+        assert(0);
+    }
+    return t2;
+}
+
+static bool ColListT2Less(const GenDb::ColList &lhs,
+                          const GenDb::ColList &rhs) {
+    return ColListT2(lhs) < ColListT2(rhs);
+}
+
+// Decode the columns of one row returned by the database and append the
+// entries within the query time range to query_result
+void DbQueryUnit::decode_row(const GenDb::ColList &row)
+{
+    AnalyticsQuery *m_query = (AnalyticsQuery *)main_query;
+    uint32_t t2 = ColListT2(row);
+    GenDb::NewColVec::const_iterator i;
+
+    QE_TRACE(DEBUG, "For " << cfname << " T2:" << t2 <<
+        " Database returned " << row.columns_.size() << " cols");
+
+    for (i = row.columns_.begin(); i != row.columns_.end(); i++)
+    {
+        query_result_unit_t result_unit;
+        uint32_t t1;
+        
+        if (m_query->is_stat_table_query()) {
+            assert(i->value->size()==1);
+            assert((i->name->size()==4)||(i->name->size()==3));
+            try {
+                t1 = boost::get<uint32_t>(i->name->at(i->name->size()-2));
+            } catch (boost::bad_get& ex) {
+                assert(0);
+            }
+        } else if (m_query->is_flow_query()) {
+            int ts_at = i->name->size() - 2;
+            assert(ts_at >= 0);
+            
+            try {
+                t1 = boost::get<uint32_t>(i->name->at(ts_at));
+            } catch (boost::bad_get& ex) {
+                assert(0);
+            }
+        } else {
+            int ts_at = i->name->size() - 1;
+            assert(ts_at >= 0);
+            try {
+                t1 = boost::get<uint32_t>(i->name->at(ts_at));
+            } catch (boost::bad_get& ex) {
+                assert(0);
+            }
+        }
+        result_unit.timestamp = TIMESTAMP_FROM_T2T1(t2, t1);
+
+        if 
+        ((result_unit.timestamp < m_query->from_time()) ||
+         (result_unit.timestamp > m_query->end_time()))
+        {
+            //QE_TRACE(DEBUG, "Discarding timestamp "
+            //        << result_unit.timestamp);
+            // got a result outside of the time range
+            continue;
+        }
+
+        // Add to result vector
+        if (m_query->is_stat_table_query()) {
+            std::string attribstr;
+            boost::uuids::uuid uuid;
+
+            try {
+                uuid = boost::get<boost::uuids::uuid>(i->name->at(i->name->size()-1));
+            } catch (boost::bad_get& ex) {
+                QE_ASSERT(0);
+            } catch (const std::out_of_range& oor) {
+                QE_ASSERT(0);
+            }
+
+            try {
+                attribstr = boost::get<std::string>(i->value->at(0));
+            } catch (boost::bad_get& ex) {
+                QE_ASSERT(0);
+            } catch (const std::out_of_range& oor) {
+                QE_ASSERT(0);
+            }
+
+            result_unit.set_stattable_info(
+                attribstr,
+                uuid);
+        } else {
+            result_unit.info = *i->value;
+        }
+
+        query_result.push_back(result_unit);
+    }
+}
+
 query_status_t DbQueryUnit::process_query()
 {
     AnalyticsQuery *m_query = (AnalyticsQuery *)main_query;
@@ -28,10 +130,8 @@ query_status_t DbQueryUnit::process_query()
     cr.finish_.push_back(timestamp_end);
 
     std::vector<GenDb::DbDataValueVec> keys;    // vector of keys for multi-row get
-    GenDb::ColListVec mget_res;   // vector of result for each row
     for (uint32_t t2 = t2_start; t2 <= t2_end; t2++)
     {
-        GenDb::ColList result;
         GenDb::DbDataValueVec rowkey;
 
         rowkey.push_back(t2);
@@ -52,121 +152,46 @@ query_status_t DbQueryUnit::process_query()
         keys.push_back(rowkey);
     }
 
-    if (!m_query->dbif->Db_GetMultiRow(mget_res, cfname, keys, &cr)) {
-        std::stringstream tempstr;
-        for (size_t i = 0; i < cr.start_.size(); i++)
-            tempstr << "cr_s(" << i << "): " << cr.start_.at(i) << ", ";
-        for (size_t i = 0; i < cr.finish_.size(); i++)
-            tempstr << "cr_f(" << i << "): " << cr.finish_.at(i) << ", ";
-        QE_TRACE(DEBUG, "GetMultiRow failed:keys count:"<< keys.size() <<" :cr_s(size):"<<cr.start_.size()<<" :cr_f(size):"<<cr.finish_.size() << tempstr.str());
-
-        for (size_t i = 0; i < keys.size(); i++) {
-            std::stringstream tempstr1;
-            for (size_t j = 0; j < keys[i].size(); j++)
-                tempstr1 << "keys[" << i << "][" << j << "]=" << keys[i].at(j) << ", ";
-            QE_TRACE(DEBUG, "GetMultiRow failed:keys:"<<i<<":"<<tempstr1.str());
+    // Fetch the rows a window at a time and decode each window before
+    // fetching the next one, so that only one window of raw columns is
+    // held at any point. Rows are decoded in T2 order and the T2 ranges
+    // are disjoint, so sorting each row's entries is enough to keep
+    // query_result sorted as a whole.
+    for (size_t first = 0; first < keys.size(); first += kMaxRowsPerFetch) {
+        size_t last = std::min(keys.size(), first + kMaxRowsPerFetch);
+        std::vector<GenDb::DbDataValueVec> window_keys(keys.begin() + first,
+                                                       keys.begin() + last);
+        GenDb::ColListVec mget_res;   // vector of result for each row
+
+        if (!m_query->dbif->Db_GetMultiRow(mget_res, cfname, window_keys,
+                                           &cr)) {
+            std::stringstream tempstr;
+            for (size_t i = 0; i < cr.start_.size(); i++)
+                tempstr << "cr_s(" << i << "): " << cr.start_.at(i) << ", ";
+            for (size_t i = 0; i < cr.finish_.size(); i++)
+                tempstr << "cr_f(" << i << "): " << cr.finish_.at(i) << ", ";
+            QE_TRACE(DEBUG, "GetMultiRow failed:keys count:"<< window_keys.size() <<" :cr_s(size):"<<cr.start_.size()<<" :cr_f(size):"<<cr.finish_.size() << tempstr.str());
+
+            for (size_t i = 0; i < window_keys.size(); i++) {
+                std::stringstream tempstr1;
+                for (size_t j = 0; j < window_keys[i].size(); j++)
+                    tempstr1 << "keys[" << first + i << "][" << j << "]=" << window_keys[i].at(j) << ", ";
+                QE_TRACE(DEBUG, "GetMultiRow failed:keys:"<<first + i<<":"<<tempstr1.str());
+            }
+
+            QE_IO_ERROR_RETURN(0, QUERY_FAILURE);
         }
-   
-        QE_IO_ERROR_RETURN(0, QUERY_FAILURE);
 
-    } else {
-        for (GenDb::ColListVec::iterator it = mget_res.begin();
+        // multiget does not return the rows in key order
+        mget_res.sort(ColListT2Less);
+        for (GenDb::ColListVec::const_iterator it = mget_res.begin();
                 it != mget_res.end(); it++) {
-            uint32_t t2;
-            assert(it->rowkey_.size()!=0);
-            try {
-                t2 = boost::get<uint32_t>(it->rowkey_.at(0));
-            } catch (boost::bad_get& ex) {
-                assert(0);
-            }
-
-            GenDb::NewColVec::iterator i;
-
-            QE_TRACE(DEBUG, "For " << cfname << " T2:" << t2 <<
-                " Database returned " << it->columns_.size() << " cols");
-
-            for (i = it->columns_.begin(); i != it->columns_.end(); i++)
-            {
-                {
-                    query_result_unit_t result_unit;
-                    uint32_t t1;
-                    
-                    if (m_query->is_stat_table_query()) {
-                        assert(i->value->size()==1);
-                        assert((i->name->size()==4)||(i->name->size()==3));
-                        try {
-                            t1 = boost::get<uint32_t>(i->name->at(i->name->size()-2));
-                        } catch (boost::bad_get& ex) {
-                            assert(0);
-                        }
-                    } else if (m_query->is_flow_query()) {
-                        int ts_at = i->name->size() - 2;
-                        assert(ts_at >= 0);
-                        
-                        try {
-                            t1 = boost::get<uint32_t>(i->name->at(ts_at));
-                        } catch (boost::bad_get& ex) {
-                            assert(0);
-                        }
-                    } else {
-                        int ts_at = i->name->size() - 1;
-                        assert(ts_at >= 0);
-                        try {
-                            t1 = boost::get<uint32_t>(i->name->at(ts_at));
-                        } catch (boost::bad_get& ex) {
-                            assert(0);
-                        }
-                    }
-                    result_unit.timestamp = TIMESTAMP_FROM_T2T1(t2, t1);
-
-                    if 
-                    ((result_unit.timestamp < m_query->from_time()) ||
-                     (result_unit.timestamp > m_query->end_time()))
-                    {
-                        //QE_TRACE(DEBUG, "Discarding timestamp "
-                        //        << result_unit.timestamp);
-                        // got a result outside of the time range
-                        continue;
-                    }
-
-                    // Add to result vector
-                    if (m_query->is_stat_table_query()) {
-                        std::string attribstr;
-                        boost::uuids::uuid uuid;
-
-                        try {
-                            uuid = boost::get<boost::uuids::uuid>(i->name->at(i->name->size()-1));
-                        } catch (boost::bad_get& ex) {
-                            QE_ASSERT(0);
-                        } catch (const std::out_of_range& oor) {
-                            QE_ASSERT(0);
-                        }
-
-                        try {
-                            attribstr = boost::get<std::string>(i->value->at(0));
-                        } catch (boost::bad_get& ex) {
-                            QE_ASSERT(0);
-                        } catch (const std::out_of_range& oor) {
-                            QE_ASSERT(0);
-                        }
-
-                        result_unit.set_stattable_info(
-                            attribstr,
-                            uuid);
-                    } else {
-                        result_unit.info = *i->value;
-                    }
-
-                    query_result.push_back(result_unit);
-                }
-            }
+            size_t row_start = query_result.size();
+            decode_row(*it);
+            std::sort(query_result.begin() + row_start, query_result.end());
         } // TBD handle database query errors
     }
 
-    // Have the result ready and processing is done
-    // sort the result before returning
-    std::sort(query_result.begin(), query_result.end());
-
     QE_TRACE(DEBUG,  " Database query completed with "
             << query_result.size() << " rows");
     if (IS_TRACE_ENABLED(WHERE_RESULT_TRACE)) {
@@ -114,6 +114,8 @@ void Options::Initialize(EventManager &evm,
         ("DEFAULT.start_time", opt::value<uint64_t>()->default_value(0),
              "Lowest start time for queries")
 
+        ("DEFAULT.stats_rollup", opt::bool_switch(&stats_rollup_),
+             "Read stats from the samples rolled up by the collector")
         ("DEFAULT.test_mode", opt::bool_switch(&test_mode_),
              "Enable query-engine to run in test-mode")
 
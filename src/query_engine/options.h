@@ -41,6 +41,7 @@ public:
     const bool use_syslog() const { return use_syslog_; }
     const std::string syslog_facility() const { return syslog_facility_; }
     const int analytics_data_ttl() const { return analytics_data_ttl_; }
+    const bool stats_rollup() const { return stats_rollup_; }
     const bool test_mode() const { return test_mode_; }
 
 private:
@@ -82,6 +83,7 @@ private:
     uint64_t start_time_;
     int max_tasks_;
     int max_slice_;
+    bool stats_rollup_;
     bool test_mode_;
     int analytics_data_ttl_;
     std::vector<std::string> cassandra_server_list_;
@@ -11,47 +11,202 @@
 using boost::assign::map_list_of;
 
 // compare flow records based on UUID
-bool PostProcessingQuery::flow_record_comparator(
-                            const QEOpServerProxy::ResultRowT& lhs,
-                            const QEOpServerProxy::ResultRowT& rhs) {
-    std::map<std::string, std::string>::const_iterator lhs_it, rhs_it;
-    lhs_it = lhs.first.find(g_viz_constants.UUID_KEY);
-    QE_ASSERT(lhs_it != lhs.first.end());
-    rhs_it = rhs.first.find(g_viz_constants.UUID_KEY);
-    QE_ASSERT(rhs_it != rhs.first.end());
-    if (lhs_it->second < rhs_it->second) return true;
-    if (lhs_it->second > rhs_it->second) return false;
+bool PostProcessingQuery::flow_record_ref_comparator(
+                            const flow_record_ref_t& lhs,
+                            const flow_record_ref_t& rhs) {
+    return *lhs.first < *rhs.first;
+}
 
-    return false;
+void PostProcessingQuery::get_sort_values(
+        QEOpServerProxy::BufferT::const_iterator first,
+        QEOpServerProxy::BufferT::const_iterator last,
+        sort_values_t *values) const {
+    std::vector<bool> numeric;
+    for (std::vector<sort_field_t>::const_iterator sort_it =
+         sort_fields.begin(); sort_it != sort_fields.end(); sort_it++) {
+        numeric.push_back((*sort_it).type == "int" ||
+                          (*sort_it).type == "long" ||
+                          (*sort_it).type == "ipv4");
+    }
+    values->resize((last - first) * sort_fields.size());
+    sort_values_t::iterator vit = values->begin();
+    for (QEOpServerProxy::BufferT::const_iterator rit = first;
+         rit != last; ++rit) {
+        for (size_t i = 0; i < sort_fields.size(); i++, ++vit) {
+            QEOpServerProxy::OutRowT::const_iterator it =
+                rit->first.find(sort_fields[i].name);
+            QE_ASSERT(it != rit->first.end());
+            vit->ival = 0;
+            vit->sval = &it->second;
+            // numeric fields are compared on ival only
+            if (numeric[i]) {
+                stringToInteger(it->second, vit->ival);
+                vit->sval = NULL;
+            }
+        }
+    }
 }
 
-bool PostProcessingQuery::sort_field_comparator(
-        const QEOpServerProxy::ResultRowT& lhs,
-        const QEOpServerProxy::ResultRowT& rhs) {
-    std::map<std::string, std::string>::const_iterator lhs_it, rhs_it;
-    for (std::vector<sort_field_t>::iterator sort_it = sort_fields.begin();
-         sort_it != sort_fields.end(); sort_it++) {
-        lhs_it = lhs.first.find((*sort_it).name);
-        QE_ASSERT(lhs_it != lhs.first.end());
-        rhs_it = rhs.first.find((*sort_it).name);
-        QE_ASSERT(rhs_it != rhs.first.end());
-        if ((*sort_it).type == std::string("int") || 
-            (*sort_it).type == std::string("long") ||
-            (*sort_it).type == std::string("ipv4")) {
-            uint64_t lhs_val = 0, rhs_val = 0;
-            stringToInteger(lhs_it->second, lhs_val);
-            stringToInteger(rhs_it->second, rhs_val);
-            if (lhs_val < rhs_val) return true;
-            if (lhs_val > rhs_val) return false;
+bool PostProcessingQuery::sort_values_less(const sort_value_t *lhs,
+                                           const sort_value_t *rhs) const {
+    for (size_t i = 0; i < sort_fields.size(); i++) {
+        if (lhs[i].sval == NULL) {
+            if (lhs[i].ival < rhs[i].ival) return true;
+            if (lhs[i].ival > rhs[i].ival) return false;
         } else {
-            if (lhs_it->second < rhs_it->second) return true;
-            if (lhs_it->second > rhs_it->second) return false;
+            int res = lhs[i].sval->compare(*rhs[i].sval);
+            if (res < 0) return true;
+            if (res > 0) return false;
         }
     }
 
     return false;
 }
 
+void PostProcessingQuery::sort_result(QEOpServerProxy::BufferT *rows,
+                                      size_t limit) {
+    size_t nfields = sort_fields.size();
+    size_t count = rows->size();
+    if (limit && count > limit) {
+        count = limit;
+    }
+    if (nfields == 0 || rows->size() < 2) {
+        rows->resize(count);
+        return;
+    }
+
+    // Sort pointers to the per row sort values, and move the rows into
+    // place once at the end
+    sort_values_t values;
+    get_sort_values(rows->begin(), rows->end(), &values);
+    std::vector<const sort_value_t *> order;
+    order.reserve(rows->size());
+    for (size_t i = 0; i < rows->size(); i++) {
+        order.push_back(&values[i * nfields]);
+    }
+    if (count < order.size()) {
+        if (sorting_type == ASCENDING) {
+            std::partial_sort(order.begin(), order.begin() + count,
+                order.end(), boost::bind(
+                    &PostProcessingQuery::sort_values_less, this, _1, _2));
+        } else {
+            std::partial_sort(order.begin(), order.begin() + count,
+                order.end(), boost::bind(
+                    &PostProcessingQuery::sort_values_less, this, _2, _1));
+        }
+    } else {
+        if (sorting_type == ASCENDING) {
+            std::sort(order.begin(), order.end(), boost::bind(
+                &PostProcessingQuery::sort_values_less, this, _1, _2));
+        } else {
+            std::sort(order.begin(), order.end(), boost::bind(
+                &PostProcessingQuery::sort_values_less, this, _2, _1));
+        }
+    }
+
+    QEOpServerProxy::BufferT sorted(count);
+    for (size_t i = 0; i < count; i++) {
+        QEOpServerProxy::ResultRowT& row =
+            (*rows)[(order[i] - &values[0]) / nfields];
+        sorted[i].first.swap(row.first);
+        sorted[i].second.swap(row.second);
+    }
+    rows->swap(sorted);
+}
+
+void PostProcessingQuery::merge_sorted_result(
+        const QEOpServerProxy::BufferT& rows1,
+        const QEOpServerProxy::BufferT& rows2,
+        QEOpServerProxy::BufferT *output, size_t limit) {
+    size_t nfields = sort_fields.size();
+    size_t count = rows1.size() + rows2.size();
+    if (limit && count > limit) {
+        count = limit;
+    }
+    output->reserve(output->size() + count);
+    size_t i = 0, j = 0;
+    if (nfields) {
+        sort_values_t values1, values2;
+        get_sort_values(rows1.begin(), rows1.end(), &values1);
+        get_sort_values(rows2.begin(), rows2.end(), &values2);
+        while (i < rows1.size() && j < rows2.size() && i + j < count) {
+            const sort_value_t *v1 = &values1[i * nfields];
+            const sort_value_t *v2 = &values2[j * nfields];
+            // on equal values, rows1 goes first
+            bool second = (sorting_type == ASCENDING) ?
+                sort_values_less(v2, v1) : sort_values_less(v1, v2);
+            if (second) {
+                output->push_back(rows2[j++]);
+            } else {
+                output->push_back(rows1[i++]);
+            }
+        }
+    }
+    size_t count1 = std::min(rows1.size() - i, count - (i + j));
+    output->insert(output->end(), rows1.begin() + i,
+                   rows1.begin() + i + count1);
+    i += count1;
+    size_t count2 = std::min(rows2.size() - j, count - (i + j));
+    output->insert(output->end(), rows2.begin() + j,
+                   rows2.begin() + j + count2);
+}
+
+bool PostProcessingQuery::merge_head_after(const merge_head_t& lhs,
+                                           const merge_head_t& rhs) const {
+    if (sorting_type == ASCENDING) {
+        if (sort_values_less(&rhs.values[0], &lhs.values[0])) return true;
+        if (sort_values_less(&lhs.values[0], &rhs.values[0])) return false;
+    } else {
+        if (sort_values_less(&lhs.values[0], &rhs.values[0])) return true;
+        if (sort_values_less(&rhs.values[0], &lhs.values[0])) return false;
+    }
+    // on equal values, earlier inputs go first
+    return lhs.input > rhs.input;
+}
+
+void PostProcessingQuery::merge_sorted_results(
+        const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
+        QEOpServerProxy::BufferT *output, size_t limit) {
+    // Heap of the next row of every input, with the sort values of that
+    // row only, so that the rows beyond limit are never looked at
+    std::vector<merge_head_t> heap;
+    size_t count = 0;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        const QEOpServerProxy::BufferT& input = *inputs[i];
+        count += input.size();
+        if (input.empty()) {
+            continue;
+        }
+        heap.push_back(merge_head_t());
+        merge_head_t& head = heap.back();
+        head.input = i;
+        head.row = 0;
+        get_sort_values(input.begin(), input.begin() + 1, &head.values);
+    }
+    if (limit && count > limit) {
+        count = limit;
+    }
+    output->reserve(output->size() + count);
+
+    std::make_heap(heap.begin(), heap.end(), boost::bind(
+        &PostProcessingQuery::merge_head_after, this, _1, _2));
+    for (size_t n = 0; n < count; n++) {
+        std::pop_heap(heap.begin(), heap.end(), boost::bind(
+            &PostProcessingQuery::merge_head_after, this, _1, _2));
+        merge_head_t& head = heap.back();
+        const QEOpServerProxy::BufferT& input = *inputs[head.input];
+        output->push_back(input[head.row]);
+        if (++head.row == input.size()) {
+            heap.pop_back();
+            continue;
+        }
+        get_sort_values(input.begin() + head.row,
+                        input.begin() + head.row + 1, &head.values);
+        std::push_heap(heap.begin(), heap.end(), boost::bind(
+            &PostProcessingQuery::merge_head_after, this, _1, _2));
+    }
+}
+
 bool PostProcessingQuery::flowseries_merge_processing(
         const QEOpServerProxy::BufferT *raw_result,
         QEOpServerProxy::BufferT* merged_result, 
@@ -211,47 +366,26 @@ bool PostProcessingQuery::merge_processing(
     if (sorted) {
         QEOpServerProxy::BufferT *merged_result = &output;
         const QEOpServerProxy::BufferT *raw_result1 = &(input);
+        // Rows past the limit can not make it to the final result, except
+        // for flow records that are uniquified in final_merge_processing
+        size_t merge_limit = 0;
+        if (limit > 0 && mquery->table() != g_viz_constants.FLOW_TABLE) {
+            merge_limit = limit;
+        }
 
         if (result_.get() == NULL) {
-            size_t merged_result_size = merged_result->size();
-            merged_result->reserve(merged_result_size + raw_result1->size());
-            copy(raw_result1->begin(), raw_result1->end(), 
-                 std::back_inserter(*merged_result));
-            if (merged_result_size) { 
-                if (sorting_type == ASCENDING) {
-                    std::inplace_merge(merged_result->begin(), 
-                        merged_result->begin() + merged_result_size,
-                        merged_result->end(),
-                        boost::bind(&PostProcessingQuery::sort_field_comparator, 
-                                    this, _1, _2));
-                } else {
-                    std::inplace_merge(merged_result->rbegin(),
-                        merged_result->rbegin() + raw_result1->size(),
-                        merged_result->rend(),
-                        boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                    this, _1, _2));
-                }
-            }
+            QEOpServerProxy::BufferT prev_result;
+            prev_result.swap(*merged_result);
+            merge_sorted_result(prev_result, *raw_result1, merged_result,
+                                merge_limit);
         } else {
             QEOpServerProxy::BufferT *raw_result2 = result_.get();
             size_t size1 = raw_result1->size();
             size_t size2 = raw_result2->size();
             QE_TRACE(DEBUG, "Merging results from vectors of size:" <<
                      size1 << " and " << size2);
-            merged_result->reserve(raw_result1->size() + raw_result2->size());
-            if (sorting_type == ASCENDING) {
-                std::merge(raw_result1->begin(), raw_result1->end(),
-                           raw_result2->begin(), raw_result2->end(),
-                           std::back_inserter(*merged_result),
-                           boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                       this, _1, _2));
-            } else {
-                std::merge(raw_result1->rbegin(), raw_result1->rend(),
-                           raw_result2->rbegin(), raw_result2->rend(),
-                           std::back_inserter(*merged_result),
-                           boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                       this, _1, _2));
-            }
+            merge_sorted_result(*raw_result1, *raw_result2, merged_result,
+                                merge_limit);
         }
     } else {
         QE_TRACE(DEBUG, "Merge_Processing: Adding inputs to output");
@@ -332,27 +466,48 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
     if (mquery->table() == g_viz_constants.FLOW_TABLE)
     {
         QE_TRACE(DEBUG, "Final_Merge_Processing: Uniquify flow records");
-        // uniquify the records
-        std::set<QEOpServerProxy::ResultRowT, 
-                 bool(*)(const QEOpServerProxy::ResultRowT&,
-                         const QEOpServerProxy::ResultRowT&)>
-                 result_row_set(&PostProcessingQuery::flow_record_comparator);
-
+        // uniquify the records, keeping the first record seen for a UUID.
+        // The UUID of each record is looked up once and the records are
+        // copied only once they are known to be unique
+        std::vector<flow_record_ref_t> records;
         for (size_t i = 0; i < inputs.size(); i++)
         {
             QEOpServerProxy::BufferT *raw_result = inputs[i].get();
-            result_row_set.insert(raw_result->begin(), raw_result->end());
+            for (QEOpServerProxy::BufferT::const_iterator it =
+                 raw_result->begin(); it != raw_result->end(); ++it) {
+                QEOpServerProxy::OutRowT::const_iterator uuid_it =
+                    it->first.find(g_viz_constants.UUID_KEY);
+                QE_ASSERT(uuid_it != it->first.end());
+                records.push_back(std::make_pair(&uuid_it->second, &*it));
+            }
         }
+        std::stable_sort(records.begin(), records.end(),
+                         &PostProcessingQuery::flow_record_ref_comparator);
 
         QEOpServerProxy::BufferT *merged_result = &output;
-        merged_result->reserve(result_row_set.size());
-        copy(result_row_set.begin(), result_row_set.end(), 
-            std::back_inserter(*merged_result));
+        for (std::vector<flow_record_ref_t>::const_iterator it =
+             records.begin(); it != records.end(); ++it) {
+            if (it != records.begin() && *(it - 1)->first == *it->first) {
+                continue;
+            }
+            merged_result->push_back(*it->second);
+        }
 
         QE_TRACE(DEBUG, "Final_Merge_Processing: Done uniquify flow records");
         merge_done = true;
     }
 
+    bool sort_done = false;
+    if (!merge_done && sorted) {
+        // The batch results are already sorted, so only the rows that
+        // make it to the final result are merged
+        QE_TRACE(DEBUG, "Merging sorted results from " << inputs.size()
+                 << " vectors with limit:" << limit);
+        merge_sorted_results(inputs, &output, limit > 0 ? limit : 0);
+        merge_done = true;
+        sort_done = true;
+    }
+
     if (!merge_done) {
         QEOpServerProxy::BufferT *merged_result = &output;
         size_t final_vector_size = 0;
@@ -360,27 +515,25 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
         for (size_t i = 0; i < inputs.size(); i++) {
             final_vector_size += inputs[i]->size();
         }
+        // rows past the limit are dropped below anyway
+        if (limit > 0 && final_vector_size > (size_t)limit) {
+            final_vector_size = limit;
+        }
         merged_result->reserve(final_vector_size);
         QE_TRACE(DEBUG, "Merging results between " << inputs.size()
                  << " vectors with final vector size:" << final_vector_size);
-        for (size_t i = 0; i < inputs.size(); i++) {
+        for (size_t i = 0; i < inputs.size() &&
+             merged_result->size() < final_vector_size; i++) {
             QEOpServerProxy::BufferT *raw_result = inputs[i].get();
-            copy(raw_result->begin(), raw_result->end(),
+            size_t count = std::min(raw_result->size(),
+                final_vector_size - merged_result->size());
+            copy(raw_result->begin(), raw_result->begin() + count,
                  std::back_inserter(*merged_result));
         }
     }
 
-    if (sorted) {
-        QEOpServerProxy::BufferT *merged_result = &output;
-        if (sorting_type == ASCENDING) {
-            std::sort(merged_result->begin(), merged_result->end(),
-                      boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                  this, _1, _2));
-        } else {
-            std::sort(merged_result->rbegin(), merged_result->rend(),
-                      boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                  this, _1, _2));
-        }
+    if (sorted && !sort_done) {
+        sort_result(&output, limit > 0 ? limit : 0);
     }
    
     if (limit) {
@@ -488,11 +641,11 @@ query_status_t PostProcessingQuery::process_query() {
     /* below is filter processing for non stats table queries
      */
     if (filter_list.size() != 0) {
-        QEOpServerProxy::BufferT filtered_table;
-        // do filter operation
+        // do filter operation, compacting the rows kept in place
+        size_t num_kept = 0;
         QE_TRACE(DEBUG, "Doing filter operation");
         for (size_t i = 0; i < raw_result->size(); i++) {
-            QEOpServerProxy::ResultRowT row = (*raw_result)[i];
+            QEOpServerProxy::ResultRowT& row = (*raw_result)[i];
             bool delete_row = true;
 
             for (size_t j = 0; j < filter_list.size(); j++) {
@@ -578,31 +731,31 @@ query_status_t PostProcessingQuery::process_query() {
                 }
             }
             if (!delete_row) {
-                filtered_table.push_back(row);
+                if (num_kept != i) {
+                    QEOpServerProxy::ResultRowT& kept_row =
+                        (*raw_result)[num_kept];
+                    kept_row.first.swap(row.first);
+                    kept_row.second.swap(row.second);
+                }
+                num_kept++;
             }
         }
-        *raw_result = filtered_table;
-    }
-
-    // Check if the result has to be sorted
-    if (sorted) {
-        if (sorting_type == ASCENDING) {
-            std::sort(raw_result->begin(), raw_result->end(), 
-                      boost::bind(&PostProcessingQuery::sort_field_comparator, 
-                                  this, _1, _2)); 
-        } else {
-            std::sort(raw_result->rbegin(), raw_result->rend(), 
-                      boost::bind(&PostProcessingQuery::sort_field_comparator,
-                                  this, _1, _2));
-        }
+        raw_result->resize(num_kept);
     }
 
     // If the flow series query is parallelized, we should apply the limit 
     // only after the result from all the tasks are merged 
     // (@ final_merge_processing).
-    if ((mquery->table() != g_viz_constants.FLOW_SERIES_TABLE || 
+    bool apply_limit = (mquery->table() != g_viz_constants.FLOW_SERIES_TABLE ||
         (mquery->table() == g_viz_constants.FLOW_SERIES_TABLE && 
-        !mquery->is_query_parallelized())) && limit) {
+        !mquery->is_query_parallelized())) && limit;
+
+    // Check if the result has to be sorted
+    if (sorted) {
+        sort_result(raw_result, apply_limit ? limit : 0);
+    }
+
+    if (apply_limit) {
         QE_TRACE(DEBUG, "Apply Limit [" << limit << "]");
         if (raw_result->size() > (size_t)limit) {
             raw_result->resize(limit);
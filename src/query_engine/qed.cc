@@ -187,6 +187,8 @@ main(int argc, char *argv[]) {
     LOG(INFO, "Endpoint " << dss_ep);
     LOG(INFO, "Max-tasks " << max_tasks);
     LOG(INFO, "Max-slice " << options.max_slice());
+    LOG(INFO, "Stats-rollup " << options.stats_rollup());
+    QueryEngine::stats_rollup_ = options.stats_rollup();
     BOOST_FOREACH(std::string collector_ip, options.collector_server_list()) {
         LOG(INFO, "Collectors  " << collector_ip);
     }
@@ -29,6 +29,7 @@ using process::ConnectionStatus;
 
 GenDb::GenDbIf* query_result_unit_t::dbif = NULL;
 int QueryEngine::max_slice_ = 100;
+bool QueryEngine::stats_rollup_ = false;
 
 typedef  std::vector< std::pair<std::string, std::string> > spair_vector;
 static spair_vector query_string_to_column_name(0);
@@ -379,6 +380,69 @@ void AnalyticsQuery::get_query_details(bool& is_merge_needed, bool& is_map_outpu
     is_map_output = is_stat_table_query();
 }
 
+// Time from which the collectors have rolled up all stats samples, 0 if
+// they do not roll them up or the time can not be read
+uint64_t AnalyticsQuery::get_stats_rollup_start_time() {
+    GenDb::ColList col_list;
+    GenDb::DbDataValueVec key;
+    key.push_back(g_viz_constants.SYSTEM_OBJECT_ANALYTICS);
+    if (!dbif->Db_GetRow(col_list, g_viz_constants.SYSTEM_OBJECT_TABLE,
+                         key)) {
+        return 0;
+    }
+    for (GenDb::NewColVec::iterator it = col_list.columns_.begin();
+            it != col_list.columns_.end(); it++) {
+        try {
+            if (boost::get<std::string>(it->name->at(0)) ==
+                    g_viz_constants.SYSTEM_OBJECT_STAT_ROLLUP_START_TIME) {
+                return boost::get<uint64_t>(it->value->at(0));
+            }
+        } catch (boost::bad_get& ex) {
+            QE_LOG(ERROR, __func__ << ": Exception on column get, what=" <<
+                   ex.what());
+            return 0;
+        }
+    }
+    return 0;
+}
+
+void AnalyticsQuery::select_stats_rollup(
+        const std::map<std::string, std::string>& json_api_data) {
+    std::map<std::string, std::string>::const_iterator iter;
+    std::vector<std::string> select_fields;
+    bool filter = false;
+
+    iter = json_api_data.find(QUERY_SELECT);
+    if (iter == json_api_data.end()) return;
+    {
+        rapidjson::Document d;
+        std::string json_string = "{ \"select\" : " + iter->second + " }";
+        d.Parse<0>(const_cast<char *>(json_string.c_str()));
+        if (d.HasParseError() || !d["select"].IsArray()) return;
+        const rapidjson::Value& json_select_fields = d["select"];
+        for (rapidjson::SizeType i = 0; i < json_select_fields.Size(); i++) {
+            if (!json_select_fields[i].IsString()) return;
+            select_fields.push_back(json_select_fields[i].GetString());
+        }
+    }
+
+    iter = json_api_data.find(QUERY_FILTER);
+    if (iter != json_api_data.end()) {
+        rapidjson::Document d;
+        std::string json_string = "{ \"filter\" : " + iter->second + " }";
+        d.Parse<0>(const_cast<char *>(json_string.c_str()));
+        filter = d.HasParseError() || !d["filter"].IsArray() ||
+            (d["filter"].Size() != 0);
+    }
+
+    stats_->SelectRollup(select_fields, filter, from_time_, end_time_,
+                         UTCTimestampUsec(), get_stats_rollup_start_time());
+    if (stats_->is_rollup()) {
+        QE_TRACE(DEBUG, "Stats query reads samples rolled up over " <<
+            stats_->rollup_period() << " sec");
+    }
+}
+
 bool AnalyticsQuery::can_parallelize_query() {
     parallelize_query_ = true;
     if (table_ == g_viz_constants.OBJECT_VALUE_TABLE) {
@@ -471,6 +535,12 @@ void AnalyticsQuery::Init(GenDb::GenDbIf *db_if, std::string qid,
         }
     }
 
+    // Pick the stats samples to read before the WHERE processing builds
+    // the database row keys
+    if (is_stat_table_query() && QueryEngine::stats_rollup_) {
+        select_stats_rollup(json_api_data);
+    }
+
     // Initialize SELECT/WHERE/Post-Processing components of query
     // for input validation
 
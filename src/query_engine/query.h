@@ -378,6 +378,8 @@ public:
             t_only_col = false; t_only_row = false;};
     virtual query_status_t process_query();
 
+    // Maximum number of rows requested from the database at a time
+    static const size_t kMaxRowsPerFetch = 64;
 
     // portion of column family name other than T1
     std::string cfname;
@@ -390,6 +392,9 @@ public:
     GenDb::DbDataValueVec row_key_suffix;
     bool t_only_col;    // only T is in column name
     bool t_only_row;    // only T2 is in row key
+
+private:
+    void decode_row(const GenDb::ColList &row);
 };
 
 // This class provides interface to process SET operations involved in the 
@@ -691,12 +696,26 @@ public:
     std::auto_ptr<BufT> result_;
     std::auto_ptr<MapBufT> mresult_;
 
-    bool sort_field_comparator(const QEOpServerProxy::ResultRowT& lhs,
-                               const QEOpServerProxy::ResultRowT& rhs);
+    // Sort the rows on sort_fields; when limit is non zero only the first
+    // limit rows are kept
+    void sort_result(QEOpServerProxy::BufferT *rows, size_t limit);
+    // Merge two buffers that are each sorted on sort_fields, stopping
+    // after limit rows when limit is non zero
+    void merge_sorted_result(const QEOpServerProxy::BufferT& rows1,
+                             const QEOpServerProxy::BufferT& rows2,
+                             QEOpServerProxy::BufferT *output,
+                             size_t limit = 0);
+    // k-way merge of buffers that are each sorted on sort_fields
+    void merge_sorted_results(
+        const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
+        QEOpServerProxy::BufferT *output, size_t limit);
 
+    // flow record and its UUID
+    typedef std::pair<const std::string *,
+                      const QEOpServerProxy::ResultRowT *> flow_record_ref_t;
     // compare flow records based on UUID
-    static bool flow_record_comparator(const QEOpServerProxy::ResultRowT& lhs,
-                                       const QEOpServerProxy::ResultRowT& rhs);
+    static bool flow_record_ref_comparator(const flow_record_ref_t& lhs,
+                                           const flow_record_ref_t& rhs);
 
     bool merge_processing(
         const QEOpServerProxy::BufferT& input, 
@@ -706,6 +725,26 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
                         QEOpServerProxy::BufferT& output);
 private:
     typedef std::map<uint64_t, QEOpServerProxy::ResultRowT> fcid_rrow_map_t;
+    // Value of a sort field in a result row. Numeric fields are converted
+    // once per row instead of once per comparison
+    struct sort_value_t {
+        uint64_t ival;
+        const std::string *sval;
+    };
+    typedef std::vector<sort_value_t> sort_values_t;
+    void get_sort_values(QEOpServerProxy::BufferT::const_iterator first,
+                         QEOpServerProxy::BufferT::const_iterator last,
+                         sort_values_t *values) const;
+    bool sort_values_less(const sort_value_t *lhs,
+                          const sort_value_t *rhs) const;
+    // next row of one of the inputs of a k-way merge
+    struct merge_head_t {
+        size_t input;
+        size_t row;
+        sort_values_t values;
+    };
+    bool merge_head_after(const merge_head_t& lhs,
+                          const merge_head_t& rhs) const;
     bool flowseries_merge_processing(
                 const QEOpServerProxy::BufferT *raw_result,
                 QEOpServerProxy::BufferT *merged_result,
@@ -860,6 +899,9 @@ const std::vector<boost::shared_ptr<QEOpServerProxy::BufferT> >& inputs,
     std::map<std::string, std::string>& json_api_data, 
     uint64_t analytics_start_time);
     bool can_parallelize_query();
+    void select_stats_rollup(
+        const std::map<std::string, std::string>& json_api_data);
+    uint64_t get_stats_rollup_start_time();
 };
 
 // limit on the size of query result we can handle
@@ -870,6 +912,8 @@ class QueryEngine {
 public:
     static const uint64_t StartTimeDiffInSec = 12*3600;
     static int max_slice_;
+    // Read stats from the samples rolled up by the collector when possible
+    static bool stats_rollup_;
     
     struct QueryParams {
         QueryParams(std::string qi, 
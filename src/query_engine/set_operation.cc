@@ -24,6 +24,62 @@ bool query_result_unit_t::operator<(const query_result_unit_t& rhs) const
     return (timestamp < rhs.timestamp);
 }
 
+namespace {
+
+typedef std::vector<query_result_unit_t> QueryResultVec;
+typedef QueryResultVec::const_iterator QueryResultIt;
+
+// lower_bound that probes first[1], first[2], first[4], first[8].. before
+// the binary search, so that skipping k entries costs O(log k)
+QueryResultIt GallopLowerBound(QueryResultIt first, QueryResultIt last,
+                               const query_result_unit_t& value) {
+    size_t size = last - first;
+    size_t bound = 1;
+    while (bound < size && first[bound] < value) {
+        bound *= 2;
+    }
+    size_t end = bound + 1 < size ? bound + 1 : size;
+    return std::lower_bound(first + bound / 2, first + end, value);
+}
+
+// Same result as std::set_intersection, with runs of entries absent from
+// the other input skipped by galloping. Entries are taken from lhs
+void GallopIntersection(const QueryResultVec& lhs, const QueryResultVec& rhs,
+                        QueryResultVec *result) {
+    QueryResultIt it = lhs.begin(), jt = rhs.begin();
+    while (it != lhs.end() && jt != rhs.end()) {
+        if (*it < *jt) {
+            it = GallopLowerBound(it, lhs.end(), *jt);
+        } else if (*jt < *it) {
+            jt = GallopLowerBound(jt, rhs.end(), *it);
+        } else {
+            result->push_back(*it);
+            ++it;
+            ++jt;
+        }
+    }
+}
+
+struct QueryResultRun {
+    QueryResultIt next;
+    QueryResultIt end;
+    size_t index;
+};
+
+// heap order of the k-way union, smallest entry and then lowest
+// sub-query on top
+bool QueryResultRunAfter(const QueryResultRun& lhs, const QueryResultRun& rhs) {
+    if (*rhs.next < *lhs.next) return true;
+    if (*lhs.next < *rhs.next) return false;
+    return lhs.index > rhs.index;
+}
+
+bool QueryResultSizeLess(const QueryUnit *lhs, const QueryUnit *rhs) {
+    return lhs->query_result.size() < rhs->query_result.size();
+}
+
+}  // namespace
+
 void SetOperationUnit::or_operation()
 {
     if (sub_queries.size() == 0)
@@ -33,23 +89,61 @@ void SetOperationUnit::or_operation()
     }
 
     // with one query no need to do any operation
-    query_result = sub_queries[0]->query_result;
-
-    for (unsigned int i = 1; i < sub_queries.size(); i++)
+    if (sub_queries.size() == 1)
     {
-        std::vector<query_result_unit_t> tmp_query_result;
+        query_result.swap(sub_queries[0]->query_result);
+        return;
+    }
 
-        QE_TRACE(DEBUG, "UNION between tables of sizes " << 
-                query_result.size() << " and " <<
-                sub_queries[i]->query_result.size());
-        set_union(query_result.begin(), query_result.end(),
-                sub_queries[i]->query_result.begin(), 
-                sub_queries[i]->query_result.end(),
-                std::back_inserter(tmp_query_result));
+    // k-way merge of the sub-query results, instead of one set_union per
+    // sub-query over the whole result so far. Like the chained
+    // set_union, an entry present n times in some sub-query is kept n
+    // times
+    std::vector<QueryResultRun> heap;
+    size_t total_size = 0;
+    for (unsigned int i = 0; i < sub_queries.size(); i++)
+    {
+        const QueryResultVec& sub_result = sub_queries[i]->query_result;
+        QE_TRACE(DEBUG, "UNION of table of size " << sub_result.size());
+        total_size += sub_result.size();
+        if (sub_result.empty()) {
+            continue;
+        }
+        QueryResultRun run;
+        run.next = sub_result.begin();
+        run.end = sub_result.end();
+        run.index = i;
+        heap.push_back(run);
+    }
+    std::make_heap(heap.begin(), heap.end(), QueryResultRunAfter);
 
-        query_result = tmp_query_result;    // keep the result in output var
-        QE_TRACE(DEBUG, "Resulting size of set " << query_result.size());
+    QueryResultVec result;
+    result.reserve(total_size);
+    std::vector<size_t> counts(sub_queries.size());
+    while (!heap.empty())
+    {
+        // take the equal entries of every sub-query off the heap
+        const query_result_unit_t& value = *heap.front().next;
+        size_t max_count = 0;
+        std::fill(counts.begin(), counts.end(), 0);
+        while (!heap.empty() && !(value < *heap.front().next))
+        {
+            std::pop_heap(heap.begin(), heap.end(), QueryResultRunAfter);
+            QueryResultRun& run = heap.back();
+            if (++counts[run.index] > max_count) {
+                max_count = counts[run.index];
+            }
+            if (++run.next == run.end) {
+                heap.pop_back();
+            } else {
+                std::push_heap(heap.begin(), heap.end(), QueryResultRunAfter);
+            }
+        }
+        result.insert(result.end(), max_count, value);
     }
+
+    query_result.swap(result);
+    QE_TRACE(DEBUG, "Resulting size of set " << query_result.size());
 }
 
 void SetOperationUnit::and_operation()
@@ -60,22 +154,24 @@ void SetOperationUnit::and_operation()
         return;
     }
 
-    // with one query no need to do any operation
-    query_result = sub_queries[0]->query_result;
+    // Entries are taken from the first sub-query, the others are
+    // intersected smallest first so that the result shrinks early
+    query_result.swap(sub_queries[0]->query_result);
+    std::vector<QueryUnit *> others(sub_queries.begin() + 1,
+                                    sub_queries.end());
+    std::stable_sort(others.begin(), others.end(), QueryResultSizeLess);
 
-    for (unsigned int i = 1; i < sub_queries.size(); i++)
+    for (unsigned int i = 0; i < others.size() && !query_result.empty(); i++)
     {
-        std::vector<query_result_unit_t> tmp_query_result;
+        QueryResultVec tmp_query_result;
 
         QE_TRACE(DEBUG, "INT between tables of sizes " << 
                 query_result.size() << " and " <<
-                sub_queries[i]->query_result.size());
-        set_intersection(query_result.begin(), query_result.end(),
-                sub_queries[i]->query_result.begin(), 
-                sub_queries[i]->query_result.end(),
-                std::back_inserter(tmp_query_result));
+                others[i]->query_result.size());
+        GallopIntersection(query_result, others[i]->query_result,
+                           &tmp_query_result);
 
-        query_result = tmp_query_result;    // keep the result in output var
+        query_result.swap(tmp_query_result);
         QE_TRACE(DEBUG, "Resulting size of set " << query_result.size());
     }
 }
@@ -7,6 +7,7 @@
  *
  */
 
+#include <cstdlib>
 #include "stats_query.h"
 
 using std::string;
@@ -20,7 +21,7 @@ StatsQuery::is_stat_table_query(const std::string & tname) {
     return true;
 }
 
-StatsQuery::StatsQuery(const std::string & tname) {
+StatsQuery::StatsQuery(const std::string & tname) : rollup_period_(0) {
 
     QE_ASSERT(is_stat_table_query(tname));
     size_t tpos,apos;
@@ -128,3 +129,87 @@ QEOpServerProxy::AggOper StatsQuery::ParseAgg(
     return QEOpServerProxy::INVALID;
 }
 
+
+std::string
+StatsQuery::db_attr(void) const {
+    if (!rollup_period_) {
+        return attr_;
+    }
+    std::ostringstream ostr;
+    ostr << attr_ << g_viz_constants.STAT_ROLLUP_SEPARATOR << rollup_period_;
+    return ostr.str();
+}
+
+bool
+StatsQuery::is_tag(const std::string& colname) const {
+    for (std::map<std::string,column_t>::const_iterator it = schema_.begin();
+            it != schema_.end(); it++) {
+        if (it->first == colname) {
+            if (it->second.index) return true;
+        } else if (it->second.suffixes.find(colname) !=
+                   it->second.suffixes.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The rolled up samples hold the sum, minimum and maximum of the numeric
+// fields that are not tags, grouped by the tags. They give the same result
+// as the raw samples for a query that only selects tags, SUM/MIN/MAX of the
+// numeric fields and COUNT, in T= bins that are a multiple of the period,
+// without a filter, over a time range that is aligned to the period and
+// was entirely rolled up. Any other query reads the raw samples.
+void
+StatsQuery::SelectRollup(const std::vector<std::string>& select_fields,
+        bool filter, uint64_t from_time, uint64_t end_time, uint64_t now,
+        uint64_t rollup_start_time) {
+    rollup_period_ = 0;
+    if (!is_static_ || filter) return;
+    if (!rollup_start_time || (from_time < rollup_start_time)) return;
+
+    uint64_t ts_period = 0;
+    for (size_t idx = 0; idx < select_fields.size(); idx++) {
+        const std::string& field(select_fields[idx]);
+        if (field.compare(0, g_viz_constants.STAT_TIMEBIN_FIELD.size(),
+                g_viz_constants.STAT_TIMEBIN_FIELD) == 0) {
+            std::string tsstr =
+                field.substr(g_viz_constants.STAT_TIMEBIN_FIELD.size());
+            ts_period = strtoul(tsstr.c_str(), NULL, 10) * 1000000ULL;
+            continue;
+        }
+        std::string sfield;
+        QEOpServerProxy::AggOper agg = ParseAgg(field, sfield);
+        column_t c = get_column_desc(agg == QEOpServerProxy::INVALID ?
+            field : sfield);
+        switch (agg) {
+            case QEOpServerProxy::INVALID:
+                if (!is_tag(field)) return;
+                break;
+            case QEOpServerProxy::COUNT:
+                break;
+            case QEOpServerProxy::SUM:
+            case QEOpServerProxy::MIN:
+            case QEOpServerProxy::MAX:
+                if ((c.datatype != QEOpServerProxy::UINT64) &&
+                    (c.datatype != QEOpServerProxy::DOUBLE)) return;
+                if (is_tag(sfield)) return;
+                break;
+            default:
+                return;
+        }
+    }
+    if (!ts_period) return;
+
+    const std::vector<uint32_t>& periods(g_viz_constants.STAT_ROLLUP_PERIODS);
+    for (size_t idx = 0; idx < periods.size(); idx++) {
+        uint64_t period = periods[idx] * 1000000ULL;
+        if ((periods[idx] <= rollup_period_) ||
+            (ts_period % period) || (from_time % period) ||
+            ((end_time + 1) % period) ||
+            (end_time + 1 + kRollupDelayUsec > now)) {
+            continue;
+        }
+        rollup_period_ = periods[idx];
+    }
+}
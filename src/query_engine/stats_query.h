@@ -34,6 +34,18 @@ public:
     std::string attr(void) const { return attr_; }
     bool is_stat_table_static(void) const { return is_static_; }
 
+    // Rollup period in seconds of the samples read, 0 for the raw samples
+    uint32_t rollup_period(void) const { return rollup_period_; }
+    bool is_rollup(void) const { return rollup_period_ != 0; }
+    // Stats attribute of the samples read, as in the database row keys
+    std::string db_attr(void) const;
+    // Read the samples of the coarsest rollup period that gives the same
+    // result as the raw samples, if any. rollup_start_time is the time from
+    // which the collector has rolled up all samples, 0 if it does not
+    void SelectRollup(const std::vector<std::string>& select_fields,
+        bool filter, uint64_t from_time, uint64_t end_time, uint64_t now,
+        uint64_t rollup_start_time);
+
     column_t get_column_desc(const std::string& colname) const {
         std::map<std::string,column_t>::const_iterator st = 
             schema_.find(colname);
@@ -50,9 +62,16 @@ public:
     static QEOpServerProxy::AggOper ParseAgg(const std::string&, std::string&);
     StatsQuery(const std::string& table);
 private:
+    // Rolled up samples are written by the collector shortly after the
+    // end of their period
+    static const uint64_t kRollupDelayUsec = 120 * 1000000ULL;
+
+    bool is_tag(const std::string& colname) const;
+
     std::string type_;
     std::string attr_;
     bool is_static_;
+    uint32_t rollup_period_;
     std::map<std::string,column_t> schema_;
 };
 
@@ -391,6 +391,16 @@ std::size_t boost::hash_value(const StatsSelect::StatVal& sv) {
     return boost::hash_value(ostr.str());
 }
 
+// Name of the field whose rolled up aggregate is in the named field, or
+// an empty string if the named field is not such an aggregate
+static string RollupFieldName(const string& name, const string& suffix) {
+    if ((name.size() <= suffix.size()) ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix)) {
+        return string();
+    }
+    return name.substr(0, name.size() - suffix.size());
+}
+
 bool StatsSelect::LoadRow(boost::uuids::uuid u,
 		uint64_t timestamp, const vector<StatEntry>& row, MapBufT& output) {
 
@@ -446,16 +456,26 @@ bool StatsSelect::LoadRow(boost::uuids::uuid u,
         }
     }
 
+    // Rolled up samples carry the maximum and minimum of each field
+    // separately from the sum
+    const bool rollup = main_query->stats().is_rollup();
     for (vector<StatEntry>::const_iterator it = row.begin();
             it != row.end(); it++) {
-        set<string>::const_iterator uit = max_field_.find(it->name);
+        string max_name(it->name), min_name(it->name);
+        if (rollup) {
+            max_name = RollupFieldName(it->name,
+                g_viz_constants.STAT_ROLLUP_MAX_SUFFIX);
+            min_name = RollupFieldName(it->name,
+                g_viz_constants.STAT_ROLLUP_MIN_SUFFIX);
+        }
+        set<string>::const_iterator uit = max_field_.find(max_name);
         if (uit!=max_field_.end()) {
-            pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::MAX,it->name);
+            pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::MAX,max_name);
             narows.insert(make_pair(aggkey, it->value)); 
         }
-        uit = min_field_.find(it->name);
+        uit = min_field_.find(min_name);
         if (uit!=min_field_.end()) {
-            pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::MIN,it->name);
+            pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::MIN,min_name);
             narows.insert(make_pair(aggkey, it->value)); 
         }
     }
@@ -482,7 +502,21 @@ bool StatsSelect::LoadRow(boost::uuids::uuid u,
  
     if (!count_field_.empty()) {
         pair<QEOpServerProxy::AggOper,string> aggkey(QEOpServerProxy::COUNT,count_field_);
-        narows.insert(make_pair(aggkey, (uint64_t) 1));            
+        uint64_t count = 1;
+        if (rollup) {
+            // Rolled up samples carry the number of samples
+            count = 0;
+            const string count_name(count_field_ +
+                g_viz_constants.STAT_ROLLUP_COUNT_SUFFIX);
+            for (vector<StatEntry>::const_iterator it = row.begin();
+                    it != row.end(); it++) {
+                if ((it->name == count_name) &&
+                    (it->value.which() == QEOpServerProxy::UINT64)) {
+                    count = boost::get<uint64_t>(it->value);
+                }
+            }
+        }
+        narows.insert(make_pair(aggkey, count));
     }
 
     MergeFullRow(ukey, uniks, narows, output);
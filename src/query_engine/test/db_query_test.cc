@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "testing/gunit.h"
+
+#include "base/string_util.h"
+#include "query.h"
+#include "analytics_query_mock.h"
+
+using ::testing::Return;
+using ::testing::AnyNumber;
+
+// Top level query holding the database query under test
+class MainQueryUnit : public QueryUnit {
+public:
+    MainQueryUnit() : QueryUnit(NULL, NULL) {
+    }
+    virtual query_status_t process_query() {
+        return QUERY_SUCCESS;
+    }
+};
+
+// Database returning kEntriesPerRow columns for every row asked for, with
+// the rows in reverse key order and the columns of a row in reverse T1
+// order, as multiget does not return them sorted
+class MultiRowDbIfMock : public CdbIfMock {
+public:
+    static const uint32_t kEntriesPerRow = 5;
+
+    virtual bool Db_GetMultiRow(GenDb::ColListVec& ret,
+        const std::string& cfname, const std::vector<GenDb::DbDataValueVec>& keys,
+        GenDb::ColumnNameRange *crange_ptr) {
+        fetch_sizes_.push_back(keys.size());
+        for (std::vector<GenDb::DbDataValueVec>::const_reverse_iterator it =
+             keys.rbegin(); it != keys.rend(); ++it) {
+            GenDb::ColList *row = new GenDb::ColList;
+            row->cfname_ = cfname;
+            row->rowkey_ = *it;
+            uint32_t t2 = boost::get<uint32_t>(it->at(0));
+            for (uint32_t i = kEntriesPerRow; i > 0; i--) {
+                uint32_t t1 = T1(i - 1);
+                GenDb::DbDataValueVec *name = new GenDb::DbDataValueVec;
+                name->push_back(t1);
+                GenDb::DbDataValueVec *value = new GenDb::DbDataValueVec;
+                value->push_back(integerToString(t2) + "." +
+                                 integerToString(t1));
+                row->columns_.push_back(new GenDb::NewCol(name, value));
+            }
+            ret.push_back(row);
+        }
+        return true;
+    }
+
+    // T1 of entry i of a row, spread over the row time range
+    static uint32_t T1(uint32_t i) {
+        return i * ((1 << g_viz_constants.RowTimeInBits) / kEntriesPerRow);
+    }
+
+    std::vector<size_t> fetch_sizes_;
+};
+
+class DbQueryTest : public ::testing::Test {
+protected:
+    virtual void SetUp() {
+        EXPECT_CALL(aqmock_, is_object_table_query())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(aqmock_, is_stat_table_query())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(false));
+        EXPECT_CALL(aqmock_, is_flow_query())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(false));
+        aqmock_.dbif = &dbif_;
+        // owned by main_query_
+        db_query_ = new DbQueryUnit(&main_query_, &aqmock_);
+        db_query_->cfname = g_viz_constants.MESSAGE_TABLE_SOURCE;
+        db_query_->t_only_row = true;
+    }
+
+    void SetTimeRange(uint64_t from_time, uint64_t end_time) {
+        EXPECT_CALL(aqmock_, from_time())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(from_time));
+        EXPECT_CALL(aqmock_, end_time())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(end_time));
+    }
+
+    MultiRowDbIfMock dbif_;
+    AnalyticsQueryMock aqmock_;
+    MainQueryUnit main_query_;
+    DbQueryUnit *db_query_;
+};
+
+// A T2 range spanning several fetch windows gives every entry within the
+// time range, sorted on the timestamp
+TEST_F(DbQueryTest, MultipleFetchWindows) {
+    const uint32_t t2_start = 1000;
+    const uint32_t rows = 150;
+    const uint32_t entries = MultiRowDbIfMock::kEntriesPerRow;
+    const size_t max_rows = DbQueryUnit::kMaxRowsPerFetch;
+    // start after the first entry of the first row, end before the last
+    // entry of the last row
+    uint64_t from_time =
+        TIMESTAMP_FROM_T2T1(t2_start, MultiRowDbIfMock::T1(1));
+    uint64_t end_time = TIMESTAMP_FROM_T2T1(t2_start + rows - 1,
+        MultiRowDbIfMock::T1(entries - 1) - 1);
+    SetTimeRange(from_time, end_time);
+
+    EXPECT_EQ(QUERY_SUCCESS, db_query_->process_query());
+    EXPECT_EQ(0, db_query_->status_details);
+
+    ASSERT_EQ(3U, dbif_.fetch_sizes_.size());
+    EXPECT_EQ(max_rows, dbif_.fetch_sizes_[0]);
+    EXPECT_EQ(max_rows, dbif_.fetch_sizes_[1]);
+    EXPECT_EQ(rows - 2 * max_rows, dbif_.fetch_sizes_[2]);
+
+    const std::vector<query_result_unit_t>& result = db_query_->query_result;
+    ASSERT_EQ(rows * entries - 2, result.size());
+    size_t i = 0;
+    for (uint32_t t2 = t2_start; t2 < t2_start + rows; t2++) {
+        for (uint32_t j = 0; j < entries; j++) {
+            uint32_t t1 = MultiRowDbIfMock::T1(j);
+            uint64_t timestamp = TIMESTAMP_FROM_T2T1(t2, t1);
+            if (timestamp < from_time || timestamp > end_time) {
+                continue;
+            }
+            ASSERT_LT(i, result.size());
+            EXPECT_EQ(timestamp, result[i].timestamp);
+            ASSERT_EQ(1U, result[i].info.size());
+            EXPECT_EQ(integerToString(t2) + "." + integerToString(t1),
+                      boost::get<std::string>(result[i].info[0]));
+            i++;
+        }
+    }
+    EXPECT_EQ(result.size(), i);
+}
+
+// A T2 range of exactly one window is fetched at once
+TEST_F(DbQueryTest, SingleFetchWindow) {
+    const uint32_t t2_start = 1000;
+    const size_t max_rows = DbQueryUnit::kMaxRowsPerFetch;
+    uint64_t from_time = TIMESTAMP_FROM_T2T1(t2_start, 0);
+    uint64_t end_time = TIMESTAMP_FROM_T2T1(t2_start + max_rows, 0);
+    end_time--;
+    SetTimeRange(from_time, end_time);
+
+    EXPECT_EQ(QUERY_SUCCESS, db_query_->process_query());
+    ASSERT_EQ(1U, dbif_.fetch_sizes_.size());
+    EXPECT_EQ(max_rows, dbif_.fetch_sizes_[0]);
+    const std::vector<query_result_unit_t>& result = db_query_->query_result;
+    EXPECT_EQ(max_rows * MultiRowDbIfMock::kEntriesPerRow, result.size());
+    for (size_t i = 1; i < result.size(); i++) {
+        EXPECT_LT(result[i - 1].timestamp, result[i].timestamp);
+    }
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
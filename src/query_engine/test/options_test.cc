@@ -80,6 +80,7 @@ TEST_F(OptionsTest, NoArguments) {
     EXPECT_EQ(options_.max_tasks(), 0);
     EXPECT_EQ(options_.max_slice(), 100);
     EXPECT_EQ(options_.test_mode(), false);
+    EXPECT_EQ(options_.stats_rollup(), false);
 }
 
 TEST_F(OptionsTest, DefaultConfFile) {
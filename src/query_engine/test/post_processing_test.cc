@@ -0,0 +1,462 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+
+#include "testing/gunit.h"
+
+#include "base/string_util.h"
+#include "query.h"
+#include "analytics_query_mock.h"
+
+using ::testing::Return;
+using ::testing::AnyNumber;
+
+typedef QEOpServerProxy::BufferT BufferT;
+typedef std::vector<boost::shared_ptr<BufferT> > BufferVec;
+
+// Orders rows on the name (string) and value (int) columns
+class RowLess {
+public:
+    explicit RowLess(bool ascending) : ascending_(ascending) {
+    }
+    bool operator()(const QEOpServerProxy::ResultRowT& lhs,
+                    const QEOpServerProxy::ResultRowT& rhs) const {
+        return ascending_ ? Less(lhs, rhs) : Less(rhs, lhs);
+    }
+
+private:
+    static bool Less(const QEOpServerProxy::ResultRowT& lhs,
+                     const QEOpServerProxy::ResultRowT& rhs) {
+        const std::string& lname = lhs.first.find("name")->second;
+        const std::string& rname = rhs.first.find("name")->second;
+        if (lname != rname) {
+            return lname < rname;
+        }
+        uint64_t lvalue, rvalue;
+        stringToInteger(lhs.first.find("value")->second, lvalue);
+        stringToInteger(rhs.first.find("value")->second, rvalue);
+        return lvalue < rvalue;
+    }
+
+    bool ascending_;
+};
+
+class PostProcessingTest : public ::testing::Test {
+protected:
+    PostProcessingTest() : seed_(1) {
+    }
+
+    virtual void SetUp() {
+        SetTable("StatTable.FieldNames.fields");
+        std::map<std::string, std::string> json;
+        // owned by aqmock_
+        pp_ = new PostProcessingQuery(json, &aqmock_);
+        pp_->sort_fields.push_back(sort_field_t("name", "string"));
+        pp_->sort_fields.push_back(sort_field_t("value", "int"));
+    }
+
+    void SetTable(const std::string& table) {
+        EXPECT_CALL(aqmock_, table())
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(table));
+    }
+
+    void SetSort(sort_op type, int limit) {
+        pp_->sorted = true;
+        pp_->sorting_type = type;
+        pp_->limit = limit;
+    }
+
+    // Deterministic pseudo random numbers, so that failures reproduce
+    uint32_t Random() {
+        seed_ = seed_ * 1103515245 + 12345;
+        return (seed_ / 65536) % 32768;
+    }
+
+    // Batch result with count rows, sorted on the sort fields. Few distinct
+    // names and values make for ties within and across batches
+    boost::shared_ptr<BufferT> Batch(size_t batch, size_t count,
+                                     bool ascending) {
+        boost::shared_ptr<BufferT> rows(new BufferT);
+        for (size_t i = 0; i < count; i++) {
+            QEOpServerProxy::OutRowT row;
+            row["name"] = "name" + integerToString(Random() % 3);
+            // 9 sorts after 10 as a string, not as an int
+            row["value"] = integerToString(Random() % 12);
+            row["id"] = integerToString(batch) + "." + integerToString(i);
+            rows->push_back(std::make_pair(row, QEOpServerProxy::MetadataT()));
+        }
+        std::stable_sort(rows->begin(), rows->end(), RowLess(ascending));
+        return rows;
+    }
+
+    BufferVec Batches(const size_t *sizes, size_t count, bool ascending) {
+        BufferVec batches;
+        for (size_t i = 0; i < count; i++) {
+            batches.push_back(Batch(i, sizes[i], ascending));
+        }
+        return batches;
+    }
+
+    // Rows of all the batches in batch order, stable sorted, which is the
+    // order the merge must produce: on equal sort values, rows of earlier
+    // batches go first
+    static std::vector<std::string> ExpectedIds(const BufferVec& batches,
+                                                bool ascending, size_t limit) {
+        BufferT all;
+        for (size_t i = 0; i < batches.size(); i++) {
+            all.insert(all.end(), batches[i]->begin(), batches[i]->end());
+        }
+        std::stable_sort(all.begin(), all.end(), RowLess(ascending));
+        if (limit && all.size() > limit) {
+            all.resize(limit);
+        }
+        return Ids(all);
+    }
+
+    static std::vector<std::string> Ids(const BufferT& rows) {
+        std::vector<std::string> ids;
+        for (size_t i = 0; i < rows.size(); i++) {
+            ids.push_back(rows[i].first.find("id")->second);
+        }
+        return ids;
+    }
+
+    AnalyticsQueryMock aqmock_;
+    PostProcessingQuery *pp_;
+    uint32_t seed_;
+};
+
+// Unevenly sized batches, including empty ones, are merged in order
+TEST_F(PostProcessingTest, MergeSortedResultsAscending) {
+    const size_t sizes[] = {0, 1, 57, 3, 0, 20, 200};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, true);
+    SetSort(ASCENDING, 0);
+    BufferT output;
+    pp_->merge_sorted_results(batches, &output, 0);
+    EXPECT_EQ(ExpectedIds(batches, true, 0), Ids(output));
+}
+
+TEST_F(PostProcessingTest, MergeSortedResultsDescending) {
+    const size_t sizes[] = {200, 20, 0, 3, 57, 1, 0};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, false);
+    SetSort(DESCENDING, 0);
+    BufferT output;
+    pp_->merge_sorted_results(batches, &output, 0);
+    EXPECT_EQ(ExpectedIds(batches, false, 0), Ids(output));
+}
+
+// Ties across batches are all in the first sort field and the merge heap
+// breaks them on the batch order
+TEST_F(PostProcessingTest, MergeSortedResultsTies) {
+    const size_t sizes[] = {4, 4, 4, 4};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, true);
+    for (size_t i = 0; i < batches.size(); i++) {
+        for (size_t j = 0; j < batches[i]->size(); j++) {
+            (*batches[i])[j].first["name"] = "name";
+            (*batches[i])[j].first["value"] = "10";
+        }
+    }
+    SetSort(ASCENDING, 0);
+    BufferT output;
+    pp_->merge_sorted_results(batches, &output, 0);
+    std::vector<std::string> ids = Ids(output);
+    ASSERT_EQ(16U, ids.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        EXPECT_EQ(integerToString(i / 4) + ".", ids[i].substr(0, 2));
+    }
+    EXPECT_EQ(ExpectedIds(batches, true, 0), ids);
+}
+
+// The merge stops after limit rows, in the middle of the batches
+TEST_F(PostProcessingTest, MergeSortedResultsLimit) {
+    const size_t sizes[] = {57, 1, 0, 20, 200};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    const size_t limits[] = {1, 10, 100, 277, 278, 1000};
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+        for (int ascending = 0; ascending < 2; ascending++) {
+            BufferVec batches = Batches(sizes, nsizes, ascending);
+            SetSort(ascending ? ASCENDING : DESCENDING, limits[i]);
+            BufferT output;
+            pp_->merge_sorted_results(batches, &output, limits[i]);
+            EXPECT_EQ(std::min(limits[i], (size_t)278), output.size());
+            EXPECT_EQ(ExpectedIds(batches, ascending, limits[i]),
+                      Ids(output));
+        }
+    }
+}
+
+// Pairwise merge of accumulated chunks, bound by the limit
+TEST_F(PostProcessingTest, MergeSortedResultLimit) {
+    const size_t sizes[] = {30, 45};
+    BufferVec batches = Batches(sizes, 2, true);
+    SetSort(ASCENDING, 0);
+    BufferT output;
+    pp_->merge_sorted_result(*batches[0], *batches[1], &output, 0);
+    EXPECT_EQ(ExpectedIds(batches, true, 0), Ids(output));
+
+    output.clear();
+    pp_->merge_sorted_result(*batches[0], *batches[1], &output, 20);
+    EXPECT_EQ(ExpectedIds(batches, true, 20), Ids(output));
+}
+
+// Sorted chunks are merged as they arrive, and rows past the limit are
+// dropped, except for flow records which are uniquified later
+TEST_F(PostProcessingTest, MergeProcessingSortedLimit) {
+    const size_t sizes[] = {30, 45, 10};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, false);
+    SetSort(DESCENDING, 25);
+    BufferT output;
+    for (size_t i = 0; i < batches.size(); i++) {
+        EXPECT_TRUE(pp_->merge_processing(*batches[i], output));
+    }
+    EXPECT_EQ(ExpectedIds(batches, false, 25), Ids(output));
+
+    SetTable(g_viz_constants.FLOW_TABLE);
+    output.clear();
+    for (size_t i = 0; i < batches.size(); i++) {
+        EXPECT_TRUE(pp_->merge_processing(*batches[i], output));
+    }
+    EXPECT_EQ(ExpectedIds(batches, false, 0), Ids(output));
+}
+
+// Unsorted chunks are concatenated, the limit is applied by the final merge
+TEST_F(PostProcessingTest, MergeProcessingUnsorted) {
+    const size_t sizes[] = {3, 4};
+    BufferVec batches = Batches(sizes, 2, true);
+    pp_->limit = 5;
+    BufferT output;
+    EXPECT_TRUE(pp_->merge_processing(*batches[0], output));
+    EXPECT_TRUE(pp_->merge_processing(*batches[1], output));
+    std::vector<std::string> expected = Ids(*batches[0]);
+    std::vector<std::string> ids1 = Ids(*batches[1]);
+    expected.insert(expected.end(), ids1.begin(), ids1.end());
+    EXPECT_EQ(expected, Ids(output));
+}
+
+// The final merge of sorted batch results is the k-way merge
+TEST_F(PostProcessingTest, FinalMergeProcessingSorted) {
+    const size_t sizes[] = {13, 0, 77, 5};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, true);
+    SetSort(ASCENDING, 40);
+    BufferT output;
+    EXPECT_TRUE(pp_->final_merge_processing(batches, output));
+    EXPECT_EQ(ExpectedIds(batches, true, 40), Ids(output));
+
+    SetSort(ASCENDING, 0);
+    output.clear();
+    EXPECT_TRUE(pp_->final_merge_processing(batches, output));
+    EXPECT_EQ(ExpectedIds(batches, true, 0), Ids(output));
+}
+
+// Unsorted batch results are copied in batch order up to the limit
+TEST_F(PostProcessingTest, FinalMergeProcessingUnsortedLimit) {
+    const size_t sizes[] = {3, 0, 4, 2};
+    const size_t nsizes = sizeof(sizes) / sizeof(sizes[0]);
+    BufferVec batches = Batches(sizes, nsizes, true);
+    std::vector<std::string> all;
+    for (size_t i = 0; i < batches.size(); i++) {
+        std::vector<std::string> ids = Ids(*batches[i]);
+        all.insert(all.end(), ids.begin(), ids.end());
+    }
+    const int limits[] = {0, 1, 3, 5, 9, 20};
+    for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+        pp_->limit = limits[i];
+        BufferT output;
+        EXPECT_TRUE(pp_->final_merge_processing(batches, output));
+        std::vector<std::string> expected(all);
+        if (limits[i] && expected.size() > (size_t)limits[i]) {
+            expected.resize(limits[i]);
+        }
+        EXPECT_EQ(expected, Ids(output));
+    }
+}
+
+// sort_field_comparator as it was before the sort values were converted
+// once per row, the reference order for sort_result and merge_sorted_result
+class OldSortFieldComparator {
+public:
+    explicit OldSortFieldComparator(
+        const std::vector<sort_field_t>& sort_fields) :
+        sort_fields_(sort_fields) {
+    }
+    bool operator()(const QEOpServerProxy::ResultRowT& lhs,
+                    const QEOpServerProxy::ResultRowT& rhs) const {
+        std::map<std::string, std::string>::const_iterator lhs_it, rhs_it;
+        for (std::vector<sort_field_t>::const_iterator sort_it =
+             sort_fields_.begin(); sort_it != sort_fields_.end(); sort_it++) {
+            lhs_it = lhs.first.find((*sort_it).name);
+            rhs_it = rhs.first.find((*sort_it).name);
+            if ((*sort_it).type == std::string("int") ||
+                (*sort_it).type == std::string("long") ||
+                (*sort_it).type == std::string("ipv4")) {
+                uint64_t lhs_val = 0, rhs_val = 0;
+                stringToInteger(lhs_it->second, lhs_val);
+                stringToInteger(rhs_it->second, rhs_val);
+                if (lhs_val < rhs_val) return true;
+                if (lhs_val > rhs_val) return false;
+            } else {
+                if (lhs_it->second < rhs_it->second) return true;
+                if (lhs_it->second > rhs_it->second) return false;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<sort_field_t> sort_fields_;
+};
+
+class SortValuesTest : public PostProcessingTest {
+protected:
+    // Rows with string, int, long, ipv4 and double columns. Few distinct
+    // values make for ties on every column
+    BufferT Rows(size_t count) {
+        BufferT rows;
+        for (size_t i = 0; i < count; i++) {
+            QEOpServerProxy::OutRowT row;
+            row["name"] = "vm" + integerToString(Random() % 4);
+            row["value"] = integerToString(Random() % 12);
+            row["bytes"] = integerToString((uint64_t)(Random() % 3) << 40);
+            // ipv4 columns hold the address as an integer, 9.0.0.x or
+            // 10.0.0.x
+            row["ip"] = integerToString(
+                ((uint64_t)(9 + Random() % 2) << 24) + Random() % 3);
+            // double columns are ordered as strings
+            row["cpu"] = integerToString(Random() % 11) + ".5";
+            row["id"] = integerToString(i);
+            rows.push_back(std::make_pair(row, QEOpServerProxy::MetadataT()));
+        }
+        return rows;
+    }
+
+    void SetSortFields(const char *fields[][2], size_t count) {
+        pp_->sort_fields.clear();
+        for (size_t i = 0; i < count; i++) {
+            pp_->sort_fields.push_back(sort_field_t(fields[i][0],
+                                                    fields[i][1]));
+        }
+    }
+
+    // Values of the sort fields of each row; rows that tie on all sort
+    // fields may come in any order
+    std::vector<std::string> Keys(const BufferT& rows) const {
+        std::vector<std::string> keys;
+        for (size_t i = 0; i < rows.size(); i++) {
+            std::string key;
+            for (size_t j = 0; j < pp_->sort_fields.size(); j++) {
+                key += rows[i].first.find(pp_->sort_fields[j].name)->second;
+                key += "|";
+            }
+            keys.push_back(key);
+        }
+        return keys;
+    }
+
+    // Rows ordered with the old comparator, as final_merge_processing did
+    BufferT OldSort(const BufferT& rows, bool ascending, size_t limit) const {
+        BufferT sorted(rows);
+        OldSortFieldComparator comparator(pp_->sort_fields);
+        if (ascending) {
+            std::sort(sorted.begin(), sorted.end(), comparator);
+        } else {
+            std::sort(sorted.rbegin(), sorted.rend(), comparator);
+        }
+        if (limit && sorted.size() > limit) {
+            sorted.resize(limit);
+        }
+        return sorted;
+    }
+
+    void SortAndCompare(const BufferT& rows, bool ascending, size_t limit) {
+        SetSort(ascending ? ASCENDING : DESCENDING, limit);
+        BufferT sorted(rows);
+        pp_->sort_result(&sorted, limit);
+        BufferT expected = OldSort(rows, ascending, limit);
+        EXPECT_EQ(Keys(expected), Keys(sorted));
+        if (limit == 0 || limit >= rows.size()) {
+            // all rows are kept
+            std::vector<std::string> ids = Ids(sorted);
+            std::vector<std::string> expected_ids = Ids(expected);
+            std::sort(ids.begin(), ids.end());
+            std::sort(expected_ids.begin(), expected_ids.end());
+            EXPECT_EQ(expected_ids, ids);
+        }
+    }
+};
+
+// Sort on mixed columns, one and several sort fields, in both directions,
+// with and without a limit
+TEST_F(SortValuesTest, SortResultMatchesOldComparator) {
+    const char *string_int[][2] = {{"name", "string"}, {"value", "int"}};
+    const char *int_string[][2] = {{"value", "int"}, {"name", "string"}};
+    const char *double_only[][2] = {{"cpu", "double"}};
+    const char *mixed[][2] = {{"ip", "ipv4"}, {"cpu", "double"},
+                              {"bytes", "long"}, {"name", "string"}};
+    BufferT rows = Rows(300);
+    const size_t limits[] = {0, 1, 7, 100, 300, 1000};
+    for (int ascending = 0; ascending < 2; ascending++) {
+        for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+            SetSortFields(string_int, 2);
+            SortAndCompare(rows, ascending, limits[i]);
+            SetSortFields(int_string, 2);
+            SortAndCompare(rows, ascending, limits[i]);
+            SetSortFields(double_only, 1);
+            SortAndCompare(rows, ascending, limits[i]);
+            SetSortFields(mixed, 4);
+            SortAndCompare(rows, ascending, limits[i]);
+        }
+    }
+}
+
+// Numeric columns are ordered as numbers and double columns as strings
+TEST_F(SortValuesTest, SortResultColumnTypes) {
+    const char *fields[][2] = {{"value", "int"}, {"cpu", "double"}};
+    SetSortFields(fields, 2);
+    BufferT rows = Rows(3);
+    rows[0].first["value"] = "10";
+    rows[0].first["cpu"] = "9.5";
+    rows[1].first["value"] = "9";
+    rows[1].first["cpu"] = "10.5";
+    rows[2].first["value"] = "9";
+    rows[2].first["cpu"] = "9.5";
+    SetSort(ASCENDING, 0);
+    pp_->sort_result(&rows, 0);
+    std::vector<std::string> ids = Ids(rows);
+    ASSERT_EQ(3U, ids.size());
+    EXPECT_EQ("1", ids[0]);
+    EXPECT_EQ("2", ids[1]);
+    EXPECT_EQ("0", ids[2]);
+}
+
+// Merging two sorted chunks gives the order the old comparator merged to
+TEST_F(SortValuesTest, MergeSortedResultMatchesOldComparator) {
+    const char *mixed[][2] = {{"name", "string"}, {"ip", "ipv4"},
+                              {"cpu", "double"}};
+    SetSortFields(mixed, 3);
+    BufferT rows = Rows(120);
+    for (int ascending = 0; ascending < 2; ascending++) {
+        SetSort(ascending ? ASCENDING : DESCENDING, 0);
+        BufferT rows1 = OldSort(BufferT(rows.begin(), rows.begin() + 50),
+                                ascending, 0);
+        BufferT rows2 = OldSort(BufferT(rows.begin() + 50, rows.end()),
+                                ascending, 0);
+        BufferT merged;
+        pp_->merge_sorted_result(rows1, rows2, &merged);
+        EXPECT_EQ(Keys(OldSort(rows, ascending, 0)), Keys(merged));
+        EXPECT_EQ(rows.size(), merged.size());
+    }
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
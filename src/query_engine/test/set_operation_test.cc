@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "testing/gunit.h"
+
+#include "base/time_util.h"
+#include "query.h"
+
+typedef std::vector<query_result_unit_t> QueryResultVec;
+
+// Top level query holding the set operation under test
+class MainQueryUnit : public QueryUnit {
+public:
+    MainQueryUnit() : QueryUnit(NULL, NULL) {
+    }
+    virtual query_status_t process_query() {
+        return QUERY_SUCCESS;
+    }
+};
+
+// Sub-query returning a canned, sorted, index result
+class IndexResultUnit : public QueryUnit {
+public:
+    IndexResultUnit(QueryUnit *parent, const QueryResultVec& result) :
+        QueryUnit(parent, parent->main_query) {
+        query_result = result;
+    }
+    virtual query_status_t process_query() {
+        return QUERY_SUCCESS;
+    }
+};
+
+class SetOperationTest : public ::testing::Test {
+protected:
+    // Synthetic index result with count entries at timestamps start,
+    // start + step, ..
+    static QueryResultVec IndexResult(size_t count, uint64_t start,
+                                      uint64_t step) {
+        QueryResultVec result;
+        result.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            query_result_unit_t unit;
+            unit.timestamp = start + i * step;
+            unit.info.push_back(GenDb::DbDataValue(
+                static_cast<uint64_t>(unit.timestamp % 7)));
+            result.push_back(unit);
+        }
+        return result;
+    }
+
+    // The set operation is owned and deleted by main_query
+    static SetOperationUnit *CreateSetOperation(MainQueryUnit *main_query,
+        bool intersection, const std::vector<QueryResultVec>& results) {
+        SetOperationUnit *set_op = new SetOperationUnit(main_query,
+                                                        main_query);
+        set_op->set_operation = intersection ?
+            SetOperationUnit::INTERSECTION_OP : SetOperationUnit::UNION_OP;
+        for (size_t i = 0; i < results.size(); i++) {
+            new IndexResultUnit(set_op, results[i]);
+        }
+        return set_op;
+    }
+
+    static QueryResultVec SetOperation(bool intersection,
+        const std::vector<QueryResultVec>& results) {
+        MainQueryUnit main_query;
+        SetOperationUnit *set_op = CreateSetOperation(&main_query,
+            intersection, results);
+        EXPECT_EQ(QUERY_SUCCESS, set_op->process_query());
+        return set_op->query_result;
+    }
+
+    // Result of chaining std::set_union / std::set_intersection
+    static QueryResultVec Expected(bool intersection,
+        const std::vector<QueryResultVec>& results) {
+        QueryResultVec expected = results[0];
+        for (size_t i = 1; i < results.size(); i++) {
+            QueryResultVec tmp;
+            if (intersection) {
+                std::set_intersection(expected.begin(), expected.end(),
+                    results[i].begin(), results[i].end(),
+                    std::back_inserter(tmp));
+            } else {
+                std::set_union(expected.begin(), expected.end(),
+                    results[i].begin(), results[i].end(),
+                    std::back_inserter(tmp));
+            }
+            expected.swap(tmp);
+        }
+        return expected;
+    }
+
+    static void ExpectEqual(const QueryResultVec& expected,
+                            const QueryResultVec& actual) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            EXPECT_FALSE(expected[i] < actual[i]);
+            EXPECT_FALSE(actual[i] < expected[i]);
+        }
+    }
+};
+
+TEST_F(SetOperationTest, Union) {
+    std::vector<QueryResultVec> results;
+    results.push_back(IndexResult(1000, 0, 3));
+    results.push_back(IndexResult(500, 100, 5));
+    results.push_back(QueryResultVec());
+    results.push_back(IndexResult(2000, 50, 2));
+    ExpectEqual(Expected(false, results), SetOperation(false, results));
+}
+
+TEST_F(SetOperationTest, UnionDuplicates) {
+    std::vector<QueryResultVec> results;
+    QueryResultVec dup(IndexResult(100, 0, 2));
+    QueryResultVec more(IndexResult(100, 0, 4));
+    dup.insert(dup.end(), more.begin(), more.end());
+    std::sort(dup.begin(), dup.end());
+    results.push_back(IndexResult(300, 0, 1));
+    results.push_back(dup);
+    ExpectEqual(Expected(false, results), SetOperation(false, results));
+}
+
+TEST_F(SetOperationTest, Intersection) {
+    std::vector<QueryResultVec> results;
+    results.push_back(IndexResult(1000, 0, 3));
+    results.push_back(IndexResult(500, 100, 5));
+    results.push_back(IndexResult(2000, 50, 2));
+    ExpectEqual(Expected(true, results), SetOperation(true, results));
+}
+
+TEST_F(SetOperationTest, IntersectionSkewed) {
+    std::vector<QueryResultVec> results;
+    results.push_back(IndexResult(100000, 0, 1));
+    results.push_back(IndexResult(10, 777, 9973));
+    results.push_back(IndexResult(100, 7, 997));
+    ExpectEqual(Expected(true, results), SetOperation(true, results));
+}
+
+TEST_F(SetOperationTest, IntersectionEmpty) {
+    std::vector<QueryResultVec> results;
+    results.push_back(IndexResult(1000, 0, 3));
+    results.push_back(QueryResultVec());
+    results.push_back(IndexResult(2000, 50, 2));
+    EXPECT_TRUE(SetOperation(true, results).empty());
+}
+
+// Compares the set operations against chained std::set_union /
+// std::set_intersection on synthetic index results; timings are printed
+// and not checked
+TEST_F(SetOperationTest, DISABLED_Benchmark) {
+    std::vector<QueryResultVec> union_results;
+    for (int i = 0; i < 8; i++) {
+        union_results.push_back(IndexResult(200000, i, 8 + i));
+    }
+    std::vector<QueryResultVec> int_results;
+    int_results.push_back(IndexResult(1000000, 0, 1));
+    int_results.push_back(IndexResult(1000, 0, 997));
+    int_results.push_back(IndexResult(100000, 0, 3));
+
+    for (int intersection = 0; intersection < 2; intersection++) {
+        const std::vector<QueryResultVec>& results =
+            intersection ? int_results : union_results;
+        uint64_t start = ClockMonotonicUsec();
+        QueryResultVec expected(Expected(intersection, results));
+        uint64_t chained = ClockMonotonicUsec() - start;
+        MainQueryUnit main_query;
+        SetOperationUnit *set_op = CreateSetOperation(&main_query,
+            intersection, results);
+        start = ClockMonotonicUsec();
+        EXPECT_EQ(QUERY_SUCCESS, set_op->process_query());
+        uint64_t processed = ClockMonotonicUsec() - start;
+        ExpectEqual(expected, set_op->query_result);
+        std::cout << (intersection ? "Intersection" : "Union") <<
+            " of " << results.size() << " results: chained " << chained <<
+            " usec, SetOperationUnit " << processed << " usec" << std::endl;
+    }
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
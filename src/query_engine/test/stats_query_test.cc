@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "testing/gunit.h"
+
+#include "stats_query.h"
+
+class StatsQueryTest : public ::testing::Test {
+protected:
+    static const uint64_t kUsecPerSec = 1000000ULL;
+
+    StatsQueryTest() :
+        stats_("StatTable.VirtualMachineStats.cpu_stats"),
+        // Two days before now, both aligned to the hour
+        from_time_((1449997200ULL - 2 * 86400) * kUsecPerSec),
+        now_(1449997200ULL * kUsecPerSec),
+        rollup_start_time_(from_time_ - 1800 * kUsecPerSec) {
+    }
+
+    virtual void SetUp() {
+        select_.push_back("T=3600");
+        select_.push_back("name");
+        select_.push_back("SUM(cpu_stats.rss)");
+        select_.push_back("MAX(cpu_stats.cpu_one_min_avg)");
+        select_.push_back("MIN(cpu_stats.cpu_one_min_avg)");
+        select_.push_back("COUNT(cpu_stats)");
+    }
+
+    uint32_t SelectRollup(uint64_t from_time, uint64_t end_time,
+                          bool filter = false) {
+        stats_.SelectRollup(select_, filter, from_time, end_time, now_,
+                            rollup_start_time_);
+        return stats_.rollup_period();
+    }
+
+    StatsQuery stats_;
+    std::vector<std::string> select_;
+    uint64_t from_time_;
+    uint64_t now_;
+    uint64_t rollup_start_time_;
+};
+
+TEST_F(StatsQueryTest, Coarsest) {
+    EXPECT_EQ(3600U, SelectRollup(from_time_,
+        from_time_ + 86400 * kUsecPerSec - 1));
+    EXPECT_TRUE(stats_.is_rollup());
+    EXPECT_EQ("cpu_stats@3600", stats_.db_attr());
+
+    select_[0] = "T=60";
+    EXPECT_EQ(60U, SelectRollup(from_time_,
+        from_time_ + 86400 * kUsecPerSec - 1));
+    EXPECT_EQ("cpu_stats@60", stats_.db_attr());
+}
+
+TEST_F(StatsQueryTest, TimeRange) {
+    // Not aligned to the hour
+    EXPECT_EQ(60U, SelectRollup(from_time_ + 60 * kUsecPerSec,
+        from_time_ + 3600 * kUsecPerSec - 1));
+    // Not aligned to the minute
+    EXPECT_EQ(0U, SelectRollup(from_time_ + kUsecPerSec,
+        from_time_ + 3600 * kUsecPerSec - 1));
+    EXPECT_EQ(0U, SelectRollup(from_time_, from_time_ + 3600 * kUsecPerSec));
+    // Not rolled up yet
+    EXPECT_EQ(0U, SelectRollup(now_ - 3600 * kUsecPerSec, now_ - 1));
+    EXPECT_FALSE(stats_.is_rollup());
+    EXPECT_EQ("cpu_stats", stats_.db_attr());
+}
+
+// Samples of the periods that started before the rollups were enabled, or
+// before the collector restarted, were not all rolled up
+TEST_F(StatsQueryTest, RollupStartTime) {
+    uint64_t end_time = from_time_ + 7200 * kUsecPerSec - 1;
+    rollup_start_time_ = from_time_ + 60 * kUsecPerSec;
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    EXPECT_EQ(3600U, SelectRollup(from_time_ + 3600 * kUsecPerSec,
+        end_time));
+    select_[0] = "T=60";
+    EXPECT_EQ(60U, SelectRollup(from_time_ + 120 * kUsecPerSec, end_time));
+
+    // Rollups are disabled
+    rollup_start_time_ = 0;
+    EXPECT_EQ(0U, SelectRollup(from_time_ + 3600 * kUsecPerSec, end_time));
+}
+
+TEST_F(StatsQueryTest, Fields) {
+    uint64_t end_time = from_time_ + 3600 * kUsecPerSec - 1;
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time, true));
+
+    select_[0] = "T=90";
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_[0] = "T";
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_[0] = "T=3600";
+
+    select_.push_back("UUID");
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_.back() = "cpu_stats.rss";
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_.back() = "CLASS(cpu_stats.rss)";
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_.back() = "SUM(name)";
+    EXPECT_EQ(0U, SelectRollup(from_time_, end_time));
+    select_.pop_back();
+    EXPECT_EQ(3600U, SelectRollup(from_time_, end_time));
+}
+
+TEST_F(StatsQueryTest, Tags) {
+    StatsQuery stats("StatTable.StatTestState.st");
+    std::vector<std::string> select;
+    select.push_back("T=60");
+    select.push_back("st.s1");
+    select.push_back("COUNT(st)");
+    uint64_t end_time = from_time_ + 3600 * kUsecPerSec - 1;
+    stats.SelectRollup(select, false, from_time_, end_time, now_,
+                       rollup_start_time_);
+    EXPECT_EQ(60U, stats.rollup_period());
+
+    // st.i2 is a suffix tag and st.d1 a tag, so neither is rolled up
+    select.push_back("SUM(st.i2)");
+    stats.SelectRollup(select, false, from_time_, end_time, now_,
+                       rollup_start_time_);
+    EXPECT_EQ(0U, stats.rollup_period());
+    select.back() = "MAX(st.d1)";
+    stats.SelectRollup(select, false, from_time_, end_time, now_,
+                       rollup_start_time_);
+    EXPECT_EQ(0U, stats.rollup_period());
+
+    // Samples are rolled up by tags only, so string fields that are not
+    // tags can not be selected
+    StatsQuery dstats("StatTable.StatTestStateDouble.dst.st");
+    select.clear();
+    select.push_back("T=60");
+    select.push_back("dst.l1");
+    select.push_back("dst.st.s2");
+    dstats.SelectRollup(select, false, from_time_, end_time, now_,
+                        rollup_start_time_);
+    EXPECT_EQ(60U, dstats.rollup_period());
+    select.push_back("dst.st.s1");
+    dstats.SelectRollup(select, false, from_time_, end_time, now_,
+                        rollup_start_time_);
+    EXPECT_EQ(0U, dstats.rollup_period());
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -275,16 +275,8 @@ bool WhereQuery::StatTermProcess(const rapidjson::Value& where_term,
     db_query->t_only_row = false;
     db_query->cfname = cfname;
 
-    size_t tpos,apos;
-    std::string tname = m_query->table();
-    tpos = tname.find('.');
-    apos = tname.find('.', tpos+1);
-
-    std::string tstr = tname.substr(tpos+1, apos-tpos-1);
-    std::string astr = tname.substr(apos+1, std::string::npos);
-
-    db_query->row_key_suffix.push_back(tstr);
-    db_query->row_key_suffix.push_back(astr);
+    db_query->row_key_suffix.push_back(m_query->stats().type());
+    db_query->row_key_suffix.push_back(m_query->stats().db_attr());
     db_query->row_key_suffix.push_back(pname);
   
     if (twotag) {
@@ -5,6 +5,7 @@
 #include <base/util.h>
 #include <base/logging.h>
 #include <base/connection_info.h>
+#include <base/timer.h>
 #include <net/bgp_af.h>
 #include <sandesh/sandesh.h>
 #include <sandesh/sandesh_types.h>
@@ -13,6 +14,7 @@
 #include "controller/controller_ifmap.h"
 #include "controller/controller_vrf_export.h"
 #include "controller/controller_init.h"
+#include "init/agent_param.h"
 #include "oper/operdb_init.h"
 #include "oper/vrf.h"
 #include "oper/nexthop.h"
@@ -76,14 +78,31 @@ AgentXmppChannel::AgentXmppChannel(Agent *agent,
                                    const std::string &label_range,
                                    uint8_t xs_idx)
     : channel_(NULL), xmpp_server_(xmpp_server), label_range_(label_range),
-      xs_idx_(xs_idx), agent_(agent), unicast_sequence_number_(0) {
+      xs_idx_(xs_idx), agent_(agent), unicast_sequence_number_(0),
+      route_export_batch_(0), route_export_associate_(false),
+      route_export_count_(0), route_export_bytes_(0), route_export_id_(0),
+      route_export_timer_(NULL) {
     bgp_peer_id_.reset();
+    if (agent_->params()) {
+        route_export_batch_ = agent_->params()->route_export_batch();
+    }
+    if (route_export_batch_ > 1) {
+        route_export_timer_ =
+            TimerManager::CreateTimer(*(agent_->event_manager()->
+                                        io_service()),
+                                      "Agent route export timer",
+                                      TaskScheduler::GetInstance()->
+                                      GetTaskId("db::DBTable"), 0);
+    }
 }
 
 AgentXmppChannel::~AgentXmppChannel() {
     BgpPeer *bgp_peer = bgp_peer_id_.get();
     assert(bgp_peer == NULL);
     channel_->UnRegisterReceive(xmps::BGP);
+    if (route_export_timer_) {
+        TimerManager::DeleteTimer(route_export_timer_);
+    }
 }
 
 void AgentXmppChannel::RegisterXmppChannel(XmppChannel *channel) {
@@ -138,6 +157,158 @@ bool AgentXmppChannel::SendUpdate(uint8_t *msg, size_t size) {
                           boost::bind(&AgentXmppChannel::WriteReadyCb, this, _1));
 }
 
+namespace {
+// Counts the bytes of an encoded node
+class XmlSizeWriter : public pugi::xml_writer {
+public:
+    XmlSizeWriter() : size_(0) {}
+    virtual void write(const void *data, size_t size) { size_ += size; }
+    size_t size() const { return size_; }
+private:
+    size_t size_;
+};
+}
+
+// Adds the route item to the export batch. The batch is sent when it is full
+// and before a route of another VRF, address family or operation is added, so
+// routes reach the control node in the order they were exported.
+template <typename ItemType>
+bool AgentXmppChannel::ExportRouteItem(ItemType &item,
+                                       const std::string &vrf_name,
+                                       const std::string &node_id,
+                                       bool associate) {
+    stringstream key;
+    key << item.entry.nlri.af << "/" << item.entry.nlri.safi << "/"
+        << vrf_name;
+
+    tbb::mutex::scoped_lock lock(route_export_mutex_);
+    if (route_export_count_ &&
+        (route_export_key_ != key.str() ||
+         route_export_associate_ != associate)) {
+        FlushRouteExportLocked();
+    }
+
+    XmlPugi *pugi;
+    if (route_export_count_ == 0) {
+        route_export_doc_.reset(XmppStanza::AllocXmppXmlImpl());
+        pugi = reinterpret_cast<XmlPugi *>(route_export_doc_.get());
+
+        pugi->AddNode("iq", "");
+        pugi->AddAttribute("type", "set");
+        pugi->AddAttribute("from", channel_->FromString());
+        std::string to(channel_->ToString());
+        to += "/";
+        to += XmppInit::kBgpPeer;
+        pugi->AddAttribute("to", to);
+
+        stringstream pubsub_id;
+        pubsub_id << "pubsub_batch" << route_export_id_;
+        pugi->AddAttribute("id", pubsub_id.str());
+
+        pugi->AddChildNode("pubsub", "");
+        pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
+        pugi->AddChildNode("publish", "");
+        // Control node associates all the items with the publish node
+        pugi->AddAttribute("node", node_id);
+
+        route_export_key_ = key.str();
+        route_export_node_ = node_id;
+        route_export_vrf_ = vrf_name;
+        route_export_associate_ = associate;
+    } else {
+        pugi = reinterpret_cast<XmlPugi *>(route_export_doc_.get());
+        pugi->ReadNode("publish");
+    }
+
+    pugi->AddChildNode("item", "");
+    pugi::xml_node node = pugi->FindNode("publish").last_child();
+
+    //Call Auto-generated Code to encode the struct
+    item.Encode(&node);
+    route_export_count_++;
+    XmlSizeWriter writer;
+    node.print(writer, "", pugi::format_raw);
+    route_export_bytes_ += writer.size();
+
+    if ((route_export_count_ >= route_export_batch_) ||
+        (route_export_bytes_ >= kRouteExportMaxBytes)) {
+        FlushRouteExportLocked();
+    } else if (route_export_count_ == 1) {
+        // Timer changes state outside route_export_mutex_. A fired timer
+        // may already have flushed and cannot be restarted, send the
+        // batch right away instead of leaving it behind
+        if (route_export_timer_->fired()) {
+            FlushRouteExportLocked();
+        } else {
+            route_export_timer_->Start(kRouteExportDelayMsec,
+                boost::bind(&AgentXmppChannel::RouteExportTimerExpired,
+                            this));
+        }
+    }
+    return true;
+}
+
+// Encodes the publish and its collection message back to back in
+// route_export_buf_, reused across batches, and sends them together
+void AgentXmppChannel::FlushRouteExportLocked() {
+    if (route_export_count_ == 0) {
+        return;
+    }
+
+    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(route_export_doc_.get());
+    route_export_buf_.clear();
+    pugi->AppendDocToBuffer(&route_export_buf_);
+
+    pugi->DeleteNode("pubsub");
+    pugi->ReadNode("iq");
+
+    stringstream collection_id;
+    collection_id << "collection_batch" << route_export_id_++;
+    pugi->ModifyAttribute("id", collection_id.str());
+    pugi->AddChildNode("pubsub", "");
+    pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
+    pugi->AddChildNode("collection", "");
+
+    pugi->AddAttribute("node", route_export_vrf_);
+    if (route_export_associate_) {
+        pugi->AddChildNode("associate", "");
+    } else {
+        pugi->AddChildNode("dissociate", "");
+    }
+    pugi->AddAttribute("node", route_export_node_);
+    pugi->AppendDocToBuffer(&route_export_buf_);
+
+    route_export_doc_.reset();
+    route_export_count_ = 0;
+    route_export_bytes_ = 0;
+    SendUpdate(&route_export_buf_[0], route_export_buf_.size());
+}
+
+void AgentXmppChannel::FlushRouteExport() {
+    if (route_export_batch_ <= 1) {
+        return;
+    }
+    tbb::mutex::scoped_lock lock(route_export_mutex_);
+    FlushRouteExportLocked();
+}
+
+void AgentXmppChannel::DropRouteExport() {
+    if (route_export_batch_ <= 1) {
+        return;
+    }
+    tbb::mutex::scoped_lock lock(route_export_mutex_);
+    // A timer that already fired finds the batch empty
+    route_export_timer_->Cancel();
+    route_export_doc_.reset();
+    route_export_count_ = 0;
+    route_export_bytes_ = 0;
+}
+
+bool AgentXmppChannel::RouteExportTimerExpired() {
+    FlushRouteExport();
+    return false;
+}
+
 void AgentXmppChannel::ReceiveEvpnUpdate(XmlPugi *pugi) {
     pugi::xml_node node = pugi->FindNode("items");
     pugi::xml_attribute attr = node.attribute("node");
@@ -1461,6 +1632,8 @@ void AgentXmppChannel::HandleAgentXmppClientChannelEvent(AgentXmppChannel *peer,
             return;
 
         BgpPeer *decommissioned_peer_id = peer->bgp_peer_id();
+        // Routes batched for export are sent again when the channel is up
+        peer->DropRouteExport();
         // Add BgpPeer to global decommissioned list
         peer->DeCommissionBgpPeer();
 
@@ -1565,6 +1738,7 @@ bool AgentXmppChannel::ControllerSendVmCfgSubscribe(AgentXmppChannel *peer,
     if (!peer) {
         return false;
     }
+    peer->FlushRouteExport();
 
     //Build the DOM tree
     auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
@@ -1612,6 +1786,7 @@ bool AgentXmppChannel::ControllerSendCfgSubscribe(AgentXmppChannel *peer) {
     if (!peer) {
         return false;
     }
+    peer->FlushRouteExport();
 
     //Build the DOM tree
     auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
@@ -1653,6 +1828,8 @@ bool AgentXmppChannel::ControllerSendSubscribe(AgentXmppChannel *peer,
     if (!peer) {
         return false;
     }
+    // Routes batched for export go out ahead of the VRF (un)subscribe
+    peer->FlushRouteExport();
     CONTROLLER_TRACE(Trace, peer->GetBgpPeerName(), vrf->GetName(),
                      subscribe ? "Subscribe" : "Unsubscribe");
     //Build the DOM tree
@@ -1707,10 +1884,6 @@ bool AgentXmppChannel::ControllerSendV4V6UnicastRouteCommon(AgentRoute *route,
     uint8_t data_[4096];
     size_t datalen_;
 
-    //Build the DOM tree
-    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
-    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
-
     if (type == Agent::INET4_UNICAST) {
         item.entry.nlri.af = BgpAf::IPv4;
     } else {
@@ -1746,6 +1919,22 @@ bool AgentXmppChannel::ControllerSendV4V6UnicastRouteCommon(AgentRoute *route,
     item.entry.sequence_number = path_preference.sequence();
     item.entry.local_preference = path_preference.preference();
 
+    //Catering for inet4 and evpn unicast routes
+    stringstream ss_node;
+    ss_node << item.entry.nlri.af << "/"
+            << item.entry.nlri.safi << "/"
+            << route->vrf()->GetName() << "/"
+            << route->GetAddressString();
+    std::string node_id(ss_node.str());
+    if (route_export_batch_ > 1) {
+        return ExportRouteItem(item, route->vrf()->GetName(), node_id,
+                               associate);
+    }
+
+    //Build the DOM tree
+    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
+    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
+
     pugi->AddNode("iq", "");
     pugi->AddAttribute("type", "set");
 
@@ -1762,14 +1951,6 @@ bool AgentXmppChannel::ControllerSendV4V6UnicastRouteCommon(AgentRoute *route,
     pugi->AddChildNode("pubsub", "");
     pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
     pugi->AddChildNode("publish", "");
-
-    //Catering for inet4 and evpn unicast routes
-    stringstream ss_node;
-    ss_node << item.entry.nlri.af << "/"
-            << item.entry.nlri.safi << "/"
-            << route->vrf()->GetName() << "/"
-            << route->GetAddressString();
-    std::string node_id(ss_node.str());
     pugi->AddAttribute("node", node_id);
     pugi->AddChildNode("item", "");
 
@@ -2059,6 +2240,11 @@ bool AgentXmppChannel::BuildAndSendEvpnDom(EnetItemType &item,
     uint8_t data_[4096];
     size_t datalen_;
 
+    if (route_export_batch_ > 1) {
+        return ExportRouteItem(item, route->vrf()->GetName(), ss_node.str(),
+                               associate);
+    }
+
     //Build the DOM tree
     auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
     XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
@@ -2193,10 +2379,6 @@ bool AgentXmppChannel::ControllerSendMcastRouteCommon(AgentRoute *route,
                      route->vrf()->GetName(), " ",
                      route->ToString());
 
-    //Build the DOM tree
-    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
-    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
-
     item.entry.nlri.af = BgpAf::IPv4;
     item.entry.nlri.safi = BgpAf::Mcast;
     item.entry.nlri.group = route->GetAddressString();
@@ -2211,6 +2393,21 @@ bool AgentXmppChannel::ControllerSendMcastRouteCommon(AgentRoute *route,
     item_nexthop.tunnel_encapsulation_list.tunnel_encapsulation.push_back("udp");
     item.entry.next_hops.next_hop.push_back(item_nexthop);
 
+    stringstream ss_node;
+    ss_node << item.entry.nlri.af << "/"
+            << item.entry.nlri.safi << "/"
+            << route->vrf()->GetName() << "/"
+            << route->GetAddressString();
+    std::string node_id(ss_node.str());
+    if (route_export_batch_ > 1) {
+        return ExportRouteItem(item, route->vrf()->GetName(), node_id,
+                               add_route);
+    }
+
+    //Build the DOM tree
+    auto_ptr<XmlBase> impl(XmppStanza::AllocXmppXmlImpl());
+    XmlPugi *pugi = reinterpret_cast<XmlPugi *>(impl.get());
+
     //Build the pugi tree
     pugi->AddNode("iq", "");
     pugi->AddAttribute("type", "set");
@@ -2229,12 +2426,6 @@ bool AgentXmppChannel::ControllerSendMcastRouteCommon(AgentRoute *route,
     pugi->AddChildNode("pubsub", "");
     pugi->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
     pugi->AddChildNode("publish", "");
-    stringstream ss_node;
-    ss_node << item.entry.nlri.af << "/"
-            << item.entry.nlri.safi << "/"
-            << route->vrf()->GetName() << "/"
-            << route->GetAddressString();
-    std::string node_id(ss_node.str());
     pugi->AddAttribute("node", node_id);
     pugi->AddChildNode("item", "");
 
@@ -7,11 +7,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 #include <boost/function.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <tbb/mutex.h>
 #include <xmpp/xmpp_channel.h>
 #include <xmpp_enet_types.h>
 #include <xmpp_unicast_types.h>
@@ -21,7 +23,9 @@ class AgentRoute;
 class Peer;
 class BgpPeer;
 class VrfEntry;
+class XmlBase;
 class XmlPugi;
+class Timer;
 class PathPreference;
 class AgentPath;
 
@@ -34,6 +38,11 @@ public:
 
     virtual std::string ToString() const;
     virtual bool SendUpdate(uint8_t *msg, size_t msgsize);
+    // Sends the routes batched for export, if any
+    void FlushRouteExport();
+    // Discards the routes batched for export when the channel goes down
+    void DropRouteExport();
+    uint16_t route_export_count() const { return route_export_count_; }
     virtual void ReceiveUpdate(const XmppStanza::XmppMessage *msg);
     virtual void ReceiveEvpnUpdate(XmlPugi *pugi);
     virtual void ReceiveMulticastUpdate(XmlPugi *pugi);
@@ -205,6 +214,12 @@ private:
                              std::stringstream &ss_node,
                              const AgentRoute *route,
                              bool associate);
+    // Route export batching
+    template <typename ItemType>
+    bool ExportRouteItem(ItemType &item, const std::string &vrf_name,
+                         const std::string &node_id, bool associate);
+    void FlushRouteExportLocked();
+    bool RouteExportTimerExpired();
 
     XmppChannel *channel_;
     std::string xmpp_server_;
@@ -213,6 +228,26 @@ private:
     boost::shared_ptr<BgpPeer> bgp_peer_id_;
     Agent *agent_;
     uint64_t unicast_sequence_number_;
+
+    // Routes of the same VRF, address family and operation exported back to
+    // back are sent in one publish of at most route_export_batch_ items and
+    // kRouteExportMaxBytes of encoded items, followed by its collection
+    // message. A partial batch is sent after kRouteExportDelayMsec or before
+    // the next subscribe message.
+    static const int kRouteExportDelayMsec = 10;
+    static const size_t kRouteExportMaxBytes = 16 * 1024;
+    uint16_t route_export_batch_;
+    tbb::mutex route_export_mutex_;
+    boost::scoped_ptr<XmlBase> route_export_doc_;
+    std::string route_export_key_;
+    std::string route_export_node_;
+    std::string route_export_vrf_;
+    bool route_export_associate_;
+    uint16_t route_export_count_;
+    size_t route_export_bytes_;
+    uint64_t route_export_id_;
+    std::vector<uint8_t> route_export_buf_;
+    Timer *route_export_timer_;
 };
 
 #endif // __CONTROLLER_PEER_H__
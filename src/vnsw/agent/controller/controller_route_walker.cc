@@ -13,6 +13,7 @@
 #include <oper/agent_route_walker.h>
 #include <oper/peer.h>
 #include <oper/vrf.h>
+#include <oper/vn.h>
 #include <oper/mirror_table.h>
 #include <oper/agent_sandesh.h>
 
@@ -21,10 +22,24 @@
 #include "controller/controller_types.h"
 #include "controller/controller_vrf_export.h"
 #include "controller/controller_export.h"
+#include "init/agent_param.h"
 
 ControllerRouteWalker::ControllerRouteWalker(Agent *agent, Peer *peer) : 
     AgentRouteWalker(agent, AgentRouteWalker::ALL), peer_(peer), 
     associate_(false), type_(NOTIFYALL) {
+    if (agent->params()) {
+        set_max_route_walks(agent->params()->route_walk_concurrency());
+    }
+}
+
+// Routes in fabric VRF and in VRF of virtual networks, where VM interfaces
+// are attached, affect data path the most and are walked first
+uint32_t ControllerRouteWalker::RouteWalkPriority(const VrfEntry *vrf) const {
+    if (vrf->GetName() == agent()->fabric_vrf_name())
+        return 0;
+    if (vrf->vn() && (vrf->vn()->GetVrf() == vrf))
+        return 1;
+    return 2;
 }
 
 // Takes action based on context of walk. These walks are not parallel.
@@ -17,6 +17,10 @@
  * 4) STALE - Marks the path/info from this peer as stale and does not delete
  * it. Valid only for headless agent mode. In the case of unicast it marks peer
  * path as stale and in multicast it doesnt delete  the info sent by this peer.
+ *
+ * When the number of parallel VRF route walks is limited, see
+ * CONTROL-NODE.route_walk_concurrency, the fabric VRF is walked first followed
+ * by the VRF of virtual networks, which carry the local VM routes.
  */
 class ControllerRouteWalker : public AgentRouteWalker {
 public:    
@@ -41,6 +45,8 @@ public:
     virtual bool VrfWalkNotify(DBTablePartBase *partition, DBEntryBase *e);
     //Override route notification
     virtual bool RouteWalkNotify(DBTablePartBase *partition, DBEntryBase *e);
+    //Override route walk order
+    virtual uint32_t RouteWalkPriority(const VrfEntry *vrf) const;
 
 private:
     //VRF notification handlers
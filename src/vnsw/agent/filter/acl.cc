@@ -114,6 +114,7 @@ DBEntry *AclTable::Add(const DBRequest *req) {
          ++it) {
         acl->AddAclEntry(*it, acl->acl_entries_);
     }
+    acl->BuildClassifier();
     return acl;
 }
 
@@ -152,6 +153,10 @@ bool AclTable::OnChange(DBEntry *entry, const DBRequest *req) {
         }
     }
 
+    if (data->ace_add && changed) {
+        acl->BuildClassifier();
+    }
+
     if (changed == false) {
         //Remove temporary create acl entries
         AclDBEntry::AclEntries::iterator iter;
@@ -444,6 +449,7 @@ void AclDBEntry::SetAclEntries(AclEntries &entries)
         entries.erase(tmp);
         acl_entries_.insert(acl_entries_.end(), *ae);
     }
+    BuildClassifier();
 }
 
 AclEntry *AclDBEntry::AddAclEntry(const AclEntrySpec &acl_entry_spec, AclEntries &entries)
@@ -502,6 +508,7 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
             acl_entries_.erase(acl_entries_.iterator_to(*iter));
             ACL_TRACE(Info, "acl entry " + integerToString(acl_entry_id) + " deleted");
             delete ae;
+            BuildClassifier();
             return true;
         }
     }
@@ -511,6 +518,8 @@ bool AclDBEntry::DeleteAclEntry(const uint32_t acl_entry_id)
 
 void AclDBEntry::DeleteAllAclEntries()
 {
+    // Classifier holds references to the entries being deleted
+    classifier_.Clear();
     AclEntries::iterator iter;
     iter = acl_entries_.begin();
     while (iter != acl_entries_.end()) {
@@ -521,67 +530,93 @@ void AclDBEntry::DeleteAllAclEntries()
     return;
 }
 
+void AclDBEntry::BuildClassifier() {
+    classifier_.Build(acl_entries_);
+}
+
+// Match a single ACL entry and accumulate its actions. terminal is set if
+// the entry matched and is a terminal rule
+bool AclDBEntry::EntryMatch(const AclEntry *entry,
+                            const PacketHeader &packet_header,
+                            MatchAclParams &m_acl, FlowPolicyInfo *info,
+                            bool *terminal) const {
+    *terminal = false;
+    const AclEntry::ActionList &al = entry->PacketMatch(packet_header);
+    if (al.empty())
+        return false;
+
+    AclEntry::ActionList::const_iterator al_it;
+    for (al_it = al.begin(); al_it != al.end(); ++al_it) {
+        TrafficAction *ta = static_cast<TrafficAction *>(*al_it.operator->());
+        m_acl.action_info.action |= 1 << ta->GetAction();
+        if (ta->GetActionType() == TrafficAction::MIRROR_ACTION) {
+            MirrorAction *a = static_cast<MirrorAction *>(*al_it.operator->());
+            MirrorActionSpec as;
+            as.ip = a->GetIp();
+            as.port = a->GetPort();
+            as.vrf_name = a->vrf_name();
+            as.analyzer_name = a->GetAnalyzerName();
+            as.encap = a->GetEncap();
+            m_acl.action_info.mirror_l.push_back(as);
+        }
+        if (ta->GetActionType() == TrafficAction::VRF_TRANSLATE_ACTION) {
+            const VrfTranslateAction *a =
+                static_cast<VrfTranslateAction *>(*al_it.operator->());
+            VrfTranslateActionSpec vrf_translate_action(a->vrf_name(),
+                                                        a->ignore_acl());
+            m_acl.action_info.vrf_translate_action_ = vrf_translate_action;
+        }
+        if (info && ta->IsDrop()) {
+            if (!info->drop) {
+                info->drop = true;
+                info->terminal = false;
+                info->other = false;
+                info->uuid = entry->uuid();
+            }
+        }
+    }
+
+    m_acl.ace_id_list.push_back((int32_t)(entry->id()));
+    if (entry->IsTerminal()) {
+        m_acl.terminal_rule = true;
+        /* Set uuid only if it is NOT already set as
+         * drop/terminal uuid */
+        if (info && !info->drop && !info->terminal) {
+            info->terminal = true;
+            info->other = false;
+            info->uuid = entry->uuid();
+        }
+        *terminal = true;
+        return true;
+    }
+    /* If the ace action is not drop and if ace is not terminal rule
+     * then set the uuid with the first matching uuid */
+    if (info && !info->drop && !info->terminal && !info->other) {
+        info->other = true;
+        info->uuid = entry->uuid();
+    }
+    return true;
+}
+
+// Only the entries selected by the classifier are matched. Candidates are
+// in ACL order, so the first terminal match still ends the lookup
 bool AclDBEntry::PacketMatch(const PacketHeader &packet_header, 
-			                 MatchAclParams &m_acl, FlowPolicyInfo *info) const
+                             MatchAclParams &m_acl, FlowPolicyInfo *info) const
 {
-    AclEntries::const_iterator iter;
     bool ret_val = false;
     m_acl.terminal_rule = false;
-	m_acl.action_info.action = 0;
-    for (iter = acl_entries_.begin();
-         iter != acl_entries_.end();
-         ++iter) {
-        const AclEntry::ActionList &al = iter->PacketMatch(packet_header);
-	AclEntry::ActionList::const_iterator al_it;
-	for (al_it = al.begin(); al_it != al.end(); ++al_it) {
-	     TrafficAction *ta = static_cast<TrafficAction *>(*al_it.operator->());
-	     m_acl.action_info.action |= 1 << ta->GetAction();
-	     if (ta->GetActionType() == TrafficAction::MIRROR_ACTION) {
-	         MirrorAction *a = static_cast<MirrorAction *>(*al_it.operator->());
-                 MirrorActionSpec as;
-		 as.ip = a->GetIp();
-		 as.port = a->GetPort();
-                 as.vrf_name = a->vrf_name();
-                 as.analyzer_name = a->GetAnalyzerName();
-                 as.encap = a->GetEncap();
-                 m_acl.action_info.mirror_l.push_back(as);
-	     }
-         if (ta->GetActionType() == TrafficAction::VRF_TRANSLATE_ACTION) {
-             const VrfTranslateAction *a =
-                 static_cast<VrfTranslateAction *>(*al_it.operator->());
-             VrfTranslateActionSpec vrf_translate_action(a->vrf_name(),
-                                                         a->ignore_acl());
-             m_acl.action_info.vrf_translate_action_ = vrf_translate_action;
-         }
-         if (info && ta->IsDrop()) {
-             if (!info->drop) {
-                 info->drop = true;
-                 info->terminal = false;
-                 info->other = false;
-                 info->uuid = iter->uuid();
-             }
-         }
-	}
-        if (!(al.empty())) {
+    m_acl.action_info.action = 0;
+
+    const AclClassifier::EntryList &entries =
+        classifier_.Lookup(packet_header);
+    AclClassifier::EntryList::const_iterator iter;
+    for (iter = entries.begin(); iter != entries.end(); ++iter) {
+        bool terminal = false;
+        if (EntryMatch(*iter, packet_header, m_acl, info, &terminal)) {
             ret_val = true;
-            m_acl.ace_id_list.push_back((int32_t)(iter->id()));
-            if (iter->IsTerminal()) {
-                m_acl.terminal_rule = true;
-                /* Set uuid only if it is NOT already set as
-                 * drop/terminal uuid */
-                if (info && !info->drop && !info->terminal) {
-                    info->terminal = true;
-                    info->other = false;
-                    info->uuid = iter->uuid();
-                }
-                return ret_val;
-            }
-            /* If the ace action is not drop and if ace is not terminal rule
-             * then set the uuid with the first matching uuid */
-            if (info && !info->drop && !info->terminal && !info->other) {
-                info->other = true;
-                info->uuid = iter->uuid();
-            }
+        }
+        if (terminal) {
+            break;
         }
     }
     return ret_val;
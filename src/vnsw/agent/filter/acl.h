@@ -14,6 +14,7 @@
 #include <filter/acl_entry_match.h>
 #include <filter/acl_entry_spec.h>
 #include <filter/acl_entry.h>
+#include <filter/acl_classifier.h>
 
 struct FlowKey;
 
@@ -113,12 +114,19 @@ public:
     bool Changed(const AclEntries &new_acl_entries) const;
     uint32_t ace_count() const { return acl_entries_.size();}
     bool IsRulePresent(const std::string &uuid) const;
+    // Rebuild the classifier after ACL entries change
+    void BuildClassifier();
+    const AclClassifier &classifier() const { return classifier_; }
 private:
     friend class AclTable;
+    bool EntryMatch(const AclEntry *entry, const PacketHeader &packet_header,
+                    MatchAclParams &m_acl, FlowPolicyInfo *info,
+                    bool *terminal) const;
     uuid uuid_;
     bool dynamic_acl_;
     std::string name_;
     AclEntries acl_entries_;
+    AclClassifier classifier_;
     DISALLOW_COPY_AND_ASSIGN(AclDBEntry);
 };
 
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include <cmn/agent_cmn.h>
+
+#include <filter/acl_entry_match.h>
+#include <filter/acl_entry.h>
+#include <filter/packet_header.h>
+#include <filter/acl_classifier.h>
+
+namespace {
+
+typedef std::pair<uint32_t, uint32_t> ValueRange;
+typedef std::vector<ValueRange> ValueRangeList;
+
+static const uint32_t kMaxValue = 0xFFFF;
+
+// Ranges of values matched by an entry in the protocol or destination port
+// dimension. An entry without a match on the dimension matches all values.
+void GetEntryRanges(const AclEntry *entry, bool protocol,
+                    ValueRangeList *ranges) {
+    ranges->clear();
+    const RangeSList *list = NULL;
+    if (protocol) {
+        if (entry->protocol_match())
+            list = &entry->protocol_match()->protocol_ranges();
+    } else {
+        if (entry->dst_port_match())
+            list = &entry->dst_port_match()->port_ranges();
+    }
+
+    if (list == NULL) {
+        ranges->push_back(ValueRange(0, kMaxValue));
+        return;
+    }
+
+    for (RangeSList::const_iterator it = list->begin(); it != list->end();
+         ++it) {
+        if (it->min > it->max)
+            continue;
+        ranges->push_back(ValueRange(it->min, it->max));
+    }
+}
+
+}  // namespace
+
+static const AclClassifier::EntryList kEmptyEntryList;
+
+void AclClassifier::IntervalIndex::Build(const EntryList &entries,
+                                         bool protocol) {
+    Clear();
+    if (entries.empty())
+        return;
+
+    // Collect the start of every elementary interval
+    ValueRangeList ranges;
+    std::vector<uint32_t> bounds;
+    bounds.push_back(0);
+    for (EntryList::const_iterator it = entries.begin(); it != entries.end();
+         ++it) {
+        GetEntryRanges(*it, protocol, &ranges);
+        for (ValueRangeList::const_iterator rit = ranges.begin();
+             rit != ranges.end(); ++rit) {
+            bounds.push_back(rit->first);
+            if (rit->second < kMaxValue)
+                bounds.push_back(rit->second + 1);
+        }
+    }
+    std::sort(bounds.begin(), bounds.end());
+    bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+    start_.assign(bounds.begin(), bounds.end());
+    leaf_.resize(start_.size());
+
+    // Entries are visited in ACL order, so every leaf stays ordered
+    for (EntryList::const_iterator it = entries.begin(); it != entries.end();
+         ++it) {
+        GetEntryRanges(*it, protocol, &ranges);
+        for (ValueRangeList::const_iterator rit = ranges.begin();
+             rit != ranges.end(); ++rit) {
+            std::vector<uint16_t>::iterator sit =
+                std::lower_bound(start_.begin(), start_.end(), rit->first);
+            size_t idx = sit - start_.begin();
+            for (; idx < start_.size() && start_[idx] <= rit->second; ++idx) {
+                EntryList &leaf = leaf_[idx];
+                // Overlapping ranges in the same entry
+                if (leaf.empty() == false && leaf.back() == *it)
+                    continue;
+                leaf.push_back(*it);
+            }
+        }
+    }
+}
+
+void AclClassifier::IntervalIndex::Clear() {
+    start_.clear();
+    leaf_.clear();
+}
+
+size_t AclClassifier::IntervalIndex::size() const {
+    size_t count = 0;
+    for (std::vector<EntryList>::const_iterator it = leaf_.begin();
+         it != leaf_.end(); ++it) {
+        count += it->size();
+    }
+    return count;
+}
+
+const AclClassifier::EntryList &
+AclClassifier::IntervalIndex::Find(uint16_t value) const {
+    if (start_.empty())
+        return kEmptyEntryList;
+    std::vector<uint16_t>::const_iterator it =
+        std::upper_bound(start_.begin(), start_.end(), value);
+    // start_[0] is always 0, hence it is never begin()
+    return leaf_[(it - start_.begin()) - 1];
+}
+
+AclClassifier::AclClassifier() : entry_count_(0) {
+}
+
+AclClassifier::~AclClassifier() {
+}
+
+void AclClassifier::Clear() {
+    protocol_.Clear();
+    tcp_dport_.Clear();
+    udp_dport_.Clear();
+    entry_count_ = 0;
+}
+
+void AclClassifier::Build(const EntryList &entries) {
+    Clear();
+    entry_count_ = entries.size();
+    protocol_.Build(entries, true);
+
+    // Port match is applicable only for TCP and UDP
+    tcp_dport_.Build(protocol_.Find(IPPROTO_TCP), false);
+    if (tcp_dport_.size() > kMaxPortLevelSize)
+        tcp_dport_.Clear();
+    udp_dport_.Build(protocol_.Find(IPPROTO_UDP), false);
+    if (udp_dport_.size() > kMaxPortLevelSize)
+        udp_dport_.Clear();
+}
+
+size_t AclClassifier::leaf_count() const {
+    return protocol_.leaf_count() + tcp_dport_.leaf_count() +
+        udp_dport_.leaf_count();
+}
+
+const AclClassifier::EntryList &
+AclClassifier::Lookup(const PacketHeader &packet_header) const {
+    if (packet_header.protocol == IPPROTO_TCP && !tcp_dport_.empty())
+        return tcp_dport_.Find(packet_header.dst_port);
+    if (packet_header.protocol == IPPROTO_UDP && !udp_dport_.empty())
+        return udp_dport_.Find(packet_header.dst_port);
+    return protocol_.Find(packet_header.protocol);
+}
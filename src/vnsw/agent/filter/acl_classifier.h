@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef __AGENT_ACL_CLASSIFIER_H__
+#define __AGENT_ACL_CLASSIFIER_H__
+
+#include <vector>
+
+#include <filter/acl_entry.h>
+
+struct PacketHeader;
+
+// Pre-filter for AclDBEntry::PacketMatch.
+//
+// ACL entries are compiled into a two level decision tree. The first level
+// splits the protocol space into elementary intervals built from the
+// protocol ranges of all entries. TCP and UDP have a second level that
+// splits the destination port space the same way. Every leaf holds the
+// entries, in ACL order, that can possibly match a packet falling into the
+// leaf. The full match is still done by AclEntry::PacketMatch on each
+// candidate, so first-match and terminal-rule semantics are unchanged.
+//
+// The classifier must be rebuilt whenever the ACL entries change.
+class AclClassifier {
+public:
+    typedef std::vector<const AclEntry *> EntryList;
+
+    // Upper bound on the number of entry references held by the port level
+    // of a protocol. Beyond this, lookups for the protocol fall back to the
+    // protocol level leaf.
+    static const size_t kMaxPortLevelSize = 64 * 1024;
+
+    AclClassifier();
+    ~AclClassifier();
+
+    template <typename Container>
+    void Build(const Container &entries) {
+        EntryList list;
+        for (typename Container::const_iterator it = entries.begin();
+             it != entries.end(); ++it) {
+            list.push_back(&(*it));
+        }
+        Build(list);
+    }
+    void Build(const EntryList &entries);
+    void Clear();
+
+    const EntryList &Lookup(const PacketHeader &packet_header) const;
+
+    size_t entry_count() const { return entry_count_; }
+    size_t leaf_count() const;
+
+private:
+    // Elementary interval index over a 16 bit value space
+    class IntervalIndex {
+    public:
+        IntervalIndex() { }
+        void Build(const EntryList &entries, bool protocol);
+        void Clear();
+        bool empty() const { return start_.empty(); }
+        size_t size() const;
+        size_t leaf_count() const { return leaf_.size(); }
+        const EntryList &Find(uint16_t value) const;
+
+    private:
+        std::vector<uint16_t> start_;
+        std::vector<EntryList> leaf_;
+    };
+
+    IntervalIndex protocol_;
+    IntervalIndex tcp_dport_;
+    IntervalIndex udp_dport_;
+    size_t entry_count_;
+    DISALLOW_COPY_AND_ASSIGN(AclClassifier);
+};
+
+#endif
@@ -90,6 +90,7 @@ void AclEntry::PopulateAclEntry(const AclEntrySpec &acl_entry_spec)
             proto->SetProtocolRange((*it).min, (*it).max);
         }
         matches_.push_back(proto);
+        protocol_match_ = proto;
     }
 
     if (acl_entry_spec.dst_port.size() > 0) {
@@ -100,6 +101,7 @@ void AclEntry::PopulateAclEntry(const AclEntrySpec &acl_entry_spec)
             port->SetPortRange((*it).min, (*it).max);
         }
         matches_.push_back(port);
+        dst_port_match_ = port;
     }
 
     if (acl_entry_spec.src_port.size() > 0) {
@@ -19,6 +19,8 @@ struct PacketHeader;
 class AclEntrySpec;
 class TrafficAction;
 class AclEntryMatch;
+class ProtocolMatch;
+class DstPortMatch;
 
 typedef std::vector<int32_t> AclEntryIDList;
 
@@ -33,11 +35,11 @@ public:
     static ActionList kEmptyActionList;
     AclEntry() : 
         id_(0), type_(TERMINAL), matches_(), actions_(), mirror_entry_(NULL),
-        uuid_() {}
+        uuid_(), protocol_match_(NULL), dst_port_match_(NULL) {}
 
     AclEntry(AclType type) :
         id_(0), type_(type), matches_(), actions_(), mirror_entry_(NULL),
-        uuid_() {}
+        uuid_(), protocol_match_(NULL), dst_port_match_(NULL) {}
 
     ~AclEntry();
     
@@ -56,6 +58,9 @@ public:
 
     uint32_t id() const { return id_; }
     const std::string &uuid() const { return uuid_; }
+    // Matches used by AclClassifier, NULL if the entry matches any value
+    const ProtocolMatch *protocol_match() const { return protocol_match_; }
+    const DstPortMatch *dst_port_match() const { return dst_port_match_; }
 
     boost::intrusive::list_member_hook<> acl_list_node;
 
@@ -67,6 +72,8 @@ private:
     ActionList actions_;
     MirrorEntryRef mirror_entry_;
     std::string uuid_;
+    const ProtocolMatch *protocol_match_;
+    const DstPortMatch *dst_port_match_;
 
     DISALLOW_COPY_AND_ASSIGN(AclEntry);
 };
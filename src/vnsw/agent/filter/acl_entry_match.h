@@ -75,6 +75,7 @@ public:
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data) = 0;
     virtual bool Match(const PacketHeader *packet_header) const = 0;
     virtual bool Compare(const AclEntryMatch &rhs) const;
+    const RangeSList &port_ranges() const { return port_ranges_; }
 protected:
     RangeSList port_ranges_;
 };
@@ -100,6 +101,7 @@ public:
     bool Match(const PacketHeader *packet_header) const;
     void SetAclEntryMatchSandeshData(AclEntrySandeshData &data);
     virtual bool Compare(const AclEntryMatch &rhs) const;
+    const RangeSList &protocol_ranges() const { return protocol_ranges_; }
 
 private:
     RangeSList protocol_ranges_;
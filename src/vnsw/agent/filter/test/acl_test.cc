@@ -5,6 +5,7 @@
 #include "base/os.h"
 #include <test_cmn_util.h>
 #include <filter/packet_header.h>
+#include <base/time_util.h>
 
 using namespace std;
 
@@ -284,6 +285,79 @@ TEST_F(AclTest, PacketMatching) {
     delete packet1;
 }
 
+// 1K rule ACL, one TCP destination port per rule. Verifies that the
+// classifier keeps first-match semantics and reports lookup rate
+TEST_F(AclTest, ClassifierScale) {
+    const int kRuleCount = 1000;
+    const int kLookupCount = 100000;
+
+    AclTable *table = Agent::GetInstance()->acl_table();
+    AclSpec acl_spec;
+    uuid acl_id = StringToUuid("00000000-0000-0000-0000-000000000013");
+    acl_spec.acl_id = acl_id;
+
+    ActionSpec action;
+    action.ta_type = TrafficAction::SIMPLE_ACTION;
+    action.simple_action = TrafficAction::PASS;
+    for (int i = 1; i <= kRuleCount; i++) {
+        AclEntrySpec ae_spec;
+        ae_spec.id = i;
+        ae_spec.terminal = true;
+        RangeSpec protocol;
+        protocol.min = protocol.max = IPPROTO_TCP;
+        ae_spec.protocol.push_back(protocol);
+        RangeSpec port;
+        port.min = port.max = 1000 + i;
+        ae_spec.dst_port.push_back(port);
+        ae_spec.action_l.push_back(action);
+        acl_spec.acl_entry_specs_.push_back(ae_spec);
+    }
+
+    DBRequest req;
+    req.key.reset(new AclKey(acl_id));
+    req.data.reset(new AclData(acl_spec));
+    req.oper = DBRequest::DB_ENTRY_ADD_CHANGE;
+    table->Enqueue(&req);
+    client->WaitForIdle();
+
+    AclKey key = AclKey(acl_id);
+    AclDBEntry *acl = static_cast<AclDBEntry *>(table->FindActiveEntry(&key));
+    EXPECT_TRUE(acl != NULL);
+    EXPECT_EQ((size_t)kRuleCount, acl->classifier().entry_count());
+
+    PacketHeader packet;
+    packet.protocol = IPPROTO_TCP;
+    packet.dst_port = 1000 + kRuleCount;
+    MatchAclParams m_acl;
+    EXPECT_TRUE(acl->PacketMatch(packet, m_acl, NULL));
+    EXPECT_EQ(1U, m_acl.ace_id_list.size());
+    EXPECT_EQ(kRuleCount, m_acl.ace_id_list[0]);
+    EXPECT_TRUE(m_acl.terminal_rule);
+
+    packet.protocol = IPPROTO_UDP;
+    MatchAclParams m_acl_udp;
+    EXPECT_FALSE(acl->PacketMatch(packet, m_acl_udp, NULL));
+
+    packet.protocol = IPPROTO_TCP;
+    uint64_t start = ClockMonotonicUsec();
+    for (int i = 0; i < kLookupCount; i++) {
+        MatchAclParams params;
+        packet.dst_port = 1000 + (i % (kRuleCount + 1));
+        acl->PacketMatch(packet, params, NULL);
+    }
+    uint64_t elapsed = ClockMonotonicUsec() - start;
+    if (elapsed == 0)
+        elapsed = 1;
+    LOG(DEBUG, "ACL classifier " << kRuleCount << " rules: "
+        << (kLookupCount * 1000000ULL) / elapsed << " lookups/sec");
+
+    req.key.reset(new AclKey(acl_id));
+    req.data.reset(NULL);
+    req.oper = DBRequest::DB_ENTRY_DELETE;
+    table->Enqueue(&req);
+    client->WaitForIdle();
+}
+
 TEST_F(AclTest, Config) {
     pugi::xml_document xdoc_;
     xdoc_.load_file("controller/src/vnsw/agent/filter/test/acl_cfg_test.xml");
@@ -295,6 +295,17 @@ void AgentParam::ParseVirtualHost() {
     }
 }
 
+void AgentParam::ParseControlNode() {
+    if (!GetValueFromTree<uint16_t>(route_export_batch_,
+                                    "CONTROL-NODE.route_export_batch")) {
+        route_export_batch_ = 0;
+    }
+    if (!GetValueFromTree<uint16_t>(route_walk_concurrency_,
+                                    "CONTROL-NODE.route_walk_concurrency")) {
+        route_walk_concurrency_ = 0;
+    }
+}
+
 void AgentParam::ParseDiscovery() {
     GetValueFromTree<string>(dss_server_, "DISCOVERY.server");
     if (!GetValueFromTree<uint16_t>(xmpp_instance_count_,
@@ -547,6 +558,14 @@ void AgentParam::ParseVirtualHostArguments
                         "VIRTUAL-HOST-INTERFACE.physical_interface");
 }
 
+void AgentParam::ParseControlNodeArguments
+    (const boost::program_options::variables_map &var_map) {
+    GetOptValue<uint16_t>(var_map, route_export_batch_,
+                          "CONTROL-NODE.route_export_batch");
+    GetOptValue<uint16_t>(var_map, route_walk_concurrency_,
+                          "CONTROL-NODE.route_walk_concurrency");
+}
+
 void AgentParam::ParseDiscoveryArguments
     (const boost::program_options::variables_map &var_map) {
     GetOptValue<string>(var_map, dss_server_, "DISCOVERY.server");
@@ -745,6 +764,7 @@ void AgentParam::InitFromConfig() {
     ParseCollector();
     ParseVirtualHost();
     ParseServerList("CONTROL-NODE.server", &xmpp_server_1_, &xmpp_server_2_);
+    ParseControlNode();
     ParseServerList("DNS.server", &dns_server_1_, &dns_port_1_,
                     &dns_server_2_, &dns_port_2_);
     ParseDiscovery();
@@ -769,6 +789,7 @@ void AgentParam::InitFromArguments() {
     ParseVirtualHostArguments(var_map_);
     ParseServerListArguments(var_map_, xmpp_server_1_, xmpp_server_2_, 
                              "CONTROL-NODE.server");
+    ParseControlNodeArguments(var_map_);
     ParseServerListArguments(var_map_, &dns_server_1_, &dns_port_1_,
                              &dns_server_2_, &dns_port_2_, "DNS.server");
     ParseDiscoveryArguments(var_map_);
@@ -976,6 +997,8 @@ void AgentParam::LogConfig() const {
     }
     LOG(DEBUG, "XMPP Server-1               : " << xmpp_server_1_);
     LOG(DEBUG, "XMPP Server-2               : " << xmpp_server_2_);
+    LOG(DEBUG, "Route Export Batch          : " << route_export_batch_);
+    LOG(DEBUG, "Route Walk Concurrency      : " << route_walk_concurrency_);
     LOG(DEBUG, "DNS Server-1                : " << dns_server_1_);
     LOG(DEBUG, "DNS Port-1                  : " << dns_port_1_);
     LOG(DEBUG, "DNS Server-2                : " << dns_server_2_);
@@ -1072,7 +1095,8 @@ AgentParam::AgentParam(Agent *agent, bool enable_flow_options,
         agent_mode_(agent_mode), agent_(agent), vhost_(),
         agent_name_(), eth_port_(),
         eth_port_no_arp_(false), eth_port_encap_type_(),
-        xmpp_instance_count_(),
+        xmpp_instance_count_(), route_export_batch_(0),
+        route_walk_concurrency_(0),
         dns_port_1_(ContrailPorts::DnsServerPort()),
         dns_port_2_(ContrailPorts::DnsServerPort()),
         mgmt_ip_(), hypervisor_mode_(MODE_KVM), xen_ll_(),
@@ -1113,6 +1137,10 @@ AgentParam::AgentParam(Agent *agent, bool enable_flow_options,
          opt::value<std::vector<std::string> >()->multitoken(),
          "IP addresses of control nodes."
          " Max of 2 Ip addresses can be configured")
+        ("CONTROL-NODE.route_export_batch", opt::value<uint16_t>(),
+         "Max routes sent to control node in one publish, 0 to disable")
+        ("CONTROL-NODE.route_walk_concurrency", opt::value<uint16_t>(),
+         "Max VRF walked in parallel on control node change, 0 for no limit")
         ("DEFAULT.collectors",
          opt::value<std::vector<std::string> >()->multitoken(),
          "Collector server list")
@@ -95,6 +95,11 @@ public:
     const std::string &eth_port_encap_type() const { return eth_port_encap_type_; }
     const Ip4Address &xmpp_server_1() const { return xmpp_server_1_; }
     const Ip4Address &xmpp_server_2() const { return xmpp_server_2_; }
+    uint16_t route_export_batch() const { return route_export_batch_; }
+    void set_route_export_batch(uint16_t val) { route_export_batch_ = val; }
+    uint16_t route_walk_concurrency() const {
+        return route_walk_concurrency_;
+    }
     const Ip4Address &dns_server_1() const { return dns_server_1_; }
     const Ip4Address &dns_server_2() const { return dns_server_2_; }
     const uint16_t dns_port_1() const { return dns_port_1_; }
@@ -269,6 +274,7 @@ private:
     void ComputeFlowLimits();
     void ParseCollector();
     void ParseVirtualHost();
+    void ParseControlNode();
     void ParseDiscovery();
     void ParseNetworks();
     void ParseHypervisor();
@@ -288,6 +294,8 @@ private:
         (const boost::program_options::variables_map &v);
     void ParseVirtualHostArguments
         (const boost::program_options::variables_map &v);
+    void ParseControlNodeArguments
+        (const boost::program_options::variables_map &v);
     void ParseDiscoveryArguments
         (const boost::program_options::variables_map &v);
     void ParseNetworksArguments
@@ -330,6 +338,8 @@ private:
     uint16_t xmpp_instance_count_;
     Ip4Address xmpp_server_1_;
     Ip4Address xmpp_server_2_;
+    uint16_t route_export_batch_;
+    uint16_t route_walk_concurrency_;
     Ip4Address dns_server_1_;
     Ip4Address dns_server_2_;
     uint16_t dns_port_1_;
@@ -2,6 +2,8 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <boost/algorithm/string.hpp>
+#include <base/string_util.h>
 #include <base/task.h>
 #include <base/util.h>
 
@@ -19,18 +21,109 @@
 
 using namespace std;
 
+FlowKStateFilter::FlowKStateFilter() :
+    vrf_id(-1), sip(), dip(), proto(-1), sport(-1), dport(-1) {
+}
+
+bool FlowKStateFilter::Init(const KFlowReq &req) {
+    boost::system::error_code ec;
+    vrf_id = req.get_vrf_id();
+    proto = req.get_proto();
+    sport = req.get_sport();
+    dport = req.get_dport();
+    if (!req.get_sip().empty()) {
+        sip = Ip4Address::from_string(req.get_sip(), ec);
+        if (ec) {
+            return false;
+        }
+    }
+    if (!req.get_dip().empty()) {
+        dip = Ip4Address::from_string(req.get_dip(), ec);
+        if (ec) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool FlowKStateFilter::IsSet() const {
+    return (vrf_id != -1 || sip.to_ulong() != 0 || dip.to_ulong() != 0 ||
+            proto != -1 || sport != -1 || dport != -1);
+}
+
+bool FlowKStateFilter::Match(const vr_flow_entry *k_flow) const {
+    if (vrf_id != -1 && k_flow->fe_vrf != vrf_id)
+        return false;
+    if (sip.to_ulong() != 0 &&
+        ntohl(k_flow->fe_key.flow4_sip) != sip.to_ulong())
+        return false;
+    if (dip.to_ulong() != 0 &&
+        ntohl(k_flow->fe_key.flow4_dip) != dip.to_ulong())
+        return false;
+    if (proto != -1 && k_flow->fe_key.flow4_proto != proto)
+        return false;
+    if (sport != -1 && ntohs(k_flow->fe_key.flow4_sport) != sport)
+        return false;
+    if (dport != -1 && ntohs(k_flow->fe_key.flow4_dport) != dport)
+        return false;
+    return true;
+}
+
+/* Encoded as <vrf>,<sip>,<dip>,<proto>,<sport>,<dport> */
+const string FlowKStateFilter::ToString() const {
+    return integerToString(vrf_id) + "," + sip.to_string() + "," +
+        dip.to_string() + "," + integerToString(proto) + "," +
+        integerToString(sport) + "," + integerToString(dport);
+}
+
+bool FlowKStateFilter::FromString(const vector<string> &tokens) {
+    boost::system::error_code sip_ec, dip_ec;
+    if (tokens.size() != 6) {
+        return false;
+    }
+    sip = Ip4Address::from_string(tokens[1], sip_ec);
+    dip = Ip4Address::from_string(tokens[2], dip_ec);
+    return (stringToInteger(tokens[0], vrf_id) && !sip_ec && !dip_ec &&
+            stringToInteger(tokens[3], proto) &&
+            stringToInteger(tokens[4], sport) &&
+            stringToInteger(tokens[5], dport));
+}
+
 FlowKState::FlowKState(Agent *agent, const string &resp_ctx, int idx) :
     Task((TaskScheduler::GetInstance()->GetTaskId("Agent::FlowResponder")),
             0), response_context_(resp_ctx), flow_idx_(idx), 
-    flow_iteration_key_(0), agent_(agent) {
+    flow_iteration_key_(0), agent_(agent), resp_(NULL), handle_valid_(true) {
 }
 
+/*
+ * Handle is the flow index to resume from, followed by the filter if one
+ * is set i.e. <index>[,<filter>]
+ */
 FlowKState::FlowKState(Agent *agent, const string &resp_ctx, 
                        const string &iter_idx) :
     Task((TaskScheduler::GetInstance()->GetTaskId("Agent::FlowResponder")),
             0), response_context_(resp_ctx), flow_idx_(-1), 
-    flow_iteration_key_(0), agent_(agent) {
-    stringToInteger(iter_idx, flow_iteration_key_);
+    flow_iteration_key_(0), agent_(agent), resp_(NULL), handle_valid_(true) {
+    vector<string> tokens;
+    boost::split(tokens, iter_idx, boost::is_any_of(","));
+    handle_valid_ = stringToInteger(tokens[0], flow_iteration_key_);
+    if (tokens.size() > 1) {
+        tokens.erase(tokens.begin());
+        handle_valid_ = handle_valid_ && filter_.FromString(tokens);
+    }
+}
+
+FlowKState::~FlowKState() {
+    if (resp_) {
+        resp_->Release();
+    }
+}
+
+const string FlowKState::Handle(uint32_t idx) const {
+    if (filter_.IsSet()) {
+        return integerToString(idx) + "," + filter_.ToString();
+    }
+    return integerToString(idx);
 }
 
 void FlowKState::SendResponse(KFlowResp *resp) const {
@@ -129,16 +222,21 @@ void FlowKState::SetFlowData(vector<KFlowInfo> &list,
 }
 
 bool FlowKState::Run() {
-    int count = 0;
     const vr_flow_entry *k_flow;
-    KFlowResp *resp;
 
     FlowTableKSyncObject *ksync_obj = agent_->ksync()->flowtable_ksync_obj();
 
+    if (!handle_valid_) {
+        ErrResp *resp = new ErrResp();
+        resp->set_context(response_context_);
+        resp->Response();
+        return true;
+    }
+
     if (flow_idx_ != -1) {
         k_flow = ksync_obj->GetKernelFlowEntry(flow_idx_, false);
         if (k_flow) {
-            resp = new KFlowResp();
+            KFlowResp *resp = new KFlowResp();
             vector<KFlowInfo> &list = const_cast<std::vector<KFlowInfo>&>
                                           (resp->get_flow_list());
             SetFlowData(list, k_flow, flow_idx_);
@@ -152,31 +250,41 @@ bool FlowKState::Run() {
     }
     uint32_t idx = flow_iteration_key_;
     uint32_t max_flows = ksync_obj->flow_table_entries_count();
+    uint32_t scanned = 0;
     
-    resp = new KFlowResp();
+    if (resp_ == NULL) {
+        resp_ = new KFlowResp();
+    }
     vector<KFlowInfo> &list = const_cast<std::vector<KFlowInfo>&>
-                                  (resp->get_flow_list());
+                                  (resp_->get_flow_list());
     while(idx < max_flows) {
         k_flow = ksync_obj->GetKernelFlowEntry(idx, false);
-        if (k_flow) {
-            count++;
+        if (k_flow && filter_.Match(k_flow)) {
             SetFlowData(list, k_flow, idx);
         } 
         idx++;
-        if (count == KState::kMaxEntriesPerResponse) {
+        if (list.size() == (size_t)KState::kMaxEntriesPerResponse) {
             if (idx != max_flows) {
-                resp->set_flow_handle(integerToString(idx));
+                resp_->set_flow_handle(Handle(idx));
             } else {
-                resp->set_flow_handle(integerToString(0));
+                resp_->set_flow_handle(Handle(0));
             }
-            SendResponse(resp);
+            SendResponse(resp_);
+            resp_ = NULL;
             return true;
         }
+        /* Yield so that a sparse or filtered table doesn't hold up the
+         * flow responder task, resume from idx in the next run.
+         */
+        if (++scanned == kMaxFlowsScannedPerRun && idx != max_flows) {
+            flow_iteration_key_ = idx;
+            return false;
+        }
     }
 
-    resp->set_flow_handle(integerToString(0));
-    SendResponse(resp);
+    resp_->set_flow_handle(Handle(0));
+    SendResponse(resp_);
+    resp_ = NULL;
 
     return true;
 }
-
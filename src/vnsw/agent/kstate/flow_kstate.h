@@ -5,24 +5,50 @@
 #ifndef vnsw_agent_flow_kstate_h
 #define vnsw_agent_flow_kstate_h
 
+/* Filter on the flow key and vrf applied when dumping all flows */
+struct FlowKStateFilter {
+    FlowKStateFilter();
+    bool Init(const KFlowReq &req);
+    bool IsSet() const;
+    bool Match(const vr_flow_entry *k_flow) const;
+    const std::string ToString() const;
+    bool FromString(const std::vector<std::string> &tokens);
+
+    int vrf_id;
+    Ip4Address sip;
+    Ip4Address dip;
+    int proto;
+    int sport;
+    int dport;
+};
+
 class FlowKState : public Task {
  public:
+    /* Flow entries looked at in one run of the task before yielding */
+    static const uint32_t kMaxFlowsScannedPerRun = 16384;
+
     FlowKState(Agent *agent, const std::string &resp_ctx, int idx);
     FlowKState(Agent *agent, const std::string &resp_ctx, 
                const std::string &iter_idx);
+    virtual ~FlowKState();
     virtual void SendResponse(KFlowResp *resp) const;
     
     virtual bool Run();
     void SetFlowData(std::vector<KFlowInfo> &list, const vr_flow_entry *k_flow,
                      int index) const;
+    void set_filter(const FlowKStateFilter &filter) { filter_ = filter; }
 protected:
     std::string response_context_;
     int flow_idx_;
     uint32_t flow_iteration_key_;
 private:
     Agent *agent_;
+    FlowKStateFilter filter_;
+    KFlowResp *resp_;
+    bool handle_valid_;
     void UpdateFlagStr(std::string &str, bool &set, unsigned sflag, 
                        unsigned cflag) const;
     const std::string FlagToStr(unsigned int flag) const;
+    const std::string Handle(uint32_t idx) const;
 };
 #endif
@@ -198,17 +198,19 @@ void KState::RouteMsgHandler(vr_route_req *r) {
     vector<KRouteInfo> &list =
                         const_cast<std::vector<KRouteInfo>&>(resp->get_rt_list());
     
-    data.set_vrf_id(r->get_rtr_vrf_id());
-    data.set_family(rst->FamilyToString(r->get_rtr_family()));
-    data.set_prefix(PrefixToString(r->get_rtr_prefix()));
-    data.set_prefix_len(r->get_rtr_prefix_len());
-    data.set_rid(r->get_rtr_rid());
-    data.set_label_flags(rst->LabelFlagsToString(
-                                  r->get_rtr_label_flags()));
-    data.set_label(r->get_rtr_label());
-    data.set_nh_id(r->get_rtr_nh_id());
-    
-    list.push_back(data);
+    if (rst->MatchFilter(r)) {
+        data.set_vrf_id(r->get_rtr_vrf_id());
+        data.set_family(rst->FamilyToString(r->get_rtr_family()));
+        data.set_prefix(PrefixToString(r->get_rtr_prefix()));
+        data.set_prefix_len(r->get_rtr_prefix_len());
+        data.set_rid(r->get_rtr_rid());
+        data.set_label_flags(rst->LabelFlagsToString(
+                                      r->get_rtr_label_flags()));
+        data.set_label(r->get_rtr_label());
+        data.set_nh_id(r->get_rtr_nh_id());
+
+        list.push_back(data);
+    }
 
     RouteContext *rctx = static_cast<RouteContext *>(rst->more_context());
     if (!rctx) {
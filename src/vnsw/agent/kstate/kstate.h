@@ -22,8 +22,13 @@
 class KState : public AgentSandeshContext {
 public:
     static const int kMaxEntriesPerResponse = 100;
+    // Chained dumps stop after a page of entries and return a handle to
+    // resume the dump from, so that a single request doesn't walk the
+    // whole kernel table.
+    static const int kMaxEntriesPerPage = 1000;
     KState(const std::string &s, Sandesh *obj) : response_context_(s), 
-        response_object_(obj), vr_response_code_(0), more_context_(NULL) {}
+        response_object_(obj), vr_response_code_(0), more_context_(NULL),
+        entries_sent_(0) {}
 
     void EncodeAndSend(Sandesh &encoder);
     virtual void SendResponse() = 0;
@@ -40,6 +45,10 @@ public:
     void *more_context() const { return more_context_; }
     void set_vr_response_code(int value) { vr_response_code_ = value; }
     bool MoreData() const;
+    // Returns true if the entries in the current response complete a page
+    bool PageFull(size_t entries) const {
+        return (entries_sent_ + entries) >= (size_t)kMaxEntriesPerPage;
+    }
     virtual void IfMsgHandler(vr_interface_req *req);
     virtual void NHMsgHandler(vr_nexthop_req *req);
     virtual void RouteMsgHandler(vr_route_req *req);
@@ -57,6 +66,7 @@ protected:
     Sandesh *response_object_;
     int vr_response_code_; /* response code from kernel */
     void *more_context_; /* context to hold marker info */
+    int entries_sent_; /* entries sent in earlier responses of this page */
 private:
     void UpdateContext(void *);
     const std::string PrefixToString(const std::vector<int8_t> &prefix);
@@ -2,6 +2,7 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <base/string_util.h>
 #include "kstate.h"
 #include "interface_kstate.h"
 #include "route_kstate.h"
@@ -24,6 +25,15 @@ void KInterfaceReq::HandleRequest() const {
     kstate->EncodeAndSend(req);
 }
 
+static void SendErrResp(KState *kstate, const std::string &context) {
+    ErrResp *resp = new ErrResp();
+    resp->set_context(context);
+    resp->Response();
+
+    kstate->Release();
+    delete kstate;
+}
+
 void KRouteReq::HandleRequest() const {
     vr_route_req req;
     std::vector<int8_t> marker;
@@ -33,6 +43,23 @@ void KRouteReq::HandleRequest() const {
     resp->set_context(context());
 
     RouteKState *kstate = new RouteKState(resp, context(), req, get_vrf_id());
+    if (!get_prefix().empty() && !kstate->SetFilter(get_prefix())) {
+        SendErrResp(kstate, context());
+        return;
+    }
+    kstate->EncodeAndSend(req);
+}
+
+void NextKRouteReq::HandleRequest() const {
+    vr_route_req req;
+    KRouteResp *resp = new KRouteResp();
+    resp->set_context(context());
+
+    RouteKState *kstate = new RouteKState(resp, context(), req, 0);
+    if (!kstate->InitFromHandle(req, get_route_handle())) {
+        SendErrResp(kstate, context());
+        return;
+    }
     kstate->EncodeAndSend(req);
 }
 
@@ -45,6 +72,21 @@ void KNHReq::HandleRequest() const {
     kstate->EncodeAndSend(req);
 }
 
+void NextKNHReq::HandleRequest() const {
+    vr_nexthop_req req;
+    KNHResp *resp = new KNHResp();
+    resp->set_context(context());
+
+    int marker;
+    NHKState *kstate = new NHKState(resp, context(), req, -1);
+    if (!stringToInteger(get_nh_handle(), marker)) {
+        SendErrResp(kstate, context());
+        return;
+    }
+    req.set_nhr_marker(marker);
+    kstate->EncodeAndSend(req);
+}
+
 void KMplsReq::HandleRequest() const {
     vr_mpls_req req;
     KMplsResp *resp = new KMplsResp();
@@ -62,8 +104,17 @@ void NextKFlowReq::HandleRequest() const {
 }
 
 void KFlowReq::HandleRequest() const {
+    FlowKStateFilter filter;
+    if (!filter.Init(*this)) {
+        ErrResp *resp = new ErrResp();
+        resp->set_context(context());
+        resp->Response();
+        return;
+    }
+
     FlowKState *task = new FlowKState(Agent::GetInstance(), context(), 
                                       get_flow_idx());
+    task->set_filter(filter);
     TaskScheduler *scheduler = TaskScheduler::GetInstance();
     scheduler->Enqueue(task);
 }
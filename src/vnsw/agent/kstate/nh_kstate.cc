@@ -2,6 +2,7 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <base/string_util.h>
 #include "kstate.h"
 #include "nh_kstate.h"
 #include "vr_nexthop.h"
@@ -36,13 +37,18 @@ void NHKState::SendNextRequest() {
 void NHKState::Handler() {
     KNHResp *resp = static_cast<KNHResp *>(response_object_);
     if (resp) {
-        if (MoreData()) {
+        if (MoreData() && !PageFull(resp->get_nh_list().size())) {
             /* There are more nexthops in Kernel. We need to query them from 
              * Kernel and send it to Sandesh.
              */
             SendResponse();
             SendNextRequest();
         } else {
+            if (MoreData()) {
+                /* Page is complete, the dump resumes from the handle */
+                int idx = reinterpret_cast<long>(more_context_);
+                resp->set_nh_handle(integerToString(idx));
+            }
             resp->set_context(response_context_);
             resp->Response();
             more_context_ = NULL;
@@ -53,6 +59,7 @@ void NHKState::Handler() {
 void NHKState::SendResponse() {
 
     KNHResp *resp = static_cast<KNHResp *>(response_object_);
+    entries_sent_ += resp->get_nh_list().size();
     resp->set_context(response_context_);
     resp->set_more(true);
     resp->Response();
@@ -2,6 +2,8 @@
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
 
+#include <boost/algorithm/string.hpp>
+#include <base/string_util.h>
 #include "kstate.h"
 #include "route_kstate.h"
 #include <net/address.h>
@@ -9,9 +11,17 @@
 
 using namespace std;
 
+static Ip4Address PrefixToIp4(const std::vector<int8_t> &prefix) {
+    boost::array<unsigned char, 4> bytes = { {0, 0, 0, 0} };
+    for (size_t i = 0; i < prefix.size() && i < bytes.size(); i++) {
+        bytes[i] = prefix.at(i);
+    }
+    return Ip4Address(bytes);
+}
+
 RouteKState::RouteKState(KRouteResp *obj, const std::string &resp_ctx, 
                          vr_route_req &req, int id) :
-                         KState(resp_ctx, obj) {
+                         KState(resp_ctx, obj), filter_plen_(-1) {
     InitEncoder(req, id);
 }
 
@@ -23,16 +33,78 @@ void RouteKState::InitEncoder(vr_route_req &req, int id) const {
     req.set_h_op(sandesh_op::DUMP);
 }
 
+bool RouteKState::SetFilter(const string &prefix) {
+    if (Ip4PrefixParse(prefix, &filter_addr_, &filter_plen_)) {
+        filter_plen_ = -1;
+        return false;
+    }
+    filter_ = prefix;
+    return true;
+}
+
+bool RouteKState::MatchFilter(const vr_route_req *req) const {
+    if (filter_plen_ < 0) {
+        return true;
+    }
+    if (req->get_rtr_prefix().size() > 4 ||
+        req->get_rtr_prefix_len() < filter_plen_) {
+        return false;
+    }
+    uint32_t mask = filter_plen_ ? (0xFFFFFFFF << (32 - filter_plen_)) : 0;
+    Ip4Address addr = PrefixToIp4(req->get_rtr_prefix());
+    return ((addr.to_ulong() ^ filter_addr_.to_ulong()) & mask) == 0;
+}
+
+/* Handle is <vrf>,<marker>,<marker plen>,<filter prefix> */
+const string RouteKState::Handle() const {
+    RouteContext *rctx = static_cast<RouteContext *>(more_context_);
+    return integerToString(rctx->vrf_id) + "," +
+        PrefixToIp4(rctx->marker).to_string() + "," +
+        integerToString(rctx->marker_plen) + "," + filter_;
+}
+
+bool RouteKState::InitFromHandle(vr_route_req &req, const string &handle) {
+    vector<string> tokens;
+    boost::split(tokens, handle, boost::is_any_of(","));
+    if (tokens.size() != 4) {
+        return false;
+    }
+
+    int vrf_id, marker_plen;
+    boost::system::error_code ec;
+    Ip4Address marker = Ip4Address::from_string(tokens[1], ec);
+    if (!stringToInteger(tokens[0], vrf_id) ||
+        !stringToInteger(tokens[2], marker_plen) || ec) {
+        return false;
+    }
+    if (!tokens[3].empty() && !SetFilter(tokens[3])) {
+        return false;
+    }
+
+    InitEncoder(req, vrf_id);
+    Ip4Address::bytes_type bytes = marker.to_bytes();
+    req.set_rtr_marker(std::vector<int8_t>(bytes.begin(), bytes.end()));
+    req.set_rtr_marker_plen(marker_plen);
+    return true;
+}
+
 void RouteKState::Handler() {
     KRouteResp *resp = static_cast<KRouteResp *>(response_object_);
     if (resp) {
-        if (MoreData()) {
+        if (MoreData() && !PageFull(resp->get_rt_list().size())) {
             /* There are more routes in Kernel. We need to query them from 
-             * Kernel and send it to Sandesh.
+             * Kernel and send it to Sandesh. Routes of a batch may all be
+             * filtered out, in which case there is nothing to send yet.
              */
-            SendResponse();
+            if (!resp->get_rt_list().empty()) {
+                SendResponse();
+            }
             SendNextRequest();
         } else {
+            if (MoreData()) {
+                /* Page is complete, the dump resumes from the handle */
+                resp->set_route_handle(Handle());
+            }
             resp->set_context(response_context_);
             resp->Response();
             RouteContext *rctx = static_cast<RouteContext *>(more_context_);
@@ -57,6 +129,7 @@ void RouteKState::SendNextRequest() {
 void RouteKState::SendResponse() {
 
     KRouteResp *resp = static_cast<KRouteResp *>(response_object_);
+    entries_sent_ += resp->get_rt_list().size();
     resp->set_context(response_context_);
     resp->set_more(true);
     resp->Response();
@@ -15,6 +15,17 @@ public:
     virtual void SendNextRequest();
     const std::string FamilyToString(int family) const;
     const std::string LabelFlagsToString(int flags) const;
+    /* Restrict the dump to routes within prefix given as a.b.c.d/len */
+    bool SetFilter(const std::string &prefix);
+    bool MatchFilter(const vr_route_req *req) const;
+    /* Resume the dump from a handle sent in an earlier response */
+    bool InitFromHandle(vr_route_req &req, const std::string &handle);
+private:
+    const std::string Handle() const;
+
+    std::string filter_;
+    Ip4Address filter_addr_;
+    int filter_plen_;
 };
 
 struct RouteContext {
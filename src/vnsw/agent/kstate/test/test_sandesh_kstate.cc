@@ -11,6 +11,7 @@
 #include "xmpp/test/xmpp_test_util.h"
 #include "pkt/test/test_flow_util.h"
 #include "ksync/ksync_sock_user.h"
+#include "kstate/kstate.h"
 #include <vector>
 
 #define vm1_ip "11.1.1.1"
@@ -173,12 +174,53 @@ public:
         req->Release();
     }
 
+    void RouteGetFiltered(int id, const std::string &prefix) {
+        KRouteReq *req = new KRouteReq();
+        req->set_vrf_id(id);
+        req->set_prefix(prefix);
+        Sandesh::set_response_callback(
+            boost::bind(&KStateSandeshTest::RouteResponse, this, _1));
+        req->HandleRequest();
+        client->WaitForIdle();
+        req->Release();
+    }
+
+    void RouteGetNext() {
+        NextKRouteReq *req = new NextKRouteReq();
+        req->set_route_handle(next_route_handle_);
+        next_route_handle_.clear();
+        Sandesh::set_response_callback(
+            boost::bind(&KStateSandeshTest::RouteResponse, this, _1));
+        req->HandleRequest();
+        client->WaitForIdle();
+        req->Release();
+    }
+
     void RouteResponse(Sandesh *sandesh) {
         response_count_++;
         KRouteResp *response = dynamic_cast<KRouteResp *>(sandesh);
         if (response != NULL) {
             type_specific_response_count_++;
             num_entries_ += response->get_rt_list().size();
+            if (!response->get_route_handle().empty()) {
+                next_route_handle_ = response->get_route_handle();
+            }
+        }
+    }
+
+    static void RouteAddDelete(vr_route_req &req, uint8_t byte, int count,
+                               bool add) {
+        for (int i = 0; i < count; i++) {
+            boost::array<unsigned char, 4> bytes =
+                { {byte, byte, (unsigned char)(i >> 8),
+                   (unsigned char)(i & 0xFF)} };
+            std::vector<int8_t> prefix(bytes.begin(), bytes.end());
+            req.set_rtr_prefix(prefix);
+            if (add) {
+                KSyncSockTypeMap::RouteAdd(req);
+            } else {
+                KSyncSockTypeMap::RouteDelete(req);
+            }
         }
     }
 
@@ -296,6 +338,7 @@ public:
 private:
     BgpPeer *peer_;
     std::string next_flow_handle_;
+    std::string next_route_handle_;
 };
 
 TEST_F(KStateSandeshTest, InterfaceTest_1) {
@@ -905,6 +948,60 @@ TEST_F(KStateSandeshTest, RouteTest_MultiResponse) {
     }
 }
 
+TEST_F(KStateSandeshTest, RouteTest_Filter) {
+    //Create 20 routes each in 48.48.0.0/16 and 64.64.0.0/16
+    vr_route_req req;
+    req.set_rtr_vrf_id(10);
+    req.set_rtr_prefix_len(32);
+    RouteAddDelete(req, 0x30, 20, true);
+    RouteAddDelete(req, 0x40, 20, true);
+
+    //Send Route DUMP request for the routes in 64.64.0.0/16
+    ClearCount();
+    RouteGetFiltered(10, "64.64.0.0/16");
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (num_entries_ == 20U));
+
+    //Invalid prefix
+    ClearCount();
+    RouteGetFiltered(10, "64.64.0.0");
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (response_count_ == 1));
+    EXPECT_EQ(0U, type_specific_response_count_);
+
+    //cleanup
+    RouteAddDelete(req, 0x30, 20, false);
+    RouteAddDelete(req, 0x40, 20, false);
+}
+
+TEST_F(KStateSandeshTest, RouteTest_Paging) {
+    //Create more routes than fit in a page
+    int total_routes = KState::kMaxEntriesPerPage + 200;
+    vr_route_req req;
+    req.set_rtr_vrf_id(10);
+    req.set_rtr_prefix_len(32);
+    RouteAddDelete(req, 0x50, total_routes, true);
+
+    //The first page stops with a handle to resume the dump from
+    ClearCount();
+    RouteGet(10);
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (next_route_handle_.empty() == false));
+    EXPECT_GE(num_entries_, (uint32_t)KState::kMaxEntriesPerPage);
+    uint32_t first_page_entries = num_entries_;
+
+    //Fetch the rest of the routes
+    ClearCount();
+    RouteGetNext();
+    client->WaitForIdle();
+    WAIT_FOR(1000, 1000, (num_entries_ + first_page_entries ==
+                          (uint32_t)total_routes));
+    EXPECT_TRUE(next_route_handle_.empty());
+
+    //cleanup
+    RouteAddDelete(req, 0x50, total_routes, false);
+}
+
 TEST_F(KStateSandeshTest, VrfAssignTest) {
     //Create 2 vrf_assign objects in mock Kernel
     vr_vrf_assign_req req1, req2;
@@ -1,6 +1,7 @@
 /*
  * Copyright (c) 2013 Juniper Networks, Inc. All rights reserved.
  */
+#include <set>
 #include <cmn/agent_cmn.h>
 #include <route/route.h>
 
@@ -18,7 +19,8 @@ using namespace std;
 
 AgentRouteWalker::AgentRouteWalker(Agent *agent, WalkType type) :
     agent_(agent), walk_type_(type),
-    vrf_walkid_(DBTableWalker::kInvalidWalkerId), walk_done_cb_(),
+    vrf_walkid_(DBTableWalker::kInvalidWalkerId), max_route_walks_(0),
+    pending_route_walk_seq_(0), route_walk_done_count_(0), walk_done_cb_(),
     route_walk_done_for_vrf_cb_(),
     work_queue_(TaskScheduler::GetInstance()->
                 GetTaskId("Agent::RouteWalker"), 0,
@@ -48,8 +50,12 @@ bool AgentRouteWalker::RouteWalker(boost::shared_ptr<AgentRouteWalkerQueueEntry>
           CancelVrfWalkInternal();
           break;
       case AgentRouteWalkerQueueEntry::START_ROUTE_WALK:
-          DecrementQueuedWalkCount();
-          StartRouteWalkInternal(vrf);
+          if (max_route_walks_ == 0) {
+              DecrementQueuedWalkCount();
+              StartRouteWalkInternal(vrf);
+          } else {
+              AddPendingRouteWalk(vrf);
+          }
           break;
       case AgentRouteWalkerQueueEntry::CANCEL_ROUTE_WALK:
           CancelRouteWalkInternal(vrf);
@@ -61,6 +67,12 @@ bool AgentRouteWalker::RouteWalker(boost::shared_ptr<AgentRouteWalkerQueueEntry>
       default:
           assert(0);
     }
+
+    // Start waiting route walks once the requests queued so far are seen,
+    // so that the walk of higher priority VRF found later goes first
+    if (max_route_walks_ && work_queue_.IsQueueEmpty()) {
+        StartPendingRouteWalks();
+    }
     return true;
 }
 
@@ -101,6 +113,15 @@ void AgentRouteWalker::CancelRouteWalkInternal(const VrfEntry *vrf) {
     DBTableWalker *walker = agent_->db()->GetWalker();
     uint32_t vrf_id = vrf->vrf_id();
 
+    //Remove the walk if it is yet to be started
+    PendingRouteWalkVrfMap::iterator pending =
+        pending_route_walk_vrfs_.find(vrf_id);
+    if (pending != pending_route_walk_vrfs_.end()) {
+        pending_route_walks_.erase(pending->second);
+        pending_route_walk_vrfs_.erase(pending);
+        DecrementQueuedWalkCount();
+    }
+
     //Cancel Route table walks
     for (uint8_t table_type = (Agent::INVALID + 1);
          table_type < Agent::ROUTE_TABLE_MAX;
@@ -196,6 +217,70 @@ void AgentRouteWalker::StartRouteWalkInternal(const VrfEntry *vrf) {
     }
 }
 
+/*
+ * Holds the route walk for given VRF till the number of VRF with route walks
+ * in progress is below max_route_walks_. The request stays counted as queued
+ * till the walk is started.
+ */
+void AgentRouteWalker::AddPendingRouteWalk(VrfEntry *vrf) {
+    if (pending_route_walk_vrfs_.find(vrf->vrf_id()) !=
+        pending_route_walk_vrfs_.end()) {
+        //Walk started later covers this request as well
+        DecrementQueuedWalkCount();
+        return;
+    }
+
+    PendingRouteWalkMap::iterator it = pending_route_walks_.insert(
+        std::make_pair(std::make_pair(RouteWalkPriority(vrf),
+                                      pending_route_walk_seq_++),
+                       VrfEntryRef(vrf))).first;
+    pending_route_walk_vrfs_[vrf->vrf_id()] = it;
+}
+
+void AgentRouteWalker::StartPendingRouteWalks() {
+    uint32_t active = active_route_walk_count();
+    while ((active < max_route_walks_) && !pending_route_walks_.empty()) {
+        PendingRouteWalkMap::iterator it = pending_route_walks_.begin();
+        VrfEntryRef vrf = it->second;
+        pending_route_walk_vrfs_.erase(vrf->vrf_id());
+        pending_route_walks_.erase(it);
+        DecrementQueuedWalkCount();
+        StartRouteWalkInternal(vrf.get());
+        if (IsRouteWalkActive(vrf->vrf_id())) {
+            active++;
+        }
+    }
+}
+
+bool AgentRouteWalker::IsRouteWalkActive(uint32_t vrf_id) const {
+    for (uint8_t table_type = (Agent::INVALID + 1);
+         table_type < Agent::ROUTE_TABLE_MAX;
+         table_type++) {
+        if (route_walkid_[table_type].find(vrf_id) !=
+            route_walkid_[table_type].end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Number of VRF with route walks in progress
+ */
+uint32_t AgentRouteWalker::active_route_walk_count() const {
+    std::set<uint32_t> vrfs;
+    for (uint8_t table_type = (Agent::INVALID + 1);
+         table_type < Agent::ROUTE_TABLE_MAX;
+         table_type++) {
+        for (VrfRouteWalkerIdMap::const_iterator it =
+             route_walkid_[table_type].begin();
+             it != route_walkid_[table_type].end(); ++it) {
+            vrfs.insert(it->first);
+        }
+    }
+    return vrfs.size();
+}
+
 /*
  * VRF entry notification handler 
  */
@@ -266,6 +351,17 @@ void AgentRouteWalker::RouteWalkDone(DBTableBase *part) {
                            iter->second);
         route_walkid_[table_type].erase(vrf_id);
         DecrementWalkCount();
+        if (!IsRouteWalkActive(vrf_id)) {
+            route_walk_done_count_++;
+            std::stringstream progress;
+            progress << "Route walks done for vrf, " << route_walk_done_count_
+                << " vrf done, " << pending_route_walks_.size()
+                << " vrf waiting";
+            AGENT_DBWALK_TRACE(AgentRouteWalkerTrace, progress.str(),
+                               walk_type_, "", vrf_walkid_, table_type,
+                               table->GetTableName(),
+                               DBTableWalker::kInvalidWalkerId);
+        }
 
         // vrf entry can be null as table wud have released the reference
         // via lifetime actor
@@ -277,6 +373,9 @@ void AgentRouteWalker::RouteWalkDone(DBTableBase *part) {
         // have happened on vrf entry as well.
         if (vrf != NULL) {
             Callback(vrf);
+        } else if (max_route_walks_) {
+            //Let waiting route walks use the freed slot
+            Callback(NULL);
         }
     }
 }
@@ -327,14 +426,8 @@ void AgentRouteWalker::OnRouteTableWalkCompleteForVrf(VrfEntry *vrf) {
     if (!route_walk_done_for_vrf_cb_)
         return;
 
-    for (uint8_t table_type = (Agent::INVALID + 1);
-         table_type < Agent::ROUTE_TABLE_MAX;
-         table_type++) {
-        VrfRouteWalkerIdMapIterator iter = 
-            route_walkid_[table_type].find(vrf->vrf_id());
-        if (iter != route_walkid_[table_type].end()) {
-            return;
-        }
+    if (IsRouteWalkActive(vrf->vrf_id())) {
+        return;
     }
     route_walk_done_for_vrf_cb_(vrf);
 }
@@ -33,6 +33,10 @@
  * route walk started by VRF.
  * Cancellation of route walk can be done by usig CancelRouteWalk with vrf as
  * argument.
+ *
+ * Route walks of all VRF run in parallel. set_max_route_walks() limits the
+ * number of VRF with route walks in progress, remaining VRF wait and are
+ * started in the order of RouteWalkPriority(), lowest first.
  * TODO - Do route cancellation for route walks when vrf walk is cancelled.
  *
  */
@@ -69,6 +73,12 @@ public:
 
     typedef std::map<uint32_t, DBTableWalker::WalkId> VrfRouteWalkerIdMap;
     typedef std::map<uint32_t, DBTableWalker::WalkId>::iterator VrfRouteWalkerIdMapIterator;
+    // Route walks waiting for a free slot, keyed by priority and then by
+    // request order
+    typedef std::map<std::pair<uint32_t, uint64_t>, VrfEntryRef>
+        PendingRouteWalkMap;
+    typedef std::map<uint32_t, PendingRouteWalkMap::iterator>
+        PendingRouteWalkVrfMap;
 
     AgentRouteWalker(Agent *agent, WalkType type);
     virtual ~AgentRouteWalker();
@@ -85,6 +95,10 @@ public:
 
     virtual void VrfWalkDone(DBTableBase *part);
     virtual void RouteWalkDone(DBTableBase *part);
+    // Order in which waiting route walks are started, lower first
+    virtual uint32_t RouteWalkPriority(const VrfEntry *vrf) const {
+        return 0;
+    }
 
     void WalkDoneCallback(WalkDone cb);
     void RouteWalkDoneForVrfCallback(RouteWalkDoneCb cb);
@@ -96,6 +110,14 @@ public:
                                            kInvalidWalkCount);}
     int walk_count() const {return walk_count_;}
     bool IsWalkCompleted() const {return (walk_count_ == kInvalidWalkCount);}
+    //Max VRF with route walks in progress, 0 for no limit
+    void set_max_route_walks(uint32_t max) {max_route_walks_ = max;}
+    uint32_t max_route_walks() const {return max_route_walks_;}
+    uint32_t pending_route_walk_count() const {
+        return pending_route_walks_.size();
+    }
+    uint32_t active_route_walk_count() const;
+    uint64_t route_walk_done_count() const {return route_walk_done_count_;}
     //Callback for start of a walk issued from Agent::RouteWalker
     //task context.
     virtual bool RouteWalker(boost::shared_ptr<AgentRouteWalkerQueueEntry> data);
@@ -107,6 +129,9 @@ private:
     void CancelVrfWalkInternal();
     void StartRouteWalkInternal(const VrfEntry * vrf);
     void CancelRouteWalkInternal(const VrfEntry *vrf);
+    void AddPendingRouteWalk(VrfEntry *vrf);
+    void StartPendingRouteWalks();
+    bool IsRouteWalkActive(uint32_t vrf_id) const;
 
     void Callback(VrfEntry *vrf);
     void CallbackInternal(VrfEntry *vrf, bool all_walks_done);
@@ -126,6 +151,11 @@ private:
     tbb::atomic<int> walk_count_;
     DBTableWalker::WalkId vrf_walkid_;
     VrfRouteWalkerIdMap route_walkid_[Agent::ROUTE_TABLE_MAX];
+    uint32_t max_route_walks_;
+    uint64_t pending_route_walk_seq_;
+    PendingRouteWalkMap pending_route_walks_;
+    PendingRouteWalkVrfMap pending_route_walk_vrfs_;
+    uint64_t route_walk_done_count_;
     WalkDone walk_done_cb_;
     RouteWalkDoneCb route_walk_done_for_vrf_cb_;
     //work queue(Agent::RouteWalker) is used for starting/cancelling
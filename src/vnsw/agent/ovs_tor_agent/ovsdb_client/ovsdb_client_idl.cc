@@ -10,6 +10,7 @@
 extern "C" {
 #include <ovsdb_wrapper.h>
 };
+#include <base/time_util.h>
 #include <oper/agent_sandesh.h>
 #include <ovsdb_types.h>
 #include <ovsdb_client_connection_state.h>
@@ -65,7 +66,14 @@ void ovsdb_wrapper_idl_callback(void *idl_base, int op,
 
 void ovsdb_wrapper_idl_txn_ack(void *idl_base, struct ovsdb_idl_txn *txn) {
     OvsdbClientIdl *client_idl = (OvsdbClientIdl *) idl_base;
-    OvsdbEntryBase *entry = client_idl->pending_txn_[txn];
+    OvsdbClientIdl::OvsdbEntryList entries;
+    uint64_t send_time = 0;
+    OvsdbClientIdl::PendingTxnMap::iterator it =
+        client_idl->pending_txn_.find(txn);
+    if (it != client_idl->pending_txn_.end()) {
+        entries.swap(it->second.entries);
+        send_time = it->second.send_time;
+    }
     bool success = ovsdb_wrapper_is_txn_success(txn);
     if (!success) {
         // increment stats.
@@ -74,20 +82,26 @@ void ovsdb_wrapper_idl_txn_ack(void *idl_base, struct ovsdb_idl_txn *txn) {
                 std::string(ovsdb_wrapper_txn_get_error(txn)));
         // we don't handle the case where txn fails, when entry is not present
         // case of unicast_mac_remote entry.
-        assert(entry != NULL);
+        assert(!entries.empty());
+        if (entries.size() > 1) {
+            client_idl->RetryBulkTxnEntries(entries);
+        }
     } else {
         // increment stats.
         client_idl->stats_.txn_succeeded++;
     }
+    if (send_time != 0) {
+        client_idl->UpdateInFlightWindow(ClockMonotonicUsec() - send_time);
+    }
     client_idl->DeleteTxn(txn);
-    if (entry)
-        entry->Ack(success);
-
-    // if there are pending txn messages to be scheduled, pick one and schedule
-    if (!client_idl->pending_send_msgs_.empty()) {
-        client_idl->session_->SendJsonRpc(client_idl->pending_send_msgs_.front());
-        client_idl->pending_send_msgs_.pop();
+    OvsdbClientIdl::OvsdbEntryList::iterator entry_it = entries.begin();
+    for (; entry_it != entries.end(); ++entry_it) {
+        (*entry_it)->Ack(success);
     }
+
+    // if there are pending txn messages to be scheduled, schedule as many
+    // as the in flight window allows
+    client_idl->SendThrottledTxnMsgs();
 }
 
 void intrusive_ptr_add_ref(OvsdbClientIdl *p) {
@@ -133,13 +147,20 @@ void intrusive_ptr_release(OvsdbClientIdl *p) {
 
 OvsdbClientIdl::OvsdbClientIdl(OvsdbClientSession *session, Agent *agent,
         OvsPeerManager *manager) : idl_(ovsdb_wrapper_idl_create()),
-    session_(session), agent_(agent), pending_txn_(), deleted_(false),
+    session_(session), agent_(agent), pending_txn_(), bulk_txn_(NULL),
+    bulk_txn_table_(NULL), bulk_txn_encoding_(false), bulk_txn_locators_(),
+    empty_txn_acks_(),
+    bulk_txn_trigger_(new TaskTrigger(
+                boost::bind(&OvsdbClientIdl::BulkTxnTrigger, this),
+                TaskScheduler::GetInstance()->GetTaskId("Agent::KSync"), 0)),
+    in_flight_txn_(0), in_flight_window_(OVSDBInitInFlightPendingTxn),
+    base_latency_(0), window_latency_(0), window_acks_(0), deleted_(false),
     manager_(manager), connection_state_(OvsdbSessionRcvWait),
     keepalive_timer_(TimerManager::CreateTimer(
                 *(agent->event_manager())->io_service(),
                 "OVSDB Client Keep Alive Timer",
                 TaskScheduler::GetInstance()->GetTaskId("Agent::KSync"), 0)),
-    monitor_request_id_(NULL), stats_() {
+    monitor_request_id_(NULL), monitor_response_pending_(false), stats_() {
     refcount_ = 0;
     vtep_global_= ovsdb_wrapper_vteprec_global_first(idl_);
     ovsdb_wrapper_idl_set_callback(idl_, (void *)this,
@@ -173,13 +194,15 @@ OvsdbClientIdl::~OvsdbClientIdl() {
     }
 
     TimerManager::DeleteTimer(keepalive_timer_);
+    bulk_txn_trigger_->Reset();
     receive_queue_->Shutdown();
     delete receive_queue_;
     manager_->Free(route_peer_.release());
     ovsdb_wrapper_idl_destroy(idl_);
 }
 
-OvsdbClientIdl::OvsdbMsg::OvsdbMsg(struct jsonrpc_msg *m) : msg(m) {
+OvsdbClientIdl::OvsdbMsg::OvsdbMsg(struct jsonrpc_msg *m) : msg(m),
+    more_batches(false) {
 }
 
 OvsdbClientIdl::OvsdbMsg::~OvsdbMsg() {
@@ -190,7 +213,7 @@ OvsdbClientIdl::OvsdbMsg::~OvsdbMsg() {
 }
 
 OvsdbClientIdl::TxnStats::TxnStats() : txn_initiated(0), txn_succeeded(0),
-    txn_failed(0) {
+    txn_failed(0), bulk_txn_sent(0), bulk_txn_entries(0), txn_latency_usec(0) {
 }
 
 void OvsdbClientIdl::OnEstablish() {
@@ -229,21 +252,73 @@ void OvsdbClientIdl::OnEstablish() {
             boost::bind(&OvsdbClientIdl::KeepAliveTimerCb, this));
 }
 
-void OvsdbClientIdl::TxnScheduleJsonRpc(struct jsonrpc_msg *msg) {
+void OvsdbClientIdl::TxnScheduleJsonRpc(struct ovsdb_idl_txn *txn,
+                                        struct jsonrpc_msg *msg) {
     // increment stats.
     stats_.txn_initiated++;
 
+    // messages already waiting are sent first to keep the order of txns
     if (!session_->ThrottleInFlightTxnMessages() ||
-        OVSDBMaxInFlightPendingTxn >= pending_txn_.size()) {
-        session_->SendJsonRpc(msg);
+        (pending_send_msgs_.empty() && in_flight_txn_ < in_flight_window_)) {
+        SendTxnJsonRpc(txn, msg);
     } else {
         // throttle txn messages, push the message to pending send
         // msg queue to be scheduled later.
-        pending_send_msgs_.push(msg);
+        pending_send_msgs_.push(TxnMsg(txn, msg));
+    }
+}
+
+void OvsdbClientIdl::SendTxnJsonRpc(struct ovsdb_idl_txn *txn,
+                                    struct jsonrpc_msg *msg) {
+    pending_txn_[txn].send_time = ClockMonotonicUsec();
+    in_flight_txn_++;
+    session_->SendJsonRpc(msg);
+}
+
+void OvsdbClientIdl::SendThrottledTxnMsgs() {
+    while (!pending_send_msgs_.empty() &&
+           (!session_->ThrottleInFlightTxnMessages() ||
+            in_flight_txn_ < in_flight_window_)) {
+        TxnMsg txn_msg = pending_send_msgs_.front();
+        pending_send_msgs_.pop();
+        SendTxnJsonRpc(txn_msg.first, txn_msg.second);
+    }
+}
+
+// Latency is evaluated once per window worth of acks, the window grows by
+// half while the average stays within twice the lowest average seen, and
+// is halved otherwise
+void OvsdbClientIdl::UpdateInFlightWindow(uint64_t latency) {
+    window_latency_ += latency;
+    window_acks_++;
+    if (window_acks_ < in_flight_window_) {
+        return;
+    }
+
+    uint64_t avg_latency = window_latency_ / window_acks_;
+    window_latency_ = 0;
+    window_acks_ = 0;
+    stats_.txn_latency_usec = avg_latency;
+    if (base_latency_ == 0 || avg_latency < base_latency_) {
+        base_latency_ = avg_latency;
+    }
+
+    if (avg_latency <= 2 * base_latency_) {
+        in_flight_window_ += in_flight_window_ / 2;
+        if (in_flight_window_ > OVSDBMaxInFlightPendingTxn) {
+            in_flight_window_ = OVSDBMaxInFlightPendingTxn;
+        }
+    } else {
+        in_flight_window_ /= 2;
+        if (in_flight_window_ < OVSDBMinInFlightPendingTxn) {
+            in_flight_window_ = OVSDBMinInFlightPendingTxn;
+        }
     }
 }
 
 bool OvsdbClientIdl::ProcessMessage(OvsdbMsg *msg) {
+    // idl should not process updates with a transaction open
+    FlushBulkTxn();
     if (!deleted_) {
         // NULL message, echo req and reply messages are just enqueued to
         // identify session activity, since they need no further processing
@@ -251,21 +326,21 @@ bool OvsdbClientIdl::ProcessMessage(OvsdbMsg *msg) {
         if (msg->msg != NULL &&
             !ovsdb_wrapper_msg_echo_req(msg->msg) &&
             !ovsdb_wrapper_msg_echo_reply(msg->msg)) {
-            bool connect_oper_db = false;
             if (ovsdb_wrapper_idl_msg_is_monitor_response(monitor_request_id_,
                                                           msg->msg)) {
                 // destroy saved monitor request json message
                 ovsdb_wrapper_json_destroy(monitor_request_id_);
                 monitor_request_id_ = NULL;
-                connect_oper_db = true;
+                monitor_response_pending_ = true;
             }
             ovsdb_wrapper_idl_msg_process(idl_, msg->msg);
             // msg->msg is freed by process method above
             msg->msg = NULL;
 
-            // after processing the response to monitor request
-            // connect to oper db.
-            if (connect_oper_db) {
+            // after processing the response to monitor request, along with
+            // the batches of rows split from it, connect to oper db.
+            if (monitor_response_pending_ && !msg->more_batches) {
+                monitor_response_pending_ = false;
                 // enable physical port updation, before connect to
                 // Oper DB, to allow creation of stale entries for
                 // vlan port bindings.
@@ -288,20 +363,159 @@ struct ovsdb_idl_txn *OvsdbClientIdl::CreateTxn(OvsdbEntryBase *entry,
         // Don't create new transactions for deleted idl.
         return NULL;
     }
+    // send the open bulk txn before starting to encode a new one
+    if (!bulk_txn_encoding_) {
+        FlushBulkTxn();
+    }
     struct ovsdb_idl_txn *txn =  ovsdb_wrapper_idl_txn_create(idl_);
-    pending_txn_[txn] = entry;
+    PendingTxn &pending_txn = pending_txn_[txn];
     if (entry != NULL) {
         // if entry is available store the ack_event in entry
         entry->ack_event_ = ack_event;
+        pending_txn.entries.push_back(entry);
     }
     return txn;
 }
 
+struct ovsdb_idl_txn *OvsdbClientIdl::CreateBulkTxn(OvsdbEntryBase *entry,
+        KSyncObject *table, KSyncEntry::KSyncEvent ack_event) {
+    if (deleted_) {
+        // Don't create new transactions for deleted idl.
+        return NULL;
+    }
+
+    if (bulk_txn_encoding_) {
+        // nested in encoding of bulk txn, use a txn of its own
+        return CreateTxn(entry, ack_event);
+    }
+
+    if (entry->bulk_txn_retry_) {
+        entry->bulk_txn_retry_ = false;
+        return CreateTxn(entry, ack_event);
+    }
+
+    if (bulk_txn_ != NULL && bulk_txn_table_ != table) {
+        FlushBulkTxn();
+    }
+
+    if (bulk_txn_ == NULL) {
+        bulk_txn_ = ovsdb_wrapper_idl_txn_create(idl_);
+        bulk_txn_table_ = table;
+        // send the bulk txn once done with the current set of updates
+        bulk_txn_trigger_->Set();
+    }
+    entry->ack_event_ = ack_event;
+    pending_txn_[bulk_txn_].entries.push_back(entry);
+    bulk_txn_encoding_ = true;
+    return bulk_txn_;
+}
+
+bool OvsdbClientIdl::EncodeSendTxn(struct ovsdb_idl_txn *txn,
+                                   OvsdbEntryBase *skip_entry) {
+    if (txn == bulk_txn_) {
+        bulk_txn_encoding_ = false;
+        if (pending_txn_[txn].entries.size() < OVSDBEntriesInBulkTxn) {
+            // wait for more entries to join
+            return true;
+        }
+        return FlushBulkTxn(skip_entry);
+    }
+
+    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
+    if (msg == NULL) {
+        DeleteTxn(txn);
+        return false;
+    }
+    TxnScheduleJsonRpc(txn, msg);
+    return true;
+}
+
+bool OvsdbClientIdl::FlushBulkTxn(OvsdbEntryBase *skip_entry) {
+    if (bulk_txn_ == NULL) {
+        return false;
+    }
+
+    struct ovsdb_idl_txn *txn = bulk_txn_;
+    bulk_txn_ = NULL;
+    bulk_txn_table_ = NULL;
+    bulk_txn_locators_.clear();
+    OvsdbEntryList &entries = pending_txn_[txn].entries;
+    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
+    if (msg != NULL) {
+        stats_.bulk_txn_sent++;
+        stats_.bulk_txn_entries += entries.size();
+        TxnScheduleJsonRpc(txn, msg);
+        return true;
+    }
+
+    // none of the entries had anything to encode, ack them from trigger
+    // as acks can start new transactions while caller is creating one
+    OvsdbEntryList::iterator it = entries.begin();
+    for (; it != entries.end(); ++it) {
+        if (*it != skip_entry) {
+            empty_txn_acks_.push_back(*it);
+        }
+    }
+    DeleteTxn(txn);
+    if (!empty_txn_acks_.empty()) {
+        bulk_txn_trigger_->Set();
+    }
+    return false;
+}
+
+void OvsdbClientIdl::RetryBulkTxnEntries(const OvsdbEntryList &entries) {
+    OvsdbEntryList::const_iterator it = entries.begin();
+    for (; it != entries.end(); ++it) {
+        (*it)->bulk_txn_retry_ = true;
+    }
+}
+
+bool OvsdbClientIdl::BulkTxnTrigger() {
+    FlushBulkTxn();
+    OvsdbEntryList entries;
+    entries.swap(empty_txn_acks_);
+    OvsdbEntryList::iterator it = entries.begin();
+    for (; it != entries.end(); ++it) {
+        (*it)->Ack(true);
+    }
+    // acks can open a new bulk txn, run again till all is sent
+    return (bulk_txn_ == NULL && empty_txn_acks_.empty());
+}
+
 void OvsdbClientIdl::DeleteTxn(struct ovsdb_idl_txn *txn) {
-    pending_txn_.erase(txn);
+    PendingTxnMap::iterator it = pending_txn_.find(txn);
+    if (it != pending_txn_.end()) {
+        if (it->second.send_time != 0) {
+            in_flight_txn_--;
+        }
+        pending_txn_.erase(it);
+    }
+    if (txn == bulk_txn_) {
+        bulk_txn_ = NULL;
+        bulk_txn_table_ = NULL;
+        bulk_txn_encoding_ = false;
+        bulk_txn_locators_.clear();
+    }
     ovsdb_wrapper_idl_txn_destroy(txn);
 }
 
+struct ovsdb_idl_row *OvsdbClientIdl::bulk_txn_locator(
+        struct ovsdb_idl_txn *txn, const std::string &dest_ip) {
+    if (txn != bulk_txn_) {
+        return NULL;
+    }
+    TxnLocatorMap::iterator it = bulk_txn_locators_.find(dest_ip);
+    return (it != bulk_txn_locators_.end()) ? it->second : NULL;
+}
+
+void OvsdbClientIdl::set_bulk_txn_locator(struct ovsdb_idl_txn *txn,
+                                          const std::string &dest_ip,
+                                          struct ovsdb_idl_row *row) {
+    if (txn == bulk_txn_) {
+        bulk_txn_locators_[dest_ip] = row;
+    }
+}
+
 // API to trigger ovs row del followed by add
 // used by OvsdbEntry on catastrophic change event, which
 // results in emulating a delete followed by add
@@ -320,10 +534,31 @@ Ip4Address OvsdbClientIdl::tsn_ip() {
 }
 
 void OvsdbClientIdl::MessageProcess(struct jsonrpc_msg *msg) {
+    // Split table updates carrying a large number of rows, typically the
+    // monitor response from a switch with many MACs, into batches of rows
+    // here in OVSDB::IO task context. KSync task applies the batches one
+    // after the other, while the messages following are still being
+    // decoded, instead of being held up by one huge update.
+    std::vector<OvsdbMsg *> batches;
+    if (msg != NULL) {
+        struct jsonrpc_msg *batch;
+        while ((batch = ovsdb_wrapper_idl_msg_split_update(msg,
+                        OVSDBRowsPerUpdateBatch)) != NULL) {
+            batches.push_back(new OvsdbMsg(batch));
+        }
+    }
+
     // Enqueue all received messages in receive queue running KSync task
     // context, to assure only one thread is writting data to OVSDB client.
+    // batches are enqueued after the message they are split from, keeping
+    // the order of updates.
     OvsdbMsg *ovs_msg = new OvsdbMsg(msg);
+    ovs_msg->more_batches = !batches.empty();
     receive_queue_->Enqueue(ovs_msg);
+    for (std::size_t i = 0; i < batches.size(); i++) {
+        batches[i]->more_batches = (i + 1 < batches.size());
+        receive_queue_->Enqueue(batches[i]);
+    }
 }
 
 Ip4Address OvsdbClientIdl::remote_ip() const {
@@ -432,17 +667,21 @@ void OvsdbClientIdl::TriggerDeletion() {
     // trigger txn failure for pending transcations
     PendingTxnMap::iterator it = pending_txn_.begin();
     while (it != pending_txn_.end()) {
-        OvsdbEntryBase *entry = it->second;
+        OvsdbEntryList entries;
+        entries.swap(it->second.entries);
         DeleteTxn(it->first);
-        // Ack failure, if entry is available.
-        if (entry)
-            entry->Ack(false);
+        // Ack failure, for all the entries of txn.
+        OvsdbEntryList::iterator entry_it = entries.begin();
+        for (; entry_it != entries.end(); ++entry_it) {
+            (*entry_it)->Ack(false);
+        }
         it = pending_txn_.begin();
     }
 
     while (!pending_send_msgs_.empty()) {
-        // flush and destroy all the pending send messages
-        ovsdb_wrapper_jsonrpc_msg_destroy(pending_send_msgs_.front());
+        // flush and destroy all the pending send messages, txn is
+        // already destroyed above
+        ovsdb_wrapper_jsonrpc_msg_destroy(pending_send_msgs_.front().second);
         pending_send_msgs_.pop();
     }
 
@@ -7,10 +7,13 @@
 
 #include <assert.h>
 #include <queue>
+#include <vector>
 
 #include <boost/intrusive_ptr.hpp>
 #include <tbb/atomic.h>
 
+#include <base/task_trigger.h>
+
 #include <cmn/agent_cmn.h>
 #include <cmn/agent.h>
 #include <agent_types.h>
@@ -74,7 +77,21 @@ public:
     // minimum value of keep alive interval
     static const int OVSDBMinKeepAliveTimer = 2000; // in millisecond
 
-    static const std::size_t OVSDBMaxInFlightPendingTxn = 100;
+    // number of transactions sent and waiting for ack when in flight txn
+    // messages are throttled, the window starts at the init value and moves
+    // between min and max, opening up while the latency observed for the
+    // acked transactions stays close to the lowest seen and closing down
+    // when the server starts lagging behind
+    static const std::size_t OVSDBMinInFlightPendingTxn = 16;
+    static const std::size_t OVSDBInitInFlightPendingTxn = 100;
+    static const std::size_t OVSDBMaxInFlightPendingTxn = 1024;
+
+    // max number of entries encoding row operations in one bulk transaction
+    static const std::size_t OVSDBEntriesInBulkTxn = 256;
+
+    // max number of rows applied to idl from one message, bigger table
+    // updates are split into batches of rows
+    static const std::size_t OVSDBRowsPerUpdateBatch = 1024;
 
     enum Op {
         OVSDB_DEL = 0,
@@ -99,6 +116,8 @@ public:
         OvsdbMsg(struct jsonrpc_msg *m);
         ~OvsdbMsg();
         struct jsonrpc_msg *msg;
+        // set if more batches of rows split from the same message follow
+        bool more_batches;
     };
 
     struct TxnStats {
@@ -106,11 +125,24 @@ public:
         uint64_t txn_initiated;
         uint64_t txn_succeeded;
         uint64_t txn_failed;
+        uint64_t bulk_txn_sent;
+        uint64_t bulk_txn_entries;
+        // average ack latency of the last window of transactions
+        uint64_t txn_latency_usec;
     };
 
     typedef boost::function<void(OvsdbClientIdl::Op, struct ovsdb_idl_row *)> NotifyCB;
-    typedef std::map<struct ovsdb_idl_txn *, OvsdbEntryBase *> PendingTxnMap;
-    typedef std::queue<struct jsonrpc_msg *> ThrottledTxnMsgs;
+    typedef std::vector<OvsdbEntryBase *> OvsdbEntryList;
+    struct PendingTxn {
+        PendingTxn() : entries(), send_time(0) {}
+        OvsdbEntryList entries;
+        // time at which txn message was sent, 0 till then
+        uint64_t send_time;
+    };
+    typedef std::map<struct ovsdb_idl_txn *, PendingTxn> PendingTxnMap;
+    typedef std::pair<struct ovsdb_idl_txn *, struct jsonrpc_msg *> TxnMsg;
+    typedef std::queue<TxnMsg> ThrottledTxnMsgs;
+    typedef std::map<std::string, struct ovsdb_idl_row *> TxnLocatorMap;
 
     OvsdbClientIdl(OvsdbClientSession *session, Agent *agent, OvsPeerManager *manager);
     virtual ~OvsdbClientIdl();
@@ -121,15 +153,33 @@ public:
     // Send request to start monitoring OVSDB server
     void OnEstablish();
 
-    // Encode and send json rpc message to OVSDB server
-    // takes ownership of jsonrpc message, and free memory
-    void TxnScheduleJsonRpc(struct jsonrpc_msg *msg);
-
     // Process the recevied message and trigger update to ovsdb client
     void MessageProcess(const u_int8_t *buf, std::size_t len);
     // Create a OVSDB transaction to start encoding an update
     struct ovsdb_idl_txn *CreateTxn(OvsdbEntryBase *entry,
             KSyncEntry::KSyncEvent ack_event = KSyncEntry::ADD_ACK);
+    // Get the OVSDB bulk transaction open for entries of given table,
+    // row operations of all the entries joining the bulk transaction are
+    // sent to OVSDB server in one transact request
+    struct ovsdb_idl_txn *CreateBulkTxn(OvsdbEntryBase *entry,
+            KSyncObject *table,
+            KSyncEntry::KSyncEvent ack_event = KSyncEntry::ADD_ACK);
+    // Encode and send the transaction, bulk transaction is sent only once
+    // it is full. returns false if there was nothing to encode for the
+    // transaction and skip_entry need not wait for an ack, transaction
+    // is deleted in that case
+    bool EncodeSendTxn(struct ovsdb_idl_txn *txn, OvsdbEntryBase *skip_entry);
+    // physical locator rows inserted in the open bulk transaction, for
+    // entries of the transaction to refer instead of inserting a duplicate
+    struct ovsdb_idl_row *bulk_txn_locator(struct ovsdb_idl_txn *txn,
+                                           const std::string &dest_ip);
+    void set_bulk_txn_locator(struct ovsdb_idl_txn *txn,
+                              const std::string &dest_ip,
+                              struct ovsdb_idl_row *row);
+    // a failed row operation aborts the whole bulk transaction, the next
+    // request of each of its entries gets a transaction of its own so that
+    // one bad entry doesn't keep failing the others
+    void RetryBulkTxnEntries(const OvsdbEntryList &entries);
     // Delete the OVSDB transaction
     void DeleteTxn(struct ovsdb_idl_txn *txn);
     void Register(EntryType type, NotifyCB cb) {callback_[type] = cb;}
@@ -141,6 +191,7 @@ public:
     Ip4Address tsn_ip();
 
     // Process jsonrpc_msg for IDL, takes ownership of jsonrpc_msg
+    // invoked from OVSDB::IO task
     void MessageProcess(struct jsonrpc_msg *msg);
 
     Ip4Address remote_ip() const;
@@ -173,6 +224,10 @@ public:
     const TxnStats &stats() const;
     uint64_t pending_txn_count() const;
     uint64_t pending_send_msg_count() const;
+    std::size_t in_flight_window() const { return in_flight_window_; }
+    // Update the in flight window with ack latency of a transaction,
+    // public for Test case
+    void UpdateInFlightWindow(uint64_t latency);
 
 private:
     friend void ovsdb_wrapper_idl_callback(void *, int, struct ovsdb_idl_row *);
@@ -182,6 +237,18 @@ private:
 
     void ConnectOperDB();
 
+    // send txn message now or queue it, if in flight window is full.
+    // takes ownership of jsonrpc message, and free memory
+    void TxnScheduleJsonRpc(struct ovsdb_idl_txn *txn,
+                            struct jsonrpc_msg *msg);
+    void SendTxnJsonRpc(struct ovsdb_idl_txn *txn, struct jsonrpc_msg *msg);
+    void SendThrottledTxnMsgs();
+    // encode and send the open bulk transaction, returns false if there
+    // was nothing to encode, acks for entries other than skip_entry are
+    // then triggered from bulk_txn_trigger_
+    bool FlushBulkTxn(OvsdbEntryBase *skip_entry = NULL);
+    bool BulkTxnTrigger();
+
     struct ovsdb_idl *idl_;
     const struct vteprec_global *vtep_global_;
     OvsdbClientSession *session_;
@@ -189,6 +256,22 @@ private:
     NotifyCB callback_[OVSDB_TYPE_COUNT];
     PendingTxnMap pending_txn_;
     ThrottledTxnMsgs pending_send_msgs_;
+    // bulk transaction open for entries of bulk_txn_table_, any other
+    // transaction or processing of a received message sends it first,
+    // unless an entry is in the middle of encoding it, transactions created
+    // while encoding then are nested the same way as for a single txn
+    struct ovsdb_idl_txn *bulk_txn_;
+    KSyncObject *bulk_txn_table_;
+    bool bulk_txn_encoding_;
+    TxnLocatorMap bulk_txn_locators_;
+    // entries of bulk transactions that turned out empty, waiting for ack
+    OvsdbEntryList empty_txn_acks_;
+    std::auto_ptr<TaskTrigger> bulk_txn_trigger_;
+    std::size_t in_flight_txn_;
+    std::size_t in_flight_window_;
+    uint64_t base_latency_;
+    uint64_t window_latency_;
+    std::size_t window_acks_;
     bool deleted_;
     // Queue for handling OVS messages. Message processing accesses many of the
     // OPER-DB and KSync structures. So, this queue will run in context KSync
@@ -202,6 +285,9 @@ private:
     // request, reset to NULL once response if feed to idl for processing
     // as it free the json for monitor request id
     struct json *monitor_request_id_;
+    // monitor response is processed, waiting for rest of the row batches
+    // split from it, before connecting to oper db
+    bool monitor_response_pending_;
 
     // transaction stats per IDL
     TxnStats stats_;
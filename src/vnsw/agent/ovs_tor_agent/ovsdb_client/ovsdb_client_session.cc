@@ -147,12 +147,20 @@ void OvsdbClientSession::AddSessionInfo(SandeshOvsdbClientSession &session) {
         sandesh_stats.set_txn_pending(client_idl_->pending_txn_count());
         sandesh_stats.set_pending_send_msg(
                 client_idl_->pending_send_msg_count());
+        sandesh_stats.set_bulk_txn_sent(stats.bulk_txn_sent);
+        sandesh_stats.set_bulk_txn_entries(stats.bulk_txn_entries);
+        sandesh_stats.set_in_flight_window(client_idl_->in_flight_window());
+        sandesh_stats.set_txn_latency_usec(stats.txn_latency_usec);
     } else {
         sandesh_stats.set_txn_initiated(0);
         sandesh_stats.set_txn_succeeded(0);
         sandesh_stats.set_txn_failed(0);
         sandesh_stats.set_txn_pending(0);
         sandesh_stats.set_pending_send_msg(0);
+        sandesh_stats.set_bulk_txn_sent(0);
+        sandesh_stats.set_bulk_txn_entries(0);
+        sandesh_stats.set_in_flight_window(0);
+        sandesh_stats.set_txn_latency_usec(0);
     }
     session.set_connection_time(connection_time_);
     session.set_txn_stats(sandesh_stats);
@@ -78,19 +78,19 @@ bool OvsdbDBEntry::Add() {
     }
 
     struct ovsdb_idl_txn *txn =
-        object->client_idl_->CreateTxn(this, KSyncEntry::ADD_ACK);
+        object->client_idl_->CreateBulkTxn(this, object,
+                                           KSyncEntry::ADD_ACK);
     if (txn == NULL) {
         // failed to create transaction because of idl marked for
         // deletion return from here.
         return true;
     }
     AddMsg(txn);
-    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
-    if (msg == NULL) {
-        object->client_idl()->DeleteTxn(txn);
+    if (!object->client_idl_->EncodeSendTxn(txn, this)) {
+        // nothing to send for the transaction, return true
+        // to complete KSync state
         return true;
     }
-    object->client_idl_->TxnScheduleJsonRpc(msg);
     return false;
 }
 
@@ -111,19 +111,19 @@ bool OvsdbDBEntry::Change() {
     }
 
     struct ovsdb_idl_txn *txn =
-        object->client_idl_->CreateTxn(this, KSyncEntry::CHANGE_ACK);
+        object->client_idl_->CreateBulkTxn(this, object,
+                                           KSyncEntry::CHANGE_ACK);
     if (txn == NULL) {
         // failed to create transaction because of idl marked for
         // deletion return from here.
         return true;
     }
     ChangeMsg(txn);
-    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
-    if (msg == NULL) {
-        object->client_idl()->DeleteTxn(txn);
+    if (!object->client_idl_->EncodeSendTxn(txn, this)) {
+        // nothing to send for the transaction, return true
+        // to complete KSync state
         return true;
     }
-    object->client_idl_->TxnScheduleJsonRpc(msg);
     return false;
 }
 
@@ -139,21 +139,19 @@ bool OvsdbDBEntry::Delete() {
 
     OvsdbDBObject *object = static_cast<OvsdbDBObject*>(GetObject());
     struct ovsdb_idl_txn *txn =
-        object->client_idl_->CreateTxn(this, KSyncEntry::DEL_ACK);
+        object->client_idl_->CreateBulkTxn(this, object,
+                                           KSyncEntry::DEL_ACK);
     if (txn == NULL) {
         // failed to create transaction because of idl marked for
         // deletion return from here.
         return true;
     }
     DeleteMsg(txn);
-    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
-    if (msg == NULL) {
-        object->client_idl()->DeleteTxn(txn);
+    if (!object->client_idl_->EncodeSendTxn(txn, this)) {
         // current transaction deleted trigger post delete
         PostDelete();
         return true;
     }
-    object->client_idl_->TxnScheduleJsonRpc(msg);
     // current transaction send completed trigger post delete
     PostDelete();
     return false;
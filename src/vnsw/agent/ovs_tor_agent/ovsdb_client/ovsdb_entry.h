@@ -19,11 +19,16 @@ class OvsdbClientIdl;
 
 class OvsdbEntryBase {
 public:
+    OvsdbEntryBase() : bulk_txn_retry_(false) {}
     virtual void Ack(bool success) = 0;
+    // set while entry waits to retry a failed bulk transaction with a
+    // transaction of its own
+    bool bulk_txn_retry() const { return bulk_txn_retry_; }
 
 protected:
     friend class OvsdbClientIdl;
     KSyncEntry::KSyncEvent ack_event_;
+    bool bulk_txn_retry_;
 };
 
 class OvsdbEntry : public KSyncEntry, public OvsdbEntryBase {
@@ -130,6 +130,101 @@ ovsdb_wrapper_idl_msg_process(struct ovsdb_idl *idl, struct jsonrpc_msg *msg)
     ovsdb_idl_msg_process(idl, msg);
 }
 
+/* Tables no other table refers to, rows of these can be moved to a
+ * separate update without leaving references to rows not yet known. */
+static const char *split_update_tables[] = {
+    "Ucast_Macs_Local",
+    "Ucast_Macs_Remote",
+    "Mcast_Macs_Local",
+    "Mcast_Macs_Remote",
+    NULL
+};
+
+/* table-updates carried by monitor reply or update notification */
+static struct json *
+msg_table_updates(struct jsonrpc_msg *msg)
+{
+    if (msg->type == JSONRPC_REPLY) {
+        if (msg->result != NULL && msg->result->type == JSON_OBJECT) {
+            return msg->result;
+        }
+    } else if (msg->type == JSONRPC_NOTIFY && !strcmp(msg->method, "update")
+               && msg->params->type == JSON_ARRAY
+               && msg->params->u.array.n == 2
+               && msg->params->u.array.elems[0]->type == JSON_NULL
+               && msg->params->u.array.elems[1]->type == JSON_OBJECT) {
+        return msg->params->u.array.elems[1];
+    }
+    return NULL;
+}
+
+size_t
+ovsdb_wrapper_idl_msg_update_row_count(struct jsonrpc_msg *msg)
+{
+    struct json *updates = msg_table_updates(msg);
+    struct shash_node *node;
+    size_t count = 0;
+
+    if (updates == NULL) {
+        return 0;
+    }
+    SHASH_FOR_EACH (node, json_object(updates)) {
+        struct json *table = node->data;
+        if (table->type == JSON_OBJECT) {
+            count += shash_count(json_object(table));
+        }
+    }
+    return count;
+}
+
+/* Moves up to max_rows rows of the mac tables out of the table-updates
+ * carried by msg, till msg is left with max_rows rows. The rows moved
+ * are returned as an update notification, with the null monitor id used
+ * by the idl, to be processed after msg. */
+struct jsonrpc_msg *
+ovsdb_wrapper_idl_msg_split_update(struct jsonrpc_msg *msg, size_t max_rows)
+{
+    struct json *updates = msg_table_updates(msg);
+    struct json *batch;
+    size_t moved = 0;
+    int i;
+
+    if (updates == NULL ||
+        ovsdb_wrapper_idl_msg_update_row_count(msg) <= max_rows) {
+        return NULL;
+    }
+
+    batch = json_object_create();
+    for (i = 0; split_update_tables[i] != NULL && moved < max_rows; i++) {
+        struct json *table = shash_find_data(json_object(updates),
+                                             split_update_tables[i]);
+        struct json *batch_table;
+        struct shash_node *node, *next;
+
+        if (table == NULL || table->type != JSON_OBJECT ||
+            shash_is_empty(json_object(table))) {
+            continue;
+        }
+        batch_table = json_object_create();
+        SHASH_FOR_EACH_SAFE (node, next, json_object(table)) {
+            if (moved == max_rows) {
+                break;
+            }
+            json_object_put(batch_table, node->name, node->data);
+            shash_delete(json_object(table), node);
+            moved++;
+        }
+        json_object_put(batch, split_update_tables[i], batch_table);
+    }
+
+    if (moved == 0) {
+        json_destroy(batch);
+        return NULL;
+    }
+    return jsonrpc_create_notify("update",
+            json_array_create_2(json_null_create(), batch));
+}
+
 struct json *
 ovsdb_wrapper_jsonrpc_msg_to_json(struct jsonrpc_msg *msg)
 {
@@ -466,7 +561,7 @@ ovsdb_wrapper_delete_ucast_mac_local(struct ovsdb_idl_row *row)
 }
 
 /* unicast mac remote */
-void
+struct ovsdb_idl_row *
 ovsdb_wrapper_add_ucast_mac_remote(struct ovsdb_idl_txn *txn,
         struct ovsdb_idl_row *row, const char *mac, struct ovsdb_idl_row *ls,
         struct ovsdb_idl_row *pl, const char *dest_ip)
@@ -487,6 +582,7 @@ ovsdb_wrapper_add_ucast_mac_remote(struct ovsdb_idl_txn *txn,
         vteprec_physical_locator_set_encapsulation_type(p, "vxlan_over_ipv4");
     }
     vteprec_ucast_macs_remote_set_locator(ucast, p);
+    return &p->header_;
 }
 
 void
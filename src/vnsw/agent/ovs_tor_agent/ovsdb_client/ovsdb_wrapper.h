@@ -34,6 +34,9 @@ void ovsdb_wrapper_idl_set_callback(struct ovsdb_idl *idl, void *idl_base,
 struct jsonrpc_msg *ovsdb_wrapper_idl_encode_monitor_request(struct ovsdb_idl *);
 bool ovsdb_wrapper_idl_msg_is_monitor_response(struct json *, struct jsonrpc_msg *);
 void ovsdb_wrapper_idl_msg_process(struct ovsdb_idl *, struct jsonrpc_msg *msg);
+size_t ovsdb_wrapper_idl_msg_update_row_count(struct jsonrpc_msg *msg);
+struct jsonrpc_msg *ovsdb_wrapper_idl_msg_split_update(struct jsonrpc_msg *msg,
+                                                       size_t max_rows);
 struct json *ovsdb_wrapper_jsonrpc_msg_to_json(struct jsonrpc_msg *);
 char *ovsdb_wrapper_json_to_string(const struct json *, int);
 void ovsdb_wrapper_json_destroy(struct json *);
@@ -89,8 +92,9 @@ char *ovsdb_wrapper_ucast_mac_local_logical_switch(struct ovsdb_idl_row *row);
 char *ovsdb_wrapper_ucast_mac_local_dst_ip(struct ovsdb_idl_row *row);
 void ovsdb_wrapper_delete_ucast_mac_local(struct ovsdb_idl_row *row);
 
-/* unicast mac remote */
-void ovsdb_wrapper_add_ucast_mac_remote(struct ovsdb_idl_txn *txn,
+/* unicast mac remote, returns the physical locator row used */
+struct ovsdb_idl_row *ovsdb_wrapper_add_ucast_mac_remote(
+        struct ovsdb_idl_txn *txn,
         struct ovsdb_idl_row *row, const char *mac, struct ovsdb_idl_row *ls,
         struct ovsdb_idl_row *pl, const char *dest_ip);
 void ovsdb_wrapper_delete_ucast_mac_remote(struct ovsdb_idl_row *row);
@@ -129,14 +129,11 @@ bool PhysicalPortEntry::OverrideOvs() {
         return true;
     }
     Encode(txn);
-    struct jsonrpc_msg *msg = ovsdb_wrapper_idl_txn_encode(txn);
-    if (msg == NULL) {
-        table_->client_idl()->DeleteTxn(txn);
+    if (!table_->client_idl()->EncodeSendTxn(txn, this)) {
         return true;
     }
     OVSDB_TRACE(Trace, "Sending Vlan Port Binding update for Physical route " +
                        dev_name_ + " Physical Port " + name_);
-    table_->client_idl()->TxnScheduleJsonRpc(msg);
     return false;
 }
 
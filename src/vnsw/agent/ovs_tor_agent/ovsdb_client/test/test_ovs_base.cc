@@ -41,6 +41,10 @@
 #include "controller/controller_export.h"
 #include "controller/controller_vrf_export.h"
 
+extern "C" {
+#include <ovsdb_wrapper.h>
+};
+
 #include "ovs_tor_agent/ovsdb_client/ovsdb_route_peer.h"
 #include "ovs_tor_agent/ovsdb_client/physical_switch_ovsdb.h"
 #include "ovs_tor_agent/ovsdb_client/logical_switch_ovsdb.h"
@@ -173,6 +177,62 @@ TEST_F(OvsBaseTest, VlanPortBindingAuditRead) {
     req->Release();
 }
 
+static struct jsonrpc_msg *ParseJsonRpc(const std::string &str) {
+    struct json_parser *parser = ovsdb_wrapper_json_parser_create(0);
+    ovsdb_wrapper_json_parser_feed(parser, str.c_str(), str.size());
+    struct json *json = ovsdb_wrapper_json_parser_finish(parser);
+    struct jsonrpc_msg *msg = NULL;
+    char *error = ovsdb_wrapper_jsonrpc_msg_from_json(json, &msg);
+    EXPECT_TRUE(error == NULL);
+    free(error);
+    return msg;
+}
+
+// Monitor response with more rows than a batch gets the MAC rows split
+// into update batches, leaving the other tables in the response
+TEST_F(OvsBaseTest, SplitMonitorResponse) {
+    std::string str = "{\"id\":0,\"error\":null,\"result\":{"
+        "\"Logical_Switch\":{\"00000000-0000-0000-0000-000000000001\":"
+        "{\"new\":{\"name\":\"ls1\",\"tunnel_key\":100}}},"
+        "\"Ucast_Macs_Local\":{";
+    const int kMacCount = 2500;
+    for (int i = 0; i < kMacCount; i++) {
+        char row[128];
+        snprintf(row, sizeof(row), "%s\"00000000-0000-0000-0001-%012d\":"
+                 "{\"new\":{\"MAC\":\"00:00:00:00:%02x:%02x\"}}",
+                 i ? "," : "", i, i >> 8, i & 0xFF);
+        str += row;
+    }
+    str += "}}}";
+    struct jsonrpc_msg *msg = ParseJsonRpc(str);
+    ASSERT_TRUE(msg != NULL);
+    EXPECT_EQ(kMacCount + 1U, ovsdb_wrapper_idl_msg_update_row_count(msg));
+
+    const std::size_t batch_rows = OvsdbClientIdl::OVSDBRowsPerUpdateBatch;
+    std::vector<struct jsonrpc_msg *> batches;
+    struct jsonrpc_msg *batch;
+    while ((batch = ovsdb_wrapper_idl_msg_split_update(msg,
+                                                       batch_rows)) != NULL) {
+        batches.push_back(batch);
+    }
+    ASSERT_EQ(2U, batches.size());
+    EXPECT_EQ(batch_rows, ovsdb_wrapper_idl_msg_update_row_count(batches[0]));
+    EXPECT_EQ(batch_rows, ovsdb_wrapper_idl_msg_update_row_count(batches[1]));
+    // logical switch is left in the response along with remaining MACs
+    EXPECT_EQ(kMacCount + 1 - 2 * batch_rows,
+              ovsdb_wrapper_idl_msg_update_row_count(msg));
+    ovsdb_wrapper_jsonrpc_msg_destroy(msg);
+    for (std::size_t i = 0; i < batches.size(); i++) {
+        ovsdb_wrapper_jsonrpc_msg_destroy(batches[i]);
+    }
+
+    // transaction reply is never split
+    msg = ParseJsonRpc("{\"id\":1,\"error\":null,\"result\":[{}]}");
+    ASSERT_TRUE(msg != NULL);
+    EXPECT_TRUE(ovsdb_wrapper_idl_msg_split_update(msg, 0) == NULL);
+    ovsdb_wrapper_jsonrpc_msg_destroy(msg);
+}
+
 TEST_F(OvsBaseTest, connection_close) {
     // Take reference to idl so that session object itself is not deleted.
     OvsdbClientIdlPtr tcp_idl = tcp_session_->client_idl();
@@ -6,6 +6,8 @@
 #include "testing/gunit.h"
 
 #include <base/logging.h>
+#include <base/string_util.h>
+#include <base/time_util.h>
 #include <io/event_manager.h>
 #include <io/test/event_manager_test.h>
 #include <tbb/task.h>
@@ -304,6 +306,257 @@ TEST_F(UnicastRemoteTest, LogicalSwitchDeleteOnRefRelease) {
     WAIT_FOR(100, 10000, (l_table->Find(&l_key) == NULL));
 }
 
+// number of remote macs found programmed in OVSDB, out of count macs
+// added by MacProgrammingBulkTxn
+static int ProgrammedMacCount(UnicastMacRemoteTable *u_table, int count) {
+    int programmed = 0;
+    for (int i = 0; i < count; i++) {
+        MacAddress mac(0, 0, 0, 2, i >> 8, i & 0xFF);
+        UnicastMacRemoteEntry key(u_table, mac.ToString());
+        UnicastMacRemoteEntry *entry =
+            static_cast<UnicastMacRemoteEntry *>(u_table->Find(&key));
+        if (entry != NULL && entry->GetState() == KSyncEntry::IN_SYNC &&
+            entry->ovs_entry() != NULL) {
+            programmed++;
+        }
+    }
+    return programmed;
+}
+
+// Programs remote macs, spread over a few tunnel destinations, to the
+// ovsdb-server run by the test and waits for all of them to be in sync,
+// the macs are expected to go in bulk transactions
+TEST_F(UnicastRemoteTest, MacProgrammingBulkTxn) {
+    const int kMacCount = 2000;
+    // Add VN
+    VnAddReq(2, "test-vn1");
+    // Add VRF
+    agent_->vrf_table()->CreateVrfReq("test-vrf1", MakeUuid(2));
+    // Add Physical Device
+    AddPhysicalDevice("test-router", 1);
+    client->WaitForIdle();
+
+    // Add DevVN
+    AddPhysicalDeviceVn(agent_, 1, 2, true);
+    client->WaitForIdle();
+
+    VrfOvsdbObject *table = tcp_session_->client_idl()->vrf_ovsdb();
+    VrfOvsdbEntry vrf_key(table, UuidToString(MakeUuid(2)));
+    VrfOvsdbEntry *vrf_entry;
+    WAIT_FOR(100, 10000,
+             (vrf_entry =
+              static_cast<VrfOvsdbEntry *>(table->Find(&vrf_key))) != NULL);
+    ASSERT_TRUE(vrf_entry != NULL);
+    UnicastMacRemoteTable *u_table = vrf_entry->route_table();
+    OvsdbClientIdl *idl = tcp_session_->client_idl();
+    OvsdbClientIdl::TxnStats start_stats = idl->stats();
+
+    uint64_t start = ClockMonotonicUsec();
+    for (int i = 0; i < kMacCount; i++) {
+        MacAddress mac(0, 0, 0, 2, i >> 8, i & 0xFF);
+        BridgeTunnelRouteAdd(agent_->local_peer(), std::string("test-vrf1"),
+                             (1 << TunnelType::VXLAN),
+                             "10.0.1." + integerToString(i % 8 + 1),
+                             101, mac, "0.0.0.0", 32);
+    }
+    WAIT_FOR(3000, 10000,
+             (ProgrammedMacCount(u_table, kMacCount) == kMacCount));
+    EXPECT_EQ(kMacCount, ProgrammedMacCount(u_table, kMacCount));
+    uint64_t elapsed = ClockMonotonicUsec() - start;
+    const OvsdbClientIdl::TxnStats &stats = idl->stats();
+    uint64_t txns = stats.txn_initiated - start_stats.txn_initiated;
+    uint64_t bulk_txns = stats.bulk_txn_sent - start_stats.bulk_txn_sent;
+    uint64_t mac_count = kMacCount;
+    EXPECT_LT(0U, bulk_txns);
+    EXPECT_GT(mac_count, txns);
+    std::cout << "Programmed " << kMacCount << " remote macs in " <<
+        elapsed << " usec, " << txns << " txns, " << bulk_txns <<
+        " bulk txns, in flight window " << idl->in_flight_window() <<
+        std::endl;
+
+    // Delete routes
+    Ip4Address zero_ip;
+    for (int i = 0; i < kMacCount; i++) {
+        MacAddress mac(0, 0, 0, 2, i >> 8, i & 0xFF);
+        EvpnAgentRouteTable::DeleteReq(agent_->local_peer(),
+                                       std::string("test-vrf1"),
+                                       mac, zero_ip, 0);
+    }
+    client->WaitForIdle();
+    WAIT_FOR(3000, 10000, (ProgrammedMacCount(u_table, kMacCount) == 0));
+
+    // Delete DevVN
+    DelPhysicalDeviceVn(agent_, 1, 2, false);
+    client->WaitForIdle();
+
+    DeletePhysicalDevice("test-router");
+    client->WaitForIdle();
+
+    agent_->vrf_table()->DeleteVrfReq("test-vrf1");
+    VnDelReq(2);
+    client->WaitForIdle();
+
+    // Validate Logical switch deleted
+    LogicalSwitchTable *l_table = idl->logical_switch_table();
+    LogicalSwitchEntry l_key(table, UuidToString(MakeUuid(2)));
+    WAIT_FOR(100, 10000, (l_table->Find(&l_key) == NULL));
+}
+
+// Entry of a failed bulk transaction sends its next update in a transaction
+// of its own, the update after that joins a bulk transaction again
+TEST_F(UnicastRemoteTest, BulkTxnFailureRetry) {
+    // Add VN
+    VnAddReq(2, "test-vn1");
+    // Add VRF
+    agent_->vrf_table()->CreateVrfReq("test-vrf1", MakeUuid(2));
+    // Add Physical Device
+    AddPhysicalDevice("test-router", 1);
+    client->WaitForIdle();
+
+    // Add DevVN
+    AddPhysicalDeviceVn(agent_, 1, 2, true);
+    client->WaitForIdle();
+
+    // macs on two tunnel destinations, so that the locators exist
+    MacAddress mac1("00:00:00:01:00:01");
+    MacAddress mac2("00:00:00:01:00:02");
+    BridgeTunnelRouteAdd(agent_->local_peer(), std::string("test-vrf1"),
+                         (1 << TunnelType::VXLAN), "10.0.0.1",
+                         101, mac1, "0.0.0.0", 32);
+    BridgeTunnelRouteAdd(agent_->local_peer(), std::string("test-vrf1"),
+                         (1 << TunnelType::VXLAN), "10.0.0.2",
+                         101, mac2, "0.0.0.0", 32);
+    client->WaitForIdle();
+
+    VrfOvsdbObject *table = tcp_session_->client_idl()->vrf_ovsdb();
+    VrfOvsdbEntry vrf_key(table, UuidToString(MakeUuid(2)));
+    VrfOvsdbEntry *vrf_entry;
+    WAIT_FOR(100, 10000,
+             (vrf_entry =
+              static_cast<VrfOvsdbEntry *>(table->Find(&vrf_key))) != NULL);
+    ASSERT_TRUE(vrf_entry != NULL);
+    UnicastMacRemoteTable *u_table = vrf_entry->route_table();
+    UnicastMacRemoteEntry key(u_table, "00:00:00:01:00:01");
+    UnicastMacRemoteEntry *entry;
+    WAIT_FOR(100, 10000,
+             ((entry =
+              static_cast<UnicastMacRemoteEntry *>(u_table->Find(&key))) != NULL
+              && entry->GetState() == KSyncEntry::IN_SYNC));
+    ASSERT_TRUE(entry != NULL);
+    // take reference of ucast mac to hold the entry
+    KSyncEntry::KSyncEntryPtr ucast_mac = entry;
+    client->WaitForIdle();
+
+    // mark the entry as done by ack of a failed bulk transaction
+    OvsdbClientIdl *idl = tcp_session_->client_idl();
+    OvsdbClientIdl::OvsdbEntryList entries;
+    entries.push_back(entry);
+    idl->RetryBulkTxnEntries(entries);
+    EXPECT_TRUE(entry->bulk_txn_retry());
+
+    OvsdbClientIdl::TxnStats start_stats = idl->stats();
+    BridgeTunnelRouteAdd(agent_->local_peer(), std::string("test-vrf1"),
+                         (1 << TunnelType::VXLAN), "10.0.0.2",
+                         101, mac1, "0.0.0.0", 32);
+    client->WaitForIdle();
+    WAIT_FOR(100, 10000, (entry->GetState() == KSyncEntry::IN_SYNC));
+    EXPECT_FALSE(entry->bulk_txn_retry());
+    EXPECT_EQ(start_stats.bulk_txn_sent, idl->stats().bulk_txn_sent);
+    EXPECT_LT(start_stats.txn_initiated, idl->stats().txn_initiated);
+    EXPECT_TRUE(entry->ovs_entry() != NULL &&
+                string("10.0.0.2") ==
+                string(ovsdb_wrapper_ucast_mac_remote_dst_ip(
+                        entry->ovs_entry())));
+
+    start_stats = idl->stats();
+    BridgeTunnelRouteAdd(agent_->local_peer(), std::string("test-vrf1"),
+                         (1 << TunnelType::VXLAN), "10.0.0.1",
+                         101, mac1, "0.0.0.0", 32);
+    client->WaitForIdle();
+    WAIT_FOR(100, 10000, (entry->GetState() == KSyncEntry::IN_SYNC));
+    EXPECT_LT(start_stats.bulk_txn_sent, idl->stats().bulk_txn_sent);
+
+    // release reference of ucast mac
+    ucast_mac = NULL;
+    // Delete routes
+    Ip4Address zero_ip;
+    EvpnAgentRouteTable::DeleteReq(agent_->local_peer(),
+                                   std::string("test-vrf1"),
+                                   mac1, zero_ip, 0);
+    EvpnAgentRouteTable::DeleteReq(agent_->local_peer(),
+                                   std::string("test-vrf1"),
+                                   mac2, zero_ip, 0);
+    client->WaitForIdle();
+
+    // Delete DevVN
+    DelPhysicalDeviceVn(agent_, 1, 2, false);
+    client->WaitForIdle();
+
+    DeletePhysicalDevice("test-router");
+    client->WaitForIdle();
+
+    agent_->vrf_table()->DeleteVrfReq("test-vrf1");
+    VnDelReq(2);
+    client->WaitForIdle();
+
+    // Validate Logical switch deleted
+    LogicalSwitchTable *l_table = idl->logical_switch_table();
+    LogicalSwitchEntry l_key(table, UuidToString(MakeUuid(2)));
+    WAIT_FOR(100, 10000, (l_table->Find(&l_key) == NULL));
+}
+
+// Feeds ack latencies to the in flight window, with KSync task held so
+// that acks from the server do not interfere
+TEST_F(UnicastRemoteTest, InFlightWindow) {
+    const uint64_t kLowLatency = 1;
+    const uint64_t kHighLatency = 1000000;
+    size_t min_window = OvsdbClientIdl::OVSDBMinInFlightPendingTxn;
+    size_t max_window = OvsdbClientIdl::OVSDBMaxInFlightPendingTxn;
+    OvsdbClientIdl *idl = tcp_session_->client_idl();
+    client->WaitForIdle();
+    TestTaskHold *hold =
+        new TestTaskHold(TaskScheduler::GetInstance()->GetTaskId("Agent::KSync"), 0);
+
+    // complete the window in progress with low latency acks
+    size_t window = idl->in_flight_window();
+    for (size_t i = 0; i < window; i++) {
+        idl->UpdateInFlightWindow(kLowLatency);
+    }
+
+    // a window of low latency acks grows the window by half
+    window = idl->in_flight_window();
+    for (size_t i = 0; i <= max_window &&
+         idl->in_flight_window() == window; i++) {
+        idl->UpdateInFlightWindow(kLowLatency);
+    }
+    EXPECT_EQ(std::min(window + window / 2, max_window),
+              idl->in_flight_window());
+
+    // a window of high latency acks halves the window
+    window = idl->in_flight_window();
+    for (size_t i = 0; i <= max_window &&
+         idl->in_flight_window() == window; i++) {
+        idl->UpdateInFlightWindow(kHighLatency);
+    }
+    EXPECT_EQ(std::max(window / 2, min_window), idl->in_flight_window());
+    EXPECT_LT(kHighLatency / max_window, idl->stats().txn_latency_usec);
+
+    // window does not shrink below the minimum
+    for (size_t i = 0; i < 10 * max_window; i++) {
+        idl->UpdateInFlightWindow(kHighLatency);
+    }
+    EXPECT_EQ(min_window, idl->in_flight_window());
+
+    // window does not grow above the maximum
+    for (size_t i = 0; i < 10 * max_window; i++) {
+        idl->UpdateInFlightWindow(kLowLatency);
+    }
+    EXPECT_EQ(max_window, idl->in_flight_window());
+
+    delete hold;
+    client->WaitForIdle();
+}
+
 TEST_F(UnicastRemoteTest, VrfNotifyWithIdlDeleted) {
     Agent *agent = Agent::GetInstance();
     TestTaskHold *hold =
@@ -125,10 +125,19 @@ void UnicastMacRemoteEntry::AddMsg(struct ovsdb_idl_txn *txn) {
         struct ovsdb_idl_row *pl_row = NULL;
         if (pl_entry)
             pl_row = pl_entry->ovs_entry();
+        OvsdbClientIdl *idl = table_->client_idl();
+        if (pl_row == NULL) {
+            // share the locator inserted by other entries of bulk txn
+            pl_row = idl->bulk_txn_locator(txn, dest_ip_);
+        }
         LogicalSwitchEntry *logical_switch =
             static_cast<LogicalSwitchEntry *>(logical_switch_.get());
-        ovsdb_wrapper_add_ucast_mac_remote(txn, ovs_entry_, mac_.c_str(),
+        struct ovsdb_idl_row *locator =
+            ovsdb_wrapper_add_ucast_mac_remote(txn, ovs_entry_, mac_.c_str(),
                 logical_switch->ovs_entry(), pl_row, dest_ip_.c_str());
+        if (pl_row == NULL) {
+            idl->set_bulk_txn_locator(txn, dest_ip_, locator);
+        }
         SendTrace(UnicastMacRemoteEntry::ADD_REQ);
     }
 }
@@ -65,6 +65,17 @@ void AgentStatsReq::HandleRequest() const {
     flow->set_more(true);
     flow->Response();
 
+    FlowTable *flow_table = agent->pkt()->flow_table();
+    FlowRevaluateStatsResp *revaluate = new FlowRevaluateStatsResp();
+    revaluate->set_queue_length(flow_table->revaluate_queue_length());
+    revaluate->set_enqueues(flow_table->revaluate_enqueues());
+    revaluate->set_revaluated(flow_table->revaluate_count());
+    revaluate->set_avg_latency_usec(flow_table->revaluate_avg_latency_usec());
+    revaluate->set_max_latency_usec(flow_table->revaluate_max_latency_usec());
+    revaluate->set_context(context());
+    revaluate->set_more(true);
+    revaluate->Response();
+
     XmppStatsResp *xmpp_resp = new XmppStatsResp();
     vector<XmppStatsInfo> list;
     for (int count = 0; count < MAX_XMPP_SERVERS; count++) {
@@ -4,6 +4,7 @@
 
 #include <vector>
 #include <bitset>
+#include <memory>
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/assign/list_of.hpp>
@@ -20,6 +21,7 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include "base/os.h"
+#include "base/time_util.h"
 
 #include "route/route.h"
 #include "cmn/agent_cmn.h"
@@ -1041,6 +1043,15 @@ bool FlowEntry::set_pending_recompute(bool value) {
     return false;
 }
 
+bool FlowEntry::set_pending_revaluate(bool value) {
+    if (data_.pending_revaluate != value) {
+        data_.pending_revaluate = value;
+        return true;
+    }
+
+    return false;
+}
+
 void FlowEntry::set_flow_handle(uint32_t flow_handle, FlowTable* table) {
     /* trigger update KSync on flow handle change */
     if (flow_handle_ != flow_handle) {
@@ -1738,6 +1749,11 @@ void FlowTable::Init() {
 
     nh_listener_ = new NhListener();
 
+    revaluate_queue_ = new FlowRevaluateQueue
+        (TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0,
+         boost::bind(&FlowTable::FlowRevaluate, this, _1),
+         FlowRevaluateQueue::kMaxSize, kFlowRevaluateIterations);
+
     agent_->acl_table()->set_ace_flow_sandesh_data_cb
         (boost::bind(&FlowTable::SetAceSandeshData, this, _1, _2, _3));
 
@@ -2142,7 +2158,10 @@ void InetRouteFlowUpdate::RouteAdd(AgentRoute *entry) {
                              route->plen() - 1);
         RouteFlowInfo *rt_info =
             agent->pkt()->flow_table()->FindRouteFlowInfo(&rt_key);
-        agent->pkt()->flow_table()->FlowRecompute(rt_info);
+        // Only flows captured by the new route need to move to it
+        RouteFlowKey capture_key(route->vrf()->vrf_id(), route->addr(),
+                                 route->plen());
+        agent->pkt()->flow_table()->FlowRecompute(rt_info, &capture_key);
     }
 }
 
@@ -2421,28 +2440,10 @@ void FlowTable::ResyncVnFlows(const VnEntry *vn) {
         return;
     }
 
-    FlowEntryTree fet = vn_it->second->fet;
-    FlowEntryTree::iterator fet_it, it;
-    it = fet.begin();
-    while (it != fet.end()) {
-        fet_it = it++;
-        FlowEntry *fe = (*fet_it).get();
-        DeleteFlowInfo(fe);
-        //Mark the flow as short if flood unknown
-        //unicast flag is reset
-        if (vn->flood_unknown_unicast() == false &&
-            fe->is_flags_set(FlowEntry::UnknownUnicastFlood)) {
-            fe->MakeShortFlow(FlowEntry::SHORT_NO_DST_ROUTE);
-            fe->GetPolicyInfo(vn);
-            ResyncAFlow(fe);
-            continue;
-        }
-        fe->GetPolicyInfo(vn);
-        ResyncAFlow(fe);
-        AddFlowInfo(fe);
-        FlowInfo flow_info;
-        fe->FillFlowInfo(flow_info);
-        FLOW_TRACE(Trace, "Evaluate Vn Flows", flow_info);
+    const FlowEntryTree &fet = vn_it->second->fet;
+    FlowEntryTree::const_iterator it;
+    for (it = fet.begin(); it != fet.end(); ++it) {
+        EnqueueFlowRevaluate((*it).get(), true);
     }
 }
 
@@ -2454,20 +2455,79 @@ void FlowTable::ResyncAclFlows(const AclDBEntry *acl)
         return;
     }
 
-    FlowEntryTree fet = acl_it->second->fet;
-    FlowEntryTree::iterator fet_it, it;
-    it = fet.begin();
-    while (it != fet.end()) {
-        fet_it = it++;
-        FlowEntry *fe = (*fet_it).get();
-        DeleteFlowInfo(fe);
+    const FlowEntryTree &fet = acl_it->second->fet;
+    FlowEntryTree::const_iterator it;
+    for (it = fet.begin(); it != fet.end(); ++it) {
+        EnqueueFlowRevaluate((*it).get(), false);
+    }
+}
+
+// Flows already waiting in the queue are not enqueued again. A VN change is
+// remembered on the flow even if it is already queued for an ACL change
+void FlowTable::EnqueueFlowRevaluate(FlowEntry *fe, bool vn_change) {
+    if (vn_change) {
+        fe->data_.pending_vn_revaluate = true;
+    }
+    if (fe->set_pending_revaluate(true) == false) {
+        return;
+    }
+    revaluate_enqueues_++;
+    revaluate_queue_->Enqueue(new FlowRevaluateEntry(fe,
+                                                     ClockMonotonicUsec()));
+}
+
+// Runs in the DB task. WorkQueue yields after kFlowRevaluateIterations flows
+// so that a large ACL or VN change does not hold up other DB notifications
+bool FlowTable::FlowRevaluate(FlowRevaluateEntry *entry) {
+    std::auto_ptr<FlowRevaluateEntry> entry_ptr(entry);
+    FlowEntry *fe = entry->fe_ptr.get();
+    bool vn_change = fe->data_.pending_vn_revaluate;
+    fe->data_.pending_vn_revaluate = false;
+    fe->set_pending_revaluate(false);
+
+    uint64_t latency = ClockMonotonicUsec() - entry->enqueue_time;
+    revaluate_count_++;
+    revaluate_latency_total_ += latency;
+    if (latency > revaluate_max_latency_) {
+        revaluate_max_latency_ = latency;
+    }
+
+    if (fe->deleted()) {
+        return true;
+    }
+
+    DeleteFlowInfo(fe);
+    //Mark the flow as short if flood unknown
+    //unicast flag is reset on the VN
+    const VnEntry *vn = fe->data().vn_entry.get();
+    if (vn_change && vn && vn->flood_unknown_unicast() == false &&
+        fe->is_flags_set(FlowEntry::UnknownUnicastFlood)) {
+        fe->MakeShortFlow(FlowEntry::SHORT_NO_DST_ROUTE);
         fe->GetPolicyInfo();
         ResyncAFlow(fe);
-        AddFlowInfo(fe);
-        FlowInfo flow_info;
-        fe->FillFlowInfo(flow_info);
-        FLOW_TRACE(Trace, "Evaluate Acl Flows", flow_info);
+        return true;
+    }
+    fe->GetPolicyInfo();
+    ResyncAFlow(fe);
+    AddFlowInfo(fe);
+    FlowInfo flow_info;
+    fe->FillFlowInfo(flow_info);
+    FLOW_TRACE(Trace, "Revaluate Flow", flow_info);
+    return true;
+}
+
+size_t FlowTable::revaluate_queue_length() const {
+    if (revaluate_queue_ == NULL) {
+        return 0;
+    }
+    return revaluate_queue_->Length();
+}
+
+uint64_t FlowTable::revaluate_avg_latency_usec() const {
+    if (revaluate_count_ == 0) {
+        return 0;
     }
+    return revaluate_latency_total_ / revaluate_count_;
 }
 
 void FlowTable::ResyncRpfNH(const RouteFlowKey &key, const AgentRoute *rt) {
@@ -2496,18 +2556,44 @@ void FlowTable::ResyncRpfNH(const RouteFlowKey &key, const AgentRoute *rt) {
     }
 }
 
-void FlowTable::FlowRecompute(RouteFlowInfo *rt_info) {
+// Returns true if source or destination of the flow falls in the prefix
+static bool FlowCapturedByPrefix(const FlowEntry *fe, const RouteFlowKey &key) {
+    if (fe->key().family != key.family) {
+        return false;
+    }
+
+    if (key.family == Address::INET) {
+        return (Address::GetIp4SubnetAddress(fe->key().src_addr.to_v4(),
+                                             key.plen) == key.ip ||
+                Address::GetIp4SubnetAddress(fe->key().dst_addr.to_v4(),
+                                             key.plen) == key.ip);
+    } else if (key.family == Address::INET6) {
+        return (Address::GetIp6SubnetAddress(fe->key().src_addr.to_v6(),
+                                             key.plen) == key.ip ||
+                Address::GetIp6SubnetAddress(fe->key().dst_addr.to_v6(),
+                                             key.plen) == key.ip);
+    }
+    return false;
+}
+
+// Trigger re-compute of flows using the route. If capture_key is set, only
+// the flows captured by the more specific capture_key prefix are re-computed
+void FlowTable::FlowRecompute(RouteFlowInfo *rt_info,
+                              const RouteFlowKey *capture_key) {
     if (rt_info == NULL) {
         return;
     }
-    FlowEntryTree fet = rt_info->fet;
-    FlowEntryTree::iterator it;
+    const FlowEntryTree &fet = rt_info->fet;
+    FlowEntryTree::const_iterator it;
     it = fet.begin();
     for (;it != fet.end(); ++it) {
         FlowEntry *fe = (*it).get();
         if (fe->is_flags_set(FlowEntry::ShortFlow)) {
             continue;
         }
+        if (capture_key && FlowCapturedByPrefix(fe, *capture_key) == false) {
+            continue;
+        }
         if (fe->is_flags_set(FlowEntry::ReverseFlow)) {
             /* for reverse flow trigger a re-eval on its forward flow */
             fe = fe->reverse_flow_entry();
@@ -3449,7 +3535,9 @@ FlowTable::FlowTable(Agent *agent) :
     agent_(agent), flow_entry_map_(), acl_flow_tree_(),
     linklocal_flow_count_(), acl_listener_id_(),
     intf_listener_id_(), vn_listener_id_(), vm_listener_id_(),
-    vrf_listener_id_(), nh_listener_(NULL),
+    vrf_listener_id_(), nh_listener_(NULL), revaluate_queue_(NULL),
+    revaluate_enqueues_(0), revaluate_count_(0), revaluate_latency_total_(0),
+    revaluate_max_latency_(0),
     inet4_route_key_(NULL, Ip4Address(), 32, false),
     inet6_route_key_(NULL, Ip6Address(), 128, false) {
     max_vm_flows_ = (uint32_t)
@@ -3464,6 +3552,10 @@ FlowTable::~FlowTable() {
     agent_->vm_table()->Unregister(vm_listener_id_);
     agent_->vrf_table()->Unregister(vrf_listener_id_);
     delete nh_listener_;
+    if (revaluate_queue_) {
+        revaluate_queue_->Shutdown();
+        delete revaluate_queue_;
+    }
 }
 
 bool FlowTable::SetUnderlayPort(FlowEntry *flow, FlowDataIpv4 &s_flow) {
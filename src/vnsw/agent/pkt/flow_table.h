@@ -23,6 +23,7 @@
 #include <tbb/atomic.h>
 #include <tbb/mutex.h>
 #include <base/util.h>
+#include <base/queue_task.h>
 #include <net/address.h>
 #include <db/db_table_walker.h>
 #include <cmn/agent_cmn.h>
@@ -67,6 +68,16 @@ struct FlowTaskMsg : public InterTaskMsg {
     FlowEntryPtr fe_ptr;
 };
 
+// Flow queued for policy re-evaluation following an ACL or VN change
+struct FlowRevaluateEntry {
+    FlowRevaluateEntry(FlowEntry *fe, uint64_t time) :
+        fe_ptr(fe), enqueue_time(time) {}
+    ~FlowRevaluateEntry() {}
+
+    FlowEntryPtr fe_ptr;
+    uint64_t enqueue_time;
+};
+
 struct FlowKey {
     FlowKey() :
         family(Address::UNSPEC), nh(0), src_addr(Ip4Address(0)),
@@ -220,7 +231,9 @@ struct FlowData {
         mirror_vrf(VrfEntry::kInvalidIndex), dest_vrf(),
         component_nh_idx((uint32_t)CompositeNH::kInvalidComponentNHIdx),
         nh_state_(NULL), source_plen(0), dest_plen(0), drop_reason(0),
-        vrf_assign_evaluated(false), pending_recompute(false), enable_rpf(true),
+        vrf_assign_evaluated(false), pending_recompute(false),
+        pending_revaluate(false), pending_vn_revaluate(false),
+        enable_rpf(true),
         l2_rpf_plen(Address::kMaxV4PrefixLen) {}
 
     MacAddress smac;
@@ -251,6 +264,9 @@ struct FlowData {
     uint16_t drop_reason;
     bool vrf_assign_evaluated;
     bool pending_recompute;
+    bool pending_revaluate;
+    // Set when a VN change is among the triggers of a pending revaluation
+    bool pending_vn_revaluate;
     uint32_t            if_index_info;
     TunnelInfo          tunnel_info;
     // map for references to the routes which were ignored due to more specific
@@ -431,6 +447,7 @@ class FlowEntry {
 
     uint16_t short_flow_reason() const { return short_flow_reason_; }
     bool set_pending_recompute(bool value);
+    bool set_pending_revaluate(bool value);
     const MacAddress &smac() const { return data_.smac; }
     const MacAddress &dmac() const { return data_.dmac; }
 private:
@@ -594,6 +611,9 @@ public:
 
     typedef Patricia::Tree<RouteFlowInfo, &RouteFlowInfo::node, RouteFlowInfo::KeyCmp> RouteFlowTree;
     typedef boost::function<bool(FlowEntry *flow)> FlowEntryCb;
+    typedef WorkQueue<FlowRevaluateEntry *> FlowRevaluateQueue;
+    // Number of flows re-evaluated per run of the revaluation queue
+    static const uint32_t kFlowRevaluateIterations = 64;
 
     struct VnFlowHandlerState : public DBState {
         AclDBEntryConstRef acl_;
@@ -665,6 +685,7 @@ public:
     void DeleteFlow(const AclDBEntry *acl, const FlowKey &key, AclEntryIDList &id_list);
     void ResyncAclFlows(const AclDBEntry *acl);
     void DeleteAll();
+    FlowRevaluateQueue *revaluate_queue() const { return revaluate_queue_; }
 
     void SetAclFlowSandeshData(const AclDBEntry *acl, AclFlowResp &data, 
                                const int last_count);
@@ -689,9 +710,19 @@ public:
     virtual void DispatchFlowMsg(SandeshLevel::type level, FlowDataIpv4 &flow);
     void IterateFlowInfoEntries(const RouteFlowKey &key, FlowEntryCb cb);
     RouteFlowInfo *FindRouteFlowInfo(RouteFlowInfo *key);
-    void FlowRecompute(RouteFlowInfo *rt_info);
+    void FlowRecompute(RouteFlowInfo *rt_info,
+                       const RouteFlowKey *capture_key = NULL);
     void FlowL2Recompute(RouteFlowInfo *rt_info);
 
+    // Flow revaluation queue statistics
+    size_t revaluate_queue_length() const;
+    uint64_t revaluate_enqueues() const { return revaluate_enqueues_; }
+    uint64_t revaluate_count() const { return revaluate_count_; }
+    uint64_t revaluate_avg_latency_usec() const;
+    uint64_t revaluate_max_latency_usec() const {
+        return revaluate_max_latency_;
+    }
+
     // Update flow port bucket information
     void NewFlow(const FlowEntry *flow);
     void DeleteFlow(const FlowEntry *flow);
@@ -719,6 +750,14 @@ private:
     uint32_t max_vm_flows_;     // maximum flow count allowed per vm
     uint32_t linklocal_flow_count_;  // total linklocal flows in the agent
 
+    // ACL and VN changes re-evaluate their flows through this queue instead
+    // of walking all flows synchronously in the notification
+    FlowRevaluateQueue *revaluate_queue_;
+    uint64_t revaluate_enqueues_;
+    uint64_t revaluate_count_;
+    uint64_t revaluate_latency_total_;
+    uint64_t revaluate_max_latency_;
+
     DBTableBase::ListenerId acl_listener_id_;
     DBTableBase::ListenerId intf_listener_id_;
     DBTableBase::ListenerId vn_listener_id_;
@@ -740,6 +779,8 @@ private:
     void DecrVnFlowCounter(VnFlowInfo *vn_flow_info, const FlowEntry *fe);
     void ResyncVnFlows(const VnEntry *vn);
     void ResyncAFlow(FlowEntry *fe);
+    void EnqueueFlowRevaluate(FlowEntry *fe, bool vn_change);
+    bool FlowRevaluate(FlowRevaluateEntry *entry);
     void ResyncVmPortFlows(const VmInterface *intf);
     void ResyncRpfNH(const RouteFlowKey &key, const AgentRoute *rt);
 
@@ -3714,6 +3714,111 @@ TEST_F(FlowTest, AclRuleUpdate) {
     client->WaitForIdle(5);
 }
 
+static void RevaluateQueueExit(tbb::atomic<int> *yield_count, bool done) {
+    if (done == false) {
+        (*yield_count)++;
+    }
+}
+
+// Re-evaluating flows of an ACL more than once while the flows are still
+// queued must not enqueue them again. An ACL change must not make short a
+// flow learnt by flooding unknown unicast, only a VN change does that.
+TEST_F(FlowTest, FlowRevaluate_Dedup) {
+    AddAcl("acl1", 1, "vn5" , "vn5", "pass");
+    client->WaitForIdle();
+    TestFlow flow[] = {
+        {
+            TestFlowPkt(Address::INET, vm2_ip, vm1_ip, IPPROTO_TCP, 30, 40,
+                        "vrf5", flow1->id(), 1),
+            {
+                new VerifyVn("vn5", "vn5")
+            }
+        }
+    };
+    CreateFlow(flow, 1);
+    EXPECT_EQ(2U, agent()->pkt()->flow_table()->Size());
+
+    FlowEntry *fe = const_cast<FlowEntry *>(flow[0].pkt_.FlowFetch());
+    ASSERT_TRUE(fe != NULL);
+    fe->set_flags(FlowEntry::UnknownUnicastFlood);
+
+    FlowTable *table = agent()->pkt()->flow_table();
+    uint64_t enqueues = table->revaluate_enqueues();
+    uint64_t count = table->revaluate_count();
+    AclDBEntry *acl = AclGet(1);
+    ASSERT_TRUE(acl != NULL);
+
+    table->revaluate_queue()->set_disable(true);
+    table->ResyncAclFlows(acl);
+    table->ResyncAclFlows(acl);
+    table->ResyncAclFlows(acl);
+    EXPECT_EQ(enqueues + 2, table->revaluate_enqueues());
+    EXPECT_EQ(2U, table->revaluate_queue_length());
+    EXPECT_TRUE(fe->data().pending_revaluate);
+
+    usleep(1000);
+    table->revaluate_queue()->set_disable(false);
+    client->WaitForIdle();
+    EXPECT_EQ(0U, table->revaluate_queue_length());
+    EXPECT_EQ(count + 2, table->revaluate_count());
+    EXPECT_FALSE(fe->data().pending_revaluate);
+    EXPECT_FALSE(fe->data().pending_vn_revaluate);
+    EXPECT_GE(table->revaluate_max_latency_usec(), 1000U);
+    EXPECT_GE(table->revaluate_max_latency_usec(),
+              table->revaluate_avg_latency_usec());
+    EXPECT_FALSE(fe->is_flags_set(FlowEntry::ShortFlow));
+
+    fe->reset_flags(FlowEntry::UnknownUnicastFlood);
+    FlushFlowTable();
+    DelOperDBAcl(1);
+    client->WaitForIdle();
+}
+
+// Revaluation of more flows than kFlowRevaluateIterations must yield the
+// DB task between runs and still process every flow.
+TEST_F(FlowTest, FlowRevaluate_Yield) {
+    AddAcl("acl1", 1, "vn5" , "vn5", "pass");
+    client->WaitForIdle();
+    const uint32_t flow_count = FlowTable::kFlowRevaluateIterations * 2;
+    for (uint32_t i = 0; i < flow_count; i++) {
+        TestFlow flow[] = {
+            {
+                TestFlowPkt(Address::INET, vm2_ip, vm1_ip, IPPROTO_TCP,
+                            1000 + i, 40, "vrf5", flow1->id(), i + 1),
+                {
+                    new VerifyVn("vn5", "vn5")
+                }
+            }
+        };
+        CreateFlow(flow, 1);
+    }
+    EXPECT_EQ(flow_count * 2, agent()->pkt()->flow_table()->Size());
+
+    FlowTable *table = agent()->pkt()->flow_table();
+    uint64_t count = table->revaluate_count();
+    tbb::atomic<int> yield_count;
+    yield_count = 0;
+    table->revaluate_queue()->SetExitCallback(
+        boost::bind(&RevaluateQueueExit, &yield_count, _1));
+
+    table->revaluate_queue()->set_disable(true);
+    table->ResyncAclFlows(AclGet(1));
+    EXPECT_EQ(flow_count * 2, table->revaluate_queue_length());
+    table->revaluate_queue()->set_disable(false);
+    client->WaitForIdle();
+
+    EXPECT_EQ(0U, table->revaluate_queue_length());
+    EXPECT_EQ(count + flow_count * 2, table->revaluate_count());
+    // Every run but the last stops after kFlowRevaluateIterations flows
+    EXPECT_GE(yield_count, 3);
+    table->revaluate_queue()->SetExitCallback(
+        WorkQueue<FlowRevaluateEntry *>::TaskExitCallback());
+
+    FlushFlowTable();
+    DelOperDBAcl(1);
+    client->WaitForIdle();
+}
+
 int main(int argc, char *argv[]) {
     GETUSERARGS();
 
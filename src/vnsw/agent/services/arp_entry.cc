@@ -12,19 +12,11 @@ ArpEntry::ArpEntry(boost::asio::io_service &io, ArpHandler *handler,
                    ArpKey &key, const VrfEntry *vrf, State state,
                    const Interface *itf)
     : io_(io), key_(key), nh_vrf_(vrf), state_(state), retry_count_(0),
-      handler_(handler), arp_timer_(NULL), interface_(itf) {
-    if (!IsDerived()) {
-        arp_timer_ = TimerManager::CreateTimer(io, "Arp Entry timer",
-                TaskScheduler::GetInstance()->GetTaskId("Agent::Services"),
-                PktHandler::ARP);
-    }
+      handler_(handler), arp_timer_(), interface_(itf) {
 }
 
 ArpEntry::~ArpEntry() {
-    if (!IsDerived()) {
-        arp_timer_->Cancel();
-        TimerManager::DeleteTimer(arp_timer_);
-    }
+    arp_timer_.Cancel();
     handler_.reset(NULL);
 }
 
@@ -71,7 +63,7 @@ void ArpEntry::HandleArpReply(const MacAddress &mac) {
     if ((state_ == ArpEntry::RESOLVING) || (state_ == ArpEntry::ACTIVE) ||
         (state_ == ArpEntry::INITING) || (state_ == ArpEntry::RERESOLVING)) {
         ArpProto *arp_proto = handler_->agent()->GetArpProto();
-        arp_timer_->Cancel();
+        arp_timer_.Cancel();
         retry_count_ = 0;
         mac_address_ = mac;
         if (state_ == ArpEntry::RESOLVING) {
@@ -156,10 +148,10 @@ bool ArpEntry::IsDerived() {
 }
 
 void ArpEntry::StartTimer(uint32_t timeout, uint32_t mtype) {
-    arp_timer_->Cancel();
-    arp_timer_->Start(timeout, boost::bind(&ArpProto::TimerExpiry,
-                                           handler_->agent()->GetArpProto(),
-                                           key_, mtype, interface_));
+    ArpProto *arp_proto = handler_->agent()->GetArpProto();
+    arp_timer_.Start(arp_proto->timer_wheel(), timeout,
+                     boost::bind(&ArpProto::TimerExpiry, arp_proto, key_,
+                                 mtype, interface_));
 }
 
 void ArpEntry::SendArpRequest() {
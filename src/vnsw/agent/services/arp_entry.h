@@ -61,7 +61,7 @@ private:
     State state_;
     int retry_count_;
     boost::intrusive_ptr<ArpHandler> handler_;
-    Timer *arp_timer_;
+    ArpTimerWheel::Timer arp_timer_;
     const Interface *interface_;
     DISALLOW_COPY_AND_ASSIGN(ArpEntry);
 };
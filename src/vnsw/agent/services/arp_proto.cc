@@ -20,6 +20,7 @@ void ArpProto::Shutdown() {
     for (ArpIterator it = arp_cache_.begin(); it != arp_cache_.end(); ) {
         it = DeleteArpEntry(it);
     }
+    timer_wheel_->Shutdown();
 }
 
 ArpProto::ArpProto(Agent *agent, boost::asio::io_service &io,
@@ -28,7 +29,10 @@ ArpProto::ArpProto(Agent *agent, boost::asio::io_service &io,
     run_with_vrouter_(run_with_vrouter), ip_fabric_interface_index_(-1),
     ip_fabric_interface_(NULL), gratuitous_arp_entry_(NULL),
     max_retries_(kMaxRetries), retry_timeout_(kRetryTimeout),
-    aging_timeout_(kAgingTimeout) {
+    aging_timeout_(kAgingTimeout),
+    timer_wheel_(new ArpTimerWheel(io,
+                 TaskScheduler::GetInstance()->GetTaskId("Agent::Services"),
+                 PktHandler::ARP)) {
 
     vrf_table_listener_id_ = agent->vrf_table()->Register(
                              boost::bind(&ArpProto::VrfNotify, this, _1, _2));
@@ -83,15 +87,12 @@ void ArpProto::VrfNotify(DBTablePartBase *part, DBEntryBase *entry) {
 
 ArpDBState::ArpDBState(ArpVrfState *vrf_state, uint32_t vrf_id, IpAddress ip,
                        uint8_t plen) : vrf_state_(vrf_state),
-    arp_req_timer_(NULL), vrf_id_(vrf_id), vm_ip_(ip), plen_(plen),
+    arp_req_timer_(), vrf_id_(vrf_id), vm_ip_(ip), plen_(plen),
     sg_list_(0), policy_(false), resolve_route_(false) {
 }
 
 ArpDBState::~ArpDBState() {
-    if (arp_req_timer_) {
-        arp_req_timer_->Cancel();
-        TimerManager::DeleteTimer(arp_req_timer_);
-    }
+    arp_req_timer_.Cancel();
 }
 
 bool ArpDBState::SendArpRequest() {
@@ -130,15 +131,8 @@ bool ArpDBState::SendArpRequest() {
 }
 
 void ArpDBState::StartTimer() {
-    if (arp_req_timer_ == NULL) {
-        arp_req_timer_ = TimerManager::CreateTimer(
-                *(vrf_state_->agent->event_manager()->io_service()),
-                "Arp Entry timer for VM",
-                TaskScheduler::GetInstance()->
-                GetTaskId("Agent::Services"), PktHandler::ARP);
-    }
-    arp_req_timer_->Start(kTimeout, boost::bind(&ArpDBState::SendArpRequest,
-                                                this));
+    arp_req_timer_.Start(vrf_state_->arp_proto->timer_wheel(), kTimeout,
+                         boost::bind(&ArpDBState::SendArpRequest, this));
 }
 
 //Send ARP request on interface in Active-BackUp mode
@@ -5,8 +5,10 @@
 #ifndef vnsw_agent_arp_proto_hpp
 #define vnsw_agent_arp_proto_hpp
 
+#include <boost/scoped_ptr.hpp>
 #include "pkt/proto.h"
 #include "services/arp_handler.h"
+#include "services/arp_timer_wheel.h"
 #include "services/arp_entry.h"
 
 #define ARP_TRACE(obj, ...)                                                 \
@@ -158,6 +160,7 @@ public:
     void ValidateAndClearVrfState(VrfEntry *vrf);
     ArpIterator FindUpperBoundArpEntry(const ArpKey &key);
     ArpIterator FindLowerBoundArpEntry(const ArpKey &key);
+    ArpTimerWheel *timer_wheel() const { return timer_wheel_.get(); }
 
 private:
     void VrfNotify(DBTablePartBase *part, DBEntryBase *entry);
@@ -184,6 +187,8 @@ private:
     uint16_t max_retries_;
     uint32_t retry_timeout_;   // milli seconds
     uint32_t aging_timeout_;   // milli seconds
+    // Single timer driving retry, aging and gratuitous ARP of all entries
+    boost::scoped_ptr<ArpTimerWheel> timer_wheel_;
 
     DISALLOW_COPY_AND_ASSIGN(ArpProto);
 };
@@ -226,7 +231,7 @@ public:
     void Delete(const InetUnicastRouteEntry *rt);
 private:
     ArpVrfState *vrf_state_;
-    Timer *arp_req_timer_;
+    ArpTimerWheel::Timer arp_req_timer_;
     uint32_t vrf_id_;
     IpAddress vm_ip_;
     uint8_t plen_;
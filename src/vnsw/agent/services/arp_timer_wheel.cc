@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "base/os.h"
+#include <boost/bind.hpp>
+#include "base/util.h"
+#include "services/arp_timer_wheel.h"
+
+void ArpTimerWheel::Timer::Start(ArpTimerWheel *wheel, uint32_t timeout,
+                                 Handler handler) {
+    Cancel();
+    wheel_ = wheel;
+    timeout_ = timeout;
+    handler_ = handler;
+    wheel_->Schedule(this);
+}
+
+ArpTimerWheel::ArpTimerWheel(boost::asio::io_service &io, int task_id,
+                             int instance) :
+    timer_(TimerManager::CreateTimer(io, "Arp timer wheel", task_id,
+                                     instance)),
+    slots_(kSlotCount), current_(0), in_tick_(false), expired_(0),
+    deferred_(0) {
+}
+
+ArpTimerWheel::~ArpTimerWheel() {
+    Shutdown();
+    TimerManager::DeleteTimer(timer_);
+}
+
+void ArpTimerWheel::Shutdown() {
+    timer_->Cancel();
+    for (std::vector<Slot>::iterator it = slots_.begin(); it != slots_.end();
+         ++it) {
+        it->clear();
+    }
+}
+
+uint32_t ArpTimerWheel::timer_count() const {
+    uint32_t count = 0;
+    for (std::vector<Slot>::const_iterator it = slots_.begin();
+         it != slots_.end(); ++it) {
+        count += it->size();
+    }
+    return count;
+}
+
+void ArpTimerWheel::Schedule(Timer *timer) {
+    uint32_t ticks = (timer->timeout_ + kTickInterval - 1) / kTickInterval;
+    if (ticks == 0)
+        ticks = 1;
+    timer->rounds_ = (ticks - 1) / kSlotCount;
+    slots_[(current_ + ticks) % kSlotCount].push_back(*timer);
+
+    // Timer is restarted by Tick() itself when it returns
+    if (in_tick_ == false && timer_->running() == false) {
+        timer_->Start(kTickInterval,
+                      boost::bind(&ArpTimerWheel::Tick, this));
+    }
+}
+
+bool ArpTimerWheel::Tick() {
+    in_tick_ = true;
+    current_ = (current_ + 1) % kSlotCount;
+    Slot &next = slots_[(current_ + 1) % kSlotCount];
+
+    Slot pending;
+    pending.splice(pending.end(), slots_[current_]);
+
+    uint32_t count = 0;
+    while (pending.empty() == false) {
+        Timer *timer = &pending.front();
+        pending.pop_front();
+        if (timer->rounds_) {
+            timer->rounds_--;
+            slots_[current_].push_back(*timer);
+            continue;
+        }
+
+        // Pace expiries, remaining timers move to the next tick
+        if (count >= kMaxExpiryPerTick) {
+            next.push_back(*timer);
+            deferred_++;
+            continue;
+        }
+
+        count++;
+        expired_++;
+        // Handler may restart the timer itself
+        Handler handler = timer->handler_;
+        if (handler() && timer->running() == false) {
+            Schedule(timer);
+        }
+    }
+
+    in_tick_ = false;
+    for (std::vector<Slot>::const_iterator it = slots_.begin();
+         it != slots_.end(); ++it) {
+        if (it->empty() == false)
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef vnsw_agent_arp_timer_wheel_hpp
+#define vnsw_agent_arp_timer_wheel_hpp
+
+#include <vector>
+#include <boost/function.hpp>
+#include <boost/intrusive/list.hpp>
+#include <base/util.h>
+#include <base/timer.h>
+
+class ArpTimerWheel;
+
+// Hashed timing wheel shared by all ARP entries.
+//
+// ARP retry, aging and gratuitous ARP timers used to be individual Timer
+// objects, one per ArpEntry and ArpDBState. The wheel drives all of them from
+// a single Timer ticking every kTickInterval msec while timers are pending.
+// At most kMaxExpiryPerTick timers expire in a tick, the rest are deferred to
+// the next tick, so that bursts (VRF or route resync) are paced out instead
+// of sending a storm of ARP packets.
+//
+// Timers are started, cancelled and expired in the Agent::Services task (or
+// in tasks mutually exclusive with it).
+class ArpTimerWheel {
+public:
+    static const uint32_t kTickInterval = 10;       // milli seconds
+    static const uint32_t kSlotCount = 512;
+    static const uint32_t kMaxExpiryPerTick = 256;
+
+    // Timer handler, returning true restarts the timer with same timeout.
+    // Handler must not delete the timer it is invoked for
+    typedef boost::function<bool(void)> Handler;
+
+    class Timer {
+    public:
+        typedef boost::intrusive::list_member_hook<
+            boost::intrusive::link_mode<boost::intrusive::auto_unlink> > Hook;
+
+        Timer() : wheel_(NULL), timeout_(0), rounds_(0) { }
+        ~Timer() { }
+
+        void Start(ArpTimerWheel *wheel, uint32_t timeout, Handler handler);
+        void Cancel() { node_.unlink(); }
+        bool running() const { return node_.is_linked(); }
+
+    private:
+        friend class ArpTimerWheel;
+        ArpTimerWheel *wheel_;
+        uint32_t timeout_;
+        uint32_t rounds_;
+        Handler handler_;
+        Hook node_;
+        DISALLOW_COPY_AND_ASSIGN(Timer);
+    };
+
+    ArpTimerWheel(boost::asio::io_service &io, int task_id, int instance);
+    ~ArpTimerWheel();
+
+    void Shutdown();
+    uint64_t expired() const { return expired_; }
+    uint64_t deferred() const { return deferred_; }
+    uint32_t timer_count() const;
+
+private:
+    friend class ArpTimerWheelTest;
+    typedef boost::intrusive::member_hook<Timer, Timer::Hook,
+                                          &Timer::node_> TimerNode;
+    typedef boost::intrusive::list<Timer, TimerNode,
+            boost::intrusive::constant_time_size<false> > Slot;
+
+    void Schedule(Timer *timer);
+    bool Tick();
+
+    ::Timer *timer_;
+    std::vector<Slot> slots_;
+    uint32_t current_;
+    bool in_tick_;
+    uint64_t expired_;
+    uint64_t deferred_;
+    DISALLOW_COPY_AND_ASSIGN(ArpTimerWheel);
+};
+
+#endif // vnsw_agent_arp_timer_wheel_hpp
@@ -0,0 +1,178 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+#include <sstream>
+#include <boost/algorithm/string/case_conv.hpp>
+#include <boost/functional/hash.hpp>
+#include "base/time_util.h"
+#include "services/dns_cache.h"
+
+namespace {
+
+void ReduceTtl(DnsItems *items, uint32_t elapsed) {
+    for (DnsItems::iterator it = items->begin(); it != items->end(); ++it) {
+        it->ttl = (it->ttl > elapsed) ? it->ttl - elapsed : 0;
+    }
+}
+
+}  // namespace
+
+DnsResponseCache::DnsResponseCache() : shards_(kShardCount) {
+}
+
+DnsResponseCache::~DnsResponseCache() {
+}
+
+std::string DnsResponseCache::Key(const std::string &vdns,
+                                  const DnsItems &ques) {
+    // DNS names are case insensitive
+    std::stringstream str;
+    str << vdns;
+    for (DnsItems::const_iterator it = ques.begin(); it != ques.end(); ++it) {
+        str << ";" << boost::algorithm::to_lower_copy(it->name) << "/"
+            << it->type << "/" << it->eclass;
+    }
+    return str.str();
+}
+
+void DnsResponseCache::ClearCompression(DnsItems *items) {
+    for (DnsItems::iterator it = items->begin(); it != items->end(); ++it) {
+        it->name_plen = it->name_offset = 0;
+        it->data_plen = it->data_offset = 0;
+        it->soa.ns_plen = it->soa.ns_offset = 0;
+        it->soa.mailbox_plen = it->soa.mailbox_offset = 0;
+    }
+}
+
+DnsResponseCache::Shard &DnsResponseCache::GetShard(const std::string &key) {
+    boost::hash<std::string> hasher;
+    return shards_[hasher(key) % kShardCount];
+}
+
+void DnsResponseCache::Add(const std::string &key, const std::string &vdns,
+                           const dns_flags &flags, const DnsItems &ans,
+                           const DnsItems &auth, const DnsItems &add) {
+    if (flags.trunc)
+        return;
+
+    uint32_t ttl = kMaxTtl;
+    bool negative = false;
+    if (flags.ret == DNS_ERR_NO_SUCH_NAME ||
+        (flags.ret == DNS_ERR_NO_ERROR && ans.empty())) {
+        negative = true;
+        ttl = kNegativeTtl;
+        for (DnsItems::const_iterator it = auth.begin(); it != auth.end();
+             ++it) {
+            if (it->type == DNS_TYPE_SOA) {
+                ttl = std::min(it->ttl, it->soa.ttl);
+                break;
+            }
+        }
+    } else if (flags.ret == DNS_ERR_NO_ERROR) {
+        for (DnsItems::const_iterator it = ans.begin(); it != ans.end();
+             ++it) {
+            ttl = std::min(ttl, it->ttl);
+        }
+    } else {
+        // server failures are not cached
+        return;
+    }
+    if (ttl > kMaxTtl)
+        ttl = kMaxTtl;
+    if (ttl == 0)
+        return;
+
+    uint64_t now = ClockMonotonicUsec();
+    Shard &shard = GetShard(key);
+    if (shard.find(key) == shard.end() && shard.size() >= kMaxEntriesPerShard)
+        MakeRoom(&shard, now);
+
+    Entry &entry = shard[key];
+    entry.vdns = vdns;
+    entry.flags = flags;
+    entry.ans = ans;
+    entry.auth = auth;
+    entry.add = add;
+    ClearCompression(&entry.ans);
+    ClearCompression(&entry.auth);
+    ClearCompression(&entry.add);
+    entry.negative = negative;
+    entry.insert_time = now;
+    entry.expiry_time = now + (uint64_t)ttl * 1000000;
+}
+
+bool DnsResponseCache::Lookup(const std::string &key, dns_flags *flags,
+                              DnsItems *ans, DnsItems *auth, DnsItems *add,
+                              bool *negative) {
+    Shard &shard = GetShard(key);
+    Shard::iterator it = shard.find(key);
+    if (it == shard.end())
+        return false;
+
+    uint64_t now = ClockMonotonicUsec();
+    const Entry &entry = it->second;
+    if (entry.expiry_time <= now) {
+        shard.erase(it);
+        return false;
+    }
+
+    uint32_t elapsed = (now - entry.insert_time) / 1000000;
+    *flags = entry.flags;
+    *ans = entry.ans;
+    *auth = entry.auth;
+    *add = entry.add;
+    ReduceTtl(ans, elapsed);
+    ReduceTtl(auth, elapsed);
+    ReduceTtl(add, elapsed);
+    *negative = entry.negative;
+    return true;
+}
+
+// Purge expired entries; if the shard is still full, evict the entry
+// closest to expiry
+void DnsResponseCache::MakeRoom(Shard *shard, uint64_t now) {
+    Shard::iterator victim = shard->end();
+    for (Shard::iterator it = shard->begin(); it != shard->end(); ) {
+        if (it->second.expiry_time <= now) {
+            shard->erase(it++);
+            continue;
+        }
+        if (victim == shard->end() ||
+            it->second.expiry_time < victim->second.expiry_time)
+            victim = it;
+        ++it;
+    }
+
+    if (shard->size() >= kMaxEntriesPerShard && victim != shard->end())
+        shard->erase(victim);
+}
+
+void DnsResponseCache::Flush(const std::string &vdns) {
+    for (std::vector<Shard>::iterator sit = shards_.begin();
+         sit != shards_.end(); ++sit) {
+        for (Shard::iterator it = sit->begin(); it != sit->end(); ) {
+            if (it->second.vdns == vdns)
+                sit->erase(it++);
+            else
+                ++it;
+        }
+    }
+}
+
+void DnsResponseCache::Clear() {
+    for (std::vector<Shard>::iterator it = shards_.begin();
+         it != shards_.end(); ++it) {
+        it->clear();
+    }
+}
+
+uint32_t DnsResponseCache::size() const {
+    uint32_t count = 0;
+    for (std::vector<Shard>::const_iterator it = shards_.begin();
+         it != shards_.end(); ++it) {
+        count += it->size();
+    }
+    return count;
+}
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef vnsw_agent_dns_cache_hpp
+#define vnsw_agent_dns_cache_hpp
+
+#include <map>
+#include <string>
+#include <vector>
+#include <base/util.h>
+#include "bind/bind_util.h"
+
+// Agent local cache of responses received from the virtual DNS server.
+//
+// Responses are keyed by the virtual DNS name and the question section of
+// the query. Positive responses are cached for the smallest TTL in the answer
+// section, negative responses (NXDOMAIN or no data) for the SOA minimum TTL
+// as per RFC 2308, both capped at kMaxTtl since record updates done via
+// other compute nodes are not notified to the agent.
+//
+// Entries are spread over kShardCount maps, so that purging expired entries
+// and eviction on overflow only walk one shard.
+//
+// Cache is accessed only from the Agent::Services task (or tasks mutually
+// exclusive with it).
+class DnsResponseCache {
+public:
+    static const uint32_t kShardCount = 16;
+    static const uint32_t kMaxEntriesPerShard = 1024;
+    static const uint32_t kMaxTtl = 300;          // seconds
+    static const uint32_t kNegativeTtl = 30;      // seconds, when SOA absent
+
+    DnsResponseCache();
+    ~DnsResponseCache();
+
+    static std::string Key(const std::string &vdns, const DnsItems &ques);
+    // Remove the name compression offsets, which are valid only in the
+    // message the items were read from
+    static void ClearCompression(DnsItems *items);
+
+    void Add(const std::string &key, const std::string &vdns,
+             const dns_flags &flags, const DnsItems &ans,
+             const DnsItems &auth, const DnsItems &add);
+    // Returns copies of the cached sections with TTLs reduced by the time
+    // spent in the cache. negative is set for cached NXDOMAIN / no data
+    bool Lookup(const std::string &key, dns_flags *flags, DnsItems *ans,
+                DnsItems *auth, DnsItems *add, bool *negative);
+    void Flush(const std::string &vdns);
+    void Clear();
+    uint32_t size() const;
+
+private:
+    struct Entry {
+        Entry() : flags(), negative(false), insert_time(0), expiry_time(0) { }
+
+        std::string vdns;
+        dns_flags flags;
+        DnsItems ans;
+        DnsItems auth;
+        DnsItems add;
+        bool negative;
+        uint64_t insert_time;     // micro seconds
+        uint64_t expiry_time;     // micro seconds
+    };
+    typedef std::map<std::string, Entry> Shard;
+
+    Shard &GetShard(const std::string &key);
+    void MakeRoom(Shard *shard, uint64_t now);
+
+    std::vector<Shard> shards_;
+    DISALLOW_COPY_AND_ASSIGN(DnsResponseCache);
+};
+
+#endif // vnsw_agent_dns_cache_hpp
@@ -11,6 +11,7 @@
 #include "cmn/agent_cmn.h"
 #include "controller/controller_dns.h"
 #include "base/timer.h"
+#include "base/time_util.h"
 #include "oper/operdb_init.h"
 #include "oper/global_vrouter.h"
 #include "oper/vn.h"
@@ -19,7 +20,7 @@ DnsHandler::DnsHandler(Agent *agent, boost::shared_ptr<PktInfo> info,
                        boost::asio::io_service &io)
     : ProtoHandler(agent, info, io), resp_ptr_(NULL), dns_resp_size_(0),
       xid_(-1), retries_(0), action_(NONE), rkey_(NULL),
-      query_name_update_(false), pend_req_(0) {
+      query_name_update_(false), pend_req_(0), start_time_(0) {
     dns_ = (dnshdr *) pkt_info_->data;
     timer_ = TimerManager::CreateTimer(io, "DnsHandlerTimer",
              TaskScheduler::GetInstance()->GetTaskId("Agent::Services"),
@@ -315,8 +316,22 @@ bool DnsHandler::HandleVirtualDnsRequest(const VmInterface *vmitf) {
                 break;
             }
             UpdateQueryNames();
-            xid_ = dns_proto->GetTransId();
+            start_time_ = ClockMonotonicUsec();
+            cache_key_ = DnsResponseCache::Key(ipam_type_.ipam_dns_server.
+                                               virtual_dns_server_name, items_);
+            if (ResolveFromCache())
+                break;
             action_ = DnsHandler::DNS_QUERY;
+            if (dns_proto->AddPendingQuery(cache_key_, this)) {
+                // resolved when the response to the pending query arrives
+                DNS_BIND_TRACE(DnsBindTrace, "DNS query pending on identical "
+                               "query; interface = " << vmitf->vm_name() <<
+                               " xid = " << dns_->xid << " " <<
+                               DnsItemsToString(items_));
+                dns_proto->IncrStatsCoalesced();
+                return false;
+            }
+            xid_ = dns_proto->GetTransId();
             if (SendDnsQuery())
                 return false;
             break;
@@ -391,9 +406,61 @@ bool DnsHandler::SendDnsQuery() {
 cleanup:
     dns_proto->IncrStatsDrop();
     dns_proto->DelDnsQuery(xid_);
+    DropWaiters();
     return false;
 }
 
+bool DnsHandler::ResolveFromCache() {
+    DnsProto *dns_proto = agent()->GetDnsProto();
+    dns_flags flags;
+    DnsItems ques, ans, auth, add;
+    bool negative = false;
+    if (!dns_proto->dns_cache()->Lookup(cache_key_, &flags, &ans, &auth, &add,
+                                        &negative)) {
+        dns_proto->IncrStatsCacheMiss();
+        return false;
+    }
+
+    dns_proto->IncrStatsCacheHit(negative);
+    DNS_BIND_TRACE(DnsBindTrace, "DNS query resolved from cache; xid = " <<
+                   dns_->xid << " " << DnsItemsToString(items_));
+    Resolve(flags, ques, ans, auth, add);
+    return true;
+}
+
+// Drop the requests which were waiting on a query that failed
+void DnsHandler::DropWaiters() {
+    DnsProto *dns_proto = agent()->GetDnsProto();
+    std::vector<DnsHandler *> waiters;
+    dns_proto->DelPendingQuery(cache_key_, &waiters);
+    for (std::vector<DnsHandler *>::iterator it = waiters.begin();
+         it != waiters.end(); ++it) {
+        dns_proto->IncrStatsDrop();
+        dns_proto->DelVmRequest((*it)->rkey_);
+        delete *it;
+    }
+}
+
+// Resolve the requests which were waiting on the query just answered
+void DnsHandler::ResolveWaiters(const dns_flags &flags, const DnsItems &ques,
+                                const DnsItems &ans, const DnsItems &auth,
+                                const DnsItems &add) {
+    DnsProto *dns_proto = agent()->GetDnsProto();
+    std::vector<DnsHandler *> waiters;
+    dns_proto->DelPendingQuery(cache_key_, &waiters);
+    for (std::vector<DnsHandler *>::iterator it = waiters.begin();
+         it != waiters.end(); ++it) {
+        // compression offsets are specific to the message from the server
+        DnsItems w_ans(ans), w_auth(auth), w_add(add);
+        DnsResponseCache::ClearCompression(&w_ans);
+        DnsResponseCache::ClearCompression(&w_auth);
+        DnsResponseCache::ClearCompression(&w_add);
+        (*it)->Resolve(flags, ques, w_ans, w_auth, w_add);
+        dns_proto->DelVmRequest((*it)->rkey_);
+        delete *it;
+    }
+}
+
 // Check the request against configured link local services and
 // update DnsItems, if found
 bool DnsHandler::ResolveLinkLocalRequest(DnsItems::iterator &item,
@@ -518,6 +585,11 @@ bool DnsHandler::HandleBindResponse() {
                                        ques, ans, auth, add)) {
             switch(handler->action_) {
                 case DnsHandler::DNS_QUERY:
+                    // cache and waiters take copies, Resolve updates the items
+                    dns_proto->dns_cache()->Add(handler->cache_key_,
+                        handler->ipam_type_.ipam_dns_server.
+                        virtual_dns_server_name, flags, ans, auth, add);
+                    handler->ResolveWaiters(flags, ques, ans, auth, add);
                     handler->Resolve(flags, ques, ans, auth, add);
                     if (flags.ret) {
                         DNS_BIND_TRACE(DnsBindError, "Query failed : " <<
@@ -542,6 +614,7 @@ bool DnsHandler::HandleBindResponse() {
             DNS_BIND_TRACE(DnsBindTrace,
                            "Received invalid BIND response: xid = " << xid);
         }
+        handler->DropWaiters();
         dns_proto->DelDnsQuery(xid);
         dns_proto->DelVmRequest(handler->rkey_);
         delete handler;
@@ -589,6 +662,7 @@ bool DnsHandler::HandleModifyVdns() {
         static_cast<DnsProto::DnsUpdateIpc *>(pkt_info_->ipc);
     DnsProto *dns_proto = agent()->GetDnsProto();
     std::vector<DnsProto::DnsUpdateIpc *> change_list;
+    dns_proto->FlushDnsCache(ipc->old_vdns);
     const DnsProto::DnsUpdateSet &update_set = dns_proto->update_set();
     for (DnsProto::DnsUpdateSet::const_iterator it = update_set.begin();
          it != update_set.end(); ++it) {
@@ -734,6 +808,8 @@ DnsHandler::Resolve(dns_flags flags, const DnsItems &ques, DnsItems &ans,
     dns_->auth_rrcount = htons(dns_->auth_rrcount);
     dns_->add_rrcount = htons(dns_->add_rrcount);
     SendDnsResponse();
+    agent()->GetDnsProto()->UpdateLatencyStats(ClockMonotonicUsec() -
+                                               start_time_);
 }
 
 void DnsHandler::SendDnsResponse() {
@@ -866,6 +942,7 @@ void DnsHandler::Update(InterTaskMsg *msg) {
     DnsProto::DnsUpdateIpc *update = static_cast<DnsProto::DnsUpdateIpc *>(msg);
     bool free_update = true;
     DnsProto *dns_proto = agent()->GetDnsProto();
+    dns_proto->FlushDnsCache(update->xmpp_data->virtual_dns);
     DnsProto::DnsUpdateIpc *update_req = dns_proto->FindUpdateRequest(update);
     if (update_req) {
         DnsUpdateData *data = update_req->xmpp_data;
@@ -909,6 +986,7 @@ void DnsHandler::DelUpdate(InterTaskMsg *msg) {
     DnsProto *dns_proto = agent()->GetDnsProto();
     DnsProto::DnsUpdateIpc *update_req = dns_proto->FindUpdateRequest(update);
     while (update_req) {
+        dns_proto->FlushDnsCache(update_req->xmpp_data->virtual_dns);
         for (DnsItems::iterator item = update_req->xmpp_data->items.begin(); 
              item != update_req->xmpp_data->items.end(); ++item) {
             // in case of delete, set the class to NONE and ttl to 0
@@ -74,6 +74,11 @@ private:
     void Resolve(dns_flags flags, const DnsItems &ques, DnsItems &ans,
                  DnsItems &auth, DnsItems &add);
     bool SendDnsQuery();
+    bool ResolveFromCache();
+    void DropWaiters();
+    void ResolveWaiters(const dns_flags &flags, const DnsItems &ques,
+                        const DnsItems &ans, const DnsItems &auth,
+                        const DnsItems &add);
     void SendDnsResponse();
     void UpdateQueryNames();
     void UpdateOffsets(DnsItem &item, bool name_update_required);
@@ -105,6 +110,8 @@ private:
     bool query_name_update_;
     uint16_t query_name_update_len_;   // num bytes added in the query section
     uint16_t pend_req_;
+    std::string cache_key_;
+    uint64_t start_time_;              // micro seconds
     ResolvList resolv_list_;
     tbb::mutex mutex_;
 
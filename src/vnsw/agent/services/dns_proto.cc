@@ -28,6 +28,17 @@ void DnsProto::IoShutdown() {
         it = next;
     }
 
+    // handlers waiting on a pending query are not in dns_query_map_
+    for (DnsPendingQueryMap::iterator it = pending_query_map_.begin();
+         it != pending_query_map_.end(); ++it) {
+        for (std::vector<DnsHandler *>::iterator hit = it->second.begin();
+             hit != it->second.end(); ++hit) {
+            delete *hit;
+        }
+    }
+    pending_query_map_.clear();
+    dns_cache_.Clear();
+
     curr_vm_requests_.clear();
     // Following tables should be deleted when all VMs are gone
     assert(update_set_.empty());
@@ -237,6 +248,7 @@ void DnsProto::VdnsNotify(IFMapNode *node) {
         std::string name = node->name();
         MoveVDnsEntry(NULL, name, name, vdns_type, false);
     }
+    FlushDnsCache(node->name());
     ProcessNotify(node->name(), node->IsDeleted(), false);
 }
 
@@ -623,6 +635,49 @@ bool DnsProto::IsVmRequestDuplicate(DnsHandler::QueryKey *key) {
     return curr_vm_requests_.find(*key) != curr_vm_requests_.end();
 }
 
+// Returns true if a query with the same key is already sent to the DNS server,
+// handler is then queued to be resolved with its response. Otherwise, handler
+// is the one sending the query.
+bool DnsProto::AddPendingQuery(const std::string &key, DnsHandler *handler) {
+    DnsPendingQueryMap::iterator it = pending_query_map_.find(key);
+    if (it == pending_query_map_.end()) {
+        pending_query_map_.insert(DnsPendingQueryMap::value_type(key,
+                                  std::vector<DnsHandler *>()));
+        return false;
+    }
+    it->second.push_back(handler);
+    return true;
+}
+
+void DnsProto::DelPendingQuery(const std::string &key,
+                               std::vector<DnsHandler *> *waiters) {
+    DnsPendingQueryMap::iterator it = pending_query_map_.find(key);
+    if (it == pending_query_map_.end())
+        return;
+    waiters->swap(it->second);
+    pending_query_map_.erase(it);
+}
+
+void DnsProto::FlushDnsCache(const std::string &vdns) {
+    // cache is keyed by the name used in queries to the DNS server
+    std::string name(vdns);
+    BindUtil::RemoveSpecialChars(name);
+    dns_cache_.Flush(name);
+}
+
+void DnsProto::UpdateLatencyStats(uint64_t usec) {
+    if (usec < 1000)
+        stats_.latency[LATENCY_1MS]++;
+    else if (usec < 10000)
+        stats_.latency[LATENCY_10MS]++;
+    else if (usec < 100000)
+        stats_.latency[LATENCY_100MS]++;
+    else if (usec < 1000000)
+        stats_.latency[LATENCY_1S]++;
+    else
+        stats_.latency[LATENCY_MAX]++;
+}
+
 DnsProto::DnsFipEntry::DnsFipEntry(const VnEntry *vn, const Ip4Address &fip,
                                    const VmInterface *itf)
     : vn_(vn), floating_ip_(fip), interface_(itf) {
@@ -7,6 +7,7 @@
 
 #include "pkt/proto.h"
 #include "services/dns_handler.h"
+#include "services/dns_cache.h"
 #include "vnc_cfg_types.h"
 
 class VmInterface;
@@ -97,10 +98,24 @@ public:
         AgentDnsXmppChannel *channel;
     };
 
+    // Upper bounds of the resolution latency histogram buckets, last bucket
+    // has no upper bound
+    enum LatencyBucket {
+        LATENCY_1MS,
+        LATENCY_10MS,
+        LATENCY_100MS,
+        LATENCY_1S,
+        LATENCY_MAX,
+        LATENCY_BUCKET_COUNT
+    };
+
     struct DnsStats {
         DnsStats() { Reset(); }
         void Reset() {
             requests = resolved = retransmit_reqs = unsupported = fail = drop = 0;
+            cache_hits = cache_negative_hits = cache_misses = coalesced = 0;
+            for (int i = 0; i < LATENCY_BUCKET_COUNT; ++i)
+                latency[i] = 0;
         }
 
         uint32_t requests;
@@ -109,6 +124,11 @@ public:
         uint32_t unsupported;
         uint32_t fail;
         uint32_t drop;
+        uint64_t cache_hits;
+        uint64_t cache_negative_hits;
+        uint64_t cache_misses;
+        uint64_t coalesced;
+        uint64_t latency[LATENCY_BUCKET_COUNT];
     };
 
     struct DnsFipEntry {
@@ -133,6 +153,9 @@ public:
     typedef std::map<uint32_t, DnsHandler *> DnsBindQueryMap;
     typedef std::pair<uint32_t, DnsHandler *> DnsBindQueryPair;
     typedef std::set<DnsHandler::QueryKey> DnsVmRequestSet;
+    // question key -> handlers waiting on the query already sent for it
+    typedef std::map<std::string, std::vector<DnsHandler *> >
+        DnsPendingQueryMap;
     typedef std::set<DnsUpdateIpc *, UpdateCompare> DnsUpdateSet;
     typedef std::map<uint32_t, std::string> IpVdnsMap;
     typedef std::pair<uint32_t, std::string> IpVdnsPair;
@@ -188,6 +211,13 @@ public:
     void DelVmRequest(DnsHandler::QueryKey *key);
     bool IsVmRequestDuplicate(DnsHandler::QueryKey *key);
 
+    bool AddPendingQuery(const std::string &key, DnsHandler *handler);
+    void DelPendingQuery(const std::string &key,
+                         std::vector<DnsHandler *> *waiters);
+
+    DnsResponseCache *dns_cache() { return &dns_cache_; }
+    void FlushDnsCache(const std::string &vdns);
+
     uint32_t timeout() const { return timeout_; }
     void set_timeout(uint32_t timeout) { timeout_ = timeout; }
     uint32_t max_retries() const { return max_retries_; }
@@ -199,6 +229,14 @@ public:
     void IncrStatsUnsupp() { stats_.unsupported++; }
     void IncrStatsFail() { stats_.fail++; }
     void IncrStatsDrop() { stats_.drop++; }
+    void IncrStatsCacheHit(bool negative) {
+        stats_.cache_hits++;
+        if (negative)
+            stats_.cache_negative_hits++;
+    }
+    void IncrStatsCacheMiss() { stats_.cache_misses++; }
+    void IncrStatsCoalesced() { stats_.coalesced++; }
+    void UpdateLatencyStats(uint64_t usec);
     const DnsStats &GetStats() const { return stats_; }
     void ClearStats() { stats_.Reset(); }
     const VmDataMap& all_vms() const { return all_vms_; }
@@ -237,6 +275,8 @@ private:
     DnsUpdateSet update_set_;
     DnsBindQueryMap dns_query_map_;
     DnsVmRequestSet curr_vm_requests_;
+    DnsPendingQueryMap pending_query_map_;
+    DnsResponseCache dns_cache_;
     DnsStats stats_;
     uint32_t timeout_;   // milli seconds
     uint32_t max_retries_;
@@ -199,6 +199,10 @@ void ServicesSandesh::ArpStatsSandesh(std::string ctxt, bool more) {
     arp->set_arp_invalid_interface(astats.arp_invalid_interface);
     arp->set_arp_invalid_vrf(astats.arp_invalid_vrf);
     arp->set_arp_invalid_address(astats.arp_invalid_address);
+    const ArpTimerWheel *wheel = arp_proto->timer_wheel();
+    arp->set_arp_timers(wheel->timer_count());
+    arp->set_arp_timer_expiries(wheel->expired());
+    arp->set_arp_timer_deferred(wheel->deferred());
     arp->set_context(ctxt);
     arp->set_more(more);
     arp->Response();
@@ -213,6 +217,23 @@ void ServicesSandesh::DnsStatsSandesh(std::string ctxt, bool more) {
     dns->set_dns_unsupported(nstats.unsupported);
     dns->set_dns_failures(nstats.fail);
     dns->set_dns_drops(nstats.drop);
+    dns->set_dns_cache_hits(nstats.cache_hits);
+    dns->set_dns_cache_negative_hits(nstats.cache_negative_hits);
+    dns->set_dns_cache_misses(nstats.cache_misses);
+    dns->set_dns_cache_entries(Agent::GetInstance()->GetDnsProto()->
+                               dns_cache()->size());
+    dns->set_dns_coalesced_reqs(nstats.coalesced);
+    static const char *latency_names[DnsProto::LATENCY_BUCKET_COUNT] = {
+        "1ms", "10ms", "100ms", "1s", "max"
+    };
+    std::vector<DnsLatencyBucket> latency;
+    for (int i = 0; i < DnsProto::LATENCY_BUCKET_COUNT; ++i) {
+        DnsLatencyBucket bucket;
+        bucket.set_latency(latency_names[i]);
+        bucket.set_count(nstats.latency[i]);
+        latency.push_back(bucket);
+    }
+    dns->set_dns_latency(latency);
     dns->set_context(ctxt);
     dns->set_more(more);
     dns->Response();
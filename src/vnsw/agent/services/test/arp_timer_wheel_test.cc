@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2015 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include "base/os.h"
+#include "testing/gunit.h"
+
+#include <boost/bind.hpp>
+#include <base/logging.h>
+#include <base/task.h>
+#include <io/event_manager.h>
+#include <cmn/agent_cmn.h>
+#include <services/arp_timer_wheel.h>
+
+void RouterIdDepInit(Agent *agent) {
+}
+
+#define TIMER_COUNT 300
+
+// Drives the wheel by invoking Tick() directly. The event manager is never
+// run, so the wheel's own timer does not fire during the tests.
+class ArpTimerWheelTest : public ::testing::Test {
+public:
+    bool Handler(int idx, bool restart) {
+        expiry_count_[idx]++;
+        return restart;
+    }
+
+protected:
+    ArpTimerWheelTest() :
+        wheel_(*evm_.io_service(),
+               TaskScheduler::GetInstance()->GetTaskId("Agent::Services"), 0) {
+        for (int i = 0; i < TIMER_COUNT; i++) {
+            expiry_count_[i] = 0;
+        }
+    }
+
+    virtual void TearDown() {
+        wheel_.Shutdown();
+    }
+
+    void Start(int idx, uint32_t timeout, bool restart) {
+        timers_[idx].Start(&wheel_, timeout,
+                           boost::bind(&ArpTimerWheelTest::Handler, this, idx,
+                                       restart));
+    }
+
+    // Slot, relative to the current one, the timer is queued in
+    int SlotOffset(int idx) {
+        for (uint32_t i = 0; i < ArpTimerWheel::kSlotCount; i++) {
+            uint32_t slot = (wheel_.current_ + i) % ArpTimerWheel::kSlotCount;
+            ArpTimerWheel::Slot::iterator it = wheel_.slots_[slot].begin();
+            for (; it != wheel_.slots_[slot].end(); ++it) {
+                if (&(*it) == &timers_[idx])
+                    return i;
+            }
+        }
+        return -1;
+    }
+
+    uint32_t Rounds(int idx) const { return timers_[idx].rounds_; }
+
+    bool Tick(uint32_t count = 1) {
+        bool ret = false;
+        for (uint32_t i = 0; i < count; i++) {
+            ret = wheel_.Tick();
+        }
+        return ret;
+    }
+
+    EventManager evm_;
+    ArpTimerWheel wheel_;
+    ArpTimerWheel::Timer timers_[TIMER_COUNT];
+    int expiry_count_[TIMER_COUNT];
+};
+
+// Timeouts are rounded up to ticks, with a minimum of one tick
+TEST_F(ArpTimerWheelTest, SlotPlacement) {
+    uint32_t tick = ArpTimerWheel::kTickInterval;
+    Start(0, 0, false);
+    Start(1, tick, false);
+    Start(2, tick + 1, false);
+    Start(3, 10 * tick, false);
+    EXPECT_EQ(4U, wheel_.timer_count());
+    EXPECT_EQ(1, SlotOffset(0));
+    EXPECT_EQ(1, SlotOffset(1));
+    EXPECT_EQ(2, SlotOffset(2));
+    EXPECT_EQ(10, SlotOffset(3));
+
+    EXPECT_TRUE(Tick());
+    EXPECT_EQ(1, expiry_count_[0]);
+    EXPECT_EQ(1, expiry_count_[1]);
+    EXPECT_EQ(0, expiry_count_[2]);
+    EXPECT_FALSE(timers_[0].running());
+    EXPECT_TRUE(timers_[2].running());
+
+    EXPECT_TRUE(Tick());
+    EXPECT_EQ(1, expiry_count_[2]);
+    EXPECT_TRUE(Tick(7));
+    EXPECT_EQ(0, expiry_count_[3]);
+    EXPECT_FALSE(Tick());
+    EXPECT_EQ(1, expiry_count_[3]);
+    EXPECT_EQ(0U, wheel_.timer_count());
+    EXPECT_EQ(4U, wheel_.expired());
+}
+
+// Timeouts longer than the wheel go round it before expiring
+TEST_F(ArpTimerWheelTest, WrapAround) {
+    uint32_t slots = ArpTimerWheel::kSlotCount;
+    uint32_t tick = ArpTimerWheel::kTickInterval;
+    Start(0, (2 * slots + 3) * tick, false);
+    EXPECT_EQ(2U, Rounds(0));
+    EXPECT_EQ(3, SlotOffset(0));
+
+    Tick(3);
+    EXPECT_EQ(0, expiry_count_[0]);
+    EXPECT_EQ(1U, Rounds(0));
+    Tick(slots);
+    EXPECT_EQ(0, expiry_count_[0]);
+    EXPECT_EQ(0U, Rounds(0));
+    Tick(slots - 1);
+    EXPECT_EQ(0, expiry_count_[0]);
+    EXPECT_FALSE(Tick());
+    EXPECT_EQ(1, expiry_count_[0]);
+
+    // Same slot as the current one is a full round away
+    Start(1, slots * tick, false);
+    EXPECT_EQ(0U, Rounds(1));
+    EXPECT_EQ(0, SlotOffset(1));
+    Tick(slots - 1);
+    EXPECT_EQ(0, expiry_count_[1]);
+    Tick();
+    EXPECT_EQ(1, expiry_count_[1]);
+}
+
+TEST_F(ArpTimerWheelTest, CancelReschedule) {
+    uint32_t tick = ArpTimerWheel::kTickInterval;
+    Start(0, tick, false);
+    Start(1, tick, false);
+    timers_[0].Cancel();
+    EXPECT_FALSE(timers_[0].running());
+    EXPECT_EQ(1U, wheel_.timer_count());
+    Tick();
+    EXPECT_EQ(0, expiry_count_[0]);
+    EXPECT_EQ(1, expiry_count_[1]);
+
+    // Starting a running timer moves it to the new slot
+    Start(0, 2 * tick, false);
+    Start(0, 5 * tick, false);
+    EXPECT_EQ(1U, wheel_.timer_count());
+    EXPECT_EQ(5, SlotOffset(0));
+    Tick(4);
+    EXPECT_EQ(0, expiry_count_[0]);
+    Tick();
+    EXPECT_EQ(1, expiry_count_[0]);
+
+    // Handler returning true restarts the timer with the same timeout
+    Start(2, 3 * tick, true);
+    Tick(9);
+    EXPECT_EQ(3, expiry_count_[2]);
+    EXPECT_TRUE(timers_[2].running());
+    EXPECT_EQ(3, SlotOffset(2));
+    timers_[2].Cancel();
+    EXPECT_FALSE(Tick());
+}
+
+// Timers beyond kMaxExpiryPerTick in a tick are deferred to the next one
+TEST_F(ArpTimerWheelTest, Pacing) {
+    uint32_t tick = ArpTimerWheel::kTickInterval;
+    uint32_t max_expiry = ArpTimerWheel::kMaxExpiryPerTick;
+    uint32_t extra = TIMER_COUNT - max_expiry;
+    for (int i = 0; i < TIMER_COUNT; i++) {
+        Start(i, tick, false);
+    }
+    EXPECT_TRUE(Tick());
+    EXPECT_EQ(max_expiry, wheel_.expired());
+    EXPECT_EQ(extra, wheel_.deferred());
+    EXPECT_EQ(extra, wheel_.timer_count());
+    for (uint32_t i = 0; i < max_expiry; i++) {
+        EXPECT_EQ(1, expiry_count_[i]);
+    }
+    for (uint32_t i = max_expiry; i < TIMER_COUNT; i++) {
+        EXPECT_EQ(0, expiry_count_[i]);
+        EXPECT_EQ(1, SlotOffset(i));
+    }
+
+    EXPECT_FALSE(Tick());
+    EXPECT_EQ(static_cast<uint64_t>(TIMER_COUNT), wheel_.expired());
+    EXPECT_EQ(extra, wheel_.deferred());
+    EXPECT_EQ(0U, wheel_.timer_count());
+}
+
+int main(int argc, char **argv) {
+    LoggingInit();
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
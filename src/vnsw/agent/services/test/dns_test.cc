@@ -195,12 +195,13 @@ public:
     void CheckSandeshResponse(Sandesh *sandesh) {
     }
 
-    int SendDnsQuery(dnshdr *dns, int numItems, DnsItem *items, dns_flags flags) {
+    int SendDnsQuery(dnshdr *dns, int numItems, DnsItem *items, dns_flags flags,
+                     uint16_t xid) {
         DnsItems questions;
         for (int i = 0; i < numItems; i++) {
             questions.push_back(items[i]);
         }
-        int len = BindUtil::BuildDnsQuery((uint8_t *)dns, 0x0102,
+        int len = BindUtil::BuildDnsQuery((uint8_t *)dns, xid,
                                           "default-vdns", questions);
         dns->flags = flags;
         return len;
@@ -218,7 +219,7 @@ public:
 
     void SendDnsReq(int type, short itf_index, int numItems,
                     DnsItem *items, dns_flags flags = default_flags,
-                    bool update = false) {
+                    bool update = false, uint16_t xid = 0x0102) {
         int len = 1024;
         uint8_t *buf  = new uint8_t[len];
         memset(buf, 0, len);
@@ -257,7 +258,7 @@ public:
 
         dnshdr *dns = (dnshdr *) (udp + 1);
         if (type == DNS_OPCODE_QUERY) {
-            len = SendDnsQuery(dns, numItems, items, flags);
+            len = SendDnsQuery(dns, numItems, items, flags, xid);
         } else if (type == DNS_OPCODE_UPDATE) {
             BindUtil::Operation op =
                 update ? BindUtil::ADD_UPDATE : BindUtil::DELETE_UPDATE;
@@ -523,7 +524,8 @@ TEST_F(DnsTest, VirtualDnsReqTest) {
     CHECK_CONDITION(stats.unsupported < 1);
     CHECK_STATS(stats, 7, 4, 2, 1, 0, 0);
 
-    // Failure response
+    // Failure response, for a question answered from the cache otherwise
+    Agent::GetInstance()->GetDnsProto()->dns_cache()->Clear();
     SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 3, a_items);
     g_xid++;
     usleep(1000);
@@ -542,6 +544,7 @@ TEST_F(DnsTest, VirtualDnsReqTest) {
 
     Agent::GetInstance()->GetDnsProto()->set_timeout(30);
     Agent::GetInstance()->GetDnsProto()->set_max_retries(1);
+    Agent::GetInstance()->GetDnsProto()->dns_cache()->Clear();
     SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items);
     g_xid++;
     usleep(100000); // wait for retry timer to expire
@@ -584,6 +587,251 @@ TEST_F(DnsTest, VirtualDnsReqTest) {
     client->WaitForIdle();
 }
 
+// Repeated questions are answered from the agent cache
+TEST_F(DnsTest, VirtualDnsCacheTest) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+    IpamInfo ipam_info[] = {
+        {"1.2.3.128", 27, "1.2.3.129", true},
+        {"7.8.9.0", 24, "7.8.9.12", true},
+        {"1.1.1.0", 24, "1.1.1.200", true},
+    };
+
+    char vdns_attr[] =
+        "<virtual-DNS-data>\
+            <domain-name>test.contrail.juniper.net</domain-name>\
+            <dynamic-records-from-client>true</dynamic-records-from-client>\
+            <record-order>fixed</record-order>\
+            <default-ttl-seconds>120</default-ttl-seconds>\
+        </virtual-DNS-data>\n";
+    char ipam_attr[] = "<network-ipam-mgmt>\n <ipam-dns-method>virtual-dns-server</ipam-dns-method>\n <ipam-dns-server><virtual-dns-server-name>vdns1</virtual-dns-server-name></ipam-dns-server>\n </network-ipam-mgmt>\n";
+
+    CreateVmportEnv(input, 1, 0);
+    client->WaitForIdle();
+    client->Reset();
+    IntfCfgAdd(input, 0);
+    WaitForItfUpdate(1);
+
+    AddVDNS("vdns1", vdns_attr);
+    client->WaitForIdle();
+    AddIPAM("vn1", ipam_info, 3, ipam_attr, "vdns1");
+    client->WaitForIdle();
+    DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
+    dns_proto->ClearStats();
+
+    DnsProto::DnsStats stats;
+    int count = 0;
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items);
+    g_xid++;
+    usleep(1000);
+    client->WaitForIdle();
+    SendDnsResp(2, a_items, 1, auth_items, 1, add_items);
+    CHECK_CONDITION(stats.resolved < 1);
+    CHECK_STATS(stats, 1, 1, 0, 0, 0, 0);
+    EXPECT_EQ(1U, stats.cache_misses);
+    EXPECT_EQ(1U, dns_proto->dns_cache()->size());
+
+    // no query is sent to the server for the same question
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items);
+    CHECK_CONDITION(stats.resolved < 2);
+    CHECK_STATS(stats, 2, 2, 0, 0, 0, 0);
+    EXPECT_EQ(1U, stats.cache_hits);
+
+    // NXDOMAIN responses are cached as well
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 4, ptr_items);
+    g_xid++;
+    usleep(1000);
+    client->WaitForIdle();
+    SendDnsResp(4, ptr_items, 1, auth_items, 1, add_items, true);
+    CHECK_CONDITION(stats.fail < 1);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 4, ptr_items);
+    CHECK_CONDITION(stats.fail < 2);
+    CHECK_STATS(stats, 4, 2, 0, 0, 2, 0);
+    EXPECT_EQ(2U, stats.cache_hits);
+    EXPECT_EQ(1U, stats.cache_negative_hits);
+
+    // record update from the VM flushes the virtual DNS entries
+    SendDnsReq(DNS_OPCODE_UPDATE, GetItfId(0), 1, a_items, default_flags, true);
+    CHECK_CONDITION(stats.resolved < 3);
+    EXPECT_EQ(0U, dns_proto->dns_cache()->size());
+
+    client->Reset();
+    DeleteVmportEnv(input, 1, 1, 0);
+    client->WaitForIdle();
+
+    IntfCfgDel(input, 0);
+    WaitForItfUpdate(0);
+    dns_proto->ClearStats();
+
+    client->Reset();
+    DelIPAM("vn1", "vdns1");
+    client->WaitForIdle();
+    DelVDNS("vdns1");
+    client->WaitForIdle();
+}
+
+// Identical questions from a VM, while the first one is waiting for the
+// DNS server, are answered from the response to the first one
+TEST_F(DnsTest, VirtualDnsCoalesceTest) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+    IpamInfo ipam_info[] = {
+        {"1.2.3.128", 27, "1.2.3.129", true},
+        {"7.8.9.0", 24, "7.8.9.12", true},
+        {"1.1.1.0", 24, "1.1.1.200", true},
+    };
+
+    char vdns_attr[] =
+        "<virtual-DNS-data>\
+            <domain-name>test.contrail.juniper.net</domain-name>\
+            <dynamic-records-from-client>true</dynamic-records-from-client>\
+            <record-order>fixed</record-order>\
+            <default-ttl-seconds>120</default-ttl-seconds>\
+        </virtual-DNS-data>\n";
+    char ipam_attr[] = "<network-ipam-mgmt>\n <ipam-dns-method>virtual-dns-server</ipam-dns-method>\n <ipam-dns-server><virtual-dns-server-name>vdns1</virtual-dns-server-name></ipam-dns-server>\n </network-ipam-mgmt>\n";
+
+    CreateVmportEnv(input, 1, 0);
+    client->WaitForIdle();
+    client->Reset();
+    IntfCfgAdd(input, 0);
+    WaitForItfUpdate(1);
+
+    AddVDNS("vdns1", vdns_attr);
+    client->WaitForIdle();
+    AddIPAM("vn1", ipam_info, 3, ipam_attr, "vdns1");
+    client->WaitForIdle();
+    DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
+    dns_proto->dns_cache()->Clear();
+    dns_proto->ClearStats();
+
+    DnsProto::DnsStats stats;
+    int count = 0;
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items, default_flags,
+               false, 0x0102);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items, default_flags,
+               false, 0x0103);
+    CHECK_CONDITION(stats.coalesced < 1);
+    EXPECT_EQ(2U, stats.cache_misses);
+    EXPECT_EQ(0U, stats.resolved);
+
+    // one response resolves both requests
+    g_xid++;
+    SendDnsResp(2, a_items, 1, auth_items, 1, add_items);
+    CHECK_CONDITION(stats.resolved < 2);
+    CHECK_STATS(stats, 2, 2, 0, 0, 0, 0);
+    EXPECT_EQ(1U, stats.coalesced);
+    EXPECT_EQ(1U, dns_proto->dns_cache()->size());
+
+    // a failure response fails the waiting request too
+    dns_proto->dns_cache()->Clear();
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items, default_flags,
+               false, 0x0104);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 2, a_items, default_flags,
+               false, 0x0105);
+    CHECK_CONDITION(stats.coalesced < 2);
+    g_xid++;
+    SendDnsResp(2, a_items, 1, auth_items, 1, add_items, true);
+    CHECK_CONDITION(stats.fail < 2);
+    CHECK_STATS(stats, 4, 2, 0, 0, 2, 0);
+
+    client->Reset();
+    DeleteVmportEnv(input, 1, 1, 0);
+    client->WaitForIdle();
+
+    IntfCfgDel(input, 0);
+    WaitForItfUpdate(0);
+    dns_proto->dns_cache()->Clear();
+    dns_proto->ClearStats();
+
+    client->Reset();
+    DelIPAM("vn1", "vdns1");
+    client->WaitForIdle();
+    DelVDNS("vdns1");
+    client->WaitForIdle();
+}
+
+// Requests waiting on a query that gets no response are dropped with it,
+// also when the interface of the VM is deleted in the meantime
+TEST_F(DnsTest, VirtualDnsCoalesceDropTest) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+    IpamInfo ipam_info[] = {
+        {"1.2.3.128", 27, "1.2.3.129", true},
+        {"7.8.9.0", 24, "7.8.9.12", true},
+        {"1.1.1.0", 24, "1.1.1.200", true},
+    };
+
+    char vdns_attr[] =
+        "<virtual-DNS-data>\
+            <domain-name>test.contrail.juniper.net</domain-name>\
+            <dynamic-records-from-client>true</dynamic-records-from-client>\
+            <record-order>fixed</record-order>\
+            <default-ttl-seconds>120</default-ttl-seconds>\
+        </virtual-DNS-data>\n";
+    char ipam_attr[] = "<network-ipam-mgmt>\n <ipam-dns-method>virtual-dns-server</ipam-dns-method>\n <ipam-dns-server><virtual-dns-server-name>vdns1</virtual-dns-server-name></ipam-dns-server>\n </network-ipam-mgmt>\n";
+
+    CreateVmportEnv(input, 1, 0);
+    client->WaitForIdle();
+    client->Reset();
+    IntfCfgAdd(input, 0);
+    WaitForItfUpdate(1);
+
+    AddVDNS("vdns1", vdns_attr);
+    client->WaitForIdle();
+    AddIPAM("vn1", ipam_info, 3, ipam_attr, "vdns1");
+    client->WaitForIdle();
+    DnsProto *dns_proto = Agent::GetInstance()->GetDnsProto();
+    dns_proto->dns_cache()->Clear();
+    dns_proto->ClearStats();
+
+    // retries run out
+    DnsProto::DnsStats stats;
+    int count = 0;
+    dns_proto->set_timeout(30);
+    dns_proto->set_max_retries(1);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items, default_flags,
+               false, 0x0102);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items, default_flags,
+               false, 0x0103);
+    g_xid++;
+    CHECK_CONDITION(stats.drop < 2);
+    CHECK_STATS(stats, 2, 0, 0, 0, 0, 2);
+    EXPECT_EQ(1U, stats.coalesced);
+
+    // the same question is sent to the server again
+    dns_proto->set_timeout(2000);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items, default_flags,
+               false, 0x0104);
+    SendDnsReq(DNS_OPCODE_QUERY, GetItfId(0), 1, a_items, default_flags,
+               false, 0x0105);
+    CHECK_CONDITION(stats.coalesced < 2);
+    EXPECT_EQ(4U, stats.cache_misses);
+
+    // interface deleted while its requests wait, retries run out later
+    dns_proto->set_timeout(30);
+    client->Reset();
+    DeleteVmportEnv(input, 1, 1, 0);
+    client->WaitForIdle();
+    IntfCfgDel(input, 0);
+    WaitForItfUpdate(0);
+    g_xid++;
+    CHECK_CONDITION(stats.drop < 4);
+    CHECK_STATS(stats, 4, 0, 0, 0, 0, 4);
+
+    dns_proto->set_timeout(2000);
+    dns_proto->set_max_retries(2);
+    dns_proto->ClearStats();
+
+    client->Reset();
+    DelIPAM("vn1", "vdns1");
+    client->WaitForIdle();
+    DelVDNS("vdns1");
+    client->WaitForIdle();
+}
+
 // Order the config such that Ipam gets updated last
 TEST_F(DnsTest, VirtualDnsIpamUpdateReqTest) {
     struct PortInfo input[] = {
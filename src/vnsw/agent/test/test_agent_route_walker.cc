@@ -62,6 +62,9 @@ public:
         walk_task_context_mismatch_ = false;
         route_table_walk_started_ = false;
         is_vrf_walk_done_ = false;
+        route_walk_limit_exceeded_ = false;
+        first_route_walk_done_vrf_ = VrfEntry::kInvalidIndex;
+        priority_vrf_name_ = "";
     };
     ~AgentRouteWalkerTest() { 
     }
@@ -166,15 +169,26 @@ public:
         //2.2.2.20/32; 255.255.255.255; 0:0:2:2:2:20; ff:ff:ff:ff:ff:ff
         route_notifications_++;
         route_table_walk_started_ = true;
+        if (max_route_walks() &&
+            (active_route_walk_count() > max_route_walks()))
+            route_walk_limit_exceeded_ = true;
         assert(AreAllWalksDone() == false);
         return true;
     }
 
     virtual void RouteWalkDone(DBTableBase *part) {
         total_rt_vrf_walk_done_++;
+        if (first_route_walk_done_vrf_ == VrfEntry::kInvalidIndex) {
+            first_route_walk_done_vrf_ =
+                static_cast<AgentRouteTable *>(part)->vrf_id();
+        }
         AgentRouteWalker::RouteWalkDone(part);
     }
 
+    virtual uint32_t RouteWalkPriority(const VrfEntry *vrf) const {
+        return (vrf->GetName() == priority_vrf_name_) ? 0 : 1;
+    }
+
     virtual bool VrfWalkNotify(DBTablePartBase *partition, DBEntryBase *e) {
         vrf_notifications_++;
         VrfEntry *vrf = static_cast<VrfEntry *>(e);
@@ -223,6 +237,9 @@ public:
     bool walk_task_context_mismatch_;
     bool route_table_walk_started_;
     bool is_vrf_walk_done_;
+    bool route_walk_limit_exceeded_;
+    uint32_t first_route_walk_done_vrf_;
+    std::string priority_vrf_name_;
     friend class SetupTask;
 };
 
@@ -298,6 +315,25 @@ TEST_F(AgentRouteWalkerTest, walk_all_routes_with_3_vrf) {
     DeleteEnvironment(3);
 }
 
+// Route walks of one VRF at a time, highest priority VRF first
+TEST_F(AgentRouteWalkerTest, walk_all_routes_with_3_vrf_limited) {
+    client->Reset();
+    SetupEnvironment(3);
+    set_max_route_walks(1);
+    priority_vrf_name_ = vrf_name_3_;
+    StartVrfWalk();
+    VerifyNotifications(35, 4, 1, ((Agent::ROUTE_TABLE_MAX - 1) * 4));
+    WAIT_FOR(100, 1000, IsWalkCompleted() == true);
+    EXPECT_TRUE(walk_task_context_mismatch_ == false);
+    EXPECT_FALSE(route_walk_limit_exceeded_);
+    EXPECT_EQ(0U, pending_route_walk_count());
+    EXPECT_EQ(VrfGet(vrf_name_3_.c_str())->vrf_id(),
+              first_route_walk_done_vrf_);
+    set_max_route_walks(0);
+    walk_task_context_mismatch_ = true;
+    DeleteEnvironment(3);
+}
+
 TEST_F(AgentRouteWalkerTest, restart_walk_with_2_vrf) {
     client->Reset();
     SetupEnvironment(2);
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <string>
+#include <base/logging.h>
+#include <boost/bind.hpp>
+#include "io/test/event_manager_test.h"
+#include <net/bgp_af.h>
+
+#include <cmn/agent_cmn.h>
+#include "base/test/task_test_util.h"
+
+#include "init/agent_param.h"
+#include "oper/operdb_init.h"
+#include "test_cmn_util.h"
+#include "xmpp/xmpp_init.h"
+#include "xmpp/test/xmpp_test_util.h"
+#include "vr_types.h"
+
+#include "xml/xml_pugi.h"
+
+#include "controller/controller_peer.h"
+#include "controller/controller_export.h"
+#include "controller/controller_types.h"
+
+using namespace pugi;
+
+void RouterIdDepInit(Agent *agent) {
+}
+
+class AgentBgpXmppPeerTest : public AgentXmppChannel {
+public:
+    AgentBgpXmppPeerTest(std::string xs, uint8_t xs_idx) :
+        AgentXmppChannel(Agent::GetInstance(), xs, "0", xs_idx),
+        rx_channel_event_queue_(
+            TaskScheduler::GetInstance()->GetTaskId("xmpp::StateMachine"), 0,
+            boost::bind(&AgentBgpXmppPeerTest::ProcessChannelEvent, this, _1)) {
+    }
+
+    bool ProcessChannelEvent(xmps::PeerState state) {
+        AgentXmppChannel::HandleAgentXmppClientChannelEvent(
+            static_cast<AgentXmppChannel *>(this), state);
+        return true;
+    }
+
+    void HandleXmppChannelEvent(xmps::PeerState state) {
+        rx_channel_event_queue_.Enqueue(state);
+    }
+
+    virtual ~AgentBgpXmppPeerTest() { }
+
+private:
+    WorkQueue<xmps::PeerState> rx_channel_event_queue_;
+};
+
+// Counts the publish messages and their route items received by the control
+// node
+class ControlNodeMockBgpXmppPeer {
+public:
+    ControlNodeMockBgpXmppPeer()
+        : channel_(NULL), publish_count_(0), item_count_(0),
+          max_publish_items_(0) {
+    }
+
+    void ReceiveUpdate(const XmppStanza::XmppMessage *msg) {
+        if (msg->type != XmppStanza::IQ_STANZA)
+            return;
+        const XmppStanza::XmppMessageIq *iq =
+            static_cast<const XmppStanza::XmppMessageIq *>(msg);
+        if (iq->action.compare("publish") != 0)
+            return;
+
+        XmlPugi *pugi = reinterpret_cast<XmlPugi *>(msg->dom.get());
+        size_t items = 0;
+        for (xml_node item = pugi->FindNode("item"); item;
+             item = item.next_sibling()) {
+            if (strcmp(item.name(), "item") == 0)
+                items++;
+        }
+        tbb::mutex::scoped_lock lock(mutex_);
+        publish_count_++;
+        item_count_ += items;
+        if (items > max_publish_items_)
+            max_publish_items_ = items;
+    }
+
+    void HandleXmppChannelEvent(XmppChannel *channel,
+                                xmps::PeerState state) {
+        if (!channel_ && state == xmps::NOT_READY) {
+            return;
+        }
+        if (state != xmps::READY) {
+            assert(channel_ && channel == channel_);
+            channel->UnRegisterReceive(xmps::BGP);
+            channel_ = NULL;
+        } else {
+            if (channel_) {
+                assert(channel == channel_);
+            }
+            channel->RegisterReceive(xmps::BGP,
+                    boost::bind(&ControlNodeMockBgpXmppPeer::ReceiveUpdate,
+                                this, _1));
+            channel_ = channel;
+        }
+    }
+
+    size_t publish_count() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return publish_count_;
+    }
+    size_t item_count() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return item_count_;
+    }
+    size_t max_publish_items() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        return max_publish_items_;
+    }
+    void ResetMaxPublishItems() {
+        tbb::mutex::scoped_lock lock(mutex_);
+        max_publish_items_ = 0;
+    }
+
+private:
+    XmppChannel *channel_;
+    tbb::mutex mutex_;
+    size_t publish_count_;
+    size_t item_count_;
+    size_t max_publish_items_;
+};
+
+class AgentXmppExportBatchTest : public ::testing::Test {
+protected:
+    AgentXmppExportBatchTest()
+        : thread_(&evm_), agent_(Agent::GetInstance()) {
+    }
+
+    virtual void SetUp() {
+        //TestInit initilaizes the controller and xmpp, so disconnect that
+        //and again spawn a new one, with the receive path overridden by the
+        //mock class.
+        agent_->controller()->Cleanup();
+        client->WaitForIdle();
+        agent_->controller()->DisConnect();
+        client->WaitForIdle();
+
+        xs = new XmppServer(&evm_, XmppInit::kControlNodeJID);
+        xc = new XmppClient(&evm_);
+        agent_->set_controller_ifmap_xmpp_server("127.0.0.1", 0);
+        xmpp_init = new XmppInit();
+
+        xs->Initialize(0, false);
+
+        thread_.Start();
+        client->WaitForIdle();
+    }
+
+    virtual void TearDown() {
+        DeleteVmportEnv(input_, 1, true);
+        client->WaitForIdle();
+
+        xs->Shutdown();
+        bgp_peer.reset();
+        client->WaitForIdle();
+        agent_->set_controller_xmpp_channel(NULL, 0);
+        agent_->set_controller_ifmap_xmpp_client(NULL, 0);
+        agent_->set_controller_ifmap_xmpp_init(NULL, 0);
+        xc->Shutdown();
+        client->WaitForIdle();
+
+        ShutdownAgentController(agent_);
+        client->WaitForIdle();
+        TcpServerManager::DeleteServer(xs);
+        TcpServerManager::DeleteServer(xc);
+        delete xmpp_init;
+        evm_.Shutdown();
+        thread_.Join();
+        client->WaitForIdle();
+        agent_->params()->set_route_export_batch(0);
+    }
+
+    XmppChannelConfig *CreateXmppChannelCfg(const char *address, int port,
+                                            const string &from,
+                                            const string &to,
+                                            bool isclient) {
+        XmppChannelConfig *cfg = new XmppChannelConfig(isclient);
+        cfg->endpoint.address(boost::asio::ip::address::from_string(address));
+        cfg->endpoint.port(port);
+        cfg->ToAddr = to;
+        cfg->FromAddr = from;
+        return cfg;
+    }
+
+    // Connects an agent peer exporting routes in batches of batch items and
+    // creates the vm port whose route is exported
+    void XmppConnectionSetUp(uint16_t batch) {
+        agent_->params()->set_route_export_batch(batch);
+        agent_->controller()->increment_multicast_sequence_number();
+        agent_->set_cn_mcast_builder(NULL);
+
+        mock_peer.reset(new ControlNodeMockBgpXmppPeer());
+        xs->RegisterConnectionEvent(xmps::BGP,
+            boost::bind(&ControlNodeMockBgpXmppPeer::HandleXmppChannelEvent,
+                        mock_peer.get(), _1, _2));
+
+        xmppc_cfg = new XmppConfigData;
+        xmppc_cfg->AddXmppChannelConfig(CreateXmppChannelCfg("127.0.0.1",
+            xs->GetPort(), XmppInit::kAgentNodeJID,
+            XmppInit::kControlNodeJID, true));
+        xc->ConfigUpdate(xmppc_cfg);
+
+        cchannel = xc->FindChannel(XmppInit::kControlNodeJID);
+        bgp_peer.reset(new AgentBgpXmppPeerTest(
+            agent_->controller_ifmap_xmpp_server(0), 0));
+        bgp_peer->RegisterXmppChannel(cchannel);
+        xc->RegisterConnectionEvent(xmps::BGP,
+            boost::bind(&AgentBgpXmppPeerTest::HandleXmppChannelEvent,
+                        bgp_peer.get(), _2));
+        agent_->set_controller_xmpp_channel(bgp_peer.get(), 0);
+        agent_->set_controller_ifmap_xmpp_client(xc, 0);
+        agent_->set_controller_ifmap_xmpp_init(xmpp_init, 0);
+
+        WAIT_FOR(1000, 10000,
+            ((sconnection = xs->FindConnection(XmppInit::kAgentNodeJID))
+             != NULL));
+        WAIT_FOR(1000, 10000,
+                 (sconnection->GetStateMcState() == xmsm::ESTABLISHED));
+        WAIT_FOR(1000, 10000, (cchannel->GetPeerState() == xmps::READY));
+
+        CreateVmportEnv(input_, 1);
+        client->WaitForIdle();
+        Ip4Address addr = Ip4Address::from_string("1.1.1.1");
+        WAIT_FOR(1000, 10000, (RouteGet("vrf1", addr, 32) != NULL));
+        route_ = RouteGet("vrf1", addr, 32);
+
+        // Let the exports triggered by the vm port reach the control node
+        WAIT_FOR(1000, 10000, (mock_peer->item_count() > 0));
+        client->WaitForIdle();
+        TASK_UTIL_EXPECT_EQ(0, bgp_peer->route_export_count());
+        mock_peer->ResetMaxPublishItems();
+    }
+
+    void ExportRoute(size_t count) {
+        for (size_t idx = 0; idx < count; idx++) {
+            AgentXmppChannel::ControllerSendRouteAdd(bgp_peer.get(), route_,
+                NULL, "vn1", route_->GetActiveLabel(), TunnelType::AllType(),
+                NULL, Agent::INET4_UNICAST, PathPreference());
+        }
+    }
+
+    static struct PortInfo input_[];
+
+    EventManager evm_;
+    ServerThread thread_;
+    XmppConfigData *xmppc_cfg;
+    XmppServer *xs;
+    XmppClient *xc;
+    XmppInit *xmpp_init;
+    XmppConnection *sconnection;
+    XmppChannel *cchannel;
+    auto_ptr<AgentBgpXmppPeerTest> bgp_peer;
+    auto_ptr<ControlNodeMockBgpXmppPeer> mock_peer;
+    Agent *agent_;
+    InetUnicastRouteEntry *route_;
+};
+
+struct PortInfo AgentXmppExportBatchTest::input_[] = {
+    {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+};
+
+namespace {
+
+// Full batches are sent as one publish carrying all of their items
+TEST_F(AgentXmppExportBatchTest, MultiItemPublish) {
+    XmppConnectionSetUp(4);
+    size_t publish_count = mock_peer->publish_count();
+    size_t item_count = mock_peer->item_count();
+
+    ExportRoute(8);
+    TASK_UTIL_EXPECT_EQ(item_count + 8, mock_peer->item_count());
+    EXPECT_EQ(publish_count + 2, mock_peer->publish_count());
+    EXPECT_EQ(4, mock_peer->max_publish_items());
+    EXPECT_EQ(0, bgp_peer->route_export_count());
+}
+
+// A partial batch is held back and sent by the export timer
+TEST_F(AgentXmppExportBatchTest, TimerFlush) {
+    XmppConnectionSetUp(4);
+    size_t publish_count = mock_peer->publish_count();
+    size_t item_count = mock_peer->item_count();
+
+    ExportRoute(3);
+    TASK_UTIL_EXPECT_EQ(item_count + 3, mock_peer->item_count());
+    EXPECT_EQ(publish_count + 1, mock_peer->publish_count());
+    EXPECT_EQ(3, mock_peer->max_publish_items());
+    EXPECT_EQ(0, bgp_peer->route_export_count());
+}
+
+// A batch is sent once its items reach the byte budget, well before the
+// item limit
+TEST_F(AgentXmppExportBatchTest, ByteBudget) {
+    XmppConnectionSetUp(1000);
+    size_t publish_count = mock_peer->publish_count();
+    size_t item_count = mock_peer->item_count();
+
+    ExportRoute(200);
+    TASK_UTIL_EXPECT_EQ(item_count + 200, mock_peer->item_count());
+    EXPECT_LT(publish_count + 1, mock_peer->publish_count());
+    EXPECT_GT(200, mock_peer->max_publish_items());
+    EXPECT_EQ(0, bgp_peer->route_export_count());
+}
+
+// A pending batch is dropped when the channel goes down, its routes are
+// exported again when the channel comes back up
+TEST_F(AgentXmppExportBatchTest, ChannelDown) {
+    XmppConnectionSetUp(4);
+    size_t item_count = mock_peer->item_count();
+
+    TaskScheduler::GetInstance()->Stop();
+    ExportRoute(2);
+    EXPECT_EQ(2, bgp_peer->route_export_count());
+    AgentXmppChannel::HandleAgentXmppClientChannelEvent(bgp_peer.get(),
+                                                        xmps::NOT_READY);
+    EXPECT_EQ(0, bgp_peer->route_export_count());
+    TaskScheduler::GetInstance()->Start();
+
+    client->WaitForIdle();
+    usleep(100000);
+    client->WaitForIdle();
+    EXPECT_EQ(item_count, mock_peer->item_count());
+}
+
+}
+
+int main(int argc, char **argv) {
+    GETUSERARGS();
+    client = TestInit(init_file, ksync_init);
+    Agent::GetInstance()->set_controller_ifmap_xmpp_server("127.0.0.1", 0);
+    Agent::GetInstance()->SetAgentMcastLabelRange(0);
+
+    LoggingInit();
+    Sandesh::SetLocalLogging(true);
+    Sandesh::SetLoggingLevel(SandeshLevel::UT_DEBUG);
+
+    Agent::GetInstance()->set_headless_agent_mode(false);
+    int ret = RUN_ALL_TESTS();
+
+    Agent::GetInstance()->event_manager()->Shutdown();
+    TestShutdown();
+    delete client;
+    return ret;
+}
@@ -14,6 +14,7 @@
 #include <uve/agent_uve_base.h>
 #include <uve/vn_uve_table_base.h>
 #include <uve/stats_interval_types.h>
+#include <uve/uve_send_stats_types.h>
 #include <init/agent_param.h>
 #include <oper/mirror_table.h>
 #include <uve/vrouter_stats_collector.h>
@@ -203,3 +204,19 @@ void AgentUveBase::RegisterDBClients() {
     interface_uve_table_.get()->RegisterDBClients();
 }
 
+
+void AgentUveSendStatsReq::HandleRequest() const {
+    AgentUveSendStatsResp *resp = new AgentUveSendStatsResp();
+    std::vector<UveTableSendStats> list;
+    AgentUveBase *uve = AgentUveBase::GetInstance();
+    if (uve) {
+        UveTableSendStats stats;
+        uve->interface_uve_table()->send_budget().FillStats(&stats);
+        list.push_back(stats);
+        uve->vn_uve_table()->send_budget().FillStats(&stats);
+        list.push_back(stats);
+    }
+    resp->set_tables(list);
+    resp->set_context(context());
+    resp->Response();
+}
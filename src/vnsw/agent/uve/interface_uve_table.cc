@@ -13,7 +13,8 @@ InterfaceUveTable::InterfaceUveTable(Agent *agent, uint32_t default_intvl)
       timer_(TimerManager::CreateTimer
              (*(agent->event_manager())->io_service(),
               "InterfaceUveTimer",
-              TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0)) {
+              TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0)),
+      send_budget_("InterfaceUveTable", AgentUveBase::kUveCountPerTimer) {
       expiry_time_ = default_intvl;
       timer_->Start(expiry_time_,
                     boost::bind(&InterfaceUveTable::TimerExpiry, this));
@@ -29,16 +30,17 @@ bool InterfaceUveTable::TimerExpiry() {
         return true;
     }
 
+    /* Only the UVEs sent are counted against the budget */
+    send_budget_.RunStart(timer_last_visited_.empty());
     uint32_t count = 0;
-    while (it != interface_tree_.end() &&
-           count < AgentUveBase::kUveCountPerTimer) {
+    while (it != interface_tree_.end() && !send_budget_.Exhausted(count)) {
         string cfg_name = it->first;
         UveInterfaceEntry* entry = it->second.get();
         InterfaceMap::iterator prev = it;
         it++;
-        count++;
 
         if (entry->deleted_) {
+            count++;
             SendInterfaceDeleteMsg(cfg_name);
             if (!entry->renewed_) {
                 interface_tree_.erase(prev);
@@ -49,12 +51,14 @@ bool InterfaceUveTable::TimerExpiry() {
                 SendInterfaceMsg(cfg_name, entry);
             }
         } else if (entry->changed_) {
+            count++;
             SendInterfaceMsg(cfg_name, entry);
             entry->changed_ = false;
             /* Clear renew flag to be on safer side. Not really required */
             entry->renewed_ = false;
         }
     }
+    send_budget_.RunEnd(count, it == interface_tree_.end());
 
     if (it == interface_tree_.end()) {
         timer_last_visited_ = "";
@@ -150,10 +154,62 @@ void InterfaceUveTable::UveInterfaceEntry::Reset() {
     prev_fip_tree_.clear();
     fip_tree_.clear();
 
+    /* The UVE is deleted, a renewed interface sends all its attributes */
+    uve_sent_ = UveVMInterfaceAgent();
+
     deleted_ = true;
     renewed_ = false;
 }
 
+/* Frames the UVE with the attributes that changed since the last UVE sent.
+ * Returns false when none of the attributes changed */
+bool InterfaceUveTable::UveInterfaceEntry::FrameInterfaceDeltaMsg
+    (const string &name, UveVMInterfaceAgent *s_intf) {
+    UveVMInterfaceAgent uve;
+    if (!FrameInterfaceMsg(name, &uve)) {
+        return false;
+    }
+
+    bool changed = false;
+    if (uve.get_name() != uve_sent_.get_name() ||
+        uve.get_virtual_network() != uve_sent_.get_virtual_network() ||
+        uve.get_vm_name() != uve_sent_.get_vm_name() ||
+        uve.get_vm_uuid() != uve_sent_.get_vm_uuid()) {
+        changed = true;
+    }
+    /* name, virtual_network, vm_name and vm_uuid are sent always */
+    s_intf->set_name(uve.get_name());
+    s_intf->set_virtual_network(uve.get_virtual_network());
+    s_intf->set_vm_name(uve.get_vm_name());
+    s_intf->set_vm_uuid(uve.get_vm_uuid());
+    uve_sent_.set_name(uve.get_name());
+    uve_sent_.set_virtual_network(uve.get_virtual_network());
+    uve_sent_.set_vm_name(uve.get_vm_name());
+    uve_sent_.set_vm_uuid(uve.get_vm_uuid());
+
+#define UVE_INTF_DELTA_FIELD(field)                                         \
+    if (uve.__isset.field && (!uve_sent_.__isset.field ||                   \
+        uve.get_##field() != uve_sent_.get_##field())) {                    \
+        s_intf->set_##field(uve.get_##field());                             \
+        uve_sent_.set_##field(uve.get_##field());                           \
+        changed = true;                                                     \
+    }
+
+    UVE_INTF_DELTA_FIELD(ip_address)
+    UVE_INTF_DELTA_FIELD(mac_address)
+    UVE_INTF_DELTA_FIELD(ip6_address)
+    UVE_INTF_DELTA_FIELD(ip6_active)
+    UVE_INTF_DELTA_FIELD(floating_ips)
+    UVE_INTF_DELTA_FIELD(label)
+    UVE_INTF_DELTA_FIELD(active)
+    UVE_INTF_DELTA_FIELD(l2_active)
+    UVE_INTF_DELTA_FIELD(uuid)
+    UVE_INTF_DELTA_FIELD(gateway)
+#undef UVE_INTF_DELTA_FIELD
+
+    return changed;
+}
+
 bool InterfaceUveTable::UveInterfaceEntry::FipAggStatsChanged
     (const vector<VmFloatingIPStats>  &list) const {
     if (list != uve_info_.get_fip_agg_stats()) {
@@ -202,7 +258,7 @@ void InterfaceUveTable::DispatchInterfaceMsg(const UveVMInterfaceAgent &uve) {
 void InterfaceUveTable::SendInterfaceMsg(const string &name,
                                          UveInterfaceEntry *entry) {
     UveVMInterfaceAgent uve;
-    if (entry->FrameInterfaceMsg(name, &uve)) {
+    if (entry->FrameInterfaceDeltaMsg(name, &uve)) {
         DispatchInterfaceMsg(uve);
     }
 }
@@ -16,6 +16,7 @@
 #include <sandesh/sandesh.h>
 #include <interface_types.h>
 #include <uve/l4_port_bitmap.h>
+#include <uve/uve_send_budget.h>
 #include <oper/vm.h>
 #include <oper/peer.h>
 #include <cmn/index_vector.h>
@@ -96,13 +97,15 @@ public:
         bool deleted_;
         bool renewed_;
         UveVMInterfaceAgent uve_info_;
+        /* Attributes sent in the last UVE, used to send only the changes */
+        UveVMInterfaceAgent uve_sent_;
         /* For exclusion between Agent::StatsCollector and Agent::Uve tasks */
         tbb::mutex mutex_;
 
         UveInterfaceEntry(const VmInterface *i) : intf_(i),
             uuid_(i->GetUuid()), port_bitmap_(),
             fip_tree_(), prev_fip_tree_(), changed_(true), deleted_(false),
-            renewed_(false), uve_info_() { }
+            renewed_(false), uve_info_(), uve_sent_() { }
         virtual ~UveInterfaceEntry() {}
         void UpdateFloatingIpStats(const FipInfo &fip_info);
         bool FillFloatingIpStats(vector<VmFloatingIPStats> &result,
@@ -116,6 +119,8 @@ public:
                                                 const std::string &vn);
         bool FrameInterfaceMsg(const std::string &name,
                                UveVMInterfaceAgent *s_intf) const;
+        bool FrameInterfaceDeltaMsg(const std::string &name,
+                                    UveVMInterfaceAgent *s_intf);
         bool GetVmInterfaceGateway(const VmInterface *vm_intf,
                                    std::string &gw) const;
         bool FipAggStatsChanged(const vector<VmFloatingIPStats>  &list) const;
@@ -133,6 +138,7 @@ public:
     void Shutdown(void);
     virtual void DispatchInterfaceMsg(const UveVMInterfaceAgent &uve);
     bool TimerExpiry();
+    const UveSendBudget &send_budget() const { return send_budget_; }
 
 protected:
     void SendInterfaceDeleteMsg(const std::string &config_name);
@@ -153,6 +159,7 @@ private:
     std::string timer_last_visited_;
     Timer *timer_;
     int expiry_time_;
+    UveSendBudget send_budget_;
     DISALLOW_COPY_AND_ASSIGN(InterfaceUveTable);
 };
 
@@ -14,52 +14,41 @@ StatsManager::~StatsManager() {
 }
 
 void StatsManager::AddInterfaceStatsEntry(const Interface *intf) {
-    InterfaceStatsTree::iterator it;
-    it = if_stats_tree_.find(intf);
-    if (it == if_stats_tree_.end()) {
-        InterfaceStats stats;
-        stats.name = intf->name();
-        if_stats_tree_.insert(InterfaceStatsPair(intf, stats));
+    if (intf->id() == Interface::kInvalidIndex) {
+        return;
+    }
+    bool added;
+    InterfaceStats *stats = if_stats_.Locate(intf->id(), &added);
+    if (added) {
+        stats->name = intf->name();
     }
 }
 
 void StatsManager::DelInterfaceStatsEntry(const Interface *intf) {
-    InterfaceStatsTree::iterator it;
-    it = if_stats_tree_.find(intf);
-    if (it != if_stats_tree_.end()) {
-        if_stats_tree_.erase(it);
-    }
+    if_stats_.Remove(intf->id());
 }
 
 void StatsManager::AddNamelessVrfStatsEntry() {
-    VrfStats stats;
-    stats.name = GetNamelessVrf();
-    vrf_stats_tree_.insert(VrfStatsPair(GetNamelessVrfId(), stats));
+    nameless_vrf_stats_.name = GetNamelessVrf();
 }
 
 void StatsManager::AddUpdateVrfStatsEntry(const VrfEntry *vrf) {
-    StatsManager::VrfIdToVrfStatsTree::iterator it;
-    it = vrf_stats_tree_.find(vrf->vrf_id());
-    if (it == vrf_stats_tree_.end()) {
-        VrfStats stats;
-        stats.name = vrf->GetName();
-        vrf_stats_tree_.insert(VrfStatsPair(vrf->vrf_id(), stats));
-    } else {
-        /* Vrf could be deleted in agent oper DB but not in Kernel. To handle
-         * this case we maintain vrfstats object in StatsManager even
-         * when vrf is absent in agent oper DB.  Since vrf could get deleted and
-         * re-added we need to update the name in vrfstats object.
-         */
-        VrfStats *stats = &it->second;
-        stats->name = vrf->GetName();
+    if (vrf->vrf_id() == VrfEntry::kInvalidIndex) {
+        return;
     }
+    bool added;
+    VrfStats *stats = vrf_stats_.Locate(vrf->vrf_id(), &added);
+    /* Vrf could be deleted in agent oper DB but not in Kernel. To handle
+     * this case we maintain vrfstats object in StatsManager even
+     * when vrf is absent in agent oper DB.  Since vrf could get deleted and
+     * re-added we need to update the name in vrfstats object.
+     */
+    stats->name = vrf->GetName();
 }
 
 void StatsManager::DelVrfStatsEntry(const VrfEntry *vrf) {
-    StatsManager::VrfIdToVrfStatsTree::iterator it;
-    it = vrf_stats_tree_.find(vrf->vrf_id());
-    if (it != vrf_stats_tree_.end()) {
-        VrfStats *stats = &it->second;
+    VrfStats *stats = vrf_stats_.Find(vrf->vrf_id());
+    if (stats != NULL) {
         stats->prev_discards = stats->k_discards;
         stats->prev_resolves = stats->k_resolves;
         stats->prev_receives = stats->k_receives;
@@ -78,24 +67,25 @@ void StatsManager::DelVrfStatsEntry(const VrfEntry *vrf) {
 
 StatsManager::InterfaceStats *StatsManager::GetInterfaceStats
     (const Interface *intf) {
-    StatsManager::InterfaceStatsTree::iterator it;
-
-    it = if_stats_tree_.find(intf);
-    if (it == if_stats_tree_.end()) {
+    if (intf == NULL) {
         return NULL;
     }
+    return if_stats_.Find(intf->id());
+}
 
-    return &it->second;
+StatsManager::InterfaceStats *StatsManager::GetInterfaceStats
+    (uint32_t intf_id) {
+    return if_stats_.Find(intf_id);
 }
 
 StatsManager::VrfStats *StatsManager::GetVrfStats(int vrf_id) {
-    StatsManager::VrfIdToVrfStatsTree::iterator it;
-    it = vrf_stats_tree_.find(vrf_id);
-    if (it == vrf_stats_tree_.end()) {
+    if (vrf_id == GetNamelessVrfId()) {
+        return &nameless_vrf_stats_;
+    }
+    if (vrf_id < 0) {
         return NULL;
     }
-
-    return &it->second;
+    return vrf_stats_.Find(vrf_id);
 }
 
 void StatsManager::InterfaceNotify(DBTablePartBase *part, DBEntryBase *e) {
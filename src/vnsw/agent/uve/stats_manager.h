@@ -10,8 +10,8 @@
 #include <oper/interface.h>
 #include <vrouter_types.h>
 #include <string>
-#include <map>
-#include <utility>
+#include <deque>
+#include <vector>
 
 // The container class for storing stats queried from vrouter
 // Defines routines for storing and managing (add, delete and query)
@@ -87,10 +87,40 @@ class StatsManager {
         uint64_t k_l2_encaps;
     };
 
-    typedef std::map<const Interface *, InterfaceStats> InterfaceStatsTree;
-    typedef std::pair<const Interface *, InterfaceStats> InterfaceStatsPair;
-    typedef std::map<int, VrfStats> VrfIdToVrfStatsTree;
-    typedef std::pair<int, VrfStats> VrfStatsPair;
+    // Stats entries addressed by the index of the object in vrouter, so that
+    // the stats dumped from vrouter are stored without a lookup. Entries are
+    // kept in a deque so that growing the array does not move them.
+    template <typename T>
+    class StatsArray {
+    public:
+        StatsArray() : entries_(), valid_() { }
+        T *Find(size_t index) {
+            if (index >= entries_.size() || !valid_[index])
+                return NULL;
+            return &entries_[index];
+        }
+        T *Locate(size_t index, bool *added) {
+            if (index >= entries_.size()) {
+                entries_.resize(index + 1);
+                valid_.resize(index + 1, false);
+            }
+            *added = !valid_[index];
+            valid_[index] = true;
+            return &entries_[index];
+        }
+        void Remove(size_t index) {
+            if (index >= entries_.size() || !valid_[index])
+                return;
+            entries_[index] = T();
+            valid_[index] = false;
+        }
+        size_t size() const { return entries_.size(); }
+    private:
+        std::deque<T> entries_;
+        std::vector<bool> valid_;
+    };
+    typedef StatsArray<InterfaceStats> InterfaceStatsArray;
+    typedef StatsArray<VrfStats> VrfStatsArray;
 
     explicit StatsManager(Agent *agent);
     virtual ~StatsManager();
@@ -98,6 +128,7 @@ class StatsManager {
     AgentDropStats drop_stats() const { return drop_stats_; }
     void set_drop_stats(const AgentDropStats &req) { drop_stats_ = req; }
     InterfaceStats* GetInterfaceStats(const Interface *intf);
+    InterfaceStats* GetInterfaceStats(uint32_t intf_id);
     VrfStats* GetVrfStats(int vrf_id);
     std::string GetNamelessVrf() { return "__untitled__"; }
     int GetNamelessVrfId() { return -1; }
@@ -114,8 +145,9 @@ class StatsManager {
     void AddUpdateVrfStatsEntry(const VrfEntry *intf);
     void DelVrfStatsEntry(const VrfEntry *intf);
 
-    VrfIdToVrfStatsTree vrf_stats_tree_;
-    InterfaceStatsTree if_stats_tree_;
+    VrfStatsArray vrf_stats_;
+    VrfStats nameless_vrf_stats_;
+    InterfaceStatsArray if_stats_;
     AgentDropStats drop_stats_;
     DBTableBase::ListenerId vrf_listener_id_;
     DBTableBase::ListenerId intf_listener_id_;
@@ -102,9 +102,5 @@ void AgentStatsCollectorTest::Test_DeleteVrfStatsEntry(int vrf_id) {
     AgentUveStats *uve = static_cast<AgentUveStats *>
         (Agent::GetInstance()->uve());
     StatsManager *sm = uve->stats_manager();
-    StatsManager::VrfIdToVrfStatsTree::iterator it;
-    it = sm->vrf_stats_tree_.find(vrf_id);
-    if (it != sm->vrf_stats_tree_.end()) {
-        sm->vrf_stats_tree_.erase(it);
-    }
+    sm->vrf_stats_.Remove(vrf_id);
 }
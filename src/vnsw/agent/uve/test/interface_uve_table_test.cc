@@ -47,6 +47,13 @@ UveVMInterfaceAgent* InterfaceUveTableTest::InterfaceUveObject
     return NULL;
 }
 
+void InterfaceUveTableTest::MarkChanged(const VmInterface *itf) {
+    InterfaceMap::iterator it = interface_tree_.find(itf->cfg_name());
+    if (it != interface_tree_.end()) {
+        it->second.get()->changed_ = true;
+    }
+}
+
 uint32_t InterfaceUveTableTest::GetVmIntfFipCount(const VmInterface* itf) {
     InterfaceMap::iterator it = interface_tree_.find(itf->cfg_name());
     if (it != interface_tree_.end()) {
@@ -21,6 +21,7 @@ public:
     const InterfaceUveTable::FloatingIp *GetVmIntfFip(const VmInterface* intf,
         const string &fip, const string &vn);
     const UveVMInterfaceAgent &last_sent_uve() const { return uve_; }
+    void MarkChanged(const VmInterface *itf);
 private:
     uint32_t send_count_;
     uint32_t delete_count_;
@@ -914,6 +914,60 @@ TEST_F(InterfaceUveTest, VmNameInInterfaceList) {
     vmut->ClearCount();
 }
 
+/* Verify that an interface UVE is not sent when none of its attributes
+ * changed since the last UVE sent */
+TEST_F(InterfaceUveTest, VmIntfDeltaUve) {
+    struct PortInfo input[] = {
+        {"vnet1", 1, "1.1.1.1", "00:00:00:01:01:01", 1, 1},
+    };
+
+    InterfaceUveTableTest *vmut = static_cast<InterfaceUveTableTest *>
+        (Agent::GetInstance()->uve()->interface_uve_table());
+    vmut->ClearCount();
+    EXPECT_EQ(0U, vmut->InterfaceUveCount());
+
+    util_.VnAdd(input[0].vn_id);
+    util_.NovaPortAdd(input);
+    util_.ConfigPortAdd(input);
+    util_.VmAdd(input[0].vm_id);
+    client->WaitForIdle();
+
+    util_.EnqueueSendVmiUveTask();
+    client->WaitForIdle();
+
+    //Verify that the first UVE carries all the attributes
+    EXPECT_EQ(1U, vmut->send_count());
+    UveVMInterfaceAgent uve1 = vmut->last_sent_uve();
+    EXPECT_TRUE(uve1.__isset.mac_address);
+    EXPECT_TRUE(uve1.__isset.ip_address);
+    EXPECT_TRUE(uve1.__isset.uuid);
+
+    //Verify that no UVE is sent when nothing changed
+    const VmInterface *vmi = VmInterfaceGet(input[0].intf_id);
+    EXPECT_TRUE(vmi != NULL);
+    vmut->MarkChanged(vmi);
+    util_.EnqueueSendVmiUveTask();
+    client->WaitForIdle();
+    EXPECT_EQ(1U, vmut->send_count());
+
+    //cleanup
+    util_.VnDelete(input[0].vn_id);
+    DelNode("virtual-machine", "vm1");
+    DelNode("virtual-network", "vn1");
+    DelNode("virtual-machine-interface", "vnet1");
+    client->WaitForIdle();
+    IntfCfgDel(input, 0);
+    client->WaitForIdle();
+
+    util_.EnqueueSendVmiUveTask();
+    client->WaitForIdle();
+    WAIT_FOR(1000, 500, ((vmut->InterfaceUveCount() == 0U)));
+
+    //clear counters at the end of test case
+    client->Reset();
+    vmut->ClearCount();
+}
+
 TEST_F(InterfaceUveTest, PhysicalIntfAddDel_1) {
 }
 
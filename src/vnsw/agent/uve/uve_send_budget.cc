@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#include <algorithm>
+#include <base/time_util.h>
+#include <uve/uve_send_budget.h>
+
+UveSendBudget::UveSendBudget(const std::string &name, uint32_t min_count)
+    : name_(name), min_count_(min_count), count_(min_count),
+      run_start_usec_(0), pass_start_usec_(0), runs_(0), uves_sent_(0),
+      last_run_usec_(0), max_run_usec_(0), total_run_usec_(0),
+      last_pass_usec_(0), max_pass_usec_(0) {
+}
+
+UveSendBudget::~UveSendBudget() {
+}
+
+void UveSendBudget::RunStart(bool pass_start) {
+    run_start_usec_ = ClockMonotonicUsec();
+    if (pass_start) {
+        pass_start_usec_ = run_start_usec_;
+    }
+}
+
+bool UveSendBudget::Exhausted(uint32_t sent) const {
+    if (sent >= count_)
+        return true;
+    return (ClockMonotonicUsec() - run_start_usec_) >= kRunTimeUsec;
+}
+
+void UveSendBudget::RunEnd(uint32_t sent, bool pass_done) {
+    uint64_t now = ClockMonotonicUsec();
+    last_run_usec_ = now - run_start_usec_;
+    if (last_run_usec_ > max_run_usec_)
+        max_run_usec_ = last_run_usec_;
+    total_run_usec_ += last_run_usec_;
+    runs_++;
+    uves_sent_ += sent;
+
+    if (last_run_usec_ > kRunTimeUsec) {
+        if (count_ > min_count_)
+            count_ = std::max(count_ / 2, min_count_);
+    } else if (!pass_done && sent >= count_ &&
+               last_run_usec_ < kRunTimeUsec / 2) {
+        count_ *= 2;
+        if (count_ > kMaxCount)
+            count_ = kMaxCount;
+    }
+
+    if (pass_done && pass_start_usec_) {
+        last_pass_usec_ = now - pass_start_usec_;
+        if (last_pass_usec_ > max_pass_usec_)
+            max_pass_usec_ = last_pass_usec_;
+        pass_start_usec_ = 0;
+    }
+}
+
+void UveSendBudget::FillStats(UveTableSendStats *stats) const {
+    stats->set_name(name_);
+    stats->set_uve_count(count_);
+    stats->set_runs(runs_);
+    stats->set_uves_sent(uves_sent_);
+    stats->set_last_run_usec(last_run_usec_);
+    stats->set_max_run_usec(max_run_usec_);
+    stats->set_total_run_usec(total_run_usec_);
+    stats->set_last_pass_usec(last_pass_usec_);
+    stats->set_max_pass_usec(max_pass_usec_);
+}
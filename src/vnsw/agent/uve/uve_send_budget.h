@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2016 Juniper Networks, Inc. All rights reserved.
+ */
+
+#ifndef vnsw_agent_uve_send_budget_h
+#define vnsw_agent_uve_send_budget_h
+
+#include <string>
+#include <base/util.h>
+#include <uve/uve_send_stats_types.h>
+
+// Number of UVEs a table sends in one timer run. The count starts at
+// min_count and doubles after a run that leaves UVEs pending and finishes
+// well within kRunTimeUsec. It halves after a run that takes longer than
+// kRunTimeUsec. A run also ends once kRunTimeUsec has elapsed.
+class UveSendBudget {
+public:
+    static const uint32_t kMaxCount = 2048;
+    static const uint64_t kRunTimeUsec = 10000;
+
+    UveSendBudget(const std::string &name, uint32_t min_count);
+    ~UveSendBudget();
+
+    // pass_start is true when the run starts at the beginning of the table
+    void RunStart(bool pass_start);
+    bool Exhausted(uint32_t sent) const;
+    // pass_done is true when the run reached the end of the table
+    void RunEnd(uint32_t sent, bool pass_done);
+
+    uint32_t count() const { return count_; }
+    void FillStats(UveTableSendStats *stats) const;
+
+private:
+    std::string name_;
+    uint32_t min_count_;
+    uint32_t count_;
+    uint64_t run_start_usec_;
+    uint64_t pass_start_usec_;
+    uint64_t runs_;
+    uint64_t uves_sent_;
+    uint64_t last_run_usec_;
+    uint64_t max_run_usec_;
+    uint64_t total_run_usec_;
+    uint64_t last_pass_usec_;
+    uint64_t max_pass_usec_;
+    DISALLOW_COPY_AND_ASSIGN(UveSendBudget);
+};
+
+#endif // vnsw_agent_uve_send_budget_h
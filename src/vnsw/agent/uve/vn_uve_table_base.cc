@@ -13,7 +13,8 @@ VnUveTableBase::VnUveTableBase(Agent *agent, uint32_t default_intvl)
       timer_(TimerManager::CreateTimer
              (*(agent->event_manager())->io_service(),
               "VnUveTimer",
-              TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0)) {
+              TaskScheduler::GetInstance()->GetTaskId("db::DBTable"), 0)),
+      send_budget_("VnUveTable", AgentUveBase::kUveCountPerTimer) {
       expiry_time_ = default_intvl;
       timer_->Start(expiry_time_,
                     boost::bind(&VnUveTableBase::TimerExpiry, this));
@@ -53,14 +54,16 @@ bool VnUveTableBase::TimerExpiry() {
         return true;
     }
 
+    /* Only the UVEs sent are counted against the budget */
+    send_budget_.RunStart(timer_last_visited_.empty());
     uint32_t count = 0;
-    while (it != uve_vn_map_.end() && count < AgentUveBase::kUveCountPerTimer) {
+    while (it != uve_vn_map_.end() && !send_budget_.Exhausted(count)) {
         VnUveEntryBase *entry = it->second.get();
         UveVnMap::iterator prev = it;
         it++;
-        count++;
 
         if (entry->deleted()) {
+            count++;
             SendDeleteVnMsg(prev->first);
             if (!entry->renewed()) {
                 Delete(prev->first);
@@ -71,12 +74,14 @@ bool VnUveTableBase::TimerExpiry() {
                 SendVnMsg(entry, entry->vn());
             }
         } else if (entry->changed()) {
+            count++;
             SendVnMsg(entry, entry->vn());
             entry->set_changed(false);
             /* Clear renew flag to be on safer side. Not really required */
             entry->set_renewed(false);
         }
     }
+    send_budget_.RunEnd(count, it == uve_vn_map_.end());
 
     if (it == uve_vn_map_.end()) {
         timer_last_visited_ = "";
@@ -15,6 +15,7 @@
 #include <virtual_network_types.h>
 #include <oper/vn.h>
 #include <uve/vn_uve_entry_base.h>
+#include <uve/uve_send_budget.h>
 
 //The container class for objects representing VirtualNetwork UVEs
 //Defines routines for storing and managing (add, delete, change and send)
@@ -43,6 +44,7 @@ public:
     void Shutdown(void);
     void SendVnAclRuleCount();
     bool TimerExpiry();
+    const UveSendBudget &send_budget() const { return send_budget_; }
 
 protected:
     void Delete(const std::string &name);
@@ -77,6 +79,7 @@ private:
     std::string timer_last_visited_;
     Timer *timer_;
     int expiry_time_;
+    UveSendBudget send_budget_;
 
     DISALLOW_COPY_AND_ASSIGN(VnUveTableBase);
 };
@@ -52,7 +52,8 @@ void AgentStatsSandeshContext::IfMsgHandler(vr_interface_req *req) {
         return;
      }
 
-    StatsManager::InterfaceStats *stats =stats_->GetInterfaceStats(intf);
+    StatsManager::InterfaceStats *stats =
+        stats_->GetInterfaceStats(req->get_vifr_idx());
 
     if (!stats) {
         return;
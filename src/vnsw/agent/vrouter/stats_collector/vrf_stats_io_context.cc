@@ -11,13 +11,17 @@
 void VrfStatsIoContext::Handler() {
     AgentStatsSandeshContext *ctx = static_cast<AgentStatsSandeshContext *>
                                                                        (ctx_);
-    VnUveTable *vt = static_cast<VnUveTable *>
-        (ctx->agent()->uve()->vn_uve_table());
-    vt->SendVnStats(true);
-    /* Reset the marker for query during next timer interval, if there is
-     * no additional records for the current query */
+    /* (1) If there are additional vrfs to be queried, send DUMP request
+     *     for those in the same timer interval
+     * (2) Reset the marker for query during next timer interval and send
+     *     the VN stats once, when results for all vrfs are obtained */
     if (!ctx->MoreData()) {
         ctx->set_marker_id(-1);
+        VnUveTable *vt = static_cast<VnUveTable *>
+            (ctx->agent()->uve()->vn_uve_table());
+        vt->SendVnStats(true);
+    } else {
+        ctx->agent()->stats_collector()->SendVrfStatsBulkGet();
     }
 }
 
@@ -7,6 +7,7 @@
 //  Test code for xml_base.h implementation
 
 #include "xml/xml_base.h"
+#include "xml/xml_pugi.h"
 #include <fstream>
 #include <sstream>
 #include <boost/algorithm/string/erase.hpp>
@@ -219,6 +220,29 @@ TEST_F (XmlBaseTest, XmlAppendDoc) {
     ASSERT_STREQ(result.c_str(), encode.c_str());
 };
 
+TEST_F (XmlBaseTest, XmlAppendDocToBuffer) {
+    EXPECT_FALSE(doc_ == NULL);
+    doc_->LoadDoc(xmls_);
+    doc_->AddNode("iq", "");
+    doc_->AddAttribute("type", "set");
+    doc_->AddAttribute("id", "sub1");
+    doc_->AddChildNode("pubsub", "");
+    doc_->AddAttribute("xmlns", "http://jabber.org/protocol/pubsub");
+
+    uint8_t data[1024];
+    int len = doc_->WriteDoc(data);
+    ASSERT_LT(0, len);
+
+    // Each append encodes the document after the previous contents
+    std::vector<uint8_t> buf;
+    XmlPugi *pugi = static_cast<XmlPugi *>(doc_);
+    pugi->AppendDocToBuffer(&buf);
+    pugi->AppendDocToBuffer(&buf);
+    ASSERT_EQ(static_cast<size_t>(2 * len), buf.size());
+    EXPECT_EQ(0, memcmp(data, &buf[0], len));
+    EXPECT_EQ(0, memcmp(data, &buf[len], len));
+};
+
 } // namespace
 int main(int argc, char **argv) {
     LoggingInit();
@@ -157,6 +157,22 @@ int XmlPugi::WriteRawDoc(uint8_t *buf) {
     return static_cast<int>(ts_);
 }
 
+namespace {
+struct VectorWriter : pugi::xml_writer {
+    explicit VectorWriter(std::vector<uint8_t> *buf) : buf_(buf) { }
+    virtual void write(const void *data, size_t sz) {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        buf_->insert(buf_->end(), p, p + sz);
+    }
+    std::vector<uint8_t> *buf_;
+};
+}
+
+void XmlPugi::AppendDocToBuffer(std::vector<uint8_t> *buf) const {
+    VectorWriter writer(buf);
+    doc_.save(writer, "", pugi::format_default, pugi::encoding_utf8);
+}
+
 void XmlPugi::PrintDoc(std::ostream& os) const {
     doc_.print(os, " ", pugi::format_raw | pugi::format_no_declaration);
 }
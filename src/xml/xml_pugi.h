@@ -5,6 +5,7 @@
 #ifndef __XML_PUGI_H__
 #define __XML_PUGI_H__
 
+#include <vector>
 #include <pugixml/pugixml.hpp>
 
 class XmlPugi : public XmlBase {
@@ -13,6 +14,9 @@ public:
     virtual int LoadDoc(const std::string &doc);
     virtual int WriteDoc(uint8_t *buf);
     virtual int WriteRawDoc(uint8_t *buf);
+    // Appends the document, encoded as in WriteDoc, to buf which grows as
+    // needed
+    void AppendDocToBuffer(std::vector<uint8_t> *buf) const;
     virtual void PrintDoc(std::ostream& os) const;
     virtual void PrintDocFormatted(std::ostream& os) const;
     virtual int AddNode(const std::string &key, const std::string &value);